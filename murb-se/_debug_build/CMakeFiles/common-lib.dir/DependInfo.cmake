@@ -0,0 +1,38 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/murb-se/src/common/core/Bodies.cpp" "CMakeFiles/common-lib.dir/src/common/core/Bodies.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/core/Bodies.cpp.o.d"
+  "/root/repo/murb-se/src/common/core/SimulationNBodyInterface.cpp" "CMakeFiles/common-lib.dir/src/common/core/SimulationNBodyInterface.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/core/SimulationNBodyInterface.cpp.o.d"
+  "/root/repo/murb-se/src/common/ogl/OGLControl.cpp" "CMakeFiles/common-lib.dir/src/common/ogl/OGLControl.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/ogl/OGLControl.cpp.o.d"
+  "/root/repo/murb-se/src/common/ogl/OGLSpheresVisu.cpp" "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisu.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisu.cpp.o.d"
+  "/root/repo/murb-se/src/common/ogl/OGLSpheresVisuGS.cpp" "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisuGS.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisuGS.cpp.o.d"
+  "/root/repo/murb-se/src/common/ogl/OGLSpheresVisuInst.cpp" "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisuInst.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisuInst.cpp.o.d"
+  "/root/repo/murb-se/src/common/ogl/OGLSpheresVisuThread.cpp" "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisuThread.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisuThread.cpp.o.d"
+  "/root/repo/murb-se/src/common/ogl/OGLTools.cpp" "CMakeFiles/common-lib.dir/src/common/ogl/OGLTools.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/ogl/OGLTools.cpp.o.d"
+  "/root/repo/murb-se/src/common/ogl/SpheresVisuFrames.cpp" "CMakeFiles/common-lib.dir/src/common/ogl/SpheresVisuFrames.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/ogl/SpheresVisuFrames.cpp.o.d"
+  "/root/repo/murb-se/src/common/ogl/SpheresVisuNo.cpp" "CMakeFiles/common-lib.dir/src/common/ogl/SpheresVisuNo.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/ogl/SpheresVisuNo.cpp.o.d"
+  "/root/repo/murb-se/src/common/utils/ArgumentsReader.cpp" "CMakeFiles/common-lib.dir/src/common/utils/ArgumentsReader.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/utils/ArgumentsReader.cpp.o.d"
+  "/root/repo/murb-se/src/common/utils/Communicator.cpp" "CMakeFiles/common-lib.dir/src/common/utils/Communicator.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/utils/Communicator.cpp.o.d"
+  "/root/repo/murb-se/src/common/utils/FFT.cpp" "CMakeFiles/common-lib.dir/src/common/utils/FFT.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/utils/FFT.cpp.o.d"
+  "/root/repo/murb-se/src/common/utils/Morton.cpp" "CMakeFiles/common-lib.dir/src/common/utils/Morton.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/utils/Morton.cpp.o.d"
+  "/root/repo/murb-se/src/common/utils/Norms.cpp" "CMakeFiles/common-lib.dir/src/common/utils/Norms.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/utils/Norms.cpp.o.d"
+  "/root/repo/murb-se/src/common/utils/Numa.cpp" "CMakeFiles/common-lib.dir/src/common/utils/Numa.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/utils/Numa.cpp.o.d"
+  "/root/repo/murb-se/src/common/utils/Octree.cpp" "CMakeFiles/common-lib.dir/src/common/utils/Octree.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/utils/Octree.cpp.o.d"
+  "/root/repo/murb-se/src/common/utils/Orb.cpp" "CMakeFiles/common-lib.dir/src/common/utils/Orb.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/utils/Orb.cpp.o.d"
+  "/root/repo/murb-se/src/common/utils/Perf.cpp" "CMakeFiles/common-lib.dir/src/common/utils/Perf.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/utils/Perf.cpp.o.d"
+  "/root/repo/murb-se/src/common/utils/TaskScheduler.cpp" "CMakeFiles/common-lib.dir/src/common/utils/TaskScheduler.cpp.o" "gcc" "CMakeFiles/common-lib.dir/src/common/utils/TaskScheduler.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
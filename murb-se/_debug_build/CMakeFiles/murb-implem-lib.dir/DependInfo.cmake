@@ -0,0 +1,38 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/murb-se/src/murb/implem/Autotuner.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/Autotuner.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/Autotuner.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/ImplemRegistry.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/ImplemRegistry.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/ImplemRegistry.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/KernelsISA.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/KernelsISA_avx2.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA_avx2.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA_avx2.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/KernelsISA_avx512.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA_avx512.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA_avx512.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/KernelsISA_sse2.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA_sse2.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA_sse2.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/ParticleMesh.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/ParticleMesh.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/ParticleMesh.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/SimulationNBodyAoSoA.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyAoSoA.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyAoSoA.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/SimulationNBodyBarnesHut.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyBarnesHut.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyBarnesHut.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/SimulationNBodyCutoff.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyCutoff.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyCutoff.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/SimulationNBodyFMM.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyFMM.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyFMM.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/SimulationNBodyHalf.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyHalf.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyHalf.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/SimulationNBodyMixed.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyMixed.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyMixed.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/SimulationNBodyNaive.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyNaive.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyNaive.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/SimulationNBodyORB.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyORB.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyORB.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/SimulationNBodyOptim.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyOptim.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyOptim.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/SimulationNBodyP3M.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyP3M.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyP3M.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/SimulationNBodyPM.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyPM.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyPM.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/SimulationNBodyRing.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyRing.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyRing.cpp.o.d"
+  "/root/repo/murb-se/src/murb/implem/SimulationNBodySIMD.cpp" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodySIMD.cpp.o" "gcc" "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodySIMD.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,44 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/murb-se/src/test/implem/aosoa.cpp" "CMakeFiles/test-bin.dir/src/test/implem/aosoa.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/aosoa.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/autotune.cpp" "CMakeFiles/test-bin.dir/src/test/implem/autotune.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/autotune.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/bh.cpp" "CMakeFiles/test-bin.dir/src/test/implem/bh.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/bh.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/collision.cpp" "CMakeFiles/test-bin.dir/src/test/implem/collision.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/collision.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/cutoff.cpp" "CMakeFiles/test-bin.dir/src/test/implem/cutoff.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/cutoff.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/dumb.cpp" "CMakeFiles/test-bin.dir/src/test/implem/dumb.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/dumb.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/dynamic.cpp" "CMakeFiles/test-bin.dir/src/test/implem/dynamic.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/dynamic.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/fmm.cpp" "CMakeFiles/test-bin.dir/src/test/implem/fmm.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/fmm.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/frames.cpp" "CMakeFiles/test-bin.dir/src/test/implem/frames.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/frames.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/half.cpp" "CMakeFiles/test-bin.dir/src/test/implem/half.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/half.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/isa.cpp" "CMakeFiles/test-bin.dir/src/test/implem/isa.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/isa.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/mixed.cpp" "CMakeFiles/test-bin.dir/src/test/implem/mixed.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/mixed.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/norms.cpp" "CMakeFiles/test-bin.dir/src/test/implem/norms.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/norms.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/numa.cpp" "CMakeFiles/test-bin.dir/src/test/implem/numa.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/numa.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/octree.cpp" "CMakeFiles/test-bin.dir/src/test/implem/octree.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/octree.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/optim.cpp" "CMakeFiles/test-bin.dir/src/test/implem/optim.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/optim.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/orb.cpp" "CMakeFiles/test-bin.dir/src/test/implem/orb.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/orb.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/p3m.cpp" "CMakeFiles/test-bin.dir/src/test/implem/p3m.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/p3m.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/pm.cpp" "CMakeFiles/test-bin.dir/src/test/implem/pm.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/pm.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/registry.cpp" "CMakeFiles/test-bin.dir/src/test/implem/registry.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/registry.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/reorder.cpp" "CMakeFiles/test-bin.dir/src/test/implem/reorder.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/reorder.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/ring.cpp" "CMakeFiles/test-bin.dir/src/test/implem/ring.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/ring.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/scheduler.cpp" "CMakeFiles/test-bin.dir/src/test/implem/scheduler.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/scheduler.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/simd.cpp" "CMakeFiles/test-bin.dir/src/test/implem/simd.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/simd.cpp.o.d"
+  "/root/repo/murb-se/src/test/implem/triplebuffer.cpp" "CMakeFiles/test-bin.dir/src/test/implem/triplebuffer.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/implem/triplebuffer.cpp.o.d"
+  "/root/repo/murb-se/src/test/main.cpp" "CMakeFiles/test-bin.dir/src/test/main.cpp.o" "gcc" "CMakeFiles/test-bin.dir/src/test/main.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
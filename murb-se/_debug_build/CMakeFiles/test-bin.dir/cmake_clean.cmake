@@ -0,0 +1,61 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test-bin.dir/src/test/implem/aosoa.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/aosoa.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/autotune.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/autotune.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/bh.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/bh.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/collision.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/collision.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/cutoff.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/cutoff.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/dumb.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/dumb.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/dynamic.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/dynamic.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/fmm.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/fmm.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/frames.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/frames.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/half.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/half.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/isa.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/isa.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/mixed.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/mixed.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/norms.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/norms.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/numa.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/numa.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/octree.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/octree.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/optim.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/optim.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/orb.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/orb.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/p3m.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/p3m.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/pm.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/pm.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/registry.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/registry.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/reorder.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/reorder.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/ring.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/ring.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/scheduler.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/scheduler.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/simd.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/simd.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/implem/triplebuffer.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/implem/triplebuffer.cpp.o.d"
+  "CMakeFiles/test-bin.dir/src/test/main.cpp.o"
+  "CMakeFiles/test-bin.dir/src/test/main.cpp.o.d"
+  "bin/murb-test"
+  "bin/murb-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-bin.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
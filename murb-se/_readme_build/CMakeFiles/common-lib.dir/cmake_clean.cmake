@@ -0,0 +1,47 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/common-lib.dir/src/common/core/Bodies.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/core/Bodies.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/core/SimulationNBodyInterface.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/core/SimulationNBodyInterface.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/ogl/OGLControl.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/ogl/OGLControl.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisu.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisu.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisuGS.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisuGS.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisuInst.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisuInst.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisuThread.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/ogl/OGLSpheresVisuThread.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/ogl/OGLTools.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/ogl/OGLTools.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/ogl/SpheresVisuFrames.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/ogl/SpheresVisuFrames.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/ogl/SpheresVisuNo.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/ogl/SpheresVisuNo.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/utils/ArgumentsReader.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/utils/ArgumentsReader.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/utils/Communicator.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/utils/Communicator.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/utils/FFT.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/utils/FFT.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/utils/Morton.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/utils/Morton.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/utils/Norms.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/utils/Norms.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/utils/Numa.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/utils/Numa.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/utils/Octree.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/utils/Octree.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/utils/Orb.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/utils/Orb.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/utils/Perf.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/utils/Perf.cpp.o.d"
+  "CMakeFiles/common-lib.dir/src/common/utils/TaskScheduler.cpp.o"
+  "CMakeFiles/common-lib.dir/src/common/utils/TaskScheduler.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/common-lib.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
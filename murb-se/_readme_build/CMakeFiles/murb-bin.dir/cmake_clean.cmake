@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/murb-bin.dir/src/murb/main.cpp.o"
+  "CMakeFiles/murb-bin.dir/src/murb/main.cpp.o.d"
+  "bin/murb"
+  "bin/murb.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/murb-bin.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,47 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/Autotuner.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/Autotuner.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/ImplemRegistry.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/ImplemRegistry.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA_avx2.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA_avx2.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA_avx512.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA_avx512.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA_sse2.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/KernelsISA_sse2.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/ParticleMesh.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/ParticleMesh.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyAoSoA.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyAoSoA.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyBarnesHut.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyBarnesHut.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyCutoff.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyCutoff.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyFMM.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyFMM.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyHalf.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyHalf.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyMixed.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyMixed.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyNaive.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyNaive.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyORB.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyORB.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyOptim.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyOptim.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyP3M.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyP3M.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyPM.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyPM.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyRing.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodyRing.cpp.o.d"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodySIMD.cpp.o"
+  "CMakeFiles/murb-implem-lib.dir/src/murb/implem/SimulationNBodySIMD.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/murb-implem-lib.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/murb-se
+# Build directory: /root/repo/murb-se/_readme_build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(murb::test "/root/repo/murb-se/_readme_build/bin/murb-test")
+set_tests_properties(murb::test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/murb-se/CMakeLists.txt;101;add_test;/root/repo/murb-se/CMakeLists.txt;0;")
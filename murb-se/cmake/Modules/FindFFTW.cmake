@@ -0,0 +1,53 @@
+#
+# Find FFTW
+#
+# Try to find FFTW3 : Fastest Fourier Transform in the West (double precision).
+# This module defines
+# - FFTW_INCLUDE_DIRS
+# - FFTW_LIBRARIES
+# - FFTW_FOUND
+#
+# The following variables can be set as arguments for the module.
+# - FFTW_ROOT_DIR : Root library directory of FFTW
+#
+
+# Additional modules
+include(FindPackageHandleStandardArgs)
+
+# Find include files
+find_path(
+	FFTW_INCLUDE_DIR
+	NAMES fftw3.h
+	PATHS
+	/usr/include
+	/usr/local/include
+	/sw/include
+	/opt/local/include
+	${FFTW_ROOT_DIR}/include
+	DOC "The directory where fftw3.h resides")
+
+# Find library files
+find_library(
+	FFTW_LIBRARY
+	NAMES fftw3
+	PATHS
+	/usr/lib64
+	/usr/lib
+	/usr/local/lib64
+	/usr/local/lib
+	/sw/lib
+	/opt/local/lib
+	${FFTW_ROOT_DIR}/lib
+	DOC "The FFTW library")
+
+# Handle REQUIRD argument, define *_FOUND variable
+find_package_handle_standard_args(FFTW DEFAULT_MSG FFTW_INCLUDE_DIR FFTW_LIBRARY)
+
+# Define FFTW_INCLUDE_DIRS and FFTW_LIBRARIES
+if (FFTW_FOUND)
+	set(FFTW_INCLUDE_DIRS ${FFTW_INCLUDE_DIR})
+	set(FFTW_LIBRARIES ${FFTW_LIBRARY})
+endif()
+
+# Hide some variables
+mark_as_advanced(FFTW_INCLUDE_DIR FFTW_LIBRARY)
@@ -1,18 +1,37 @@
 #include "Bodies.hpp"
 
-#include <mipp.h>
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <limits>
+#include <numeric>
 #include <string>
+#include <unordered_map>
 
+#include "../utils/Mipp.hpp"
+#include "../utils/Morton.hpp"
+#include "../utils/Numa.hpp"
 #include "../utils/Perf.hpp"
+#include "../utils/TaskScheduler.hpp"
+
+/* bodies per task of the loops submitted to the task scheduler (a multiple of the SIMD blocks of the AoSoA layout) */
+static constexpr unsigned long grainBodies = 4096;
+
+template <typename T> const T Bodies<T>::G = 6.67384e-11;
+
+template <typename T> constexpr unsigned char Bodies<T>::layoutAoS;
+template <typename T> constexpr unsigned char Bodies<T>::layoutAoSoA;
+template <typename T> constexpr unsigned char Bodies<T>::layoutHot;
+template <typename T> constexpr unsigned char Bodies<T>::layoutAll;
 
 template <typename T>
 Bodies<T>::Bodies(const unsigned long n, const std::string &scheme, const unsigned long randInit)
-    : n(n), padding(0), allocatedBytes(0)
+    : n(n), activeLayouts(0), staleLayouts(layoutAll), padding(0), allocatedBytes(0), layoutVersion(0),
+      reorderingPeriod(0), reorderingThreshold(0), nItesSinceReordering(0), localityRef(0), collisions(false),
+      capacity(0), nDead(0), nextId(0), compactionThreshold(0.25)
 {
     assert(n > 0);
     if (scheme == "galaxy")
@@ -27,30 +46,543 @@ Bodies<T>::Bodies(const unsigned long n, const std::string &scheme, const unsign
 
 template <typename T> void Bodies<T>::allocateBuffers()
 {
-    this->dataSoA.m.resize(this->n + this->padding);
-    this->dataSoA.r.resize(this->n + this->padding);
-    this->dataSoA.qx.resize(this->n + this->padding);
-    this->dataSoA.qy.resize(this->n + this->padding);
-    this->dataSoA.qz.resize(this->n + this->padding);
-    this->dataSoA.vx.resize(this->n + this->padding);
-    this->dataSoA.vy.resize(this->n + this->padding);
-    this->dataSoA.vz.resize(this->n + this->padding);
+    this->dataAoSoA.blockSize = mipp::N<T>();
+    this->reserve(this->n + this->padding);
+
+    this->ids.resize(this->n);
+    std::iota(this->ids.begin(), this->ids.end(), 0);
+    this->alive.assign(this->n, 1);
+    this->nextId = this->n;
+}
+
+template <typename T> void Bodies<T>::reserve(const unsigned long capacity)
+{
+    const unsigned long N = mipp::N<T>();
+    const unsigned long c = ((capacity + N - 1) / N) * N;
+    if (c <= this->capacity)
+        return;
+    const bool firstAllocation = this->capacity == 0;
+    this->capacity = c;
+
+    // the new slots are value-initialized: massless bodies
+    this->dataSoA.m.resize(c);
+    this->dataSoA.r.resize(c);
+    this->dataSoA.qx.resize(c);
+    this->dataSoA.qy.resize(c);
+    this->dataSoA.qz.resize(c);
+    this->dataSoA.vx.resize(c);
+    this->dataSoA.vy.resize(c);
+    this->dataSoA.vz.resize(c);
+
+    // the active layout follows the SoA, the others are reallocated when they are rebuilt
+    if (this->activeLayouts & layoutAoS)
+        this->dataAoS.resize(c);
+    if (this->activeLayouts & layoutAoSoA) {
+        this->dataAoSoA.hot.resize(c * 4);
+        this->dataAoSoA.cold.resize(c * 4);
+    }
+    if (this->activeLayouts & layoutHot)
+        this->dataHot.resize(c);
+    this->invalidateLayouts();
+
+    this->ids.reserve(c);
+    this->alive.reserve(c);
 
-    this->dataAoS.resize(this->n + this->padding);
+    this->allocatedBytes = c * (sizeof(T) * (8 * 3 + 4) + sizeof(unsigned long) + sizeof(unsigned char));
 
-    this->allocatedBytes = (this->n + this->padding) * sizeof(T) * 8 * 2;
+    // the growths copy the old bodies from the thread of `reserve`, only the first allocation is placed
+    if (firstAllocation)
+        this->firstTouch();
+}
+
+template <typename T> void Bodies<T>::firstTouch()
+{
+    const unsigned long c = this->capacity;
+    dataSoA_t<T> &d = this->dataSoA;
+    std::vector<T> *fields[8] = {&d.m, &d.r, &d.qx, &d.qy, &d.qz, &d.vx, &d.vy, &d.vz};
+    for (int f = 0; f < 8; f++)
+        Numa::releasePages(fields[f]->data(), c * sizeof(T));
+
+    // the derived layouts are placed by `buildLayouts`
+    TaskScheduler::get().parallelForAffinity(0, c, grainBodies, [&](unsigned long begin, unsigned long end) {
+        for (int f = 0; f < 8; f++)
+            std::fill(fields[f]->begin() + begin, fields[f]->begin() + end, (T)0);
+    });
+}
+
+template <typename T>
+unsigned long Bodies<T>::addBody(const T mi, const T ri, const T qix, const T qiy, const T qiz, const T vix,
+                                 const T viy, const T viz)
+{
+    // amortized growth: the capacity doubles when it is full
+    if (this->n + 1 > this->capacity)
+        this->reserve(2 * this->capacity);
+
+    // the new body takes the first padding slot, the other padding slots are still massless
+    this->setBody(this->n, mi, ri, qix, qiy, qiz, vix, viy, viz);
+    this->n++;
+    const unsigned long N = mipp::N<T>();
+    this->padding = ((this->n + N - 1) / N) * N - this->n;
+
+    this->ids.push_back(this->nextId);
+    this->alive.push_back(1);
+    this->invalidateLayouts();
+    this->layoutVersion++;
+    return this->nextId++;
+}
+
+template <typename T> void Bodies<T>::removeBody(const unsigned long iBody)
+{
+    assert(iBody < this->n);
+    if (!this->alive[iBody])
+        return;
+
+    // tombstone: a massless body, motionless (skipped by `updatePositionsAndVelocities`), it stays in its slot until
+    // the next compaction
+    const dataSoA_t<T> &d = this->dataSoA;
+    this->setBody(iBody, 0, 0, d.qx[iBody], d.qy[iBody], d.qz[iBody], 0, 0, 0);
+    this->alive[iBody] = 0;
+    this->nDead++;
+    this->invalidateLayouts();
 }
 
 template <typename T> const unsigned long Bodies<T>::getN() const { return this->n; }
 
+template <typename T> const unsigned long Bodies<T>::getNAlive() const { return this->n - this->nDead; }
+
+template <typename T> const unsigned long Bodies<T>::getCapacity() const { return this->capacity; }
+
 template <typename T> const unsigned short Bodies<T>::getPadding() const { return this->padding; }
 
 template <typename T> const dataSoA_t<T> &Bodies<T>::getDataSoA() const { return this->dataSoA; }
 
-template <typename T> const std::vector<dataAoS_t<T>> &Bodies<T>::getDataAoS() const { return this->dataAoS; }
+template <typename T> const std::vector<dataAoS_t<T>> &Bodies<T>::getDataAoS() const
+{
+    this->buildLayouts(layoutAoS);
+    return this->dataAoS;
+}
+
+template <typename T> const std::vector<dataHot_t<T>> &Bodies<T>::getDataHot() const
+{
+    this->buildLayouts(layoutHot);
+    return this->dataHot;
+}
+
+template <typename T> const dataAoSoA_t<T> &Bodies<T>::getDataAoSoA() const
+{
+    this->buildLayouts(layoutAoSoA);
+    return this->dataAoSoA;
+}
 
 template <typename T> const float Bodies<T>::getAllocatedBytes() const { return this->allocatedBytes; }
 
+template <typename T> const std::vector<unsigned long> &Bodies<T>::getIds() const { return this->ids; }
+
+template <typename T> const unsigned long Bodies<T>::getLayoutVersion() const { return this->layoutVersion; }
+
+template <typename T> const bool Bodies<T>::isAlive(const unsigned long iBody) const { return this->alive[iBody]; }
+
+template <typename T> void Bodies<T>::setActiveLayout(const std::string &layout)
+{
+    if (layout == "AoS")
+        this->activeLayouts = layoutAoS;
+    else if (layout == "AoSoA")
+        this->activeLayouts = layoutAoSoA;
+    else if (layout == "hot")
+        this->activeLayouts = layoutHot;
+    else
+        this->activeLayouts = 0;
+    // the active layout is only updated from now on: it has to be up to date
+    this->buildLayouts(this->activeLayouts);
+}
+
+template <typename T> void Bodies<T>::buildLayouts(const unsigned char layouts) const
+{
+    const unsigned char stale = layouts & this->staleLayouts;
+    if (!stale)
+        return;
+
+    // the first build allocates the layout, its pages are placed by the threads of the copy
+    const unsigned long c = this->capacity;
+    if ((stale & layoutAoS) && this->dataAoS.size() != c) {
+        this->dataAoS.resize(c);
+        Numa::releasePages(this->dataAoS.data(), c * sizeof(dataAoS_t<T>));
+    }
+    if ((stale & layoutAoSoA) && this->dataAoSoA.hot.size() != c * 4) {
+        this->dataAoSoA.hot.resize(c * 4);
+        this->dataAoSoA.cold.resize(c * 4);
+        Numa::releasePages(this->dataAoSoA.hot.data(), c * 4 * sizeof(T));
+        Numa::releasePages(this->dataAoSoA.cold.data(), c * 4 * sizeof(T));
+    }
+    if ((stale & layoutHot) && this->dataHot.size() != c) {
+        this->dataHot.resize(c);
+        Numa::releasePages(this->dataHot.data(), c * sizeof(dataHot_t<T>));
+    }
+
+    TaskScheduler::get().parallelForAffinity(0, c, grainBodies, [&](unsigned long begin, unsigned long end) {
+        for (unsigned long iBody = begin; iBody < end; iBody++)
+            this->copyBody(iBody, stale);
+    });
+    this->staleLayouts &= ~stale;
+}
+
+template <typename T> void Bodies<T>::invalidateLayouts() { this->staleLayouts |= layoutAll & ~this->activeLayouts; }
+
+template <typename T> void Bodies<T>::setReorderingPolicy(const unsigned long period, const T threshold)
+{
+    this->reorderingPeriod = period;
+    this->reorderingThreshold = threshold;
+    this->nItesSinceReordering = 0;
+    this->localityRef = this->computeLocality();
+}
+
+template <typename T> void Bodies<T>::setCollisionPolicy(const bool enable) { this->collisions = enable; }
+
+template <typename T> void Bodies<T>::setCompactionPolicy(const T threshold)
+{
+    assert(threshold >= 0);
+    this->compactionThreshold = threshold;
+}
+
+template <typename T> bool Bodies<T>::updateLayout()
+{
+    // the merging also removes the tombstones
+    bool merged = this->collisions && this->mergeCollisions() > 0;
+    if (!merged && this->nDead > 0 && this->nDead >= this->compactionThreshold * this->n) {
+        this->compact();
+        merged = true;
+    }
+    if (this->reorderingPeriod == 0)
+        return merged;
+
+    bool reorder = ++this->nItesSinceReordering >= this->reorderingPeriod;
+    if (!reorder && this->reorderingThreshold > 0 && this->localityRef > 0)
+        reorder = this->computeLocality() > this->reorderingThreshold * this->localityRef;
+
+    if (reorder)
+        this->reorderMorton();
+    return merged || reorder;
+}
+
+/* range of sorted bodies of a cell, in the open addressing hash table of the cells */
+struct cellRange_t {
+    uint64_t key;        /*!< Morton key of the cell (the max value for an empty slot). */
+    unsigned long begin; /*!< First sorted body of the cell. */
+    unsigned long end;   /*!< Last sorted body of the cell + 1. */
+};
+
+static inline unsigned long hashCell(const uint64_t key, const int bits)
+{
+    return (key * 0x9e3779b97f4a7c15ull) >> (64 - bits);
+}
+
+template <typename T> void Bodies<T>::findOverlaps(std::vector<unsigned long> &pairs) const
+{
+    const dataSoA_t<T> &d = this->dataSoA;
+    const unsigned long n = this->n;
+    pairs.clear();
+
+    // one partial result per task: {rMax, xMin, yMin, zMin}
+    const unsigned long nBlocks = (n + grainBodies - 1) / grainBodies;
+    std::vector<std::array<T, 4>> partials(nBlocks);
+    TaskScheduler::get().parallelFor(0, n, grainBodies, [&](unsigned long begin, unsigned long end) {
+        std::array<T, 4> p = {0, std::numeric_limits<T>::max(), std::numeric_limits<T>::max(),
+                              std::numeric_limits<T>::max()};
+        for (unsigned long i = begin; i < end; i++) {
+            p[0] = std::max(p[0], d.r[i]);
+            p[1] = std::min(p[1], d.qx[i]);
+            p[2] = std::min(p[2], d.qy[i]);
+            p[3] = std::min(p[3], d.qz[i]);
+        }
+        partials[begin / grainBodies] = p;
+    });
+    T rMax = 0, xMin = std::numeric_limits<T>::max(), yMin = xMin, zMin = xMin;
+    for (const std::array<T, 4> &p : partials) {
+        rMax = std::max(rMax, p[0]);
+        xMin = std::min(xMin, p[1]);
+        yMin = std::min(yMin, p[2]);
+        zMin = std::min(zMin, p[3]);
+    }
+    if (rMax <= 0)
+        return;
+
+    // cells twice as wide as the largest radius: the overlapping bodies are in neighbor cells
+    const T invCellSize = 1 / (2 * rMax);
+    const uint32_t cMax = (1u << 21) - 1;
+    auto cellOf = [&](const unsigned long i, uint32_t c[3]) {
+        const T q[3] = {(d.qx[i] - xMin) * invCellSize, (d.qy[i] - yMin) * invCellSize, (d.qz[i] - zMin) * invCellSize};
+        for (int a = 0; a < 3; a++)
+            c[a] = q[a] < (T)cMax ? (uint32_t)q[a] : cMax;
+    };
+
+    std::vector<uint64_t> keys(n);
+    std::vector<unsigned long> order(n);
+    TaskScheduler::get().parallelFor(0, n, grainBodies, [&](unsigned long begin, unsigned long end) {
+        for (unsigned long i = begin; i < end; i++) {
+            uint32_t c[3];
+            cellOf(i, c);
+            keys[i] = mortonEncode(c[0], c[1], c[2]);
+        }
+    });
+    std::iota(order.begin(), order.end(), 0);
+    radixSortPairs(keys, order);
+
+    // spatial hash of the non-empty cells (load factor <= 1/2)
+    int bits = 1;
+    while ((1ul << bits) < 2 * n)
+        bits++;
+    const unsigned long mask = (1ul << bits) - 1;
+    std::vector<cellRange_t> table(1ul << bits, cellRange_t{std::numeric_limits<uint64_t>::max(), 0, 0});
+    for (unsigned long b = 0, e; b < n; b = e) {
+        for (e = b + 1; e < n && keys[e] == keys[b]; e++)
+            ;
+        unsigned long h = hashCell(keys[b], bits);
+        while (table[h].key != std::numeric_limits<uint64_t>::max())
+            h = (h + 1) & mask;
+        table[h] = cellRange_t{keys[b], b, e};
+    }
+
+    // one list of pairs per task, concatenated in the order of the tasks
+    const unsigned long grainPairs = 256;
+    std::vector<std::vector<unsigned long>> localPairs((n + grainPairs - 1) / grainPairs);
+    TaskScheduler::get().parallelFor(0, n, grainPairs, [&](unsigned long begin, unsigned long end) {
+        std::vector<unsigned long> &lp = localPairs[begin / grainPairs];
+        for (unsigned long s = begin; s < end; s++) {
+            const unsigned long i = order[s];
+            uint32_t c[3];
+            cellOf(i, c);
+            for (int dx = -1; dx <= 1; dx++)
+                for (int dy = -1; dy <= 1; dy++)
+                    for (int dz = -1; dz <= 1; dz++) {
+                        const long x = (long)c[0] + dx, y = (long)c[1] + dy, z = (long)c[2] + dz;
+                        if (x < 0 || y < 0 || z < 0 || x > cMax || y > cMax || z > cMax)
+                            continue;
+                        const uint64_t key = mortonEncode(x, y, z);
+                        unsigned long h = hashCell(key, bits);
+                        while (table[h].key != key && table[h].key != std::numeric_limits<uint64_t>::max())
+                            h = (h + 1) & mask;
+                        // each pair is found once, by its first body in the sorted order
+                        for (unsigned long t = std::max(table[h].begin, s + 1); t < table[h].end; t++) {
+                            const unsigned long j = order[t];
+                            if (!this->alive[i] || !this->alive[j])
+                                continue;
+                            const T rx = d.qx[j] - d.qx[i], ry = d.qy[j] - d.qy[i], rz = d.qz[j] - d.qz[i];
+                            const T rij = d.r[i] + d.r[j];
+                            if (rx * rx + ry * ry + rz * rz < rij * rij) {
+                                lp.push_back(i);
+                                lp.push_back(j);
+                            }
+                        }
+                    }
+        }
+    });
+    for (const std::vector<unsigned long> &lp : localPairs)
+        pairs.insert(pairs.end(), lp.begin(), lp.end());
+}
+
+template <typename T> unsigned long Bodies<T>::mergeCollisions()
+{
+    std::vector<unsigned long> pairs;
+    this->findOverlaps(pairs);
+    if (pairs.empty())
+        return 0;
+
+    // groups of bodies connected by overlaps (union-find, there are few pairs)
+    std::unordered_map<unsigned long, unsigned long> parent;
+    auto find = [&parent](unsigned long i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    for (unsigned long p = 0; p < pairs.size(); p++)
+        parent.emplace(pairs[p], pairs[p]);
+    for (unsigned long p = 0; p < pairs.size(); p += 2) {
+        const unsigned long a = find(pairs[p]), b = find(pairs[p + 1]);
+        if (a != b)
+            parent[std::max(a, b)] = std::min(a, b);
+    }
+
+    // merge each group into its heaviest body: mass, momentum and volume are conserved
+    struct merge_t {
+        double m, qx, qy, qz, vx, vy, vz, r3;
+        unsigned long heaviest;
+    };
+    const dataSoA_t<T> &d = this->dataSoA;
+    std::unordered_map<unsigned long, merge_t> groups;
+    std::vector<unsigned char> &alive = this->alive;
+    for (const auto &body : parent) {
+        const unsigned long i = body.first;
+        auto g = groups.emplace(find(i), merge_t{0, 0, 0, 0, 0, 0, 0, 0, i}).first;
+        merge_t &a = g->second;
+        const double mi = d.m[i];
+        a.m += mi;
+        a.qx += mi * d.qx[i];
+        a.qy += mi * d.qy[i];
+        a.qz += mi * d.qz[i];
+        a.vx += mi * d.vx[i];
+        a.vy += mi * d.vy[i];
+        a.vz += mi * d.vz[i];
+        a.r3 += (double)d.r[i] * d.r[i] * d.r[i];
+        if (d.m[i] > d.m[a.heaviest] || (d.m[i] == d.m[a.heaviest] && i < a.heaviest))
+            a.heaviest = i;
+        alive[i] = 0;
+    }
+    for (const auto &g : groups) {
+        const merge_t &a = g.second;
+        const double invM = a.m > 0 ? 1. / a.m : 0.;
+        const unsigned long h = a.heaviest;
+        if (a.m > 0)
+            this->setBody(h, a.m, std::cbrt(a.r3), a.qx * invM, a.qy * invM, a.qz * invM, a.vx * invM, a.vy * invM,
+                          a.vz * invM);
+        alive[h] = 1;
+    }
+
+    // the tombstones are removed too
+    const unsigned long nOld = this->n - this->nDead;
+    this->compact();
+    return nOld - this->n;
+}
+
+template <typename T> void Bodies<T>::compact()
+{
+    const std::vector<unsigned char> &alive = this->alive;
+    const unsigned long n = this->n;
+    const unsigned long nTotal = n + this->padding;
+
+    // each block of `grainBodies` bodies counts its alive bodies, a prefix sum gives its first output position (the
+    // blocks are the tasks of the scheduler)
+    const unsigned long nBlocks = (n + grainBodies - 1) / grainBodies;
+    std::vector<unsigned long> offsets(nBlocks + 1, 0);
+    TaskScheduler::get().parallelFor(0, n, grainBodies, [&](unsigned long begin, unsigned long end) {
+        unsigned long count = 0;
+        for (unsigned long i = begin; i < end; i++)
+            count += alive[i];
+        offsets[begin / grainBodies + 1] = count;
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    const unsigned long nNew = offsets[nBlocks];
+
+    std::vector<unsigned long> src(nNew);
+    TaskScheduler::get().parallelFor(0, n, grainBodies, [&](unsigned long begin, unsigned long end) {
+        unsigned long o = offsets[begin / grainBodies];
+        for (unsigned long i = begin; i < end; i++)
+            if (alive[i])
+                src[o++] = i;
+    });
+
+    // gather the alive bodies (src[k] >= k: through a temporary array)
+    dataSoA_t<T> &d = this->dataSoA;
+    std::vector<T> *fields[8] = {&d.m, &d.r, &d.qx, &d.qy, &d.qz, &d.vx, &d.vy, &d.vz};
+    std::vector<T> tmp(nNew);
+    for (int f = 0; f < 8; f++) {
+        std::vector<T> &field = *fields[f];
+        TaskScheduler::get().parallelFor(0, nNew, grainBodies, [&](unsigned long begin, unsigned long end) {
+            for (unsigned long k = begin; k < end; k++)
+                tmp[k] = field[src[k]];
+        });
+        std::copy(tmp.begin(), tmp.end(), field.begin());
+    }
+    std::vector<unsigned long> ids(nNew);
+    for (unsigned long k = 0; k < nNew; k++)
+        ids[k] = this->ids[src[k]];
+    std::copy(ids.begin(), ids.end(), this->ids.begin());
+    this->ids.resize(nNew);
+    this->alive.assign(nNew, 1);
+    this->nDead = 0;
+
+    // new padding: the bodies up to the end of the arrays are massless (and invisible) copies of the last body, at
+    // the origin if all the bodies have been removed
+    this->n = nNew;
+    const unsigned long N = mipp::N<T>();
+    this->padding = ((nNew + N - 1) / N) * N - nNew;
+    TaskScheduler::get().parallelForAffinity(0, nNew, grainBodies, [&](unsigned long begin, unsigned long end) {
+        for (unsigned long i = begin; i < end; i++)
+            this->copyBody(i, this->activeLayouts);
+    });
+    const T qxLast = nNew ? d.qx[nNew - 1] : (T)0;
+    const T qyLast = nNew ? d.qy[nNew - 1] : (T)0;
+    const T qzLast = nNew ? d.qz[nNew - 1] : (T)0;
+    for (unsigned long i = nNew; i < nTotal; i++)
+        this->setBody(i, 0, 0, qxLast, qyLast, qzLast, 0, 0, 0);
+    this->invalidateLayouts();
+
+    this->layoutVersion++;
+    if (this->reorderingPeriod)
+        this->localityRef = this->computeLocality();
+}
+
+template <typename T> void Bodies<T>::reorderMorton()
+{
+    // the tombstones are not permuted
+    if (this->nDead > 0)
+        this->compact();
+    dataSoA_t<T> &d = this->dataSoA;
+
+    std::vector<uint64_t> keys;
+    computeMortonKeys<T>(d.qx.data(), d.qy.data(), d.qz.data(), this->n, keys);
+    // perm[i] is the current position of the body to move at position i
+    std::vector<unsigned long> perm(this->n);
+    std::iota(perm.begin(), perm.end(), 0);
+    radixSortPairs(keys, perm);
+
+    // apply the permutation in place by following its cycles
+    std::vector<T> *fields[8] = {&d.m, &d.r, &d.qx, &d.qy, &d.qz, &d.vx, &d.vy, &d.vz};
+    std::vector<bool> done(this->n, false);
+    for (unsigned long iStart = 0; iStart < this->n; iStart++) {
+        if (done[iStart] || perm[iStart] == iStart)
+            continue;
+
+        T tmp[8];
+        for (int f = 0; f < 8; f++)
+            tmp[f] = (*fields[f])[iStart];
+        const unsigned long idTmp = this->ids[iStart];
+
+        unsigned long i = iStart;
+        for (unsigned long iSrc = perm[i]; iSrc != iStart; i = iSrc, iSrc = perm[i]) {
+            for (int f = 0; f < 8; f++)
+                (*fields[f])[i] = (*fields[f])[iSrc];
+            this->ids[i] = this->ids[iSrc];
+            done[i] = true;
+        }
+        for (int f = 0; f < 8; f++)
+            (*fields[f])[i] = tmp[f];
+        this->ids[i] = idTmp;
+        done[i] = true;
+    }
+
+    // the active layout is rebuilt from the SoA now, the others when they are read
+    TaskScheduler::get().parallelForAffinity(0, this->n, grainBodies, [&](unsigned long begin, unsigned long end) {
+        for (unsigned long iBody = begin; iBody < end; iBody++)
+            this->copyBody(iBody, this->activeLayouts);
+    });
+    this->invalidateLayouts();
+
+    this->layoutVersion++;
+    this->nItesSinceReordering = 0;
+    this->localityRef = this->computeLocality();
+}
+
+template <typename T> T Bodies<T>::computeLocality() const
+{
+    if (this->n < 2)
+        return 0;
+
+    const dataSoA_t<T> &d = this->dataSoA;
+    // one partial sum per task: the result does not depend on the number of threads
+    std::vector<T> sums((this->n - 1 + grainBodies - 1) / grainBodies, 0);
+    TaskScheduler::get().parallelFor(1, this->n, grainBodies, [&](unsigned long begin, unsigned long end) {
+        T sum = 0;
+        for (unsigned long iBody = begin; iBody < end; iBody++) {
+            const T dx = d.qx[iBody] - d.qx[iBody - 1];
+            const T dy = d.qy[iBody] - d.qy[iBody - 1];
+            const T dz = d.qz[iBody] - d.qz[iBody - 1];
+            sum += std::sqrt(dx * dx + dy * dy + dz * dz);
+        }
+        sums[(begin - 1) / grainBodies] = sum;
+    });
+    return std::accumulate(sums.begin(), sums.end(), (T)0) / (T)(this->n - 1);
+}
+
 template <typename T>
 void Bodies<T>::setBody(const unsigned long &iBody, const T &mi, const T &ri, const T &qix, const T &qiy, const T &qiz,
                         const T &vix, const T &viy, const T &viz)
@@ -64,15 +596,43 @@ void Bodies<T>::setBody(const unsigned long &iBody, const T &mi, const T &ri, co
     this->dataSoA.vx[iBody] = vix;
     this->dataSoA.vy[iBody] = viy;
     this->dataSoA.vz[iBody] = viz;
-    // AoS
-    this->dataAoS[iBody].m = mi;
-    this->dataAoS[iBody].r = ri;
-    this->dataAoS[iBody].qx = qix;
-    this->dataAoS[iBody].qy = qiy;
-    this->dataAoS[iBody].qz = qiz;
-    this->dataAoS[iBody].vx = vix;
-    this->dataAoS[iBody].vy = viy;
-    this->dataAoS[iBody].vz = viz;
+    // the active layout, the others are rebuilt from the SoA when they are read
+    this->copyBody(iBody, this->activeLayouts);
+}
+
+template <typename T> void Bodies<T>::copyBody(const unsigned long iBody, const unsigned char layouts) const
+{
+    const dataSoA_t<T> &d = this->dataSoA;
+    if (layouts & layoutAoS) {
+        dataAoS_t<T> &b = this->dataAoS[iBody];
+        b.m = d.m[iBody];
+        b.r = d.r[iBody];
+        b.qx = d.qx[iBody];
+        b.qy = d.qy[iBody];
+        b.qz = d.qz[iBody];
+        b.vx = d.vx[iBody];
+        b.vy = d.vy[iBody];
+        b.vz = d.vz[iBody];
+    }
+    if (layouts & layoutAoSoA) {
+        const unsigned long bs = this->dataAoSoA.blockSize;
+        const unsigned long iHot = (iBody / bs) * 4 * bs + (iBody % bs);
+        this->dataAoSoA.hot[iHot + 0 * bs] = d.qx[iBody];
+        this->dataAoSoA.hot[iHot + 1 * bs] = d.qy[iBody];
+        this->dataAoSoA.hot[iHot + 2 * bs] = d.qz[iBody];
+        this->dataAoSoA.hot[iHot + 3 * bs] = d.m[iBody];
+        this->dataAoSoA.cold[iHot + 0 * bs] = d.vx[iBody];
+        this->dataAoSoA.cold[iHot + 1 * bs] = d.vy[iBody];
+        this->dataAoSoA.cold[iHot + 2 * bs] = d.vz[iBody];
+        this->dataAoSoA.cold[iHot + 3 * bs] = d.r[iBody];
+    }
+    if (layouts & layoutHot) {
+        dataHot_t<T> &h = this->dataHot[iBody];
+        h.qx = d.qx[iBody];
+        h.qy = d.qy[iBody];
+        h.qz = d.qz[iBody];
+        h.gm = G * d.m[iBody];
+    }
 }
 
 /* create a galaxy... */
@@ -200,22 +760,95 @@ void Bodies<T>::updatePositionAndVelocity(const unsigned long iBody, const T mi,
 
 template <typename T> void Bodies<T>::updatePositionsAndVelocities(const accSoA_t<T> &accelerations, T &dt)
 {
-    // flops = n * 18
-    for (unsigned long iBody = 0; iBody < this->n; iBody++)
-        updatePositionAndVelocity(iBody, this->dataSoA.m[iBody], this->dataSoA.r[iBody], this->dataSoA.qx[iBody],
-                                  this->dataSoA.qy[iBody], this->dataSoA.qz[iBody], this->dataSoA.vx[iBody],
-                                  this->dataSoA.vy[iBody], this->dataSoA.vz[iBody], accelerations.ax[iBody],
-                                  accelerations.ay[iBody], accelerations.az[iBody], dt);
+    this->updatePositionsAndVelocities(accelerations, dt, 0, this->n);
+}
+
+template <typename T>
+void Bodies<T>::updatePositionsAndVelocities(const accSoA_t<T> &accelerations, T &dt, const unsigned long begin,
+                                             const unsigned long end)
+{
+    assert(begin <= end && end <= this->n);
+    // flops = (end - begin) * 18
+    TaskScheduler::get().parallelForAffinity(begin, end, grainBodies, [&](unsigned long b, unsigned long e) {
+        for (unsigned long iBody = b; iBody < e; iBody++)
+            if (this->alive[iBody]) // the tombstones stay motionless
+                updatePositionAndVelocity(iBody, this->dataSoA.m[iBody], this->dataSoA.r[iBody],
+                                          this->dataSoA.qx[iBody], this->dataSoA.qy[iBody], this->dataSoA.qz[iBody],
+                                          this->dataSoA.vx[iBody], this->dataSoA.vy[iBody], this->dataSoA.vz[iBody],
+                                          accelerations.ax[iBody], accelerations.ay[iBody], accelerations.az[iBody],
+                                          dt);
+    });
+    this->invalidateLayouts();
 }
 
 template <typename T> void Bodies<T>::updatePositionsAndVelocities(const std::vector<accAoS_t<T>> &accelerations, T &dt)
 {
     // flops = n * 18
-    for (unsigned long iBody = 0; iBody < this->n; iBody++)
-        updatePositionAndVelocity(iBody, this->dataSoA.m[iBody], this->dataSoA.r[iBody], this->dataSoA.qx[iBody],
-                                  this->dataSoA.qy[iBody], this->dataSoA.qz[iBody], this->dataSoA.vx[iBody],
-                                  this->dataSoA.vy[iBody], this->dataSoA.vz[iBody], accelerations[iBody].ax,
-                                  accelerations[iBody].ay, accelerations[iBody].az, dt);
+    TaskScheduler::get().parallelForAffinity(0, this->n, grainBodies, [&](unsigned long begin, unsigned long end) {
+        for (unsigned long iBody = begin; iBody < end; iBody++)
+            if (this->alive[iBody]) // the tombstones stay motionless
+                updatePositionAndVelocity(iBody, this->dataSoA.m[iBody], this->dataSoA.r[iBody],
+                                          this->dataSoA.qx[iBody], this->dataSoA.qy[iBody], this->dataSoA.qz[iBody],
+                                          this->dataSoA.vx[iBody], this->dataSoA.vy[iBody], this->dataSoA.vz[iBody],
+                                          accelerations[iBody].ax, accelerations[iBody].ay, accelerations[iBody].az,
+                                          dt);
+    });
+    this->invalidateLayouts();
+}
+
+template <typename T> void Bodies<T>::updatePositionsAndVelocities(const accAoSoA_t<T> &accelerations, T &dt)
+{
+    constexpr int N = mipp::N<T>();
+    assert(this->dataAoSoA.blockSize == N);
+
+    const mipp::Reg<T> rDt = dt;
+    const mipp::Reg<T> rHalf = (T)0.5;
+    const bool aosoa = this->activeLayouts & layoutAoSoA;
+    const unsigned char others = this->activeLayouts & ~layoutAoSoA;
+
+    // flops = (n + padding) * 18
+    const unsigned long nBlocks = (this->n + this->padding) / N;
+    TaskScheduler::get().parallelForAffinity(0, nBlocks, grainBodies / N, [&](unsigned long begin, unsigned long end) {
+        std::vector<T> *q[3] = {&this->dataSoA.qx, &this->dataSoA.qy, &this->dataSoA.qz};
+        std::vector<T> *v[3] = {&this->dataSoA.vx, &this->dataSoA.vy, &this->dataSoA.vz};
+        for (unsigned long iBlock = begin; iBlock < end; iBlock++) {
+            const T *acc = &accelerations.a[iBlock * 3 * N];
+
+            // the tombstones stay motionless (the padding bodies are not tombstones)
+            bool live[N];
+            bool allLive = true;
+            for (int l = 0; l < N; l++) {
+                live[l] = iBlock * N + l >= this->n || this->alive[iBlock * N + l];
+                allLive = allLive && live[l];
+            }
+
+            for (int d = 0; d < 3; d++) {
+                const mipp::Reg<T> rq = &(*q[d])[iBlock * N];
+                const mipp::Reg<T> rv = &(*v[d])[iBlock * N];
+                const mipp::Reg<T> raDt = mipp::Reg<T>(&acc[d * N]) * rDt;
+
+                mipp::Reg<T> rqNew = mipp::fmadd(mipp::fmadd(raDt, rHalf, rv), rDt, rq);
+                mipp::Reg<T> rvNew = rv + raDt;
+                if (!allLive) {
+                    const mipp::Msk<N> mLive = live;
+                    rqNew = mipp::blend(rqNew, rq, mLive);
+                    rvNew = mipp::blend(rvNew, rv, mLive);
+                }
+
+                rqNew.store(&(*q[d])[iBlock * N]);
+                rvNew.store(&(*v[d])[iBlock * N]);
+                if (aosoa) {
+                    rqNew.store(&this->dataAoSoA.hot[(iBlock * 4 + d) * N]);
+                    rvNew.store(&this->dataAoSoA.cold[(iBlock * 4 + d) * N]);
+                }
+            }
+
+            if (others)
+                for (int l = 0; l < N; l++)
+                    this->copyBody(iBlock * N + l, others);
+        }
+    });
+    this->invalidateLayouts();
 }
 
 // ==================================================================================== explicit template instantiation
@@ -42,6 +42,39 @@ template <typename T> struct dataAoS_t {
     T r;  /*!< Radius. */
 };
 
+/*!
+ * \struct dataHot_t
+ * \brief  Structure of the body characteristics read by the force computation (packed like a float4).
+ *
+ * \tparam T : Type.
+ *
+ * The mass is premultiplied by the gravitational constant. The velocities and the radius are not in this structure,
+ * they are only read from the SoA (cold) arrays.
+ */
+template <typename T> struct dataHot_t {
+    T qx; /*!< Position x. */
+    T qy; /*!< Position y. */
+    T qz; /*!< Position z. */
+    T gm; /*!< Mass multiplied by the gravitational constant. */
+};
+
+/*!
+ * \struct dataAoSoA_t
+ * \brief  Array of structures of arrays (tiled layout).
+ *
+ * \tparam T : Type.
+ *
+ * The bodies are grouped in blocks of `blockSize` bodies (the number of elements in a SIMD register). For the block b,
+ * `hot` contains qx[blockSize], qy[blockSize], qz[blockSize] and m[blockSize] contiguously (starting at
+ * b * 4 * blockSize), this is all the force computation needs. `cold` contains vx[blockSize], vy[blockSize],
+ * vz[blockSize] and r[blockSize] with the same organization.
+ */
+template <typename T> struct dataAoSoA_t {
+    std::vector<T> hot;       /*!< Array of blocks of positions x, y, z and masses. */
+    std::vector<T> cold;      /*!< Array of blocks of velocities x, y, z and radiuses. */
+    unsigned short blockSize; /*!< Number of bodies per block. */
+};
+
 /*!
  * \struct accSoA_t
  * \brief  Structure of arrays.
@@ -70,6 +103,19 @@ template <typename T> struct accAoS_t {
     T az; /*!< Acceleration z. */
 };
 
+/*!
+ * \struct accAoSoA_t
+ * \brief  Array of structures of arrays (tiled layout).
+ *
+ * \tparam T : Type.
+ *
+ * The accelerations of the bodies by blocks of `dataAoSoA_t::blockSize` bodies: for the block b, ax[blockSize],
+ * ay[blockSize] and az[blockSize] are contiguous (starting at b * 3 * blockSize).
+ */
+template <typename T> struct accAoSoA_t {
+    std::vector<T> a; /*!< Array of blocks of accelerations x, y and z. */
+};
+
 /*!
  * \class  Bodies
  * \brief  Bodies class represents the physic data of each body (mass, radius, position and velocity).
@@ -77,12 +123,36 @@ template <typename T> struct accAoS_t {
  * \tparam T : Float type.
  */
 template <typename T> class Bodies {
+  public:
+    static const T G; /*!< The gravitational constant in m^3.kg^-1.s^-2. */
+
   protected:
-    unsigned long n;                   /*!< Number of bodies. */
-    dataSoA_t<T> dataSoA;              /*!< Structure of arrays of bodies data. */
-    std::vector<dataAoS_t<T>> dataAoS; /*!< Array of structures of bodies data. */
-    unsigned short padding;            /*!< Number of fictional bodies to fill the last vector. */
-    float allocatedBytes;              /*!< Number of allocated bytes. */
+    static constexpr unsigned char layoutAoS = 1;   /*!< Flag of the AoS layout. */
+    static constexpr unsigned char layoutAoSoA = 2; /*!< Flag of the AoSoA layout. */
+    static constexpr unsigned char layoutHot = 4;   /*!< Flag of the packed hot layout. */
+    static constexpr unsigned char layoutAll = 7;   /*!< Flags of all the layouts derived from the SoA. */
+
+    unsigned long n;                           /*!< Number of bodies (including the tombstones). */
+    dataSoA_t<T> dataSoA;                      /*!< Structure of arrays of bodies data (always up to date). */
+    mutable std::vector<dataAoS_t<T>> dataAoS; /*!< Array of structures of bodies data. */
+    mutable dataAoSoA_t<T> dataAoSoA;          /*!< Array of structures of arrays of bodies data (tiled). */
+    mutable std::vector<dataHot_t<T>> dataHot; /*!< Positions and G.masses (packed, hot data of the force loop). */
+    unsigned char activeLayouts;               /*!< Derived layouts written by each update of the SoA (`layout*`). */
+    mutable unsigned char staleLayouts;        /*!< Derived layouts to rebuild from the SoA before they are read. */
+    unsigned short padding;                    /*!< Number of fictional bodies to fill the last vector. */
+    float allocatedBytes;                      /*!< Number of allocated bytes. */
+    std::vector<unsigned long> ids;            /*!< Stable id of the body stored at each position (reordering). */
+    unsigned long layoutVersion;               /*!< Incremented each time the bodies are moved in memory. */
+    unsigned long reorderingPeriod;            /*!< Number of iterations between two reorderings (0 = disabled). */
+    T reorderingThreshold;                     /*!< Locality degradation factor that triggers a reordering. */
+    unsigned long nItesSinceReordering;        /*!< Number of iterations since the last reordering. */
+    T localityRef;                             /*!< Locality metric right after the last reordering. */
+    bool collisions;                           /*!< Merge the overlapping bodies in `updateLayout`. */
+    unsigned long capacity;                    /*!< Number of allocated slots (multiple of the SIMD width). */
+    std::vector<unsigned char> alive;          /*!< 1 for the live bodies, 0 for the tombstones (removed bodies). */
+    unsigned long nDead;                       /*!< Number of tombstones. */
+    unsigned long nextId;                      /*!< Id of the next added body. */
+    T compactionThreshold;                     /*!< Fraction of tombstones that triggers a compaction. */
 
   public:
     /*!
@@ -106,10 +176,24 @@ template <typename T> class Bodies {
     /*!
      *  \brief N getter.
      *
-     *  \return The number of bodies.
+     *  \return The number of bodies, including the tombstones (the kernels loop over them, they are massless).
      */
     const unsigned long getN() const;
 
+    /*!
+     *  \brief Live bodies getter.
+     *
+     *  \return The number of bodies, without the tombstones.
+     */
+    const unsigned long getNAlive() const;
+
+    /*!
+     *  \brief Capacity getter.
+     *
+     *  \return The number of allocated slots (`n` + `padding` <= capacity).
+     */
+    const unsigned long getCapacity() const;
+
     /*!
      *  \brief Padding getter.
      *
@@ -127,10 +211,27 @@ template <typename T> class Bodies {
     /*!
      *  \brief AoS data getter.
      *
+     *  The layout is rebuilt from the SoA if it is not the active layout and the bodies have been updated since it
+     *  was last read (see `setActiveLayout`), the same for the hot and the AoSoA layouts.
+     *
      *  \return The characteristics of the bodies in AoS form.
      */
     const std::vector<dataAoS_t<T>> &getDataAoS() const;
 
+    /*!
+     *  \brief Hot data getter.
+     *
+     *  \return The positions and the masses premultiplied by G of the bodies, packed (x, y, z, G.m) per body.
+     */
+    const std::vector<dataHot_t<T>> &getDataHot() const;
+
+    /*!
+     *  \brief AoSoA data getter.
+     *
+     *  \return The characteristics of the bodies in AoSoA form (blocks of SIMD width, including the padding).
+     */
+    const dataAoSoA_t<T> &getDataAoSoA() const;
+
     /*!
      *  \brief Allocated bytes getter.
      *
@@ -138,16 +239,166 @@ template <typename T> class Bodies {
      */
     const float getAllocatedBytes() const;
 
+    /*!
+     *  \brief Ids getter.
+     *
+     *  \return The stable id of the body stored at each position (the initial position of the body).
+     */
+    const std::vector<unsigned long> &getIds() const;
+
+    /*!
+     *  \brief Layout version getter.
+     *
+     *  \return A counter incremented each time the bodies are moved in memory or added (data cached per position has
+     *          to be rebuilt when it changes).
+     */
+    const unsigned long getLayoutVersion() const;
+
+    /*!
+     *  \brief Tombstone test.
+     *
+     *  \param iBody : Position of the body.
+     *
+     *  \return False if the body has been removed and not yet compacted.
+     */
+    const bool isAlive(const unsigned long iBody) const;
+
+    /*!
+     *  \brief Select the layout kept up to date by the updates of the bodies.
+     *
+     *  The SoA is always up to date. The layout read by the implementation (`implemCaps_t::layout`: `AoS`, `AoSoA` or
+     *  `hot`) is written by each update too, the other layouts are only rebuilt from the SoA by their getter when
+     *  they are read. Any other name keeps only the SoA up to date.
+     *
+     *  \param layout : Name of the layout.
+     */
+    void setActiveLayout(const std::string &layout);
+
+    /*!
+     *  \brief Allocate slots in advance, the capacity never shrinks.
+     *
+     *  The arrays are only reallocated if `capacity` is above the current capacity (the pointers returned by the
+     *  getters are then invalidated), the new slots are massless.
+     *
+     *  \param capacity : Number of slots, rounded up to a multiple of the SIMD width.
+     */
+    void reserve(const unsigned long capacity);
+
+    /*!
+     *  \brief Add a body after the others.
+     *
+     *  The body takes the first padding slot, the capacity doubles when it is full (amortized O(1)). The layout
+     *  version is incremented.
+     *
+     *  \param mi  : Body mass.
+     *  \param ri  : Body radius.
+     *  \param qix : Body position x.
+     *  \param qiy : Body position y.
+     *  \param qiz : Body position z.
+     *  \param vix : Body velocity x.
+     *  \param viy : Body velocity y.
+     *  \param viz : Body velocity z.
+     *
+     *  \return The stable id of the new body.
+     */
+    unsigned long addBody(const T mi, const T ri, const T qix, const T qiy, const T qiz, const T vix, const T viy,
+                          const T viz);
+
+    /*!
+     *  \brief Remove a body, in O(1).
+     *
+     *  The body becomes a tombstone: a massless and motionless body that stays in its slot (the other bodies do not
+     *  move and `getN` does not change) until the next compaction, by `updateLayout` (see `setCompactionPolicy`),
+     *  `mergeCollisions` or `reorderMorton`.
+     *
+     *  \param iBody : Position of the body.
+     */
+    void removeBody(const unsigned long iBody);
+
+    /*!
+     *  \brief Select when the bodies are reordered along a Morton curve by `updateLayout`.
+     *
+     *  \param period    : Reorder every `period` iterations (0 disables the reordering).
+     *  \param threshold : Also reorder as soon as the locality metric is `threshold` times worse than right after the
+     *                     last reordering (0 disables this criterion).
+     */
+    void setReorderingPolicy(const unsigned long period, const T threshold = 2);
+
+    /*!
+     *  \brief Enable or disable the merging of the overlapping bodies by `updateLayout`.
+     *
+     *  \param enable : Merge the bodies whose spheres (radius `r`) overlap.
+     */
+    void setCollisionPolicy(const bool enable);
+
+    /*!
+     *  \brief Select when the tombstones are removed by `updateLayout`.
+     *
+     *  \param threshold : Compact the arrays when the tombstones are at least this fraction of the bodies.
+     */
+    void setCompactionPolicy(const T threshold);
+
+    /*!
+     *  \brief Apply the collision, the compaction and the reordering policies, to call once per iteration.
+     *
+     *  \return True if the bodies have been moved in memory (merged, compacted or reordered).
+     */
+    bool updateLayout();
+
+    /*!
+     *  \brief Merge the overlapping bodies and compact the arrays.
+     *
+     *  The overlapping pairs are found with a spatial hash of cells twice as wide as the largest radius. Each group of
+     *  bodies connected by overlaps becomes one body (in the slot of the heaviest one): the mass and the momentum are
+     *  conserved, the position is the center of mass and the volume is conserved. The other bodies are removed and
+     *  the arrays are compacted in parallel, `n` decreases and the padding is recomputed (the bodies from `n` to the
+     *  end of the arrays are massless). The arrays are not reallocated, the pointers returned by the getters stay
+     *  valid.
+     *
+     *  \return The number of bodies removed by the merging (the tombstones are removed too, they are not counted).
+     */
+    unsigned long mergeCollisions();
+
+    /*!
+     *  \brief Sort the bodies along a Morton (Z-order) curve.
+     *
+     *  The keys are 63-bit Morton codes in the bounding box of the bodies, they are sorted with a parallel radix sort
+     *  and all the arrays are permuted in place (the pointers returned by the getters stay valid). The padding
+     *  bodies stay at the end, the tombstones are removed first.
+     */
+    void reorderMorton();
+
+    /*!
+     *  \brief Locality metric: mean distance between the bodies stored at consecutive positions.
+     *
+     *  \return The locality metric (the lower the better).
+     */
+    T computeLocality() const;
+
     /*!
      *  \brief Update positions and velocities array.
      *
      *  \param accelerations : The array of accelerations needed to compute new positions and velocities (SoA).
      *  \param dt            : The time step value (required for time integration scheme).
      *
-     *  Update positions and velocities, this is the time integration scheme to apply after each iteration.
+     *  Update positions and velocities, this is the time integration scheme to apply after each iteration (the
+     *  tombstones are not moved).
      */
     void updatePositionsAndVelocities(const accSoA_t<T> &accelerations, T &dt);
 
+    /*!
+     *  \brief Update positions and velocities of a range of bodies.
+     *
+     *  \param accelerations : The array of accelerations of all the bodies (SoA), only the range is read.
+     *  \param dt            : The time step value (required for time integration scheme).
+     *  \param begin         : First body of the range.
+     *  \param end           : Last body of the range + 1.
+     *
+     *  The other bodies are not modified (the distributed implementations integrate the bodies of their rank).
+     */
+    void updatePositionsAndVelocities(const accSoA_t<T> &accelerations, T &dt, const unsigned long begin,
+                                      const unsigned long end);
+
     /*!
      *  \brief Update positions and velocities with time integration.
      *
@@ -158,6 +409,17 @@ template <typename T> class Bodies {
      */
     void updatePositionsAndVelocities(const std::vector<accAoS_t<T>> &accelerations, T &dt);
 
+    /*!
+     *  \brief Update positions and velocities with time integration (SIMD).
+     *
+     *  \param accelerations : The array of accelerations needed to compute new positions and velocities (AoSoA).
+     *  \param dt            : The time step value (required for time integration scheme).
+     *
+     *  Update positions and velocities block by block (the padding bodies are integrated too), this is the time
+     *  integration scheme to apply after each iteration.
+     */
+    void updatePositionsAndVelocities(const accAoSoA_t<T> &accelerations, T &dt);
+
     /*!
      *  \brief Initialized bodies like in a Galaxy with random.
      *
@@ -212,10 +474,48 @@ template <typename T> class Bodies {
     inline void setBody(const unsigned long &iBody, const T &mi, const T &ri, const T &qix, const T &qiy, const T &qiz,
                         const T &vix, const T &viy, const T &viz);
 
+    /*!
+     *  \brief Copy a body from the SoA to derived layouts.
+     *
+     *  \param iBody   : Body i id.
+     *  \param layouts : Flags of the layouts to write (`layout*`).
+     */
+    inline void copyBody(const unsigned long iBody, const unsigned char layouts) const;
+
+    /*!
+     *  \brief Rebuild the stale derived layouts from the SoA (all the slots of the capacity, in parallel).
+     *
+     *  \param layouts : Flags of the layouts to rebuild if they are stale (`layout*`).
+     */
+    void buildLayouts(const unsigned char layouts) const;
+
+    /*!
+     *  \brief Mark the derived layouts that are not active as stale, to call after an update of the SoA.
+     */
+    void invalidateLayouts();
+
     /*!
      *  \brief Allocation of buffers.
      */
     void allocateBuffers();
+
+    /*!
+     *  \brief First touch of the zero-filled SoA arrays by the threads that own the bodies in the loops of the task
+     *         scheduler (`parallelForAffinity`): the pages are allocated on the NUMA nodes of these threads.
+     */
+    void firstTouch();
+
+    /*!
+     *  \brief Find the pairs of overlapping bodies.
+     *
+     *  \param pairs : The pairs (i, j) of overlapping bodies, flattened.
+     */
+    void findOverlaps(std::vector<unsigned long> &pairs) const;
+
+    /*!
+     *  \brief Remove the dead bodies (`alive` is 0) and keep the order of the others (parallel stream compaction).
+     */
+    void compact();
 };
 
 #endif /* BODIES_HPP_ */
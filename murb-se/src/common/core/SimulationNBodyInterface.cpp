@@ -1,5 +1,3 @@
-#include <mipp.h>
-
 #include <cassert>
 #include <cmath>
 #include <fstream>
@@ -8,21 +6,66 @@
 #include <string>
 
 #include "SimulationNBodyInterface.hpp"
+#include "utils/Mipp.hpp"
 
-SimulationNBodyInterface::SimulationNBodyInterface(const unsigned long nBodies, const std::string &scheme,
-                                                   const float soft, const unsigned long randInit)
-    : bodies(nBodies, scheme, randInit), dt(std::numeric_limits<float>::infinity()), soft(soft), flopsPerIte(0),
+template <typename T>
+SimulationNBodyInterface<T>::SimulationNBodyInterface(const unsigned long nBodies, const std::string &scheme,
+                                                      const T soft, const unsigned long randInit)
+    : bodies(nBodies, scheme, randInit), dt(std::numeric_limits<T>::infinity()), soft(soft), flopsPerIte(0),
       allocatedBytes(bodies.getAllocatedBytes())
 {
-    this->allocatedBytes += (this->bodies.getN() + this->bodies.getPadding()) * sizeof(float) * 3;
+    this->allocatedBytes += (this->bodies.getN() + this->bodies.getPadding()) * sizeof(T) * 3;
 }
 
-const Bodies<float> &SimulationNBodyInterface::getBodies() const { return this->bodies; }
+template <typename T> const Bodies<T> &SimulationNBodyInterface<T>::getBodies() const { return this->bodies; }
+
+template <typename T> void SimulationNBodyInterface<T>::setDt(T dtVal) { this->dt = dtVal; }
+
+template <typename T> const T SimulationNBodyInterface<T>::getDt() const { return this->dt; }
+
+template <typename T>
+void SimulationNBodyInterface<T>::setReorderingPolicy(const unsigned long period, const T threshold)
+{
+    this->bodies.setReorderingPolicy(period, threshold);
+}
 
-void SimulationNBodyInterface::setDt(float dtVal) { this->dt = dtVal; }
+template <typename T> void SimulationNBodyInterface<T>::setCollisionPolicy(const bool enable)
+{
+    this->bodies.setCollisionPolicy(enable);
+}
 
-const float SimulationNBodyInterface::getDt() const { return this->dt; }
+template <typename T> void SimulationNBodyInterface<T>::setCompactionPolicy(const T threshold)
+{
+    this->bodies.setCompactionPolicy(threshold);
+}
 
-const float SimulationNBodyInterface::getFlopsPerIte() const { return this->flopsPerIte; }
+template <typename T> void SimulationNBodyInterface<T>::setActiveLayout(const std::string &layout)
+{
+    this->bodies.setActiveLayout(layout);
+}
+
+template <typename T>
+unsigned long SimulationNBodyInterface<T>::addBody(const T mi, const T ri, const T qix, const T qiy, const T qiz,
+                                                   const T vix, const T viy, const T viz)
+{
+    return this->bodies.addBody(mi, ri, qix, qiy, qiz, vix, viy, viz);
+}
+
+template <typename T> void SimulationNBodyInterface<T>::removeBody(const unsigned long iBody)
+{
+    this->bodies.removeBody(iBody);
+}
+
+template <typename T> bool SimulationNBodyInterface<T>::updateBodiesLayout() { return this->bodies.updateLayout(); }
+
+template <typename T> const float SimulationNBodyInterface<T>::getFlopsPerIte() const { return this->flopsPerIte; }
+
+template <typename T> const float SimulationNBodyInterface<T>::getAllocatedBytes() const
+{
+    return this->allocatedBytes;
+}
 
-const float SimulationNBodyInterface::getAllocatedBytes() const { return this->allocatedBytes; }
+// ==================================================================================== explicit template instantiation
+template class SimulationNBodyInterface<double>;
+template class SimulationNBodyInterface<float>;
+// ==================================================================================== explicit template instantiation
@@ -8,15 +8,17 @@
 /*!
  * \class  SimulationNBodyInterface
  * \brief  This is the main simulation class, it describes the main methods to implement in extended classes.
+ *
+ * \tparam T : Floating-point type of the bodies data (positions, velocities, ...).
  */
-class SimulationNBodyInterface {
+template <typename T> class SimulationNBodyInterface {
   protected:
-    const float G = 6.67384e-11f; /*!< The gravitational constant in m^3.kg^-1.s^-2. */
-    Bodies<float> bodies;         /*!< Bodies object, represent all the bodies available in space. */
-    float dt;                     /*!< Time step value. */
-    float soft;                   /*!< Softening factor value. */
-    float flopsPerIte;            /*!< Number of floating-point operations per iteration. */
-    float allocatedBytes;         /*!< Number of allocated bytes. */
+    const T G = Bodies<T>::G; /*!< The gravitational constant in m^3.kg^-1.s^-2. */
+    Bodies<T> bodies;         /*!< Bodies object, represent all the bodies available in space. */
+    T dt;                     /*!< Time step value. */
+    T soft;                   /*!< Softening factor value. */
+    float flopsPerIte;        /*!< Number of floating-point operations per iteration. */
+    float allocatedBytes;     /*!< Number of allocated bytes. */
 
   protected:
     /*!
@@ -29,8 +31,8 @@ class SimulationNBodyInterface {
      *  \param soft      : Softening factor value.
      *  \param randInit  : PNRG seed.
      */
-    SimulationNBodyInterface(const unsigned long nBodies, const std::string &scheme = "galaxy",
-                             const float soft = 0.035f, const unsigned long randInit = 0);
+    SimulationNBodyInterface(const unsigned long nBodies, const std::string &scheme = "galaxy", const T soft = 0.035,
+                             const unsigned long randInit = 0);
 
   public:
     /*!
@@ -52,21 +54,76 @@ class SimulationNBodyInterface {
      *
      *  \return Bodies class.
      */
-    const Bodies<float> &getBodies() const;
+    const Bodies<T> &getBodies() const;
 
     /*!
      *  \brief dt setter.
      *
      *  \param dtVal : Constant time step value.
      */
-    void setDt(float dtVal);
+    void setDt(T dtVal);
 
     /*!
      *  \brief Time step getter.
      *
      *  \return Time step value.
      */
-    const float getDt() const;
+    const T getDt() const;
+
+    /*!
+     *  \brief Select when the bodies are reordered along a Morton curve (see `Bodies::setReorderingPolicy`).
+     *
+     *  \param period    : Reorder every `period` iterations (0 disables the reordering).
+     *  \param threshold : Also reorder when the locality metric is `threshold` times worse than after the last
+     *                     reordering (0 disables this criterion).
+     */
+    void setReorderingPolicy(const unsigned long period, const T threshold = 2);
+
+    /*!
+     *  \brief Enable or disable the merging of the colliding bodies (see `Bodies::mergeCollisions`).
+     *
+     *  \param enable : Merge the overlapping bodies after each iteration, the number of bodies decreases.
+     */
+    void setCollisionPolicy(const bool enable);
+
+    /*!
+     *  \brief Select when the removed bodies are compacted (see `Bodies::setCompactionPolicy`).
+     *
+     *  \param threshold : Compact the arrays when the removed bodies are at least this fraction of the bodies.
+     */
+    void setCompactionPolicy(const T threshold);
+
+    /*!
+     *  \brief Select the layout of the bodies kept up to date at each iteration (see `Bodies::setActiveLayout`).
+     *
+     *  \param layout : Layout read by the implementation (`implemCaps_t::layout`).
+     */
+    void setActiveLayout(const std::string &layout);
+
+    /*!
+     *  \brief Add a body between two iterations (see `Bodies::addBody`), the buffers of the solver follow.
+     *
+     *  \return The stable id of the new body.
+     */
+    virtual unsigned long addBody(const T mi, const T ri, const T qix, const T qiy, const T qiz, const T vix,
+                                  const T viy, const T viz);
+
+    /*!
+     *  \brief Remove a body between two iterations (see `Bodies::removeBody`).
+     *
+     *  \param iBody : Position of the body (`getBodies().getIds()` gives the stable id of each position).
+     */
+    virtual void removeBody(const unsigned long iBody);
+
+    /*!
+     *  \brief Merge the colliding bodies and reorder the bodies in memory if the policies require it, to call after
+     *         each iteration.
+     *
+     *  The bodies can move in memory, `getBodies().getIds()` gives the stable id of each body.
+     *
+     *  \return True if bodies have been merged or reordered.
+     */
+    virtual bool updateBodiesLayout();
 
     /*!
      *  \brief Flops per iteration getter.
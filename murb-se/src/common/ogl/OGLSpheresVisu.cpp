@@ -1,4 +1,5 @@
 #ifdef VISU
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <iostream>
@@ -11,6 +12,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/transform.hpp>
 
+#include "../utils/Norms.hpp"
 #include "OGLSpheresVisu.hpp"
 #include "OGLTools.hpp"
 
@@ -22,10 +24,13 @@ OGLSpheresVisu<T>::OGLSpheresVisu(const std::string winName, const int winWidth,
     : SpheresVisu(), window(NULL), positionsX(positionsX), positionsXBuffer(NULL), positionsY(positionsY),
       positionsYBuffer(NULL), positionsZ(positionsZ), positionsZBuffer(NULL), velocitiesX(velocitiesX),
       velocitiesXBuffer(NULL), velocitiesY(velocitiesY), velocitiesYBuffer(NULL), velocitiesZ(velocitiesZ),
-      velocitiesZBuffer(NULL), radius(radius), radiusBuffer(NULL), colorBuffer(NULL), nSpheres(nSpheres),
+      velocitiesZBuffer(NULL), radius(radius), radiusBuffer(NULL), normsBuffer(NULL), normsRange{0.f, 0.f},
+      nSpheres(nSpheres), nAllocated(nSpheres), bodies(NULL), bodiesVersion(0), bodiesNAlive(0),
       vertexArrayRef((GLuint)0), positionBufferRef{(GLuint)0, (GLuint)0, (GLuint)0},
       accelerationBufferRef{(GLuint)0, (GLuint)0, (GLuint)0}, radiusBufferRef((GLuint)0), colorBufferRef((GLuint)0),
-      mvpRef((GLuint)0), shaderProgramRef((GLuint)0), mvp(glm::mat4(1.0f)), control(NULL), color(color)
+      mvpRef((GLuint)0), normRangeRef(-1), shaderProgramRef((GLuint)0), mvp(glm::mat4(1.0f)), control(NULL),
+      color(color), persistent(false), streamRegion(0), positionsMap{NULL, NULL, NULL}, colorMap(NULL),
+      streamFences{NULL, NULL, NULL}
 {
     assert(winWidth > 0);
     assert(winHeight > 0);
@@ -41,21 +46,8 @@ OGLSpheresVisu<T>::OGLSpheresVisu(const std::string winName, const int winWidth,
         this->velocitiesXBuffer = const_cast<float *>((float *)velocitiesX); // TODO: do not use const_cast !
         this->velocitiesYBuffer = const_cast<float *>((float *)velocitiesY); // TODO: do not use const_cast !
         this->velocitiesZBuffer = const_cast<float *>((float *)velocitiesZ); // TODO: do not use const_cast !
-        this->radiusBuffer = const_cast<float *>((float *)radius);           // TODO: do not use const_cast !
     }
-    else {
-        this->positionsXBuffer = new float[this->nSpheres];
-        this->positionsYBuffer = new float[this->nSpheres];
-        this->positionsZBuffer = new float[this->nSpheres];
-        this->velocitiesXBuffer = new float[this->nSpheres];
-        this->velocitiesYBuffer = new float[this->nSpheres];
-        this->velocitiesZBuffer = new float[this->nSpheres];
-        this->radiusBuffer = new float[this->nSpheres];
-
-        for (unsigned long iVertex = 0; iVertex < this->nSpheres; iVertex++)
-            this->radiusBuffer[iVertex] = (float)this->radius[iVertex];
-    }
-    this->colorBuffer = new float[this->nSpheres * 3];
+    this->allocateBuffers();
 
     this->window = OGLTools::initAndMakeWindow(winWidth, winHeight, winName.c_str());
 
@@ -63,23 +55,20 @@ OGLSpheresVisu<T>::OGLSpheresVisu(const std::string winName, const int winWidth,
         glGenVertexArrays(1, &(this->vertexArrayRef));
         glBindVertexArray(this->vertexArrayRef);
 
-        // bind position and radius buffers to OpenGL system
-        glGenBuffers(1, &this->positionBufferRef[0]); // can change over iterations, so binding is in refreshDisplay()
-        glGenBuffers(1, &this->positionBufferRef[1]); // can change over iterations, so binding is in refreshDisplay()
-        glGenBuffers(1, &this->positionBufferRef[2]); // can change over iterations, so binding is in refreshDisplay()
-        if (this->velocitiesX != nullptr && this->color) {
-            // glGenBuffers(
-            //     1, &this->accelerationBufferRef[0]); // can change over iterations, so binding is in refreshDisplay()
-            // glGenBuffers(
-            //     1, &this->accelerationBufferRef[1]); // can change over iterations, so binding is in refreshDisplay()
-            // glGenBuffers(
-            //     1, &this->accelerationBufferRef[2]); // can change over iterations, so binding is in refreshDisplay()
-            glGenBuffers(1, &(this->colorBufferRef));
-        }
+        // the positions and the colors change at each frame: with OpenGL >= 4.4, they are written in persistently
+        // mapped buffers of `nStreamRegions` frames (no reallocation nor synchronous copy by the driver), else the
+        // buffers are orphaned at each frame
+        this->persistent = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+        this->createStreamBuffers();
+        std::cout << "Streaming of the positions: "
+                  << (this->persistent ? "persistently mapped buffers" : "orphaned buffers (OpenGL < 4.4)")
+                  << std::endl;
+
         glGenBuffers(1, &(this->radiusBufferRef));
-        glBindBuffer(GL_ARRAY_BUFFER, this->radiusBufferRef);
-        glBufferData(GL_ARRAY_BUFFER, this->nSpheres * sizeof(GLfloat), this->radiusBuffer, GL_STATIC_DRAW);
+    }
+    this->uploadRadiuses();
 
+    if (this->window) {
         // set background color to black
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
@@ -99,20 +88,45 @@ OGLSpheresVisu<T>::OGLSpheresVisu()
     : SpheresVisu(), window(NULL), positionsX(NULL), positionsXBuffer(NULL), positionsY(NULL), positionsYBuffer(NULL),
       positionsZ(NULL), positionsZBuffer(NULL), velocitiesX(NULL), velocitiesXBuffer(NULL), velocitiesY(NULL),
       velocitiesYBuffer(NULL), velocitiesZ(NULL), velocitiesZBuffer(NULL), radius(NULL), radiusBuffer(NULL),
-      nSpheres(0), vertexArrayRef((GLuint)0), positionBufferRef{(GLuint)0, (GLuint)0, (GLuint)0},
+      normsBuffer(NULL), normsRange{0.f, 0.f}, nSpheres(0), nAllocated(0), bodies(NULL), bodiesVersion(0),
+      bodiesNAlive(0), vertexArrayRef((GLuint)0), positionBufferRef{(GLuint)0, (GLuint)0, (GLuint)0},
       accelerationBufferRef{(GLuint)0, (GLuint)0, (GLuint)0}, radiusBufferRef((GLuint)0), colorBufferRef((GLuint)0),
-      mvpRef((GLuint)0), shaderProgramRef((GLuint)0), mvp(glm::mat4(1.0f)), control(NULL), color(false)
+      mvpRef((GLuint)0), normRangeRef(-1), shaderProgramRef((GLuint)0), mvp(glm::mat4(1.0f)), control(NULL),
+      color(false), persistent(false), streamRegion(0), positionsMap{NULL, NULL, NULL}, colorMap(NULL),
+      streamFences{NULL, NULL, NULL}
 {
 }
 
 template <typename T> OGLSpheresVisu<T>::~OGLSpheresVisu()
 {
-    if (this->window)
+    if (this->window) {
+        this->releaseStreamBuffers();
         glfwDestroyWindow(this->window);
+    }
 
     if (this->control)
         delete this->control;
 
+    this->releaseBuffers();
+}
+
+template <typename T> void OGLSpheresVisu<T>::allocateBuffers()
+{
+    // the positions are converted in float (if necessary) before the copy in the orphaned buffers
+    if (sizeof(T) != sizeof(float)) {
+        this->positionsXBuffer = new float[this->nAllocated];
+        this->positionsYBuffer = new float[this->nAllocated];
+        this->positionsZBuffer = new float[this->nAllocated];
+        this->velocitiesXBuffer = new float[this->nAllocated];
+        this->velocitiesYBuffer = new float[this->nAllocated];
+        this->velocitiesZBuffer = new float[this->nAllocated];
+        this->radiusBuffer = new float[this->nAllocated];
+    }
+    this->normsBuffer = new float[this->nAllocated];
+}
+
+template <typename T> void OGLSpheresVisu<T>::releaseBuffers()
+{
     if (sizeof(T) != sizeof(float)) {
         if (this->positionsXBuffer != nullptr) {
             delete[] this->positionsXBuffer;
@@ -142,10 +156,68 @@ template <typename T> OGLSpheresVisu<T>::~OGLSpheresVisu()
             delete[] this->radiusBuffer;
             this->radiusBuffer = nullptr;
         }
-        if (this->colorBuffer != nullptr) {
-            delete[] this->colorBuffer;
-            this->colorBuffer = nullptr;
+    }
+    if (this->normsBuffer != nullptr) {
+        delete[] this->normsBuffer;
+        this->normsBuffer = nullptr;
+    }
+}
+
+template <typename T> void OGLSpheresVisu<T>::createStreamBuffers()
+{
+    glGenBuffers(3, this->positionBufferRef); // can change over iterations, so binding is in refreshDisplay()
+    if (this->velocitiesX != nullptr && this->color)
+        glGenBuffers(1, &(this->colorBufferRef));
+    if (!this->persistent)
+        return;
+
+    for (int i = 0; i < 3; i++)
+        this->createStreamBuffer(this->positionBufferRef[i], 1, &this->positionsMap[i]);
+    if (this->velocitiesX != nullptr && this->color)
+        this->createStreamBuffer(this->colorBufferRef, 1, &this->colorMap);
+    if (!this->persistent) { // a mapping failed: the storage of the buffers is immutable, recreate them
+        this->releaseStreamBuffers();
+        glGenBuffers(3, this->positionBufferRef);
+        if (this->velocitiesX != nullptr && this->color)
+            glGenBuffers(1, &(this->colorBufferRef));
+    }
+}
+
+template <typename T> void OGLSpheresVisu<T>::releaseStreamBuffers()
+{
+    for (unsigned r = 0; r < nStreamRegions; r++)
+        if (this->streamFences[r]) {
+            glDeleteSync(this->streamFences[r]);
+            this->streamFences[r] = NULL;
         }
+    for (int i = 0; i < 3; i++)
+        if (this->positionsMap[i]) {
+            glBindBuffer(GL_ARRAY_BUFFER, this->positionBufferRef[i]);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            this->positionsMap[i] = NULL;
+        }
+    if (this->colorMap) {
+        glBindBuffer(GL_ARRAY_BUFFER, this->colorBufferRef);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        this->colorMap = NULL;
+    }
+    glDeleteBuffers(3, this->positionBufferRef);
+    if (this->velocitiesX != nullptr && this->color)
+        glDeleteBuffers(1, &(this->colorBufferRef));
+    this->streamRegion = 0;
+}
+
+template <typename T> void OGLSpheresVisu<T>::uploadRadiuses()
+{
+    if (sizeof(T) == sizeof(float))
+        this->radiusBuffer = const_cast<float *>((float *)this->radius); // TODO: do not use const_cast !
+    else
+        for (unsigned long iVertex = 0; iVertex < this->nSpheres; iVertex++)
+            this->radiusBuffer[iVertex] = (float)this->radius[iVertex];
+
+    if (this->window) {
+        glBindBuffer(GL_ARRAY_BUFFER, this->radiusBufferRef);
+        glBufferData(GL_ARRAY_BUFFER, this->nSpheres * sizeof(GLfloat), this->radiusBuffer, GL_STATIC_DRAW);
     }
 }
 
@@ -174,6 +246,8 @@ bool OGLSpheresVisu<T>::compileShaders(const std::vector<GLenum> shadersType,
     // ProjectionMatrix * ViewMatrix * ModelMatrix => MVP pattern (Model = identity here)
     // Get a handle for our "MVP" uniform
     this->mvpRef = glGetUniformLocation(this->shaderProgramRef, "MVP");
+    // range of the squared norms of the velocities for the palette of the colors (-1 if the shaders have no colors)
+    this->normRangeRef = glGetUniformLocation(this->shaderProgramRef, "normRange");
 
     for (int iShader = 0; iShader < (int)shaders.size(); iShader++)
         glDeleteShader(shaders[iShader]);
@@ -181,35 +255,87 @@ bool OGLSpheresVisu<T>::compileShaders(const std::vector<GLenum> shadersType,
     return isFine;
 }
 
+template <typename T>
+void OGLSpheresVisu<T>::createStreamBuffer(const GLuint bufferRef, const unsigned nComponents, float **map)
+{
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr bytes = nStreamRegions * this->nAllocated * nComponents * sizeof(GLfloat);
+    glBindBuffer(GL_ARRAY_BUFFER, bufferRef);
+    glBufferStorage(GL_ARRAY_BUFFER, bytes, NULL, flags);
+    *map = (float *)glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, flags);
+    if (*map == NULL)
+        this->persistent = false;
+}
+
+template <typename T> GLintptr OGLSpheresVisu<T>::streamOffset(const unsigned nComponents) const
+{
+    return this->persistent ? this->streamRegion * this->nAllocated * nComponents * sizeof(GLfloat) : 0;
+}
+
+template <typename T> void OGLSpheresVisu<T>::fenceFrame()
+{
+    if (this->persistent) {
+        this->streamFences[this->streamRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        this->streamRegion = (this->streamRegion + 1) % nStreamRegions;
+    }
+}
+
 template <typename T> void OGLSpheresVisu<T>::updatePositions()
 {
-    // convert positions in float (if necessary)
-    if (sizeof(T) != sizeof(float)) {
+    // the arrays of the bodies move and their number changes between two frames (insertions, compactions)
+    if (this->bodies != NULL) {
+        const dataSoA_t<T> &d = this->bodies->getDataSoA();
+        const bool moved = this->bodies->getLayoutVersion() != this->bodiesVersion ||
+                           this->bodies->getNAlive() != this->bodiesNAlive;
+        this->bodiesVersion = this->bodies->getLayoutVersion();
+        this->bodiesNAlive = this->bodies->getNAlive();
+        this->setBodies(d.qx.data(), d.qy.data(), d.qz.data(), d.vx.data(), d.vy.data(), d.vz.data(),
+                        moved ? d.r.data() : NULL, this->bodies->getN());
+    }
+
+    // convert positions in float (if necessary), they are converted by the copy in the persistent buffers
+    if (sizeof(T) != sizeof(float) && !this->persistent)
         for (unsigned long iVertex = 0; iVertex < this->nSpheres; iVertex++) {
             this->positionsXBuffer[iVertex] = (float)this->positionsX[iVertex];
             this->positionsYBuffer[iVertex] = (float)this->positionsY[iVertex];
             this->positionsZBuffer[iVertex] = (float)this->positionsZ[iVertex];
         }
-        if (this->velocitiesX != nullptr)
-            for (unsigned long iVertex = 0; iVertex < this->nSpheres; iVertex++)
-                this->velocitiesXBuffer[iVertex] = (float)this->velocitiesX[iVertex];
-        if (this->velocitiesY != nullptr)
-            for (unsigned long iVertex = 0; iVertex < this->nSpheres; iVertex++)
-                this->velocitiesYBuffer[iVertex] = (float)this->velocitiesY[iVertex];
-        if (this->velocitiesZ != nullptr)
-            for (unsigned long iVertex = 0; iVertex < this->nSpheres; iVertex++)
-                this->velocitiesZBuffer[iVertex] = (float)this->velocitiesZ[iVertex];
-    }
-
-    // bind position buffers to GPU
-    glBindBuffer(GL_ARRAY_BUFFER, this->positionBufferRef[0]);
-    glBufferData(GL_ARRAY_BUFFER, this->nSpheres * sizeof(GLfloat), this->positionsXBuffer, GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, this->positionBufferRef[1]);
-    glBufferData(GL_ARRAY_BUFFER, this->nSpheres * sizeof(GLfloat), this->positionsYBuffer, GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, this->positionBufferRef[2]);
-    glBufferData(GL_ARRAY_BUFFER, this->nSpheres * sizeof(GLfloat), this->positionsZBuffer, GL_STATIC_DRAW);
-
-    if (this->velocitiesX != nullptr && this->color) {
+
+    const bool hasColor = this->velocitiesX != nullptr && this->color;
+    if (this->persistent) {
+        // wait until the GPU has drawn the frame that read this region (`nStreamRegions` frames ago)
+        GLsync &fence = this->streamFences[this->streamRegion];
+        if (fence) {
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+                ;
+            glDeleteSync(fence);
+            fence = NULL;
+        }
+
+        // the positions are converted directly in the mapped memory (coherent: no flush)
+        const unsigned long offset = this->streamRegion * this->nAllocated;
+        std::copy(this->positionsX, this->positionsX + this->nSpheres, this->positionsMap[0] + offset);
+        std::copy(this->positionsY, this->positionsY + this->nSpheres, this->positionsMap[1] + offset);
+        std::copy(this->positionsZ, this->positionsZ + this->nSpheres, this->positionsMap[2] + offset);
+        // the shaders map the squared norms of the velocities on the palette
+        if (hasColor)
+            squaredNorms<T>(this->velocitiesX, this->velocitiesY, this->velocitiesZ, this->nSpheres,
+                            this->colorMap + offset, this->normsRange[0], this->normsRange[1]);
+        return;
+    }
+
+    // orphan the storage of the position buffers (the driver does not wait for the last draw) and fill it
+    for (int i = 0; i < 3; i++) {
+        const float *positions = (i == 0) ? this->positionsXBuffer
+                                          : ((i == 1) ? this->positionsYBuffer : this->positionsZBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, this->positionBufferRef[i]);
+        glBufferData(GL_ARRAY_BUFFER, this->nSpheres * sizeof(GLfloat), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, this->nSpheres * sizeof(GLfloat), positions);
+    }
+
+    if (hasColor) {
+        squaredNorms<T>(this->velocitiesX, this->velocitiesY, this->velocitiesZ, this->nSpheres, this->normsBuffer,
+                        this->normsRange[0], this->normsRange[1]);
         // glBindBuffer(GL_ARRAY_BUFFER, this->accelerationBufferRef[0]);
         // glBufferData(GL_ARRAY_BUFFER, this->nSpheres * sizeof(GLfloat), this->velocitiesXBuffer, GL_STATIC_DRAW);
         // glBindBuffer(GL_ARRAY_BUFFER, this->accelerationBufferRef[1]);
@@ -217,8 +343,64 @@ template <typename T> void OGLSpheresVisu<T>::updatePositions()
         // glBindBuffer(GL_ARRAY_BUFFER, this->accelerationBufferRef[2]);
         // glBufferData(GL_ARRAY_BUFFER, this->nSpheres * sizeof(GLfloat), this->velocitiesZBuffer, GL_STATIC_DRAW);
         glBindBuffer(GL_ARRAY_BUFFER, this->colorBufferRef);
-        glBufferData(GL_ARRAY_BUFFER, this->nSpheres * 3 * sizeof(GLfloat), this->colorBuffer, GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, this->nSpheres * sizeof(GLfloat), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, this->nSpheres * sizeof(GLfloat), this->normsBuffer);
+    }
+}
+
+template <typename T> bool OGLSpheresVisu<T>::hasWindow() const { return this->window != NULL; }
+
+template <typename T>
+void OGLSpheresVisu<T>::setBodies(const T *positionsX, const T *positionsY, const T *positionsZ,
+                                  const T *velocitiesX, const T *velocitiesY, const T *velocitiesZ, const T *radius,
+                                  const unsigned long nSpheres)
+{
+    assert(positionsX);
+    assert(positionsY);
+    assert(positionsZ);
+    assert(radius || nSpheres <= this->nAllocated);
+
+    this->positionsX = positionsX;
+    this->positionsY = positionsY;
+    this->positionsZ = positionsZ;
+    if (this->velocitiesX != nullptr) {
+        this->velocitiesX = velocitiesX;
+        this->velocitiesY = velocitiesY;
+        this->velocitiesZ = velocitiesZ;
     }
+
+    // the buffers grow geometrically (the bodies are added one by one) and never shrink
+    if (nSpheres > this->nAllocated) {
+        this->releaseBuffers();
+        this->nAllocated = std::max(nSpheres, 2 * this->nAllocated);
+        this->allocateBuffers();
+        if (this->window) {
+            this->releaseStreamBuffers();
+            this->createStreamBuffers();
+        }
+    }
+    this->nSpheres = nSpheres;
+
+    if (sizeof(T) == sizeof(float)) {
+        this->positionsXBuffer = const_cast<float *>((float *)this->positionsX);   // TODO: do not use const_cast !
+        this->positionsYBuffer = const_cast<float *>((float *)this->positionsY);   // TODO: do not use const_cast !
+        this->positionsZBuffer = const_cast<float *>((float *)this->positionsZ);   // TODO: do not use const_cast !
+        this->velocitiesXBuffer = const_cast<float *>((float *)this->velocitiesX); // TODO: do not use const_cast !
+        this->velocitiesYBuffer = const_cast<float *>((float *)this->velocitiesY); // TODO: do not use const_cast !
+        this->velocitiesZBuffer = const_cast<float *>((float *)this->velocitiesZ); // TODO: do not use const_cast !
+    }
+
+    if (radius != NULL) {
+        this->radius = radius;
+        this->uploadRadiuses();
+    }
+}
+
+template <typename T> void OGLSpheresVisu<T>::followBodies(const Bodies<T> &bodies)
+{
+    this->bodies = &bodies;
+    this->bodiesVersion = bodies.getLayoutVersion();
+    this->bodiesNAlive = bodies.getNAlive();
 }
 
 template <typename T> bool OGLSpheresVisu<T>::windowShouldClose()
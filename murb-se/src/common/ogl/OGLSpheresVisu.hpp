@@ -10,6 +10,7 @@
 
 #include <glm/glm.hpp>
 
+#include "../core/Bodies.hpp"
 #include "SpheresVisu.hpp"
 
 #include "OGLControl.hpp"
@@ -32,9 +33,14 @@ template <typename T> class OGLSpheresVisu : public SpheresVisu {
     float *velocitiesZBuffer;
     const T *radius;
     float *radiusBuffer;
-    float *colorBuffer;
+    float *normsBuffer;
+    float normsRange[2];
 
-    const unsigned long nSpheres;
+    unsigned long nSpheres;      /*!< Number of drawn spheres. */
+    unsigned long nAllocated;    /*!< Number of spheres of the buffers (`nSpheres` or more). */
+    const Bodies<T> *bodies;     /*!< Bodies read at each frame (NULL if the arrays are given by `setBodies`). */
+    unsigned long bodiesVersion; /*!< Layout version of `bodies` when its radiuses have been read. */
+    unsigned long bodiesNAlive;  /*!< Number of live bodies of `bodies` when its radiuses have been read. */
 
     GLuint vertexArrayRef;
     GLuint positionBufferRef[3];
@@ -42,6 +48,7 @@ template <typename T> class OGLSpheresVisu : public SpheresVisu {
     GLuint radiusBufferRef;
     GLuint colorBufferRef;
     GLuint mvpRef;
+    GLint normRangeRef;
     GLuint shaderProgramRef;
 
     glm::mat4 mvp;
@@ -50,6 +57,13 @@ template <typename T> class OGLSpheresVisu : public SpheresVisu {
 
     const bool color;
 
+    static constexpr unsigned nStreamRegions = 3; /*!< Regions of the persistent buffers (frames in flight). */
+    bool persistent;                              /*!< Positions and colors in persistently mapped buffers. */
+    unsigned streamRegion;                        /*!< Region of the persistent buffers written by this frame. */
+    float *positionsMap[3];                       /*!< Mapped persistent buffers of the positions. */
+    float *colorMap;                              /*!< Mapped persistent buffer of the squared norms. */
+    GLsync streamFences[nStreamRegions];          /*!< End of the last draw that read each region. */
+
   protected:
     OGLSpheresVisu(const std::string winName, const int winWidth, const int winHeight, const T *positionsX,
                    const T *positionsY, const T *positionsZ, const T *velocitiesX, const T *velocitiesY,
@@ -64,9 +78,65 @@ template <typename T> class OGLSpheresVisu : public SpheresVisu {
     bool pressedPageUp();
     bool pressedPageDown();
 
+    /*!
+     *  \brief Window getter.
+     *
+     *  \return True if the window and its OpenGL context have been created.
+     */
+    bool hasWindow() const;
+
+    /*!
+     *  \brief Read the next frames from other arrays, the buffers grow with the number of spheres.
+     *
+     *  \param positionsX  : Array of positions x.
+     *  \param positionsY  : Array of positions y.
+     *  \param positionsZ  : Array of positions z.
+     *  \param velocitiesX : Array of velocities x (ignored if the visualization has no colors).
+     *  \param velocitiesY : Array of velocities y (ignored if the visualization has no colors).
+     *  \param velocitiesZ : Array of velocities z (ignored if the visualization has no colors).
+     *  \param radius      : Array of radiuses, NULL if they have not changed (required if `nSpheres` grows).
+     *  \param nSpheres    : Number of spheres.
+     */
+    void setBodies(const T *positionsX, const T *positionsY, const T *positionsZ, const T *velocitiesX,
+                   const T *velocitiesY, const T *velocitiesZ, const T *radius, const unsigned long nSpheres);
+
+    /*!
+     *  \brief Read the arrays of the bodies at each frame.
+     *
+     *  The arrays move and the number of bodies changes with the insertions, the removals and the compactions: they
+     *  are fetched before each draw, the radiuses are read again when the layout version or the number of live bodies
+     *  changes.
+     *
+     *  \param bodies : Bodies of the simulation.
+     */
+    void followBodies(const Bodies<T> &bodies);
+
   protected:
     bool compileShaders(const std::vector<GLenum> shadersType, const std::vector<std::string> shadersFiles);
     void updatePositions();
+
+    /*!
+     *  \brief Offset of the data of this frame in the position and color buffers (for `glVertexAttribPointer`).
+     *
+     *  \param nComponents : Number of floats per sphere of the buffer.
+     *
+     *  \return The offset in bytes (0 without persistent buffers).
+     */
+    GLintptr streamOffset(const unsigned nComponents) const;
+
+    /*!
+     *  \brief Fence the draw of this frame: the next frames do not overwrite its region before the GPU has read it
+     *         (to call after the draw command).
+     */
+    void fenceFrame();
+
+  private:
+    void allocateBuffers();
+    void releaseBuffers();
+    void createStreamBuffers();
+    void releaseStreamBuffers();
+    void createStreamBuffer(const GLuint bufferRef, const unsigned nComponents, float **map);
+    void uploadRadiuses();
 };
 
 #endif /* OGL_SPHERES_VISU_HPP_ */
@@ -94,7 +94,8 @@ template <typename T> void OGLSpheresVisuInst<T>::refreshDisplay()
             (void *)0       // array buffer offset
         );
 
-        // 2nd attribute buffer : vertex positions
+        // 2nd attribute buffer : vertex positions (region of this frame in the persistent buffers)
+        const GLintptr offset = this->streamOffset(1);
         for (int i = 0; i < 3; i++) {
             glEnableVertexAttribArray(iBufferIndex);
             glBindBuffer(GL_ARRAY_BUFFER, this->positionBufferRef[i]);
@@ -104,7 +105,7 @@ template <typename T> void OGLSpheresVisuInst<T>::refreshDisplay()
                 GL_FLOAT,       // type
                 GL_FALSE,       // normalized?
                 0,              // stride
-                (void *)0       // array buffer offset
+                (void *)offset  // array buffer offset
             );
         }
 
@@ -165,6 +166,7 @@ template <typename T> void OGLSpheresVisuInst<T>::refreshDisplay()
         //   for(i in NSpheres) : glDrawArrays(GL_TRIANGLE_STRIP, 0, 4),
         // but faster.
         glDrawArraysInstanced(GL_LINE_STRIP, 0, this->vertexModelSize * sizeof(GLfloat), this->nSpheres);
+        this->fenceFrame();
 
         glDisableVertexAttribArray(0);
         glDisableVertexAttribArray(1);
@@ -0,0 +1,112 @@
+#ifdef VISU
+#include <algorithm>
+#include <cassert>
+
+#include "../utils/Numa.hpp"
+#include "OGLSpheresVisuThread.hpp"
+
+template <typename T>
+OGLSpheresVisuThread<T>::OGLSpheresVisuThread(const Bodies<T> &bodies, const factory_t &create)
+    : SpheresVisu(), bodies(bodies), bodiesVersion(bodies.getLayoutVersion()), bodiesNAlive(bodies.getNAlive()),
+      radiusesVersion(1), ready(false), stop(false), closed(false), spaceBar(false), pageUp(false), pageDown(false)
+{
+    // the first snapshot is the front slot of the render thread before its first `consume`
+    this->takeSnapshot();
+    this->snapshots.publish();
+
+    this->renderThread = std::thread(&OGLSpheresVisuThread<T>::render, this, create);
+
+    // the window is created before the simulation starts
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->cvReady.wait(lock, [this]() { return this->ready; });
+}
+
+template <typename T> OGLSpheresVisuThread<T>::~OGLSpheresVisuThread()
+{
+    this->stop = true;
+    if (this->renderThread.joinable())
+        this->renderThread.join();
+}
+
+template <typename T> void OGLSpheresVisuThread<T>::takeSnapshot()
+{
+    const dataSoA_t<T> &d = this->bodies.getDataSoA();
+    const unsigned long n = this->bodies.getN();
+    snapshot_t &s = this->snapshots.getBack();
+    s.qx.assign(d.qx.begin(), d.qx.begin() + n);
+    s.qy.assign(d.qy.begin(), d.qy.begin() + n);
+    s.qz.assign(d.qz.begin(), d.qz.begin() + n);
+    s.vx.assign(d.vx.begin(), d.vx.begin() + n);
+    s.vy.assign(d.vy.begin(), d.vy.begin() + n);
+    s.vz.assign(d.vz.begin(), d.vz.begin() + n);
+
+    // the radiuses only change when bodies are added, removed, merged or moved in memory
+    if (this->bodies.getLayoutVersion() != this->bodiesVersion || this->bodies.getNAlive() != this->bodiesNAlive) {
+        this->bodiesVersion = this->bodies.getLayoutVersion();
+        this->bodiesNAlive = this->bodies.getNAlive();
+        this->radiusesVersion++;
+    }
+    if (s.radiusesVersion != this->radiusesVersion || s.r.size() != n) {
+        s.r.assign(d.r.begin(), d.r.begin() + n);
+        s.radiusesVersion = this->radiusesVersion;
+    }
+}
+
+template <typename T> void OGLSpheresVisuThread<T>::render(const factory_t create)
+{
+    // not pinned with the threads of the simulation
+    Numa::unpinCurrentThread();
+    this->snapshots.consume();
+    const snapshot_t *s = &this->snapshots.getFront();
+    OGLSpheresVisu<T> *visu = create(s->qx.data(), s->qy.data(), s->qz.data(), s->vx.data(), s->vy.data(),
+                                     s->vz.data(), s->r.data(), s->qx.size());
+    unsigned long radiusesVersion = s->radiusesVersion;
+    if (!visu->hasWindow())
+        this->closed = true;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->ready = true;
+    }
+    this->cvReady.notify_one();
+
+    while (!this->stop && !this->closed) {
+        if (this->snapshots.consume()) {
+            s = &this->snapshots.getFront();
+            const bool newRadiuses = s->radiusesVersion != radiusesVersion;
+            radiusesVersion = s->radiusesVersion;
+            visu->setBodies(s->qx.data(), s->qy.data(), s->qz.data(), s->vx.data(), s->vy.data(), s->vz.data(),
+                            newRadiuses ? s->r.data() : NULL, s->qx.size());
+        }
+        // draws, swaps the buffers (vertical synchronization) and polls the events
+        visu->refreshDisplay();
+
+        this->spaceBar = visu->pressedSpaceBar();
+        this->pageUp = visu->pressedPageUp();
+        this->pageDown = visu->pressedPageDown();
+        if (visu->windowShouldClose())
+            this->closed = true;
+    }
+
+    // the OpenGL context is destroyed by the thread that owns it
+    delete visu;
+}
+
+template <typename T> void OGLSpheresVisuThread<T>::refreshDisplay()
+{
+    this->takeSnapshot();
+    this->snapshots.publish();
+}
+
+template <typename T> bool OGLSpheresVisuThread<T>::windowShouldClose() { return this->closed; }
+
+template <typename T> bool OGLSpheresVisuThread<T>::pressedSpaceBar() { return this->spaceBar; }
+
+template <typename T> bool OGLSpheresVisuThread<T>::pressedPageUp() { return this->pageUp; }
+
+template <typename T> bool OGLSpheresVisuThread<T>::pressedPageDown() { return this->pageDown; }
+
+// ==================================================================================== explicit template instantiation
+template class OGLSpheresVisuThread<double>;
+template class OGLSpheresVisuThread<float>;
+// ==================================================================================== explicit template instantiation
+#endif
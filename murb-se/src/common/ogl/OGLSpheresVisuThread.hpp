@@ -0,0 +1,89 @@
+#ifdef VISU
+#ifndef OGL_SPHERES_VISU_THREAD_HPP_
+#define OGL_SPHERES_VISU_THREAD_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../core/Bodies.hpp"
+#include "../utils/TripleBuffer.hpp"
+#include "OGLSpheresVisu.hpp"
+#include "SpheresVisu.hpp"
+
+/*!
+ * \class  OGLSpheresVisuThread
+ * \brief  OpenGL visualization rendered by its own thread from snapshots of the bodies.
+ *
+ * \tparam T : Floating-point type.
+ *
+ * `refreshDisplay` only copies the positions and the velocities of the bodies in the back slot of a triple buffer and
+ * publishes it: the simulation does not wait for the GPU nor for the vertical synchronization. The arrays and the
+ * number of bodies are read again at each snapshot (they change with the insertions and the compactions), the radiuses
+ * only when the layout version or the number of live bodies changes. The render thread
+ * creates the window (the OpenGL context lives on this thread), draws the newest published snapshot and polls the
+ * events in loop; the state of the keys and the closing of the window are forwarded with atomic flags. The snapshots
+ * published while a frame is drawn are skipped.
+ */
+template <typename T> class OGLSpheresVisuThread : public SpheresVisu {
+  public:
+    /* factory of the visualization drawn by the render thread (positions x, y, z, velocities x, y, z, radiuses and
+     * number of bodies) */
+    typedef std::function<OGLSpheresVisu<T> *(const T *, const T *, const T *, const T *, const T *, const T *,
+                                              const T *, const unsigned long)>
+        factory_t;
+
+  protected:
+    /* positions, velocities and radiuses of the bodies at an iteration */
+    struct snapshot_t {
+        std::vector<T> qx, qy, qz;
+        std::vector<T> vx, vy, vz;
+        std::vector<T> r;
+        unsigned long radiusesVersion = 0; /* value of `radiusesVersion` when `r` has been copied */
+    };
+
+    const Bodies<T> &bodies;             /*!< Bodies of the simulation (read by `refreshDisplay`). */
+    unsigned long bodiesVersion;         /*!< Layout version of the bodies at the last snapshot. */
+    unsigned long bodiesNAlive;          /*!< Number of live bodies at the last snapshot. */
+    unsigned long radiusesVersion;       /*!< Incremented when the radiuses of the bodies may have changed. */
+    TripleBuffer<snapshot_t> snapshots;  /*!< Snapshots between the simulation and the render thread. */
+    std::thread renderThread;            /*!< Thread of the OpenGL context. */
+    std::mutex mutex;                    /*!< Protect `ready`. */
+    std::condition_variable cvReady;     /*!< Signal the creation of the window. */
+    bool ready;                          /*!< The render thread has created its visualization. */
+    std::atomic<bool> stop;              /*!< Request the end of the render thread. */
+    std::atomic<bool> closed;            /*!< The window has been closed (or could not be created). */
+    std::atomic<bool> spaceBar;          /*!< The space bar is pressed (at the last frame). */
+    std::atomic<bool> pageUp;            /*!< The page up key is pressed (at the last frame). */
+    std::atomic<bool> pageDown;          /*!< The page down key is pressed (at the last frame). */
+
+  public:
+    /*!
+     *  \brief Constructor: starts the render thread and waits for its window.
+     *
+     *  \param bodies : Bodies of the simulation.
+     *  \param create : Factory of the drawn visualization, called by the render thread with the arrays of a snapshot.
+     */
+    OGLSpheresVisuThread(const Bodies<T> &bodies, const factory_t &create);
+
+    /*!
+     *  \brief Destructor: stops the render thread (the window is closed by this thread).
+     */
+    virtual ~OGLSpheresVisuThread();
+
+    void refreshDisplay();
+    bool windowShouldClose();
+    bool pressedSpaceBar();
+    bool pressedPageUp();
+    bool pressedPageDown();
+
+  protected:
+    void takeSnapshot();
+    void render(const factory_t create);
+};
+
+#endif /* OGL_SPHERES_VISU_THREAD_HPP_ */
+#endif
@@ -0,0 +1,188 @@
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "../utils/Norms.hpp"
+#include "../utils/Numa.hpp"
+#include "SpheresVisuFrames.hpp"
+
+/* palette of the OpenGL visualization (slow to fast bodies) */
+static const unsigned char MAPPING_R[16] = {106, 153, 204, 255, 248, 241, 211, 134, 57, 24, 12, 0, 4, 9, 25, 66};
+static const unsigned char MAPPING_G[16] = {52, 87, 128, 170, 201, 233, 236, 181, 125, 82, 44, 7, 4, 1, 7, 30};
+static const unsigned char MAPPING_B[16] = {3, 0, 0, 0, 95, 191, 248, 229, 209, 177, 138, 100, 73, 47, 26, 15};
+
+template <typename T>
+SpheresVisuFrames<T>::SpheresVisuFrames(const Bodies<T> &bodies, const std::string &directory,
+                                        const unsigned long period, const int width, const int height,
+                                        const bool color)
+    : SpheresVisu(), bodies(bodies), directory(directory), period(std::max(period, 1ul)), width(width),
+      height(height), color(color), iteration(0), nPublished(0), published(false), stop(false), nWritten(0),
+      camDistance(0.)
+{
+    if (width <= 0 || height <= 0) {
+        std::cout << "The size of the images (" << width << "x" << height << ") is not valid... exiting." << std::endl;
+        exit(-1);
+    }
+    struct stat info;
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cout << "Impossible to create the directory '" << directory << "' of the images... exiting." << std::endl;
+        exit(-1);
+    }
+    if (stat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+        std::cout << "'" << directory << "' is not a directory... exiting." << std::endl;
+        exit(-1);
+    }
+
+    this->writerThread = std::thread(&SpheresVisuFrames<T>::write, this);
+}
+
+template <typename T> SpheresVisuFrames<T>::~SpheresVisuFrames()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stop = true;
+    }
+    this->cvPublished.notify_one();
+    if (this->writerThread.joinable())
+        this->writerThread.join();
+
+    if (this->nWritten < this->nPublished)
+        std::cout << "Images: " << this->nWritten << " written in '" << this->directory << "', "
+                  << this->nPublished - this->nWritten
+                  << " not written (writer slower than the simulation or write error)." << std::endl;
+}
+
+template <typename T> void SpheresVisuFrames<T>::refreshDisplay()
+{
+    if (this->iteration % this->period == 0) {
+        const dataSoA_t<T> &d = this->bodies.getDataSoA();
+        const unsigned long n = this->bodies.getN();
+        snapshot_t &s = this->snapshots.getBack();
+        s.iteration = this->iteration;
+        s.qx.assign(d.qx.begin(), d.qx.begin() + n);
+        s.qy.assign(d.qy.begin(), d.qy.begin() + n);
+        s.qz.assign(d.qz.begin(), d.qz.begin() + n);
+        s.vx.assign(d.vx.begin(), d.vx.begin() + n);
+        s.vy.assign(d.vy.begin(), d.vy.begin() + n);
+        s.vz.assign(d.vz.begin(), d.vz.begin() + n);
+        s.m.assign(d.m.begin(), d.m.begin() + n);
+        this->snapshots.publish();
+        this->nPublished++;
+
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->published = true;
+        }
+        this->cvPublished.notify_one();
+    }
+    this->iteration++;
+}
+
+template <typename T> void SpheresVisuFrames<T>::write()
+{
+    // not pinned with the threads of the simulation
+    Numa::unpinCurrentThread();
+    bool warned = false;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->cvPublished.wait(lock, [this]() { return this->published || this->stop; });
+            if (!this->published)
+                break;
+            this->published = false;
+        }
+        if (!this->snapshots.consume())
+            continue;
+
+        const snapshot_t &s = this->snapshots.getFront();
+        this->draw(s);
+
+        std::stringstream path;
+        path << this->directory << "/frame_" << std::setw(6) << std::setfill('0') << s.iteration << ".ppm";
+        std::ofstream file(path.str().c_str(), std::ios::out | std::ios::binary);
+        file << "P6\n" << this->width << " " << this->height << "\n255\n";
+        file.write((const char *)this->image.data(), this->image.size());
+        if (!file.good()) {
+            if (!warned)
+                std::cout << "Impossible to write the image '" << path.str() << "'." << std::endl;
+            warned = true;
+            continue;
+        }
+        this->nWritten++;
+    }
+}
+
+template <typename T> void SpheresVisuFrames<T>::draw(const snapshot_t &s)
+{
+    const unsigned long n = s.qx.size();
+    const double tanHalfFoV = std::tan(22.5 * M_PI / 180.); // vertical field of view of 45 degrees
+    const double focal = 0.5 * this->height / tanHalfFoV;
+
+    // the camera frames the bodies of the first image and then stays still
+    if (this->camDistance == 0.) {
+        double extent = 0., depth = 0.;
+        for (unsigned long b = 0; b < n; b++) {
+            extent = std::max(extent, std::max(std::abs((double)s.qy[b]),
+                                               std::abs((double)s.qx[b]) * this->height / this->width));
+            depth = std::max(depth, std::abs((double)s.qz[b]));
+        }
+        // the plane z = 0 fills 90% of the image, the camera stays in front of all the bodies
+        this->camDistance = (extent > 0.) ? std::max(extent / (0.9 * tanHalfFoV), 1.1 * depth) : 1.;
+    }
+
+    float normMin = 0.f, normMax = 0.f;
+    if (this->color) {
+        this->norms.resize(n);
+        squaredNorms<T>(s.vx.data(), s.vy.data(), s.vz.data(), n, this->norms.data(), normMin, normMax);
+    }
+    const float normRange = std::max(normMax - normMin, 1e-30f);
+
+    // additive splats: a pixel gets brighter with the number of bodies it contains
+    const float gain = 0.6f / 255.f;
+    this->accumulation.assign(3 * this->width * this->height, 0.f);
+    for (unsigned long b = 0; b < n; b++) {
+        if (s.m[b] == 0) // tombstone of a collision
+            continue;
+        const double dist = this->camDistance - s.qz[b];
+        if (dist <= 0.)
+            continue;
+        const long px = std::lround(0.5 * this->width + focal * s.qx[b] / dist);
+        const long py = std::lround(0.5 * this->height - focal * s.qy[b] / dist);
+        if (px < 0 || px >= this->width || py < 0 || py >= this->height)
+            continue;
+
+        int c = 3;
+        if (this->color)
+            c = std::min(std::max((int)((this->norms[b] - normMin) / normRange * 15), 0), 15);
+        float *pixel = &this->accumulation[3 * (py * this->width + px)];
+        pixel[0] += gain * (this->color ? MAPPING_R[c] : 255);
+        pixel[1] += gain * (this->color ? MAPPING_G[c] : 255);
+        pixel[2] += gain * (this->color ? MAPPING_B[c] : 255);
+    }
+
+    // exponential tone mapping: the dense cores saturate smoothly
+    this->image.resize(this->accumulation.size());
+    for (size_t i = 0; i < this->accumulation.size(); i++)
+        this->image[i] = (unsigned char)std::lround(255.f * (1.f - std::exp(-this->accumulation[i])));
+}
+
+template <typename T> bool SpheresVisuFrames<T>::windowShouldClose() { return false; }
+
+template <typename T> bool SpheresVisuFrames<T>::pressedSpaceBar() { return false; }
+
+template <typename T> bool SpheresVisuFrames<T>::pressedPageUp() { return false; }
+
+template <typename T> bool SpheresVisuFrames<T>::pressedPageDown() { return false; }
+
+template <typename T> unsigned long SpheresVisuFrames<T>::getNWritten() const { return this->nWritten; }
+
+// ==================================================================================== explicit template instantiation
+template class SpheresVisuFrames<double>;
+template class SpheresVisuFrames<float>;
+// ==================================================================================== explicit template instantiation
@@ -0,0 +1,95 @@
+#ifndef SPHERES_VISU_FRAMES_HPP_
+#define SPHERES_VISU_FRAMES_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../core/Bodies.hpp"
+#include "../utils/TripleBuffer.hpp"
+#include "SpheresVisu.hpp"
+
+/*!
+ * \class  SpheresVisuFrames
+ * \brief  Headless visualization: the bodies are drawn in images (PPM) by a writer thread, without display nor GPU.
+ *
+ * \tparam T : Floating-point type.
+ *
+ * Every `period` calls of `refreshDisplay`, the positions, the velocities and the masses of the bodies are copied in
+ * the back slot of a triple buffer and published: the simulation never waits for the drawing nor for the file
+ * system. The writer thread takes the newest snapshot, projects the bodies with a perspective camera on the z axis
+ * (framed on the first snapshot, then fixed), splats each body on one pixel with additive blending (colored by the
+ * squared norm of its velocity like the OpenGL visualization, or white) and writes `frame_<iteration>.ppm`. If the
+ * writer is slower than the simulation, the older snapshots are skipped (the names keep the iteration numbers).
+ */
+template <typename T> class SpheresVisuFrames : public SpheresVisu {
+  protected:
+    /* bodies at an iteration */
+    struct snapshot_t {
+        unsigned long iteration;
+        std::vector<T> qx, qy, qz;
+        std::vector<T> vx, vy, vz;
+        std::vector<T> m;
+    };
+
+    const Bodies<T> &bodies;             /*!< Bodies of the simulation (read by `refreshDisplay`). */
+    const std::string directory;         /*!< Directory of the images. */
+    const unsigned long period;          /*!< Number of iterations between two images. */
+    const int width;                     /*!< Width of the images in pixels. */
+    const int height;                    /*!< Height of the images in pixels. */
+    const bool color;                    /*!< Colors from the velocities (or white). */
+    unsigned long iteration;             /*!< Number of calls of `refreshDisplay`. */
+    unsigned long nPublished;            /*!< Number of published snapshots. */
+    TripleBuffer<snapshot_t> snapshots;  /*!< Snapshots between the simulation and the writer thread. */
+    std::thread writerThread;            /*!< Thread that draws and writes the images. */
+    std::mutex mutex;                    /*!< Protect `published`. */
+    std::condition_variable cvPublished; /*!< Wake up the writer thread. */
+    bool published;                      /*!< A snapshot has been published since the writer thread woke up. */
+    bool stop;                           /*!< Request the end of the writer thread (after the last snapshot). */
+    std::atomic<unsigned long> nWritten; /*!< Number of written images. */
+    double camDistance;                  /*!< Distance between the camera and the origin (0 before the 1st image). */
+    std::vector<float> norms;            /*!< Squared norms of the velocities (writer thread). */
+    std::vector<float> accumulation;     /*!< Accumulated RGB intensities of the pixels (writer thread). */
+    std::vector<unsigned char> image;    /*!< RGB image (writer thread). */
+
+  public:
+    /*!
+     *  \brief Constructor: creates the directory and starts the writer thread.
+     *
+     *  \param bodies    : Bodies of the simulation.
+     *  \param directory : Directory of the images (created if it does not exist).
+     *  \param period    : Number of iterations between two images (the first image is the initial state).
+     *  \param width     : Width of the images in pixels.
+     *  \param height    : Height of the images in pixels.
+     *  \param color     : Colors from the velocities (or white).
+     */
+    SpheresVisuFrames(const Bodies<T> &bodies, const std::string &directory, const unsigned long period = 10,
+                      const int width = 1024, const int height = 768, const bool color = true);
+
+    /*!
+     *  \brief Destructor: writes the last published snapshot and stops the writer thread.
+     */
+    virtual ~SpheresVisuFrames();
+
+    void refreshDisplay();
+    bool windowShouldClose();
+    bool pressedSpaceBar();
+    bool pressedPageUp();
+    bool pressedPageDown();
+
+    /*!
+     *  \brief Written images getter.
+     *
+     *  \return The number of images written until now.
+     */
+    unsigned long getNWritten() const;
+
+  protected:
+    void write();
+    void draw(const snapshot_t &s);
+};
+
+#endif /* SPHERES_VISU_FRAMES_HPP_ */
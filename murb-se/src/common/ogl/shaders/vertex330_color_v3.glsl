@@ -0,0 +1,37 @@
+#version 330 core
+
+// Input vertex data, different for all executions of this shader.
+layout(location = 0) in float positionXPerVertex;
+layout(location = 1) in float positionYPerVertex;
+layout(location = 2) in float positionZPerVertex;
+
+// Input radius
+layout(location = 3) in float radiusPerVertex;
+
+// Input squared norm of the velocity
+layout(location = 4) in float normPerVertex;
+
+// Output data ; will be interpolated for each fragment.
+out vec3 gColor;
+out float gRadius;
+
+// Min. and max. squared norms of the velocities of the frame.
+uniform vec2 normRange;
+
+float MAPPING_R[16] = float[](106, 153, 204, 255, 248, 241, 211, 134,  57,  24,  12,   0,  4,  9, 25, 66);
+float MAPPING_G[16] = float[]( 52,  87, 128, 170, 201, 233, 236, 181, 125,  82,  44,   7,  4,  1,  7, 30);
+float MAPPING_B[16] = float[](  3,   0,   0,   0,  95, 191, 248, 229, 209, 177, 138, 100, 73, 47, 26, 15);
+
+void main()
+{
+    // Output position of the vertex, in clip space : MVP * position
+    //gl_Position = MVP * vec4(vertexPosition, 1);
+    gl_Position = vec4(positionXPerVertex, positionYPerVertex, positionZPerVertex, 1);
+
+    // Palette of 16 colors over the range of the squared norms
+    float mix = (normPerVertex - normRange.x) / max(normRange.y - normRange.x, 1.0e-30f);
+    int n = clamp(int(mix * 15), 0, 15);
+    gColor = vec3(MAPPING_R[n], MAPPING_G[n], MAPPING_B[n]) / 255;
+
+    gRadius = radiusPerVertex;
+}
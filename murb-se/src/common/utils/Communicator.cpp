@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef MURB_MPI
+#include <mpi.h>
+#endif
+
+#include "Communicator.hpp"
+#include "Numa.hpp"
+#include "TaskScheduler.hpp"
+
+/*!
+ * \class  CommunicatorSockets
+ * \brief  Built-in transport: the ranks are forked by the rank 0, each pair of ranks shares a Unix socket.
+ */
+class CommunicatorSockets : public Communicator {
+  protected:
+    unsigned rank;               /*!< Rank of the process. */
+    unsigned size;               /*!< Number of ranks. */
+    std::vector<int> sockets;    /*!< Socket to each rank (-1 for the rank itself). */
+    std::vector<pid_t> children; /*!< Processes of the other ranks (rank 0). */
+    std::thread exchange;        /*!< Exchange started by `startSendRecv`. */
+    unsigned nThreads;           /*!< Threads of the scheduler before the fork (restored on the rank 0). */
+    int nOMPThreads;             /*!< OpenMP threads before the fork (restored on the rank 0). */
+
+  public:
+    CommunicatorSockets(const unsigned nRanks) : rank(0), size(nRanks), sockets(nRanks, -1), nThreads(1), nOMPThreads(1)
+    {
+        std::vector<std::vector<int>> pairs(nRanks, std::vector<int>(nRanks, -1));
+        for (unsigned i = 0; i < nRanks; i++)
+            for (unsigned j = i + 1; j < nRanks; j++) {
+                int sv[2];
+                if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+                    std::cout << "The sockets of the ranks can not be created (" << std::strerror(errno)
+                              << ")... exiting." << std::endl;
+                    exit(-1);
+                }
+                pairs[i][j] = sv[0];
+                pairs[j][i] = sv[1];
+            }
+
+        // the threads of the scheduler are stopped: the forked ranks start without a thread holding a lock
+        TaskScheduler &scheduler = TaskScheduler::get();
+        this->nThreads = scheduler.getNumThreads();
+        scheduler.setNumThreads(1);
+        std::cout.flush();
+        for (unsigned r = 1; r < nRanks; r++) {
+            const pid_t pid = fork();
+            if (pid < 0) {
+                std::cout << "The rank " << r << " can not be forked (" << std::strerror(errno) << ")... exiting."
+                          << std::endl;
+                exit(-1);
+            }
+            if (pid == 0) {
+                this->rank = r;
+                this->children.clear();
+                break;
+            }
+            this->children.push_back(pid);
+        }
+
+        for (unsigned i = 0; i < nRanks; i++)
+            for (unsigned j = 0; j < nRanks; j++)
+                if (i == this->rank)
+                    this->sockets[j] = pairs[i][j];
+                else if (pairs[i][j] != -1)
+                    close(pairs[i][j]);
+
+        if (this->rank != 0) {
+            // one process per rank, on all the CPUs of the process
+            scheduler.setPinning(false);
+            Numa::unpinCurrentThread();
+        }
+        // the ranks share the CPUs of the host
+        scheduler.setNumThreads(std::max(1u, this->nThreads / nRanks));
+#ifdef _OPENMP
+        // the OpenMP threads of the rank 0 do not exist in the forked processes (libgomp would wait for them): the
+        // OpenMP loops of the other ranks are sequential
+        this->nOMPThreads = omp_get_max_threads();
+        omp_set_num_threads((this->rank == 0) ? std::max(1, this->nOMPThreads / (int)nRanks) : 1);
+#endif
+    }
+
+    virtual ~CommunicatorSockets()
+    {
+        if (this->exchange.joinable())
+            this->exchange.join();
+        // the other ranks see the end of their sockets
+        for (const int s : this->sockets)
+            if (s != -1)
+                close(s);
+        for (const pid_t pid : this->children)
+            waitpid(pid, nullptr, 0);
+        if (this->rank == 0) {
+            TaskScheduler::get().setNumThreads(this->nThreads);
+#ifdef _OPENMP
+            omp_set_num_threads(this->nOMPThreads);
+#endif
+        }
+    }
+
+    virtual unsigned getRank() const { return this->rank; }
+
+    virtual unsigned getSize() const { return this->size; }
+
+    virtual std::string getTransport() const { return "sockets"; }
+
+    virtual void send(const unsigned dest, const void *buf, const size_t bytes)
+    {
+        const char *p = (const char *)buf;
+        size_t sent = 0;
+        while (sent < bytes) {
+            const ssize_t s = ::send(this->sockets[dest], p + sent, bytes - sent, MSG_NOSIGNAL);
+            if (s < 0 && errno == EINTR)
+                continue;
+            if (s <= 0)
+                this->fail("send to", dest);
+            sent += s;
+        }
+    }
+
+    virtual bool recv(const unsigned src, void *buf, const size_t bytes)
+    {
+        char *p = (char *)buf;
+        size_t received = 0;
+        while (received < bytes) {
+            const ssize_t r = ::recv(this->sockets[src], p + received, bytes - received, 0);
+            if (r < 0 && errno == EINTR)
+                continue;
+            if (r == 0)
+                return false;
+            if (r < 0)
+                this->fail("receive from", src);
+            received += r;
+        }
+        return true;
+    }
+
+    virtual void startSendRecv(const unsigned dest, const void *sBuf, const size_t sBytes, const unsigned src,
+                               void *rBuf, const size_t rBytes)
+    {
+        this->exchange = std::thread([=]() {
+            // the caller may be a pinned thread of the task scheduler: the exchange runs on any CPU
+            Numa::unpinCurrentThread();
+            this->sendRecv(dest, sBuf, sBytes, src, rBuf, rBytes);
+        });
+    }
+
+    virtual void waitSendRecv() { this->exchange.join(); }
+
+    virtual void exitRank()
+    {
+        for (const int s : this->sockets)
+            if (s != -1)
+                close(s);
+        _exit(0); // the process is a copy of the rank 0: no destructor, no flush of its buffers
+    }
+
+  protected:
+    void fail(const std::string &action, const unsigned peer)
+    {
+        std::cout << "The rank " << this->rank << " can not " << action << " the rank " << peer << " ("
+                  << std::strerror(errno) << ")... exiting." << std::endl;
+        exit(-1);
+    }
+
+    /* both directions progress together: the ring does not deadlock when the messages are larger than the buffers
+     * of the sockets */
+    void sendRecv(const unsigned dest, const void *sBuf, const size_t sBytes, const unsigned src, void *rBuf,
+                  const size_t rBytes)
+    {
+        // exchange of a rank with itself (ring of 1 rank): there is no socket
+        if (dest == this->rank && src == this->rank) {
+            std::memcpy(rBuf, sBuf, std::min(sBytes, rBytes));
+            return;
+        }
+        const char *sp = (const char *)sBuf;
+        char *rp = (char *)rBuf;
+        size_t sent = 0, received = 0;
+        while (sent < sBytes || received < rBytes) {
+            pollfd fds[2];
+            nfds_t nfds = 0;
+            if (sent < sBytes)
+                fds[nfds++] = {this->sockets[dest], POLLOUT, 0};
+            if (received < rBytes)
+                fds[nfds++] = {this->sockets[src], POLLIN, 0};
+            if (poll(fds, nfds, -1) < 0) {
+                if (errno == EINTR)
+                    continue;
+                this->fail("poll", src);
+            }
+            for (nfds_t k = 0; k < nfds; k++) {
+                if (!fds[k].revents)
+                    continue;
+                if (fds[k].events == POLLOUT) {
+                    const ssize_t s = ::send(fds[k].fd, sp + sent, sBytes - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+                    if (s > 0)
+                        sent += s;
+                    else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                        this->fail("send to", dest);
+                }
+                else {
+                    const ssize_t r = ::recv(fds[k].fd, rp + received, rBytes - received, MSG_DONTWAIT);
+                    if (r > 0)
+                        received += r;
+                    else if (r == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+                        this->fail("receive from", src);
+                }
+            }
+        }
+    }
+};
+
+#ifdef MURB_MPI
+/*!
+ * \class  CommunicatorMPI
+ * \brief  MPI transport: the ranks are the processes of `MPI_COMM_WORLD`.
+ */
+class CommunicatorMPI : public Communicator {
+  protected:
+    int rank;                /*!< Rank of the process. */
+    int size;                /*!< Number of ranks. */
+    MPI_Request requests[2]; /*!< Exchange started by `startSendRecv`. */
+
+  public:
+    CommunicatorMPI()
+    {
+        int initialized;
+        MPI_Initialized(&initialized);
+        if (!initialized) {
+            // only the thread of the rank calls MPI, the threads of the scheduler do not
+            int provided;
+            MPI_Init_thread(nullptr, nullptr, MPI_THREAD_FUNNELED, &provided);
+        }
+        MPI_Comm_rank(MPI_COMM_WORLD, &this->rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &this->size);
+    }
+
+    virtual ~CommunicatorMPI()
+    {
+        int finalized;
+        MPI_Finalized(&finalized);
+        if (!finalized)
+            MPI_Finalize();
+    }
+
+    virtual unsigned getRank() const { return this->rank; }
+
+    virtual unsigned getSize() const { return this->size; }
+
+    virtual std::string getTransport() const { return "mpi"; }
+
+    virtual void send(const unsigned dest, const void *buf, const size_t bytes)
+    {
+        MPI_Send(buf, (int)bytes, MPI_BYTE, dest, 0, MPI_COMM_WORLD);
+    }
+
+    virtual bool recv(const unsigned src, void *buf, const size_t bytes)
+    {
+        MPI_Recv(buf, (int)bytes, MPI_BYTE, src, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        return true;
+    }
+
+    virtual void startSendRecv(const unsigned dest, const void *sBuf, const size_t sBytes, const unsigned src,
+                               void *rBuf, const size_t rBytes)
+    {
+        MPI_Irecv(rBuf, (int)rBytes, MPI_BYTE, src, 0, MPI_COMM_WORLD, &this->requests[0]);
+        MPI_Isend(sBuf, (int)sBytes, MPI_BYTE, dest, 0, MPI_COMM_WORLD, &this->requests[1]);
+    }
+
+    virtual void waitSendRecv() { MPI_Waitall(2, this->requests, MPI_STATUSES_IGNORE); }
+
+    virtual void exitRank()
+    {
+        MPI_Finalize();
+        exit(0);
+    }
+};
+#endif
+
+std::string Communicator::getDefaultTransport()
+{
+#ifdef MURB_MPI
+    return "mpi";
+#else
+    return "sockets";
+#endif
+}
+
+Communicator *Communicator::create(const std::string &transport, const unsigned nRanks)
+{
+    const std::string t = (transport == "auto") ? Communicator::getDefaultTransport() : transport;
+    if (t == "sockets") {
+        if (nRanks == 0) {
+            std::cout << "The number of ranks has to be at least 1... exiting." << std::endl;
+            exit(-1);
+        }
+        return new CommunicatorSockets(nRanks);
+    }
+#ifdef MURB_MPI
+    if (t == "mpi")
+        return new CommunicatorMPI();
+#endif
+    std::cout << "Transport '" << t << "' does not exist in this binary... exiting." << std::endl;
+    exit(-1);
+}
@@ -0,0 +1,109 @@
+#ifndef COMMUNICATOR_HPP_
+#define COMMUNICATOR_HPP_
+
+#include <cstddef>
+#include <string>
+
+/*!
+ * \class  Communicator
+ * \brief  Point-to-point messages between the ranks (processes) of a distributed implementation.
+ *
+ * Two transports:
+ *   - `mpi`: the ranks are the processes of `mpirun` (compiled with `-DENABLE_MURB_MPI=ON`),
+ *   - `sockets`: built-in, the rank 0 forks the other ranks and each pair of ranks is connected by a Unix socket, to
+ *     run on one host without MPI.
+ *
+ * The messages between two ranks are received in the order they are sent. One exchange (`startSendRecv`) can be in
+ * flight while the caller computes.
+ */
+class Communicator {
+  public:
+    virtual ~Communicator() = default;
+
+    /*!
+     *  \brief Create the ranks.
+     *
+     *  With the `sockets` transport, the ranks other than 0 are forked here: they return from `create` with their own
+     *  rank and a copy of the memory of the rank 0. The threads of the task scheduler are shared between the ranks and
+     *  the OpenMP loops of the forked ranks are sequential.
+     *
+     *  \param transport : `sockets`, `mpi`, or `auto` (see `getDefaultTransport`).
+     *  \param nRanks    : Number of ranks of the `sockets` transport (the one of `mpirun` otherwise).
+     *
+     *  \return The communicator of the calling rank.
+     */
+    static Communicator *create(const std::string &transport, const unsigned nRanks);
+
+    /*!
+     *  \brief Transport of `auto`: `mpi` if the binary is compiled with MPI, `sockets` otherwise.
+     *
+     *  \return The transport.
+     */
+    static std::string getDefaultTransport();
+
+    /*!
+     *  \brief Rank getter.
+     *
+     *  \return The rank of the calling process, from 0 to `getSize() - 1`.
+     */
+    virtual unsigned getRank() const = 0;
+
+    /*!
+     *  \brief Number of ranks getter.
+     *
+     *  \return The number of ranks.
+     */
+    virtual unsigned getSize() const = 0;
+
+    /*!
+     *  \brief Transport getter.
+     *
+     *  \return `sockets` or `mpi`.
+     */
+    virtual std::string getTransport() const = 0;
+
+    /*!
+     *  \brief Send a message and wait for the end of the sending.
+     *
+     *  \param dest  : Destination rank.
+     *  \param buf   : Message.
+     *  \param bytes : Size of the message.
+     */
+    virtual void send(const unsigned dest, const void *buf, const size_t bytes) = 0;
+
+    /*!
+     *  \brief Receive a message.
+     *
+     *  \param src   : Source rank.
+     *  \param buf   : Message.
+     *  \param bytes : Size of the message.
+     *
+     *  \return False if the source rank is gone (its process ended).
+     */
+    virtual bool recv(const unsigned src, void *buf, const size_t bytes) = 0;
+
+    /*!
+     *  \brief Start to send a message to `dest` and to receive a message from `src` (one exchange at a time).
+     *
+     *  \param dest   : Destination rank.
+     *  \param sBuf   : Message to send, it must not be modified before `waitSendRecv`.
+     *  \param sBytes : Size of the message to send.
+     *  \param src    : Source rank.
+     *  \param rBuf   : Message to receive, valid after `waitSendRecv`.
+     *  \param rBytes : Size of the message to receive.
+     */
+    virtual void startSendRecv(const unsigned dest, const void *sBuf, const size_t sBytes, const unsigned src,
+                               void *rBuf, const size_t rBytes) = 0;
+
+    /*!
+     *  \brief Wait for the end of the exchange started by `startSendRecv`.
+     */
+    virtual void waitSendRecv() = 0;
+
+    /*!
+     *  \brief End of a rank other than 0: leave the process without returning (after the last message).
+     */
+    virtual void exitRank() = 0;
+};
+
+#endif /* COMMUNICATOR_HPP_ */
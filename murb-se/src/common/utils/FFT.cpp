@@ -0,0 +1,138 @@
+#include "FFT.hpp"
+
+#ifdef MURB_FFTW
+#include <fftw3.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+constexpr unsigned long FFT3D::nLines;
+
+FFT3D::FFT3D(const unsigned long m) : m(m), plan(nullptr)
+{
+    assert(m > 0 && (m & (m - 1)) == 0);
+
+    unsigned long log2m = 0;
+    while ((1ul << log2m) < m)
+        log2m++;
+    this->bitReverse.resize(m);
+    for (unsigned long i = 0; i < m; i++) {
+        unsigned long r = 0;
+        for (unsigned long b = 0; b < log2m; b++)
+            r |= ((i >> b) & 1) << (log2m - 1 - b);
+        this->bitReverse[i] = r;
+    }
+    this->twiddles.resize(m / 2);
+    for (unsigned long k = 0; k < m / 2; k++)
+        this->twiddles[k] = std::polar(1., -2. * M_PI * k / m);
+
+#ifdef MURB_FFTW
+    // batch of `nLines` lines with split real and imaginary parts, the plan is executed on other arrays
+    std::vector<double> re(nLines * m), im(nLines * m);
+    fftw_iodim dim = {(int)m, (int)nLines, (int)nLines};
+    fftw_iodim batch = {(int)nLines, 1, 1};
+    this->plan = fftw_plan_guru_split_dft(1, &dim, 1, &batch, re.data(), im.data(), re.data(), im.data(),
+                                          FFTW_ESTIMATE | FFTW_UNALIGNED);
+#endif
+}
+
+FFT3D::~FFT3D()
+{
+#ifdef MURB_FFTW
+    fftw_destroy_plan((fftw_plan)this->plan);
+#endif
+}
+
+void FFT3D::transformLines(double *re, double *im, const bool inverse) const
+{
+#ifdef MURB_FFTW
+    // the backward transform is the forward transform with the real and the imaginary parts swapped
+    if (inverse)
+        fftw_execute_split_dft((fftw_plan)this->plan, im, re, im, re);
+    else
+        fftw_execute_split_dft((fftw_plan)this->plan, re, im, re, im);
+#else
+    const unsigned long L = nLines;
+    for (unsigned long i = 0; i < this->m; i++)
+        if (i < this->bitReverse[i])
+            for (unsigned long l = 0; l < L; l++) {
+                std::swap(re[i * L + l], re[this->bitReverse[i] * L + l]);
+                std::swap(im[i * L + l], im[this->bitReverse[i] * L + l]);
+            }
+
+    // iterative radix-2 Cooley-Tukey, the innermost loop is on the lines of the batch (vectorizable)
+    const double sign = inverse ? -1. : 1.;
+    for (unsigned long len = 2; len <= this->m; len <<= 1) {
+        const unsigned long half = len >> 1;
+        const unsigned long step = this->m / len;
+        for (unsigned long i = 0; i < this->m; i += len)
+            for (unsigned long k = 0; k < half; k++) {
+                const double wr = this->twiddles[k * step].real(), wi = sign * this->twiddles[k * step].imag();
+                double *ur = re + (i + k) * L, *ui = im + (i + k) * L;
+                double *vr = re + (i + k + half) * L, *vi = im + (i + k + half) * L;
+                for (unsigned long l = 0; l < L; l++) {
+                    const double tr = vr[l] * wr - vi[l] * wi;
+                    const double ti = vr[l] * wi + vi[l] * wr;
+                    vr[l] = ur[l] - tr;
+                    vi[l] = ui[l] - ti;
+                    ur[l] += tr;
+                    ui[l] += ti;
+                }
+            }
+    }
+#endif
+}
+
+void FFT3D::transformAxis(std::complex<double> *data, const int axis, const unsigned long n, const bool inverse) const
+{
+    const unsigned long m = this->m;
+    // lines along `axis`: the index of the point k of the line (a, b) is a.strideA + b.strideB + k.stride
+    // only the lines with a < n are transformed
+    const unsigned long stride = axis == 0 ? m * m : (axis == 1 ? m : 1);
+    const unsigned long strideA = axis == 0 ? m : m * m;
+    const unsigned long strideB = axis == 2 ? m : 1;
+    const unsigned long nB = axis == 2 ? n : m;
+
+    // the lines are transformed by batches of `nLines` consecutive b
+#pragma omp parallel
+    {
+        std::vector<double> re(nLines * m, 0.), im(nLines * m, 0.);
+#pragma omp for schedule(static) collapse(2)
+        for (unsigned long a = 0; a < n; a++)
+            for (unsigned long b0 = 0; b0 < nB; b0 += nLines) {
+                const unsigned long nl = std::min(nLines, nB - b0);
+                std::complex<double> *ptr = data + a * strideA + b0 * strideB;
+                for (unsigned long k = 0; k < m; k++)
+                    for (unsigned long l = 0; l < nl; l++) {
+                        re[k * nLines + l] = ptr[l * strideB + k * stride].real();
+                        im[k * nLines + l] = ptr[l * strideB + k * stride].imag();
+                    }
+                this->transformLines(re.data(), im.data(), inverse);
+                for (unsigned long k = 0; k < m; k++)
+                    for (unsigned long l = 0; l < nl; l++)
+                        ptr[l * strideB + k * stride] = std::complex<double>(re[k * nLines + l], im[k * nLines + l]);
+            }
+    }
+}
+
+void FFT3D::forward(std::complex<double> *data, unsigned long n) const
+{
+    if (n == 0 || n > this->m)
+        n = this->m;
+    // z lines with x, y < n, then y lines with x < n, then all the x lines
+    this->transformAxis(data, 2, n, false);
+    this->transformAxis(data, 1, n, false);
+    this->transformAxis(data, 0, this->m, false);
+}
+
+void FFT3D::backward(std::complex<double> *data, unsigned long n) const
+{
+    if (n == 0 || n > this->m)
+        n = this->m;
+    // all the x lines, then the y lines with x < n, then the z lines with x, y < n
+    this->transformAxis(data, 0, this->m, true);
+    this->transformAxis(data, 1, n, true);
+    this->transformAxis(data, 2, n, true);
+}
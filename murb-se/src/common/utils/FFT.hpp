@@ -0,0 +1,52 @@
+#ifndef FFT_HPP_
+#define FFT_HPP_
+
+#include <complex>
+#include <vector>
+
+/*!
+ * \class  FFT3D
+ * \brief  3D complex FFT on a cubic grid of m x m x m points (m is a power of 2).
+ *
+ * The grid is stored with the z axis contiguous: the point (x, y, z) is at (x.m + y).m + z. The 1D transforms are
+ * computed by batches of `nLines` lines copied with split real and imaginary parts (radix-2 vectorized across the
+ * lines, or FFTW when MUrB is compiled with MURB_FFTW) and the batches are distributed over the OpenMP threads.
+ *
+ * The transforms can be pruned for zero-padded convolutions: the forward transform skips the lines that are null
+ * when only the first `n` points of each dimension are non zero, the inverse transform only computes the first `n`
+ * points of each dimension.
+ */
+class FFT3D {
+  protected:
+    static constexpr unsigned long nLines = 8;  /*!< Number of lines transformed together. */
+    const unsigned long m;                      /*!< Number of points per dimension. */
+    std::vector<std::complex<double>> twiddles; /*!< exp(-2.i.pi.k/m), k < m/2. */
+    std::vector<unsigned long> bitReverse;      /*!< Bit reversal permutation. */
+    void *plan;                                 /*!< FFTW plan of a batch of lines (if available). */
+
+  public:
+    FFT3D(const unsigned long m);
+    virtual ~FFT3D();
+
+    /*!
+     *  \brief Forward transform (exp(-i...)), in place.
+     *
+     *  \param data : The grid.
+     *  \param n    : Only the points with x, y and z < n are non zero (default is m).
+     */
+    void forward(std::complex<double> *data, unsigned long n = 0) const;
+
+    /*!
+     *  \brief Backward transform (exp(+i...), not normalized), in place.
+     *
+     *  \param data : The grid.
+     *  \param n    : Only the points with x, y and z < n are needed (default is m).
+     */
+    void backward(std::complex<double> *data, unsigned long n = 0) const;
+
+  protected:
+    void transformLines(double *re, double *im, const bool inverse) const;
+    void transformAxis(std::complex<double> *data, const int axis, const unsigned long n, const bool inverse) const;
+};
+
+#endif /* FFT_HPP_ */
@@ -0,0 +1,19 @@
+#ifndef MIPP_HPP_
+#define MIPP_HPP_
+
+/*
+ * MIPP, without the false positives of GCC < 13 in its AVX-512 intrinsics: `_mm512_undefined_*` initializes a
+ * register with itself, which is reported as uninitialized in every function where it is inlined (GCC bug 105593).
+ * The warnings are located in the intrinsics headers, they are only disabled there.
+ */
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 13
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <mipp.h>
+#pragma GCC diagnostic pop
+#else
+#include <mipp.h>
+#endif
+
+#endif /* MIPP_HPP_ */
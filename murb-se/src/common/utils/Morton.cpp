@@ -0,0 +1,123 @@
+#include "Morton.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+#include "TaskScheduler.hpp"
+
+/* points per task of the loops submitted to the task scheduler */
+static constexpr unsigned long grainPoints = 4096;
+
+template <typename T>
+void computeMortonKeys(const T *qx, const T *qy, const T *qz, const unsigned long n, std::vector<uint64_t> &keys)
+{
+    keys.resize(n);
+    if (n == 0)
+        return;
+
+    // one bounding box per task: {minX, minY, minZ, maxX, maxY, maxZ}
+    std::vector<std::array<T, 6>> boxes((n + grainPoints - 1) / grainPoints);
+    TaskScheduler::get().parallelFor(0, n, grainPoints, [&](unsigned long begin, unsigned long end) {
+        std::array<T, 6> box = {qx[begin], qy[begin], qz[begin], qx[begin], qy[begin], qz[begin]};
+        for (unsigned long i = begin + 1; i < end; i++) {
+            box[0] = std::min(box[0], qx[i]);
+            box[1] = std::min(box[1], qy[i]);
+            box[2] = std::min(box[2], qz[i]);
+            box[3] = std::max(box[3], qx[i]);
+            box[4] = std::max(box[4], qy[i]);
+            box[5] = std::max(box[5], qz[i]);
+        }
+        boxes[begin / grainPoints] = box;
+    });
+    T minX = boxes[0][0], minY = boxes[0][1], minZ = boxes[0][2];
+    T maxX = boxes[0][3], maxY = boxes[0][4], maxZ = boxes[0][5];
+    for (const std::array<T, 6> &box : boxes) {
+        minX = std::min(minX, box[0]);
+        minY = std::min(minY, box[1]);
+        minZ = std::min(minZ, box[2]);
+        maxX = std::max(maxX, box[3]);
+        maxY = std::max(maxY, box[4]);
+        maxZ = std::max(maxZ, box[5]);
+    }
+
+    // cubic box: the same scale on the 3 axes keeps the Z-order isotropic
+    const T extent = std::max(maxX - minX, std::max(maxY - minY, maxZ - minZ));
+    const double scale = extent > 0 ? (double)((1 << 21) - 1) / (double)extent : 0.;
+
+    TaskScheduler::get().parallelFor(0, n, grainPoints, [&](unsigned long begin, unsigned long end) {
+        for (unsigned long i = begin; i < end; i++) {
+            const uint32_t x = (uint32_t)((double)(qx[i] - minX) * scale);
+            const uint32_t y = (uint32_t)((double)(qy[i] - minY) * scale);
+            const uint32_t z = (uint32_t)((double)(qz[i] - minZ) * scale);
+            keys[i] = mortonEncode(x, y, z);
+        }
+    });
+}
+
+void radixSortPairs(std::vector<uint64_t> &keys, std::vector<unsigned long> &values)
+{
+    assert(keys.size() == values.size());
+    const unsigned long n = keys.size();
+    constexpr int radix = 256;
+    if (n < 2)
+        return;
+
+    std::vector<uint64_t> keysTmp(n);
+    std::vector<unsigned long> valuesTmp(n);
+
+    const unsigned nThreads = TaskScheduler::get().getNumThreads();
+    // the counting and the scattering use the same static chunks so the sort is stable
+    const unsigned long chunk = (n + nThreads - 1) / nThreads;
+    // histograms[t * radix + d]: number of keys of the thread t with the digit d, then its first output position
+    std::vector<unsigned long> histograms(nThreads * radix);
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        std::fill(histograms.begin(), histograms.end(), 0);
+
+        TaskScheduler::get().parallelFor(0, nThreads, 1, [&](unsigned long tBegin, unsigned long tEnd) {
+            for (unsigned long t = tBegin; t < tEnd; t++) {
+                const unsigned long end = std::min(n, (t + 1) * chunk);
+                for (unsigned long i = t * chunk; i < end; i++)
+                    histograms[t * radix + ((keys[i] >> shift) & (radix - 1))]++;
+            }
+        });
+
+        // skip the pass if all the keys have the same digit (nothing would move)
+        const int d0 = (keys[0] >> shift) & (radix - 1);
+        unsigned long count0 = 0;
+        for (unsigned t = 0; t < nThreads; t++)
+            count0 += histograms[t * radix + d0];
+        if (count0 == n)
+            continue;
+
+        unsigned long offset = 0;
+        for (int d = 0; d < radix; d++)
+            for (unsigned t = 0; t < nThreads; t++) {
+                const unsigned long count = histograms[t * radix + d];
+                histograms[t * radix + d] = offset;
+                offset += count;
+            }
+
+        TaskScheduler::get().parallelFor(0, nThreads, 1, [&](unsigned long tBegin, unsigned long tEnd) {
+            for (unsigned long t = tBegin; t < tEnd; t++) {
+                const unsigned long end = std::min(n, (t + 1) * chunk);
+                for (unsigned long i = t * chunk; i < end; i++) {
+                    const unsigned long pos = histograms[t * radix + ((keys[i] >> shift) & (radix - 1))]++;
+                    keysTmp[pos] = keys[i];
+                    valuesTmp[pos] = values[i];
+                }
+            }
+        });
+
+        keys.swap(keysTmp);
+        values.swap(valuesTmp);
+    }
+}
+
+// ==================================================================================== explicit template instantiation
+template void computeMortonKeys<double>(const double *, const double *, const double *, const unsigned long,
+                                        std::vector<uint64_t> &);
+template void computeMortonKeys<float>(const float *, const float *, const float *, const unsigned long,
+                                       std::vector<uint64_t> &);
+// ==================================================================================== explicit template instantiation
@@ -0,0 +1,64 @@
+#ifndef MORTON_HPP_
+#define MORTON_HPP_
+
+#include <cstdint>
+#include <vector>
+
+/*!
+ *  \brief Spread the 21 lower bits of `v` so that there are two zeros between each bit.
+ *
+ *  \param v : Value to spread.
+ *
+ *  \return The spread value (63 bits).
+ */
+inline uint64_t mortonSplit3(uint64_t v)
+{
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffff;
+    v = (v | v << 16) & 0x1f0000ff0000ff;
+    v = (v | v << 8) & 0x100f00f00f00f00f;
+    v = (v | v << 4) & 0x10c30c30c30c30c3;
+    v = (v | v << 2) & 0x1249249249249249;
+    return v;
+}
+
+/*!
+ *  \brief 63-bit Morton (Z-order) key of a 3D point quantized on a 2^21 x 2^21 x 2^21 grid.
+ *
+ *  \param x : Coordinate x in [0, 2^21[.
+ *  \param y : Coordinate y in [0, 2^21[.
+ *  \param z : Coordinate z in [0, 2^21[.
+ *
+ *  \return The Morton key (x is the least significant bit of each triplet).
+ */
+inline uint64_t mortonEncode(const uint32_t x, const uint32_t y, const uint32_t z)
+{
+    return mortonSplit3(x) | (mortonSplit3(y) << 1) | (mortonSplit3(z) << 2);
+}
+
+/*!
+ *  \brief Compute the Morton keys of a set of points in their bounding box.
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  \param qx   : Array of positions x.
+ *  \param qy   : Array of positions y.
+ *  \param qz   : Array of positions z.
+ *  \param n    : Number of points.
+ *  \param keys : Array of keys (resized to `n`).
+ */
+template <typename T>
+void computeMortonKeys(const T *qx, const T *qy, const T *qz, const unsigned long n, std::vector<uint64_t> &keys);
+
+/*!
+ *  \brief Stable parallel LSD radix sort of (key, value) pairs, 8 bits per pass.
+ *
+ *  The passes where all the keys share the same digit are skipped, so sorting 63-bit Morton keys of clustered points
+ *  costs less than 8 passes.
+ *
+ *  \param keys   : Array of keys (sorted on exit).
+ *  \param values : Array of values, permuted like the keys.
+ */
+void radixSortPairs(std::vector<uint64_t> &keys, std::vector<unsigned long> &values);
+
+#endif /* MORTON_HPP_ */
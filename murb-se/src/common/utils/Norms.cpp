@@ -0,0 +1,52 @@
+#include <algorithm>
+#include <limits>
+
+#include "Mipp.hpp"
+#include "Norms.hpp"
+
+static inline void storeNorms(const mipp::Reg<float> &r, float *norms) { r.storeu(norms); }
+
+static inline void storeNorms(const mipp::Reg<double> &r, float *norms)
+{
+    double tmp[mipp::N<double>()];
+    r.storeu(tmp);
+    for (int k = 0; k < mipp::N<double>(); k++)
+        norms[k] = (float)tmp[k];
+}
+
+template <typename T>
+void squaredNorms(const T *x, const T *y, const T *z, const unsigned long n, float *norms, float &min, float &max)
+{
+    constexpr int N = mipp::N<T>();
+    mipp::Reg<T> rMin = std::numeric_limits<T>::infinity();
+    mipp::Reg<T> rMax = -std::numeric_limits<T>::infinity();
+
+    const unsigned long nVec = (n / N) * N;
+    for (unsigned long i = 0; i < nVec; i += N) {
+        const mipp::Reg<T> rx = mipp::loadu(x + i);
+        const mipp::Reg<T> ry = mipp::loadu(y + i);
+        const mipp::Reg<T> rz = mipp::loadu(z + i);
+        const mipp::Reg<T> rNorm = mipp::fmadd(rz, rz, mipp::fmadd(ry, ry, rx * rx));
+        rMin = mipp::min(rMin, rNorm);
+        rMax = mipp::max(rMax, rNorm);
+        storeNorms(rNorm, norms + i);
+    }
+
+    T sMin = mipp::hmin(rMin);
+    T sMax = mipp::hmax(rMax);
+    for (unsigned long i = nVec; i < n; i++) {
+        const T norm = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+        sMin = std::min(sMin, norm);
+        sMax = std::max(sMax, norm);
+        norms[i] = (float)norm;
+    }
+    min = (float)sMin;
+    max = (float)sMax;
+}
+
+// ==================================================================================== explicit template instantiation
+template void squaredNorms<double>(const double *, const double *, const double *, const unsigned long, float *,
+                                   float &, float &);
+template void squaredNorms<float>(const float *, const float *, const float *, const unsigned long, float *, float &,
+                                  float &);
+// ==================================================================================== explicit template instantiation
@@ -0,0 +1,22 @@
+#ifndef NORMS_HPP_
+#define NORMS_HPP_
+
+/*!
+ *  \brief Squared norms of an array of vectors and their range.
+ *
+ *  \tparam T : Floating-point type of the vectors.
+ *
+ *  The norms and the reduction of their minimum and maximum are computed in a single SIMD pass (MIPP).
+ *
+ *  \param x     : Array of components x.
+ *  \param y     : Array of components y.
+ *  \param z     : Array of components z.
+ *  \param n     : Number of vectors.
+ *  \param norms : Array of the `n` squared norms (in fp32, can be a mapped OpenGL buffer).
+ *  \param min   : Smallest squared norm (+infinity if n = 0).
+ *  \param max   : Largest squared norm (-infinity if n = 0).
+ */
+template <typename T>
+void squaredNorms(const T *x, const T *y, const T *z, const unsigned long n, float *norms, float &min, float &max);
+
+#endif /* NORMS_HPP_ */
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "Numa.hpp"
+
+/* the CPUs the process may run on (read before any thread is pinned) */
+static std::vector<unsigned> getProcessCPUs()
+{
+    std::vector<unsigned> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (unsigned c = 0; c < CPU_SETSIZE; c++)
+            if (CPU_ISSET(c, &set))
+                cpus.push_back(c);
+#endif
+    if (cpus.empty())
+        for (unsigned c = 0; c < std::max(std::thread::hardware_concurrency(), 1u); c++)
+            cpus.push_back(c);
+    return cpus;
+}
+
+static std::vector<std::vector<unsigned>> readNodes()
+{
+    const std::vector<unsigned> processCPUs = getProcessCPUs();
+    std::map<unsigned, std::vector<unsigned>> nodes; // sorted by node id
+#ifdef __linux__
+    if (DIR *dir = opendir("/sys/devices/system/node")) {
+        while (dirent *entry = readdir(dir)) {
+            unsigned id;
+            char end;
+            if (std::sscanf(entry->d_name, "node%u%c", &id, &end) != 1)
+                continue;
+            std::ifstream file(std::string("/sys/devices/system/node/") + entry->d_name + "/cpulist");
+            std::string list;
+            std::getline(file, list);
+            std::vector<unsigned> cpus;
+            for (const unsigned c : Numa::parseCPUList(list))
+                if (std::binary_search(processCPUs.begin(), processCPUs.end(), c))
+                    cpus.push_back(c);
+            if (!cpus.empty())
+                nodes[id] = cpus;
+        }
+        closedir(dir);
+    }
+#endif
+    std::vector<std::vector<unsigned>> result;
+    for (const auto &node : nodes)
+        result.push_back(node.second);
+    if (result.empty())
+        result.push_back(processCPUs);
+    return result;
+}
+
+const std::vector<std::vector<unsigned>> &Numa::getNodes()
+{
+    static const std::vector<std::vector<unsigned>> nodes = readNodes();
+    return nodes;
+}
+
+unsigned Numa::getNumCPUs()
+{
+    unsigned nCPUs = 0;
+    for (const std::vector<unsigned> &node : Numa::getNodes())
+        nCPUs += node.size();
+    return nCPUs;
+}
+
+std::vector<unsigned> Numa::parseCPUList(const std::string &list)
+{
+    std::vector<unsigned> cpus;
+    std::istringstream iss(list);
+    std::string range;
+    while (std::getline(iss, range, ',')) {
+        unsigned first, last;
+        const int n = std::sscanf(range.c_str(), "%u-%u", &first, &last);
+        if (n < 1)
+            continue;
+        if (n == 1)
+            last = first;
+        for (unsigned c = first; c <= last; c++)
+            cpus.push_back(c);
+    }
+    std::sort(cpus.begin(), cpus.end());
+    return cpus;
+}
+
+/* `0-3,8` from 0, 1, 2, 3, 8 */
+static std::string toCPUList(const std::vector<unsigned> &cpus)
+{
+    std::string list;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+            j++;
+        list += (list.empty() ? "" : ",") + std::to_string(cpus[i]);
+        if (j > i)
+            list += "-" + std::to_string(cpus[j]);
+        i = j + 1;
+    }
+    return list;
+}
+
+std::string Numa::toString()
+{
+    const std::vector<std::vector<unsigned>> &nodes = Numa::getNodes();
+    std::string str = std::to_string(nodes.size()) + (nodes.size() > 1 ? " nodes (" : " node (");
+    for (size_t n = 0; n < nodes.size(); n++)
+        str += (n ? " | " : "") + toCPUList(nodes[n]);
+    return str + ")";
+}
+
+std::vector<unsigned> Numa::getPlacement(const unsigned nThreads)
+{
+    std::vector<unsigned> cpus;
+    for (const std::vector<unsigned> &node : Numa::getNodes())
+        cpus.insert(cpus.end(), node.begin(), node.end());
+    std::vector<unsigned> placement(nThreads);
+    for (unsigned t = 0; t < nThreads; t++)
+        placement[t] = cpus[(unsigned long)t * cpus.size() / nThreads];
+    return placement;
+}
+
+unsigned Numa::getNodeOfCPU(const unsigned cpu)
+{
+    const std::vector<std::vector<unsigned>> &nodes = Numa::getNodes();
+    for (unsigned n = 0; n < nodes.size(); n++)
+        if (std::binary_search(nodes[n].begin(), nodes[n].end(), cpu))
+            return n;
+    return 0;
+}
+
+bool Numa::pinCurrentThread(const unsigned cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+void Numa::unpinCurrentThread()
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const std::vector<unsigned> &node : Numa::getNodes())
+        for (const unsigned c : node)
+            CPU_SET(c, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+void Numa::releasePages(void *ptr, const size_t bytes)
+{
+#ifdef __linux__
+    const uintptr_t pageSize = sysconf(_SC_PAGESIZE);
+    const uintptr_t begin = ((uintptr_t)ptr + pageSize - 1) / pageSize * pageSize;
+    const uintptr_t end = ((uintptr_t)ptr + bytes) / pageSize * pageSize;
+    if (end > begin)
+        madvise((void *)begin, end - begin, MADV_DONTNEED);
+#endif
+}
@@ -0,0 +1,91 @@
+#ifndef NUMA_HPP_
+#define NUMA_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*!
+ * \class  Numa
+ * \brief  NUMA topology of the host (`/sys/devices/system/node`), restricted to the CPUs the process may run on.
+ *
+ * Without the sysfs entries (other OS, containers), the host is one node with all the CPUs of the process.
+ */
+class Numa {
+  public:
+    /*!
+     *  \brief CPUs of each NUMA node (the nodes without CPU of the process are skipped).
+     *
+     *  \return The CPUs per node, in increasing order.
+     */
+    static const std::vector<std::vector<unsigned>> &getNodes();
+
+    /*!
+     *  \brief Number of CPUs the process may run on (size of its affinity mask, `sched_getaffinity`).
+     *
+     *  \return The number of CPUs of all the nodes.
+     */
+    static unsigned getNumCPUs();
+
+    /*!
+     *  \brief Parse a list of CPUs in the format of the kernel (`0-3,8,10-11`).
+     *
+     *  \param list : The list.
+     *
+     *  \return The CPUs.
+     */
+    static std::vector<unsigned> parseCPUList(const std::string &list);
+
+    /*!
+     *  \brief Topology as a string (for the configuration banner), `2 nodes (0-15 | 16-31)`.
+     *
+     *  \return The topology.
+     */
+    static std::string toString();
+
+    /*!
+     *  \brief Placement of threads: the CPUs of the nodes one after the other, the threads spread over them in order
+     *         (the consecutive threads, which own consecutive ranges of bodies, are on the same node).
+     *
+     *  \param nThreads : Number of threads.
+     *
+     *  \return The CPU of each thread.
+     */
+    static std::vector<unsigned> getPlacement(const unsigned nThreads);
+
+    /*!
+     *  \brief Node of a CPU.
+     *
+     *  \param cpu : The CPU.
+     *
+     *  \return The index of its node in `getNodes()` (0 if it is not a CPU of the process).
+     */
+    static unsigned getNodeOfCPU(const unsigned cpu);
+
+    /*!
+     *  \brief Pin the calling thread on a CPU (Linux only).
+     *
+     *  \param cpu : The CPU.
+     *
+     *  \return True if the thread has been pinned.
+     */
+    static bool pinCurrentThread(const unsigned cpu);
+
+    /*!
+     *  \brief Unpin the calling thread: it may run on all the CPUs of the process.
+     */
+    static void unpinCurrentThread();
+
+    /*!
+     *  \brief Release the physical pages of a zero-filled buffer (Linux only): they are allocated again, zeroed, on
+     *         the node of the next thread that touches them (first-touch policy).
+     *
+     *  Only the pages entirely inside the buffer are released, the content of the buffer is unchanged if it is zero.
+     *
+     *  \param ptr   : The buffer.
+     *  \param bytes : Size of the buffer in bytes.
+     */
+    static void releasePages(void *ptr, const size_t bytes);
+};
+
+#endif /* NUMA_HPP_ */
@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+
+#include "Morton.hpp"
+#include "Octree.hpp"
+
+template <typename T> Octree<T>::Octree(const unsigned long leafSize) : leafSize(leafSize)
+{
+    assert(leafSize > 0);
+}
+
+template <typename T> const std::vector<octreeNode_t> &Octree<T>::getNodes() const { return this->nodes; }
+
+template <typename T> const std::vector<unsigned long> &Octree<T>::getLevelStart() const { return this->levelStart; }
+
+template <typename T> const std::vector<unsigned long> &Octree<T>::getLeaves() const { return this->leaves; }
+
+template <typename T> const std::vector<unsigned long> &Octree<T>::getPermutation() const { return this->perm; }
+
+template <typename T> const std::vector<T> &Octree<T>::getSortedQx() const { return this->sqx; }
+
+template <typename T> const std::vector<T> &Octree<T>::getSortedQy() const { return this->sqy; }
+
+template <typename T> const std::vector<T> &Octree<T>::getSortedQz() const { return this->sqz; }
+
+template <typename T> const std::vector<T> &Octree<T>::getSortedGm() const { return this->sgm; }
+
+template <typename T> float Octree<T>::getAllocatedBytes() const
+{
+    return this->keys.capacity() * sizeof(uint64_t) + this->perm.capacity() * sizeof(unsigned long) +
+           4 * this->sqx.capacity() * sizeof(T) + this->nodes.capacity() * sizeof(octreeNode_t) +
+           (this->levelStart.capacity() + this->leaves.capacity()) * sizeof(unsigned long);
+}
+
+template <typename T> void Octree<T>::build(const T *qx, const T *qy, const T *qz, const T *gm, const unsigned long n)
+{
+    computeMortonKeys<T>(qx, qy, qz, n, this->keys);
+    this->perm.resize(n);
+    std::iota(this->perm.begin(), this->perm.end(), 0);
+    radixSortPairs(this->keys, this->perm);
+
+    this->sqx.resize(n);
+    this->sqy.resize(n);
+    this->sqz.resize(n);
+    this->sgm.resize(n);
+    this->gather(qx, qy, qz, gm);
+    this->buildNodes();
+    this->computeMoments();
+}
+
+template <typename T> void Octree<T>::refit(const T *qx, const T *qy, const T *qz, const T *gm)
+{
+    this->gather(qx, qy, qz, gm);
+    this->computeMoments();
+}
+
+template <typename T> void Octree<T>::gather(const T *qx, const T *qy, const T *qz, const T *gm)
+{
+    const unsigned long n = this->perm.size();
+#pragma omp parallel for schedule(static)
+    for (unsigned long i = 0; i < n; i++) {
+        this->sqx[i] = qx[this->perm[i]];
+        this->sqy[i] = qy[this->perm[i]];
+        this->sqz[i] = qz[this->perm[i]];
+        this->sgm[i] = gm[this->perm[i]];
+    }
+}
+
+template <typename T> void Octree<T>::buildNodes()
+{
+    const unsigned long n = this->keys.size();
+    const uint64_t *keys = this->keys.data();
+
+    octreeNode_t root;
+    root.begin = 0;
+    root.end = n;
+    root.firstChild = 0;
+    root.nChildren = 0;
+    this->nodes.assign(1, root);
+    this->levelStart.assign({0, 1});
+
+    std::vector<unsigned long> offsets;
+    for (int level = 0; level < 21; level++) {
+        const unsigned long first = this->levelStart[level];
+        const unsigned long last = this->levelStart[level + 1];
+        const unsigned long nNodes = last - first;
+        const int shift = 3 * (20 - level);
+        const unsigned long leafSize = this->leafSize;
+
+        // count the children: the keys of a node share the digits above `shift`, so the next digit is sorted
+        offsets.assign(nNodes + 1, 0);
+#pragma omp parallel for schedule(dynamic, 64)
+        for (unsigned long i = 0; i < nNodes; i++) {
+            const octreeNode_t &node = this->nodes[first + i];
+            if (node.end - node.begin <= leafSize)
+                continue;
+            unsigned long count = 0;
+            for (unsigned long b = node.begin; b < node.end; count++) {
+                const uint64_t digit = (keys[b] >> shift) & 7;
+                b = std::partition_point(keys + b, keys + node.end,
+                                         [shift, digit](const uint64_t k) { return ((k >> shift) & 7) == digit; }) -
+                    keys;
+            }
+            offsets[i + 1] = count;
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        const unsigned long nChildren = offsets[nNodes];
+        if (nChildren == 0)
+            break;
+
+        // write the children of the level contiguously
+        this->nodes.resize(last + nChildren);
+#pragma omp parallel for schedule(dynamic, 64)
+        for (unsigned long i = 0; i < nNodes; i++) {
+            octreeNode_t &node = this->nodes[first + i];
+            node.firstChild = last + offsets[i];
+            node.nChildren = offsets[i + 1] - offsets[i];
+            unsigned long c = node.firstChild;
+            for (unsigned long b = node.begin; b < node.end && node.nChildren; c++) {
+                const uint64_t digit = (keys[b] >> shift) & 7;
+                const unsigned long e =
+                    std::partition_point(keys + b, keys + node.end,
+                                         [shift, digit](const uint64_t k) { return ((k >> shift) & 7) == digit; }) -
+                    keys;
+                octreeNode_t &child = this->nodes[c];
+                child.begin = b;
+                child.end = e;
+                child.firstChild = 0;
+                child.nChildren = 0;
+                b = e;
+            }
+        }
+        this->levelStart.push_back(last + nChildren);
+    }
+
+    this->leaves.clear();
+    for (unsigned long i = 0; i < this->nodes.size(); i++)
+        if (this->nodes[i].nChildren == 0)
+            this->leaves.push_back(i);
+}
+
+template <typename T> void Octree<T>::computeLeafMoments(octreeNode_t &node) const
+{
+    double m = 0, cx = 0, cy = 0, cz = 0;
+    for (unsigned long i = node.begin; i < node.end; i++) {
+        m += this->sgm[i];
+        cx += (double)this->sgm[i] * this->sqx[i];
+        cy += (double)this->sgm[i] * this->sqy[i];
+        cz += (double)this->sgm[i] * this->sqz[i];
+    }
+    if (m > 0) {
+        cx /= m;
+        cy /= m;
+        cz /= m;
+    }
+    else if (node.end > node.begin) {
+        cx = this->sqx[node.begin];
+        cy = this->sqy[node.begin];
+        cz = this->sqz[node.begin];
+    }
+
+    double r2 = 0;
+    std::fill(node.q, node.q + 6, 0.);
+    for (unsigned long i = node.begin; i < node.end; i++) {
+        const double dx = this->sqx[i] - cx, dy = this->sqy[i] - cy, dz = this->sqz[i] - cz;
+        r2 = std::max(r2, dx * dx + dy * dy + dz * dz);
+        const double gm = this->sgm[i];
+        node.q[0] += gm * dx * dx;
+        node.q[1] += gm * dx * dy;
+        node.q[2] += gm * dx * dz;
+        node.q[3] += gm * dy * dy;
+        node.q[4] += gm * dy * dz;
+        node.q[5] += gm * dz * dz;
+    }
+
+    node.cx = cx;
+    node.cy = cy;
+    node.cz = cz;
+    node.radius = std::sqrt(r2);
+    node.gm = m;
+}
+
+template <typename T> void Octree<T>::computeNodeMoments(octreeNode_t &node) const
+{
+    double m = 0, cx = 0, cy = 0, cz = 0;
+    for (unsigned char c = 0; c < node.nChildren; c++) {
+        const octreeNode_t &child = this->nodes[node.firstChild + c];
+        m += child.gm;
+        cx += child.gm * child.cx;
+        cy += child.gm * child.cy;
+        cz += child.gm * child.cz;
+    }
+    if (m > 0) {
+        cx /= m;
+        cy /= m;
+        cz /= m;
+    }
+    else {
+        cx = this->nodes[node.firstChild].cx;
+        cy = this->nodes[node.firstChild].cy;
+        cz = this->nodes[node.firstChild].cz;
+    }
+
+    // parallel axis theorem for the quadrupoles
+    double radius = 0;
+    std::fill(node.q, node.q + 6, 0.);
+    for (unsigned char c = 0; c < node.nChildren; c++) {
+        const octreeNode_t &child = this->nodes[node.firstChild + c];
+        const double dx = child.cx - cx, dy = child.cy - cy, dz = child.cz - cz;
+        radius = std::max(radius, std::sqrt(dx * dx + dy * dy + dz * dz) + child.radius);
+        node.q[0] += child.q[0] + child.gm * dx * dx;
+        node.q[1] += child.q[1] + child.gm * dx * dy;
+        node.q[2] += child.q[2] + child.gm * dx * dz;
+        node.q[3] += child.q[3] + child.gm * dy * dy;
+        node.q[4] += child.q[4] + child.gm * dy * dz;
+        node.q[5] += child.q[5] + child.gm * dz * dz;
+    }
+
+    node.cx = cx;
+    node.cy = cy;
+    node.cz = cz;
+    node.radius = radius;
+    node.gm = m;
+}
+
+template <typename T> void Octree<T>::computeMoments()
+{
+    // bottom-up, one level at a time: the children of a node are on the next level
+    for (unsigned long level = this->levelStart.size() - 1; level-- > 0;) {
+        const unsigned long first = this->levelStart[level];
+        const unsigned long last = this->levelStart[level + 1];
+#pragma omp parallel for schedule(dynamic, 64)
+        for (unsigned long i = first; i < last; i++) {
+            octreeNode_t &node = this->nodes[i];
+            if (node.nChildren == 0)
+                this->computeLeafMoments(node);
+            else
+                this->computeNodeMoments(node);
+        }
+    }
+}
+
+// ==================================================================================== explicit template instantiation
+template class Octree<double>;
+template class Octree<float>;
+// ==================================================================================== explicit template instantiation
@@ -0,0 +1,156 @@
+#ifndef OCTREE_HPP_
+#define OCTREE_HPP_
+
+#include <cstdint>
+#include <vector>
+
+/*!
+ * \struct octreeNode_t
+ * \brief  Node of the octree.
+ *
+ * The children of a node are contiguous in the array of nodes and always stored after their parent. The quadrupole
+ * is the second moment of the G.masses around the center of mass: q[0..5] = sum G.m.(dx.dx, dx.dy, dx.dz, dy.dy,
+ * dy.dz, dz.dz).
+ */
+struct octreeNode_t {
+    double cx;                /*!< Center of mass x. */
+    double cy;                /*!< Center of mass y. */
+    double cz;                /*!< Center of mass z. */
+    double radius;            /*!< Upper bound of the distance between the center and the bodies of the node. */
+    double gm;                /*!< Sum of the G.masses of the node. */
+    double q[6];              /*!< Quadrupole moment around the center of mass (xx, xy, xz, yy, yz, zz). */
+    unsigned long begin;      /*!< First body of the node (in the sorted arrays). */
+    unsigned long end;        /*!< Last body of the node + 1 (in the sorted arrays). */
+    unsigned long firstChild; /*!< Index of the first child. */
+    unsigned char nChildren;  /*!< Number of children (0 for a leaf). */
+};
+
+/*!
+ * \struct nodeHot_t
+ * \brief  Packed monopole and quadrupole of a tree node, read as one stream by the node-interaction kernel.
+ *
+ * \tparam T : Floating-point type.
+ *
+ * The quadrupole is stored divided by the mass (its magnitude is the squared size of the node, it would overflow in
+ * fp32 otherwise) and multiplied by 3, and its half trace is precomputed.
+ */
+template <typename T> struct nodeHot_t {
+    T cx, cy, cz; /*!< Center of mass. */
+    T gm;         /*!< Sum of the G.masses. */
+    T q[6];       /*!< 3 / M x quadrupole around the center of mass (xx, xy, xz, yy, yz, zz). */
+    T tq;         /*!< (q[0] + q[3] + q[5]) / 2. */
+};
+
+/*!
+ * \class  Octree
+ * \brief  Parallel octree of a set of bodies, built from their sorted Morton keys.
+ *
+ * \tparam T : Floating-point type of the bodies (the moments are always computed in `double`).
+ *
+ * The octree is the radix tree of the 63-bit Morton keys with 3-bit digits: a node is a range of sorted keys sharing
+ * a prefix, its children are the sub-ranges sharing one more digit (found by binary search). The nodes are built
+ * level by level (breadth-first): the children of all the nodes of a level are counted in parallel, a prefix sum
+ * gives their positions and they are written in parallel, so the nodes of a level are contiguous. A node with at
+ * most `leafSize` bodies is a leaf.
+ *
+ * The centers of mass, the radii and the quadrupoles are computed bottom-up one level at a time, each node only
+ * reads its own bodies or its children: no atomics.
+ *
+ * `refit` keeps the topology and the order of the bodies and only recomputes the moments from the new positions: it
+ * is valid as long as the bodies stay at the same place in memory, and the tree quality slowly degrades as the bodies
+ * move.
+ */
+template <typename T> class Octree {
+  protected:
+    const unsigned long leafSize;          /*!< Maximum number of bodies per leaf. */
+    std::vector<uint64_t> keys;            /*!< Sorted Morton keys. */
+    std::vector<unsigned long> perm;       /*!< Original index of each sorted body. */
+    std::vector<T> sqx, sqy, sqz, sgm;     /*!< Sorted positions and G.masses. */
+    std::vector<octreeNode_t> nodes;       /*!< Nodes in breadth-first order (the root is the first one). */
+    std::vector<unsigned long> levelStart; /*!< First node of each level (+ the number of nodes at the end). */
+    std::vector<unsigned long> leaves;     /*!< Indices of the leaves. */
+
+  public:
+    /*!
+     *  \brief Constructor.
+     *
+     *  \param leafSize : Maximum number of bodies per leaf.
+     */
+    Octree(const unsigned long leafSize = 64);
+    virtual ~Octree() = default;
+
+    /*!
+     *  \brief Build the tree: Morton keys, parallel radix sort, nodes and moments.
+     *
+     *  \param qx : Array of positions x.
+     *  \param qy : Array of positions y.
+     *  \param qz : Array of positions z.
+     *  \param gm : Array of masses multiplied by G.
+     *  \param n  : Number of bodies.
+     */
+    void build(const T *qx, const T *qy, const T *qz, const T *gm, const unsigned long n);
+
+    /*!
+     *  \brief Update the sorted bodies and the moments, keep the topology (same bodies as the last `build`).
+     *
+     *  \param qx : Array of positions x.
+     *  \param qy : Array of positions y.
+     *  \param qz : Array of positions z.
+     *  \param gm : Array of masses multiplied by G.
+     */
+    void refit(const T *qx, const T *qy, const T *qz, const T *gm);
+
+    /*!
+     *  \brief Nodes getter.
+     *
+     *  \return The nodes in breadth-first order, the root is the first one.
+     */
+    const std::vector<octreeNode_t> &getNodes() const;
+
+    /*!
+     *  \brief Levels getter.
+     *
+     *  \return The first node of each level, the last element is the number of nodes.
+     */
+    const std::vector<unsigned long> &getLevelStart() const;
+
+    /*!
+     *  \brief Leaves getter.
+     *
+     *  \return The indices of the leaves.
+     */
+    const std::vector<unsigned long> &getLeaves() const;
+
+    /*!
+     *  \brief Permutation getter.
+     *
+     *  \return The original index of each sorted body.
+     */
+    const std::vector<unsigned long> &getPermutation() const;
+
+    /*!
+     *  \brief Sorted positions and G.masses getters.
+     *
+     *  \return The positions x, y, z and the G.masses of the bodies in the order of the tree.
+     */
+    const std::vector<T> &getSortedQx() const;
+    const std::vector<T> &getSortedQy() const;
+    const std::vector<T> &getSortedQz() const;
+    const std::vector<T> &getSortedGm() const;
+
+    /*!
+     *  \brief Allocated bytes getter.
+     *
+     *  \return The number of bytes allocated by the tree.
+     */
+    float getAllocatedBytes() const;
+
+  protected:
+    void gather(const T *qx, const T *qy, const T *qz, const T *gm);
+    void buildNodes();
+    void computeMoments();
+    void computeLeafMoments(octreeNode_t &node) const;
+    void computeNodeMoments(octreeNode_t &node) const;
+};
+
+#endif /* OCTREE_HPP_ */
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "Orb.hpp"
+
+double orbDistance(const orbDomain_t &d, const double x, const double y, const double z)
+{
+    if (d.min[0] > d.max[0])
+        return std::numeric_limits<double>::infinity();
+    const double dx = std::max(0., std::max(d.min[0] - x, x - d.max[0]));
+    const double dy = std::max(0., std::max(d.min[1] - y, y - d.max[1]));
+    const double dz = std::max(0., std::max(d.min[2] - z, z - d.max[2]));
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+template <typename T>
+orbDomain_t orbBoundingBox(const T *qx, const T *qy, const T *qz, const unsigned long *ids, const unsigned long n)
+{
+    orbDomain_t d;
+    for (int k = 0; k < 3; k++) {
+        d.min[k] = std::numeric_limits<double>::infinity();
+        d.max[k] = -std::numeric_limits<double>::infinity();
+    }
+    for (unsigned long i = 0; i < n; i++) {
+        const unsigned long b = ids ? ids[i] : i;
+        d.min[0] = std::min(d.min[0], (double)qx[b]);
+        d.min[1] = std::min(d.min[1], (double)qy[b]);
+        d.min[2] = std::min(d.min[2], (double)qz[b]);
+        d.max[0] = std::max(d.max[0], (double)qx[b]);
+        d.max[1] = std::max(d.max[1], (double)qy[b]);
+        d.max[2] = std::max(d.max[2], (double)qz[b]);
+    }
+    return d;
+}
+
+/* cut the bodies ids[begin:end] between the domains [partBegin:partEnd] */
+template <typename T>
+static void orbSplit(const T *q[3], const float *weights, std::vector<unsigned long> &ids, const unsigned long begin,
+                     const unsigned long end, const unsigned partBegin, const unsigned partEnd,
+                     std::vector<unsigned long> &offsets, std::vector<orbDomain_t> &domains)
+{
+    const orbDomain_t box = orbBoundingBox<T>(q[0], q[1], q[2], ids.data() + begin, end - begin);
+    if (partEnd - partBegin == 1) {
+        offsets[partBegin] = begin;
+        domains[partBegin] = box;
+        return;
+    }
+
+    int axis = 0;
+    for (int k = 1; k < 3; k++)
+        if (box.max[k] - box.min[k] > box.max[axis] - box.min[axis])
+            axis = k;
+    // the indices break the ties: the decomposition is the same on all the hosts
+    const T *c = q[axis];
+    std::sort(ids.begin() + begin, ids.begin() + end,
+              [c](const unsigned long a, const unsigned long b) { return c[a] < c[b] || (c[a] == c[b] && a < b); });
+
+    const unsigned nLeft = (partEnd - partBegin) / 2;
+    double total = 0.;
+    for (unsigned long i = begin; i < end; i++)
+        total += weights ? weights[ids[i]] : 1.f;
+    const double target = total * nLeft / (partEnd - partBegin);
+
+    // a body goes to the left half if the middle of its weight is before the target
+    unsigned long cut = begin;
+    double prefix = 0.;
+    for (; cut < end; cut++) {
+        const double w = weights ? weights[ids[cut]] : 1.f;
+        if (prefix + 0.5 * w > target)
+            break;
+        prefix += w;
+    }
+    // no empty domain while there are enough bodies
+    if (end - begin >= partEnd - partBegin)
+        cut = std::min(std::max(cut, begin + nLeft), end - (partEnd - partBegin - nLeft));
+
+    orbSplit<T>(q, weights, ids, begin, cut, partBegin, partBegin + nLeft, offsets, domains);
+    orbSplit<T>(q, weights, ids, cut, end, partBegin + nLeft, partEnd, offsets, domains);
+}
+
+template <typename T>
+void orbDecompose(const T *qx, const T *qy, const T *qz, const float *weights, const unsigned long n,
+                  const unsigned nParts, std::vector<unsigned long> &ids, std::vector<unsigned long> &offsets,
+                  std::vector<orbDomain_t> &domains)
+{
+    assert(nParts > 0);
+    ids.resize(n);
+    for (unsigned long i = 0; i < n; i++)
+        ids[i] = i;
+    offsets.resize(nParts + 1);
+    offsets[nParts] = n;
+    domains.resize(nParts);
+
+    const T *q[3] = {qx, qy, qz};
+    orbSplit<T>(q, weights, ids, 0, n, 0, nParts, offsets, domains);
+}
+
+// ==================================================================================== explicit template instantiation
+template orbDomain_t orbBoundingBox<double>(const double *, const double *, const double *, const unsigned long *,
+                                            const unsigned long);
+template orbDomain_t orbBoundingBox<float>(const float *, const float *, const float *, const unsigned long *,
+                                           const unsigned long);
+template void orbDecompose<double>(const double *, const double *, const double *, const float *, const unsigned long,
+                                   const unsigned, std::vector<unsigned long> &, std::vector<unsigned long> &,
+                                   std::vector<orbDomain_t> &);
+template void orbDecompose<float>(const float *, const float *, const float *, const float *, const unsigned long,
+                                  const unsigned, std::vector<unsigned long> &, std::vector<unsigned long> &,
+                                  std::vector<orbDomain_t> &);
+// ==================================================================================== explicit template instantiation
@@ -0,0 +1,68 @@
+#ifndef ORB_HPP_
+#define ORB_HPP_
+
+#include <vector>
+
+/*!
+ * \struct orbDomain_t
+ * \brief  Bounding box of the bodies of a domain (min > max if the domain is empty).
+ */
+struct orbDomain_t {
+    double min[3]; /*!< Lower corner (x, y, z). */
+    double max[3]; /*!< Upper corner (x, y, z). */
+};
+
+/*!
+ *  \brief Distance between a point and a domain.
+ *
+ *  \param d : Domain.
+ *  \param x : Coordinate x of the point.
+ *  \param y : Coordinate y of the point.
+ *  \param z : Coordinate z of the point.
+ *
+ *  \return The distance between the point and the box of the domain (0 inside), infinite if the domain is empty.
+ */
+double orbDistance(const orbDomain_t &d, const double x, const double y, const double z);
+
+/*!
+ *  \brief Orthogonal recursive bisection of a set of weighted bodies.
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  The bodies are cut in two along the longest axis of their bounding box, at the position where the weights of the
+ *  two halves are proportional to their number of parts, then each half is cut again until there is one part per
+ *  domain. With the measured costs of the bodies as weights, the domains have the same work whatever the clustering
+ *  of the bodies.
+ *
+ *  \param qx      : Array of positions x.
+ *  \param qy      : Array of positions y.
+ *  \param qz      : Array of positions z.
+ *  \param weights : Array of weights (nullptr for the same weight for all the bodies).
+ *  \param n       : Number of bodies.
+ *  \param nParts  : Number of domains.
+ *  \param ids     : Indices of the bodies grouped by domain (resized to `n`).
+ *  \param offsets : First body of each domain in `ids`, the last element is `n` (resized to `nParts + 1`).
+ *  \param domains : Bounding box of each domain (resized to `nParts`).
+ */
+template <typename T>
+void orbDecompose(const T *qx, const T *qy, const T *qz, const float *weights, const unsigned long n,
+                  const unsigned nParts, std::vector<unsigned long> &ids, std::vector<unsigned long> &offsets,
+                  std::vector<orbDomain_t> &domains);
+
+/*!
+ *  \brief Bounding box of a set of bodies.
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  \param qx  : Array of positions x.
+ *  \param qy  : Array of positions y.
+ *  \param qz  : Array of positions z.
+ *  \param ids : Indices of the bodies (nullptr for the bodies 0 to n - 1).
+ *  \param n   : Number of bodies.
+ *
+ *  \return The bounding box.
+ */
+template <typename T>
+orbDomain_t orbBoundingBox(const T *qx, const T *qy, const T *qz, const unsigned long *ids, const unsigned long n);
+
+#endif /* ORB_HPP_ */
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <cassert>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Numa.hpp"
+#include "TaskScheduler.hpp"
+
+/* the current thread is a worker or executes a `parallelFor`: the nested loops are executed inline */
+static thread_local bool inParallelFor = false;
+/* id of the current thread in its scheduler (0 for the callers) */
+static thread_local unsigned threadId = 0;
+
+TaskScheduler &TaskScheduler::get()
+{
+    static TaskScheduler scheduler(TaskScheduler::getDefaultNumThreads());
+    return scheduler;
+}
+
+unsigned TaskScheduler::getDefaultNumThreads()
+{
+#ifdef _OPENMP
+    return std::max(omp_get_max_threads(), 1);
+#else
+    return std::max(std::thread::hardware_concurrency(), 1u);
+#endif
+}
+
+TaskScheduler::TaskScheduler(const unsigned nThreads) : stop(false), nSleeping(0), epoch(0), pinned(false)
+{
+    this->startWorkers(nThreads);
+}
+
+TaskScheduler::~TaskScheduler() { this->stopWorkers(); }
+
+unsigned TaskScheduler::getNumThreads() const { return this->deques.size(); }
+
+void TaskScheduler::setNumThreads(const unsigned nThreads)
+{
+    if (nThreads == this->getNumThreads())
+        return;
+    std::lock_guard<std::mutex> lock(this->callerMutex);
+    this->stopWorkers();
+    this->startWorkers(nThreads);
+}
+
+void TaskScheduler::setPinning(const bool pinned)
+{
+    if (pinned == this->pinned)
+        return;
+    std::lock_guard<std::mutex> lock(this->callerMutex);
+    const unsigned nThreads = this->getNumThreads();
+    this->stopWorkers();
+    this->pinned = pinned;
+    this->startWorkers(nThreads);
+}
+
+bool TaskScheduler::isPinned() const { return this->pinned; }
+
+unsigned TaskScheduler::getThreadNode(const unsigned id) const
+{
+    return this->pinned ? Numa::getNodeOfCPU(this->cpus[id]) : 0;
+}
+
+unsigned TaskScheduler::getThreadId() { return threadId; }
+
+void TaskScheduler::startWorkers(const unsigned nThreads)
+{
+    assert(nThreads > 0);
+    this->stop = false;
+    if (this->pinned) {
+#ifdef _OPENMP
+        // the OpenMP team is created before any thread is pinned: its threads keep the mask of the process
+#pragma omp parallel
+        {
+        }
+#endif
+        this->cpus = Numa::getPlacement(nThreads);
+    }
+    else
+        this->cpus.clear();
+    this->deques.clear();
+    for (unsigned t = 0; t < nThreads; t++)
+        this->deques.push_back(std::unique_ptr<deque_t>(new deque_t()));
+    for (unsigned t = 1; t < nThreads; t++)
+        this->workers.push_back(std::thread(&TaskScheduler::workerLoop, this, t));
+}
+
+void TaskScheduler::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->sleepMutex);
+        this->stop = true;
+        this->epoch++;
+    }
+    this->wakeUp.notify_all();
+    for (std::thread &w : this->workers)
+        w.join();
+    this->workers.clear();
+}
+
+void TaskScheduler::push(const unsigned id, const task_t &task)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->deques[id]->mutex);
+        this->deques[id]->tasks.push_back(task);
+    }
+    // a worker going to sleep checks the deques after incrementing `nSleeping`: the task is not missed
+    if (this->nSleeping > 0) {
+        {
+            std::lock_guard<std::mutex> lock(this->sleepMutex);
+            this->epoch++;
+        }
+        this->wakeUp.notify_all();
+    }
+}
+
+bool TaskScheduler::findTask(const unsigned id, task_t &task)
+{
+    // the last pushed task of the own deque (the most local one)
+    {
+        deque_t &own = *this->deques[id];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    // else the oldest (largest) task of another deque
+    const unsigned nDeques = this->deques.size();
+    for (unsigned k = 1; k < nDeques; k++) {
+        deque_t &victim = *this->deques[(id + k) % nDeques];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::execute(const unsigned id, task_t task)
+{
+    job_t &job = *task.job;
+    while (task.begin < task.end) {
+        const unsigned long nChunks = (task.end - task.begin + job.grain - 1) / job.grain;
+        bool hungry = false;
+        if (nChunks > 1) {
+            std::lock_guard<std::mutex> lock(this->deques[id]->mutex);
+            hungry = this->deques[id]->tasks.empty();
+        }
+        if (hungry) {
+            // lazy splitting: the second half is exposed to the thieves
+            const unsigned long mid = task.begin + (nChunks / 2) * job.grain;
+            this->push(id, task_t{&job, mid, task.end});
+            task.end = mid;
+            continue;
+        }
+        const unsigned long end = std::min(task.begin + job.grain, task.end);
+        (*job.body)(task.begin, end);
+        job.remaining -= end - task.begin;
+        task.begin = end;
+    }
+}
+
+void TaskScheduler::workerLoop(const unsigned id)
+{
+    inParallelFor = true;
+    threadId = id;
+    if (this->pinned)
+        Numa::pinCurrentThread(this->cpus[id]);
+    unsigned spins = 0;
+    while (!this->stop) {
+        task_t task;
+        if (this->findTask(id, task)) {
+            this->execute(id, task);
+            spins = 0;
+        }
+        else if (++spins < 256)
+            std::this_thread::yield();
+        else {
+            std::unique_lock<std::mutex> lock(this->sleepMutex);
+            this->nSleeping++;
+            const unsigned long e = this->epoch;
+            if (this->findTask(id, task)) {
+                this->nSleeping--;
+                lock.unlock();
+                this->execute(id, task);
+            }
+            else {
+                this->wakeUp.wait(lock, [this, e]() { return this->stop || this->epoch != e; });
+                this->nSleeping--;
+            }
+            spins = 0;
+        }
+    }
+}
+
+bool TaskScheduler::runInline(const unsigned long begin, const unsigned long end, const unsigned long grain,
+                              const std::function<void(unsigned long, unsigned long)> &body)
+{
+    bool nested = inParallelFor;
+#ifdef _OPENMP
+    nested = nested || omp_in_parallel();
+#endif
+    if (end - begin > grain && this->getNumThreads() > 1 && !nested)
+        return false;
+    for (unsigned long b = begin; b < end; b += grain)
+        body(b, std::min(b + grain, end));
+    return true;
+}
+
+void TaskScheduler::wait(job_t &job)
+{
+    // help the workers until the end of the loop
+    while (job.remaining > 0) {
+        task_t task;
+        if (this->findTask(0, task))
+            this->execute(0, task);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void TaskScheduler::parallelFor(const unsigned long begin, const unsigned long end, const unsigned long grain,
+                                const std::function<void(unsigned long, unsigned long)> &body)
+{
+    assert(grain > 0);
+    if (begin >= end || this->runInline(begin, end, grain, body))
+        return;
+
+    std::lock_guard<std::mutex> lock(this->callerMutex);
+    inParallelFor = true;
+    // the caller is pinned only during the loop
+    if (this->pinned)
+        Numa::pinCurrentThread(this->cpus[0]);
+    job_t job;
+    job.body = &body;
+    job.begin = begin;
+    job.grain = grain;
+    job.remaining = end - begin;
+    this->execute(0, task_t{&job, begin, end});
+    this->wait(job);
+    if (this->pinned)
+        Numa::unpinCurrentThread();
+    inParallelFor = false;
+}
+
+void TaskScheduler::parallelForAffinity(const unsigned long begin, const unsigned long end, const unsigned long grain,
+                                        const std::function<void(unsigned long, unsigned long)> &body)
+{
+    assert(grain > 0);
+    if (begin >= end || this->runInline(begin, end, grain, body))
+        return;
+
+    std::lock_guard<std::mutex> lock(this->callerMutex);
+    inParallelFor = true;
+    // the caller is pinned only during the loop (it works on the part of the thread 0)
+    if (this->pinned)
+        Numa::pinCurrentThread(this->cpus[0]);
+    job_t job;
+    job.body = &body;
+    job.begin = begin;
+    job.grain = grain;
+    job.remaining = end - begin;
+    const unsigned nThreads = this->getNumThreads();
+    const unsigned long nChunks = (end - begin + grain - 1) / grain;
+    auto partBegin = [&](const unsigned t) { return std::min(end, begin + (t * nChunks / nThreads) * grain); };
+    for (unsigned t = nThreads - 1; t > 0; t--)
+        if (partBegin(t) < partBegin(t + 1))
+            this->push(t, task_t{&job, partBegin(t), partBegin(t + 1)});
+    this->execute(0, task_t{&job, begin, partBegin(1)});
+    this->wait(job);
+    if (this->pinned)
+        Numa::unpinCurrentThread();
+    inParallelFor = false;
+}
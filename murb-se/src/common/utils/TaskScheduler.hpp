@@ -0,0 +1,170 @@
+#ifndef TASK_SCHEDULER_HPP_
+#define TASK_SCHEDULER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+ * \class  TaskScheduler
+ * \brief  Persistent pool of threads with one deque of tasks per thread and work stealing.
+ *
+ * A `parallelFor` is one task (a range of iterations) pushed in the deque of the caller, which takes part in the
+ * computation. The ranges are split lazily: the owner of a range executes it `grain` iterations at a time from the
+ * front and, each time its deque is empty (its previous halves have been stolen or done), it exposes the second half
+ * of what remains. The idle threads steal the oldest (largest) tasks of the other deques, then spin for a short time
+ * and sleep. A range smaller than `grain`, a pool of one thread and the nested calls (from a task or from an OpenMP
+ * parallel region) are executed inline by the caller, without synchronization.
+ */
+class TaskScheduler {
+  protected:
+    struct job_t {
+        const std::function<void(unsigned long, unsigned long)> *body; /*!< Body of the loop. */
+        unsigned long begin;                                          /*!< First iteration of the loop. */
+        unsigned long grain;                                          /*!< Iterations per call of the body. */
+        std::atomic<unsigned long> remaining;                         /*!< Iterations not done. */
+    };
+
+    struct task_t {
+        job_t *job;          /*!< Loop of the task. */
+        unsigned long begin; /*!< First iteration of the task. */
+        unsigned long end;   /*!< Last iteration of the task + 1. */
+    };
+
+    struct deque_t {
+        std::mutex mutex;         /*!< Protection of the tasks. */
+        std::deque<task_t> tasks; /*!< Tasks: the owner pushes and pops at the back, the thieves steal at the front. */
+    };
+
+    std::vector<std::unique_ptr<deque_t>> deques; /*!< Deques of the caller (0) and of the workers. */
+    std::vector<std::thread> workers;             /*!< Persistent threads. */
+    std::atomic<bool> stop;                       /*!< Stop the workers. */
+    std::atomic<unsigned> nSleeping;              /*!< Number of sleeping workers. */
+    unsigned long epoch;                          /*!< Incremented to wake up the workers (`sleepMutex`). */
+    std::mutex sleepMutex;                        /*!< Protection of `epoch`. */
+    std::condition_variable wakeUp;               /*!< Sleep of the idle workers. */
+    std::mutex callerMutex;                       /*!< One caller at a time (deque 0). */
+    bool pinned;                                  /*!< The threads are pinned on the CPUs of `Numa::getPlacement`. */
+    std::vector<unsigned> cpus;                   /*!< CPU of each thread (if `pinned`). */
+
+  public:
+    /*!
+     *  \brief Shared scheduler of the process, created on first use with `getDefaultNumThreads()` threads.
+     *
+     *  \return The scheduler.
+     */
+    static TaskScheduler &get();
+
+    /*!
+     *  \brief Default number of threads: the number of OpenMP threads, or of hardware threads without OpenMP.
+     *
+     *  \return The number of threads.
+     */
+    static unsigned getDefaultNumThreads();
+
+    /*!
+     *  \brief Constructor.
+     *
+     *  \param nThreads : Number of threads, including the caller of `parallelFor` (`nThreads - 1` workers).
+     */
+    explicit TaskScheduler(const unsigned nThreads);
+
+    /*!
+     *  \brief Destructor: stop and join the workers.
+     */
+    ~TaskScheduler();
+
+    /*!
+     *  \brief Number of threads getter.
+     *
+     *  \return The number of threads, including the caller of `parallelFor`.
+     */
+    unsigned getNumThreads() const;
+
+    /*!
+     *  \brief Restart the workers with another number of threads (not during a `parallelFor`).
+     *
+     *  \param nThreads : Number of threads, including the caller of `parallelFor`.
+     */
+    void setNumThreads(const unsigned nThreads);
+
+    /*!
+     *  \brief Execute a loop in parallel and wait for it.
+     *
+     *  The body is called on chunks of at most `grain` iterations that start at `begin + k * grain`: a per-chunk
+     *  result indexed by `(b - begin) / grain` does not depend on the scheduling.
+     *
+     *  \param begin : First iteration.
+     *  \param end   : Last iteration + 1.
+     *  \param grain : Number of iterations per call of the body (the granularity of the stealing).
+     *  \param body  : Body of the loop, called with the range of iterations `[b, e[`.
+     */
+    void parallelFor(const unsigned long begin, const unsigned long end, const unsigned long grain,
+                     const std::function<void(unsigned long, unsigned long)> &body);
+
+    /*!
+     *  \brief Execute a loop in parallel with a static affinity and wait for it.
+     *
+     *  The chunks of `grain` iterations are divided into `getNumThreads()` contiguous parts and the part `t` is pushed
+     *  in the deque of the thread `t`: the same thread works on the same part of the data from one loop to the next
+     *  (first-touch placement on the NUMA nodes), the idle threads still steal the chunks of the late ones.
+     *
+     *  \param begin : First iteration.
+     *  \param end   : Last iteration + 1.
+     *  \param grain : Number of iterations per call of the body (the granularity of the stealing).
+     *  \param body  : Body of the loop, called with the range of iterations `[b, e[`.
+     */
+    void parallelForAffinity(const unsigned long begin, const unsigned long end, const unsigned long grain,
+                             const std::function<void(unsigned long, unsigned long)> &body);
+
+    /*!
+     *  \brief Pin the threads on the CPUs of `Numa::getPlacement`, or unpin them.
+     *
+     *  The workers stay pinned. The caller of a `parallelFor` (the thread 0) is only pinned during the loop: the
+     *  threads it creates between the loops (OpenMP team, render and writer threads...) inherit its unpinned mask.
+     *
+     *  \param pinned : Pin or unpin.
+     */
+    void setPinning(const bool pinned);
+
+    /*!
+     *  \brief Threads pinning getter.
+     *
+     *  \return True if the threads are pinned.
+     */
+    bool isPinned() const;
+
+    /*!
+     *  \brief NUMA node of a thread.
+     *
+     *  \param id : Thread id (see `getThreadId`).
+     *
+     *  \return The index of the node in `Numa::getNodes()`, 0 if the threads are not pinned.
+     */
+    unsigned getThreadNode(const unsigned id) const;
+
+    /*!
+     *  \brief Id of the calling thread in its scheduler.
+     *
+     *  \return The id of the worker, 0 for the other threads (the caller of `parallelFor`).
+     */
+    static unsigned getThreadId();
+
+  protected:
+    void startWorkers(const unsigned nThreads);
+    void stopWorkers();
+    void workerLoop(const unsigned id);
+    bool findTask(const unsigned id, task_t &task);
+    void push(const unsigned id, const task_t &task);
+    void execute(const unsigned id, task_t task);
+    bool runInline(const unsigned long begin, const unsigned long end, const unsigned long grain,
+                   const std::function<void(unsigned long, unsigned long)> &body);
+    void wait(job_t &job);
+};
+
+#endif /* TASK_SCHEDULER_HPP_ */
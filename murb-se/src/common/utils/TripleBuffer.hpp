@@ -0,0 +1,61 @@
+#ifndef TRIPLE_BUFFER_HPP_
+#define TRIPLE_BUFFER_HPP_
+
+#include <atomic>
+
+/*!
+ * \class  TripleBuffer
+ * \brief  Lock-free triple buffer between one producer thread and one consumer thread.
+ *
+ * \tparam S : Type of a slot.
+ *
+ * The producer writes the back slot and publishes it, the consumer reads the front slot and takes the newest
+ * published one. The third slot (the middle one) is exchanged atomically with the back slot by `publish` and with the
+ * front slot by `consume`: the producer never waits for the consumer, the consumer never reads a slot being written
+ * and the slots published between two `consume` are skipped.
+ */
+template <typename S> class TripleBuffer {
+  protected:
+    static constexpr unsigned fresh = 4; /*!< Flag of `middle`: the middle slot has not been consumed. */
+    S slots[3];                          /*!< Back, middle and front slots. */
+    std::atomic<unsigned> middle;        /*!< Index of the middle slot | `fresh`. */
+    unsigned back;                       /*!< Index of the back slot (producer). */
+    unsigned front;                      /*!< Index of the front slot (consumer). */
+
+  public:
+    TripleBuffer() : middle(1), back(0), front(2) {}
+
+    /*!
+     *  \brief Slot written by the producer.
+     *
+     *  \return The back slot.
+     */
+    S &getBack() { return this->slots[this->back]; }
+
+    /*!
+     *  \brief Publish the back slot (producer), the producer gets another slot to write.
+     */
+    void publish() { this->back = this->middle.exchange(this->back | fresh, std::memory_order_acq_rel) & ~fresh; }
+
+    /*!
+     *  \brief Take the last published slot as the front slot (consumer).
+     *
+     *  \return True if a slot has been published since the last call, false if the front slot is unchanged.
+     */
+    bool consume()
+    {
+        if (!(this->middle.load(std::memory_order_relaxed) & fresh))
+            return false;
+        this->front = this->middle.exchange(this->front, std::memory_order_acq_rel) & ~fresh;
+        return true;
+    }
+
+    /*!
+     *  \brief Slot read by the consumer.
+     *
+     *  \return The front slot.
+     */
+    const S &getFront() const { return this->slots[this->front]; }
+};
+
+#endif /* TRIPLE_BUFFER_HPP_ */
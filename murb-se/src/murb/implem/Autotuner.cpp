@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "utils/Numa.hpp"
+#include "utils/TaskScheduler.hpp"
+
+#include "Autotuner.hpp"
+
+std::string Autotuner::getCPUModel()
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line))
+        if (line.compare(0, 10, "model name") == 0 && line.find(':') != std::string::npos) {
+            std::string model = line.substr(line.find(':') + 1);
+            model.erase(0, model.find_first_not_of(" \t"));
+            if (!model.empty())
+                return model;
+        }
+    return "unknown";
+}
+
+std::string Autotuner::getCachePath()
+{
+    if (const char *path = std::getenv("MURB_AUTOTUNE_CACHE"))
+        return path;
+    std::string dir;
+    if (const char *xdg = std::getenv("XDG_CACHE_HOME"))
+        dir = xdg;
+    else if (const char *home = std::getenv("HOME")) {
+        dir = std::string(home) + "/.cache";
+        mkdir(dir.c_str(), 0755); // the first run on the host
+    }
+    return dir.empty() ? "murb-autotune.txt" : dir + "/murb-autotune.txt";
+}
+
+std::vector<std::string> Autotuner::getCandidates(const std::string &knob)
+{
+    std::vector<std::string> values;
+    if (knob == "threads") {
+        const unsigned long nCPUs = Numa::getNumCPUs();
+        for (unsigned long t = 1; t < nCPUs; t *= 2)
+            values.push_back(std::to_string(t));
+        values.push_back(std::to_string(nCPUs));
+    }
+    else if (knob == "tile") {
+        for (unsigned long t = 64; t <= 4096; t *= 2)
+            values.push_back(std::to_string(t));
+    }
+    else if (knob == "leaf") {
+        for (unsigned long l = 8; l <= 128; l *= 2)
+            values.push_back(std::to_string(l));
+    }
+    else if (knob == "schedule") {
+        values.push_back("static");
+        values.push_back("dynamic");
+    }
+    return values;
+}
+
+void Autotuner::setKnob(implemParams_t &params, const std::string &knob, const std::string &value)
+{
+    if (knob == "threads")
+        params.threads = std::stoul(value);
+    else if (knob == "tile")
+        params.tileSize = std::stoul(value);
+    else if (knob == "leaf")
+        params.leafSize = std::stoul(value);
+    else if (knob == "schedule")
+        params.schedule = value;
+    else {
+        std::cout << "Knob '" << knob << "' does not exist... exiting." << std::endl;
+        exit(-1);
+    }
+}
+
+std::string Autotuner::getKnob(const implemParams_t &params, const std::string &knob)
+{
+    if (knob == "threads")
+        return std::to_string(params.threads);
+    else if (knob == "tile")
+        return std::to_string(params.tileSize);
+    else if (knob == "leaf")
+        return std::to_string(params.leafSize);
+    else if (knob == "schedule")
+        return params.schedule;
+    std::cout << "Knob '" << knob << "' does not exist... exiting." << std::endl;
+    exit(-1);
+}
+
+std::string Autotuner::toString(const std::string &tag, const implemParams_t &params)
+{
+    const implemInfo_t *implem = ImplemRegistry::find(tag);
+    std::string str;
+    if (implem != nullptr)
+        for (const std::string &knob : implem->caps.knobs)
+            str += (str.empty() ? "" : ", ") + knob + "=" + Autotuner::getKnob(params, knob);
+    return str;
+}
+
+/* key of the cache: implementation, precision, number of bodies rounded to a power of 2 and number of CPUs available
+ * to the process (the best number of threads depends on it, the CPU model is the end of the line, it contains
+ * spaces) */
+static std::string getKey(const std::string &tag, const std::string &precision, const unsigned long n)
+{
+    const unsigned long nRounded = 1ul << (unsigned long)std::lround(std::log2((double)std::max(n, 1ul)));
+    return tag + " " + precision + " " + std::to_string(nRounded) + " " + std::to_string(Numa::getNumCPUs());
+}
+
+/* a line of the cache: key, knobs (`knob=value`, `;` separated) and CPU model */
+static bool parseLine(const std::string &line, std::string &key, std::string &knobs, std::string &cpu)
+{
+    std::istringstream iss(line);
+    std::string tag, precision, n, nCPUs;
+    if (!(iss >> tag >> precision >> n >> nCPUs >> knobs))
+        return false;
+    key = tag + " " + precision + " " + n + " " + nCPUs;
+    std::getline(iss, cpu);
+    cpu.erase(0, cpu.find_first_not_of(" \t"));
+    return true;
+}
+
+bool Autotuner::load(const std::string &tag, const std::string &precision, implemParams_t &params)
+{
+    const std::string key = getKey(tag, precision, params.nBodies);
+    const std::string cpuModel = Autotuner::getCPUModel();
+    std::ifstream cache(Autotuner::getCachePath());
+    std::string line, lineKey, knobs, cpu;
+    while (std::getline(cache, line)) {
+        if (!parseLine(line, lineKey, knobs, cpu) || lineKey != key || cpu != cpuModel)
+            continue;
+        std::istringstream iss(knobs);
+        std::string knob;
+        while (std::getline(iss, knob, ';')) {
+            const size_t eq = knob.find('=');
+            if (eq != std::string::npos)
+                Autotuner::setKnob(params, knob.substr(0, eq), knob.substr(eq + 1));
+        }
+        return true;
+    }
+    return false;
+}
+
+/* replace the entry of the host in the cache file (the entries of the other hosts are kept) */
+static void save(const std::string &tag, const std::string &precision, const implemParams_t &params)
+{
+    const std::string key = getKey(tag, precision, params.nBodies);
+    const std::string cpuModel = Autotuner::getCPUModel();
+    const std::string path = Autotuner::getCachePath();
+
+    std::vector<std::string> lines;
+    std::ifstream in(path);
+    std::string line, lineKey, knobs, cpu;
+    while (std::getline(in, line))
+        if (parseLine(line, lineKey, knobs, cpu) && !(lineKey == key && cpu == cpuModel))
+            lines.push_back(line);
+    in.close();
+
+    knobs.clear();
+    for (const std::string &knob : ImplemRegistry::find(tag)->caps.knobs)
+        knobs += (knobs.empty() ? "" : ";") + knob + "=" + Autotuner::getKnob(params, knob);
+    lines.push_back(key + " " + knobs + " " + cpuModel);
+
+    std::ofstream out(path);
+    if (!out) {
+        std::cout << "The autotuning cache '" << path << "' can not be written." << std::endl;
+        return;
+    }
+    for (const std::string &l : lines)
+        out << l << std::endl;
+}
+
+float Autotuner::tune(const std::string &tag, const std::string &precision, implemParams_t &params,
+                      const bool verbose, const unsigned long maxBodies)
+{
+    const implemInfo_t *implem = ImplemRegistry::find(tag);
+    if (implem == nullptr)
+        return -1.f;
+
+    implemParams_t trial = params;
+    trial.nBodies = std::min(params.nBodies, maxBodies);
+    // the trials change the number of threads of the process: start from the current one
+    if (!trial.threads && std::find(implem->caps.knobs.begin(), implem->caps.knobs.end(), "threads") !=
+                              implem->caps.knobs.end())
+        trial.threads = TaskScheduler::get().getNumThreads();
+    float bestTime = ImplemRegistry::measure(tag, precision, trial);
+    if (bestTime < 0.f)
+        return -1.f;
+    if (verbose)
+        std::cout << "Autotuning of " << tag << " (" << precision << ", " << trial.nBodies << " bodies):" << std::endl
+                  << "  -> " << std::left << std::setw(40) << Autotuner::toString(tag, trial) << std::right << ": "
+                  << std::fixed << std::setprecision(3) << bestTime << " ms/ite." << std::defaultfloat << std::endl;
+
+    for (const std::string &knob : implem->caps.knobs) {
+        std::string bestValue = Autotuner::getKnob(trial, knob);
+        for (const std::string &value : Autotuner::getCandidates(knob)) {
+            if (value == bestValue)
+                continue;
+            Autotuner::setKnob(trial, knob, value);
+            const float time = ImplemRegistry::measure(tag, precision, trial);
+            if (verbose)
+                std::cout << "  -> " << std::left << std::setw(40) << Autotuner::toString(tag, trial) << std::right
+                          << ": " << std::fixed << std::setprecision(3) << time << " ms/ite." << std::defaultfloat
+                          << std::endl;
+            if (time < bestTime) {
+                bestTime = time;
+                bestValue = value;
+            }
+        }
+        Autotuner::setKnob(trial, knob, bestValue);
+    }
+
+    for (const std::string &knob : implem->caps.knobs)
+        Autotuner::setKnob(params, knob, Autotuner::getKnob(trial, knob));
+    if (!implem->caps.knobs.empty())
+        save(tag, precision, params);
+    return bestTime;
+}
@@ -0,0 +1,100 @@
+#ifndef AUTOTUNER_HPP_
+#define AUTOTUNER_HPP_
+
+#include <string>
+#include <vector>
+
+#include "ImplemRegistry.hpp"
+
+/*!
+ * \class  Autotuner
+ * \brief  Search of the knobs of an implementation (`implemCaps_t::knobs`) with short timed runs, the winners are
+ *         saved in a cache file, per CPU model, number of CPUs available to the process, implementation, precision and
+ *         number of bodies (rounded to a power of 2).
+ *
+ * The cache file is `$MURB_AUTOTUNE_CACHE`, or `murb-autotune.txt` in `$XDG_CACHE_HOME` or `$HOME/.cache`.
+ */
+class Autotuner {
+  public:
+    /*!
+     *  \brief CPU model of the host (`model name` of `/proc/cpuinfo`).
+     *
+     *  \return The CPU model, or `unknown`.
+     */
+    static std::string getCPUModel();
+
+    /*!
+     *  \brief Path of the cache file.
+     *
+     *  \return The path.
+     */
+    static std::string getCachePath();
+
+    /*!
+     *  \brief Candidate values of a knob.
+     *
+     *  \param knob : `threads` (powers of 2 up to the number of CPUs available to the process), `tile`, `leaf` or
+     *               `schedule`.
+     *
+     *  \return The values, in the format of `setKnob`.
+     */
+    static std::vector<std::string> getCandidates(const std::string &knob);
+
+    /*!
+     *  \brief Set a knob of the parameters of an implementation.
+     *
+     *  \param params : Parameters of the implementation.
+     *  \param knob   : `threads`, `tile`, `leaf` or `schedule`.
+     *  \param value  : Value of the knob.
+     */
+    static void setKnob(implemParams_t &params, const std::string &knob, const std::string &value);
+
+    /*!
+     *  \brief Get a knob of the parameters of an implementation.
+     *
+     *  \param params : Parameters of the implementation.
+     *  \param knob   : `threads`, `tile`, `leaf` or `schedule`.
+     *
+     *  \return Value of the knob.
+     */
+    static std::string getKnob(const implemParams_t &params, const std::string &knob);
+
+    /*!
+     *  \brief Knobs of an implementation as a string (for the configuration banner).
+     *
+     *  \param tag    : Implementation tag.
+     *  \param params : Parameters of the implementation.
+     *
+     *  \return `knob=value` separated by commas (empty if the implementation has no knob).
+     */
+    static std::string toString(const std::string &tag, const implemParams_t &params);
+
+    /*!
+     *  \brief Load the knobs of an implementation from the cache file.
+     *
+     *  \param tag       : Implementation tag.
+     *  \param precision : `fp32`, `fp64` or `mixed`.
+     *  \param params    : Parameters of the implementation, the knobs are updated if they are in the cache.
+     *
+     *  \return True if the knobs are in the cache.
+     */
+    static bool load(const std::string &tag, const std::string &precision, implemParams_t &params);
+
+    /*!
+     *  \brief Search the knobs of an implementation (one pass of coordinate descent, in the order of
+     *         `implemCaps_t::knobs`) and save the winner in the cache file.
+     *
+     *  \param tag       : Implementation tag.
+     *  \param precision : `fp32`, `fp64` or `mixed`.
+     *  \param params    : Parameters of the implementation, the knobs are updated with the winner.
+     *  \param verbose   : Print the time of each trial.
+     *  \param maxBodies : Maximum number of bodies of the timed runs.
+     *
+     *  \return The time of an iteration with the winner in ms (on at most `maxBodies` bodies), -1 if `tag` does not
+     *          exist in `precision`.
+     */
+    static float tune(const std::string &tag, const std::string &precision, implemParams_t &params,
+                      const bool verbose = false, const unsigned long maxBodies = 16384);
+};
+
+#endif /* AUTOTUNER_HPP_ */
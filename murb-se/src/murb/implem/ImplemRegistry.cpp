@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "utils/Perf.hpp"
+#include "utils/TaskScheduler.hpp"
+
+#include "ImplemRegistry.hpp"
+
+/* the implementations, in a function so it is initialized before the registrations of the other translation units */
+static std::vector<implemInfo_t> &getImplems()
+{
+    static std::vector<implemInfo_t> implems;
+    return implems;
+}
+
+static implemInfo_t &getOrAddImplem(const std::string &tag, const std::string &precision, const implemCaps_t &caps)
+{
+    std::vector<implemInfo_t> &implems = getImplems();
+    auto it = std::find_if(implems.begin(), implems.end(), [&tag](const implemInfo_t &i) { return i.tag == tag; });
+    if (it == implems.end()) {
+        implems.push_back(implemInfo_t());
+        implems.back().tag = tag;
+        it = implems.end() - 1;
+    }
+    if (it->caps.description.empty())
+        it->caps = caps;
+    if (std::find(it->precisions.begin(), it->precisions.end(), precision) != it->precisions.end()) {
+        std::cout << "Implementation '" << tag << "' is registered twice in " << precision << "... exiting."
+                  << std::endl;
+        exit(-1);
+    }
+    it->precisions.push_back(precision);
+    std::sort(it->precisions.begin(), it->precisions.end());
+    return *it;
+}
+
+bool ImplemRegistry::add(const std::string &tag, const std::string &precision, const implemCaps_t &caps,
+                         implemFactory_t<float> factory)
+{
+    getOrAddImplem(tag, precision, caps).factoriesFloat[precision] = factory;
+    return true;
+}
+
+bool ImplemRegistry::add(const std::string &tag, const std::string &precision, const implemCaps_t &caps,
+                         implemFactory_t<double> factory)
+{
+    getOrAddImplem(tag, precision, caps).factoriesDouble[precision] = factory;
+    return true;
+}
+
+std::vector<const implemInfo_t *> ImplemRegistry::list()
+{
+    std::vector<const implemInfo_t *> implems;
+    for (const implemInfo_t &i : getImplems())
+        implems.push_back(&i);
+    // the order of the static initializations is unspecified
+    std::sort(implems.begin(), implems.end(),
+              [](const implemInfo_t *a, const implemInfo_t *b) { return a->tag < b->tag; });
+    return implems;
+}
+
+const implemInfo_t *ImplemRegistry::find(const std::string &tag)
+{
+    for (const implemInfo_t &i : getImplems())
+        if (i.tag == tag)
+            return &i;
+    return nullptr;
+}
+
+template <typename T> static const std::map<std::string, implemFactory_t<T>> &getFactories(const implemInfo_t &i);
+
+template <> const std::map<std::string, implemFactory_t<float>> &getFactories<float>(const implemInfo_t &i)
+{
+    return i.factoriesFloat;
+}
+
+template <> const std::map<std::string, implemFactory_t<double>> &getFactories<double>(const implemInfo_t &i)
+{
+    return i.factoriesDouble;
+}
+
+template <typename T>
+SimulationNBodyInterface<T> *ImplemRegistry::create(const std::string &tag, const std::string &precision,
+                                                    const implemParams_t &params)
+{
+    const implemInfo_t *implem = ImplemRegistry::find(tag);
+    if (implem == nullptr)
+        return nullptr;
+    const std::map<std::string, implemFactory_t<T>> &factories = getFactories<T>(*implem);
+    auto it = factories.find(precision);
+    if (it == factories.end())
+        return nullptr;
+    if (params.threads) {
+#ifdef _OPENMP
+        omp_set_num_threads(params.threads);
+#endif
+        TaskScheduler::get().setNumThreads(params.threads);
+    }
+    SimulationNBodyInterface<T> *simu = it->second(params);
+    simu->setActiveLayout(implem->caps.layout);
+    return simu;
+}
+
+/* time of one iteration in ms (at least 50 ms, after a warm-up iteration) */
+template <typename T> static float timeIteration(SimulationNBodyInterface<T> *simu)
+{
+    simu->computeOneIteration();
+    Perf perf;
+    unsigned long nIte = 0;
+    perf.start();
+    do {
+        simu->computeOneIteration();
+        nIte++;
+        perf.stop();
+    } while (perf.getElapsedTime() < 50.f);
+    return perf.getElapsedTime() / nIte;
+}
+
+template <typename T>
+static float measureImplem(const std::string &tag, const std::string &precision, const implemParams_t &params)
+{
+    SimulationNBodyInterface<T> *simu = ImplemRegistry::create<T>(tag, precision, params);
+    if (simu == nullptr)
+        return -1.f;
+    const float time = timeIteration(simu);
+    delete simu;
+    return time;
+}
+
+float ImplemRegistry::measure(const std::string &tag, const std::string &precision, const implemParams_t &params)
+{
+    return (precision == "fp32") ? measureImplem<float>(tag, precision, params)
+                                 : measureImplem<double>(tag, precision, params);
+}
+
+std::string ImplemRegistry::selectFastest(const std::string &precision, const implemParams_t &params,
+                                          const bool verbose, const unsigned long maxBodies)
+{
+    static std::map<std::string, std::string> cache;
+    const std::string key = precision + "/" + std::to_string(params.nBodies);
+    if (cache.count(key))
+        return cache[key];
+
+    implemParams_t calibration = params;
+    calibration.nBodies = std::min(params.nBodies, maxBodies);
+    if (verbose)
+        std::cout << "Calibration of the implementations (" << precision << ", " << calibration.nBodies
+                  << " bodies):" << std::endl;
+
+    std::string fastest;
+    float fastestTime = 0.f;
+    for (const implemInfo_t *implem : ImplemRegistry::list()) {
+        if (!implem->caps.exact)
+            continue;
+        const float time = ImplemRegistry::measure(implem->tag, precision, calibration);
+        if (time < 0.f)
+            continue;
+        if (verbose)
+            std::cout << "  -> " << std::left << std::setw(16) << implem->tag << std::right << ": " << std::fixed
+                      << std::setprecision(3) << time << " ms/ite." << std::defaultfloat << std::endl;
+        if (fastest.empty() || time < fastestTime) {
+            fastest = implem->tag;
+            fastestTime = time;
+        }
+    }
+    cache[key] = fastest;
+    return fastest;
+}
+
+std::string ImplemRegistry::getDescription(const std::string &prefix)
+{
+    std::stringstream desc;
+    for (const implemInfo_t *implem : ImplemRegistry::list()) {
+        std::string precisions;
+        for (const std::string &p : implem->precisions)
+            precisions += (precisions.empty() ? "" : ", ") + p;
+        desc << prefix << std::left << std::setw(18) << ("\"" + implem->tag + "\"") << std::right << " ("
+             << precisions << "; " << implem->caps.layout << (implem->caps.multithreaded ? ", multithreaded" : "")
+             << (implem->caps.isa ? ", --isa" : "") << ") " << implem->caps.description << std::endl;
+    }
+    return desc.str();
+}
+
+// ==================================================================================== explicit template instantiation
+template SimulationNBodyInterface<double> *ImplemRegistry::create<double>(const std::string &, const std::string &,
+                                                                          const implemParams_t &);
+template SimulationNBodyInterface<float> *ImplemRegistry::create<float>(const std::string &, const std::string &,
+                                                                        const implemParams_t &);
+// ==================================================================================== explicit template instantiation
@@ -0,0 +1,163 @@
+#ifndef IMPLEM_REGISTRY_HPP_
+#define IMPLEM_REGISTRY_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "core/SimulationNBodyInterface.hpp"
+
+/*!
+ * \struct implemParams_t
+ * \brief  Parameters given to the implementations when they are created (from the command line).
+ */
+struct implemParams_t {
+    unsigned long nBodies = 1000;    /*!< Number of bodies. */
+    std::string scheme = "galaxy";   /*!< Initial condition of the bodies. */
+    float soft = 2e+08;              /*!< Softening factor. */
+    unsigned long order = 4;         /*!< Expansion order of the fast multipole method. */
+    float theta = 0.5f;              /*!< Opening angle of the tree methods. */
+    unsigned long rebuildPeriod = 1; /*!< Period of the rebuilds of the octree. */
+    unsigned long gridSize = 64;     /*!< Number of nodes per dimension of the particle-mesh grid. */
+    std::string assignment = "tsc";  /*!< Mass assignment scheme of the particle-mesh. */
+    float split = 1.25f;             /*!< Split radius of the P3M solver, in grid spacings. */
+    float cutoff = 5e7;              /*!< Cutoff radius of the truncated gravity. */
+    unsigned long threads = 0;       /*!< Number of threads (0 = unchanged). */
+    unsigned long tileSize = 256;    /*!< Number of bodies per tile of the direct sums. */
+    unsigned long leafSize = 0;      /*!< Number of bodies per leaf of the trees (0 = default of the implementation). */
+    std::string schedule = "static"; /*!< Schedule of the tiles (`static` or `dynamic`). */
+    bool replicate = false;          /*!< Copy of the j-bodies on each NUMA node (`cpu+simd`). */
+    unsigned ranks = 2;              /*!< Number of ranks of the distributed implementations (`sockets`). */
+    std::string transport = "auto";  /*!< Transport between the ranks (`auto`, `sockets` or `mpi`). */
+};
+
+template <typename T> using implemFactory_t = SimulationNBodyInterface<T> *(*)(const implemParams_t &);
+
+/*!
+ * \struct implemCaps_t
+ * \brief  Capabilities of an implementation.
+ */
+struct implemCaps_t {
+    std::string description; /*!< One line description (method, options). */
+    std::string layout;      /*!< Layout of the bodies read (`AoS`, `SoA`, `AoSoA`, `hot`, `fp16`...), kept updated. */
+    bool multithreaded;      /*!< Parallelized (OpenMP or task scheduler). */
+    bool exact;              /*!< Direct sum in the precision of the computations (a candidate of `--im auto`). */
+    std::vector<std::string> knobs; /*!< Parameters of the autotuner used (`threads`, `tile`, `leaf`, `schedule`). */
+    bool isa;                       /*!< Kernels dispatched on the instruction set of the CPU (`--isa`). */
+};
+
+/*!
+ * \struct implemInfo_t
+ * \brief  An implementation of the registry and its factories, one per precision.
+ */
+struct implemInfo_t {
+    std::string tag;                                                /*!< Implementation tag (`--im`). */
+    implemCaps_t caps;                                              /*!< Capabilities. */
+    std::vector<std::string> precisions;                            /*!< Precisions (`fp32`, `fp64`, `mixed`). */
+    std::map<std::string, implemFactory_t<float>> factoriesFloat;   /*!< Factories of the fp32 bodies. */
+    std::map<std::string, implemFactory_t<double>> factoriesDouble; /*!< Factories of the fp64 bodies (`mixed`). */
+};
+
+/*!
+ * \class  ImplemRegistry
+ * \brief  Registry of the implementations, filled at static initialization by the `SimulationNBody*` translation
+ *         units (see `REGISTER_IMPLEM`).
+ */
+class ImplemRegistry {
+  public:
+    /*!
+     *  \brief Register an implementation for one precision.
+     *
+     *  \param tag       : Implementation tag.
+     *  \param precision : `fp32` (float factory), `fp64` or `mixed` (double factories).
+     *  \param caps      : Capabilities (kept from the first registration, an empty description only adds a precision).
+     *  \param factory   : Function that allocates the simulation.
+     *
+     *  \return True (to initialize a static variable).
+     */
+    static bool add(const std::string &tag, const std::string &precision, const implemCaps_t &caps,
+                    implemFactory_t<float> factory);
+    static bool add(const std::string &tag, const std::string &precision, const implemCaps_t &caps,
+                    implemFactory_t<double> factory);
+
+    /*!
+     *  \brief Registered implementations.
+     *
+     *  \return The implementations, sorted by tag.
+     */
+    static std::vector<const implemInfo_t *> list();
+
+    /*!
+     *  \brief Find an implementation.
+     *
+     *  \param tag : Implementation tag.
+     *
+     *  \return The implementation or `nullptr` if `tag` is not registered.
+     */
+    static const implemInfo_t *find(const std::string &tag);
+
+    /*!
+     *  \brief Allocate a simulation.
+     *
+     *  \tparam T : Floating-point type of the bodies (`float` for fp32, `double` for fp64 and mixed).
+     *
+     *  \param tag       : Implementation tag.
+     *  \param precision : `fp32`, `fp64` or `mixed`.
+     *  \param params    : Parameters of the simulation.
+     *
+     *  \return A fresh allocated simulation or `nullptr` if `tag` does not exist in `precision`.
+     *
+     *  The number of threads of OpenMP and of the task scheduler is set if `params.threads` is not 0. The layout of
+     *  the capabilities is the only one written at each iteration (see `Bodies::setActiveLayout`).
+     */
+    template <typename T>
+    static SimulationNBodyInterface<T> *create(const std::string &tag, const std::string &precision,
+                                               const implemParams_t &params);
+
+    /*!
+     *  \brief Time of an iteration: one warm-up iteration, then at least 50 ms of iterations.
+     *
+     *  \param tag       : Implementation tag.
+     *  \param precision : `fp32`, `fp64` or `mixed`.
+     *  \param params    : Parameters of the simulation.
+     *
+     *  \return The time of an iteration in ms, or -1 if `tag` does not exist in `precision`.
+     */
+    static float measure(const std::string &tag, const std::string &precision, const implemParams_t &params);
+
+    /*!
+     *  \brief Select the fastest exact implementation with short timed runs (the results are kept for the next
+     *         calls with the same precision and number of bodies).
+     *
+     *  The candidates run on at most `maxBodies` bodies: they are all direct sums, their ranking does not depend
+     *  much on n above a few thousands of bodies.
+     *
+     *  \param precision : `fp32`, `fp64` or `mixed`.
+     *  \param params    : Parameters of the simulation.
+     *  \param verbose   : Print the time of each candidate.
+     *  \param maxBodies : Maximum number of bodies of the calibration.
+     *
+     *  \return The tag of the fastest implementation (empty if there is no candidate).
+     */
+    static std::string selectFastest(const std::string &precision, const implemParams_t &params,
+                                     const bool verbose = false, const unsigned long maxBodies = 4096);
+
+    /*!
+     *  \brief Description of the implementations (for `--help` and `--im list`).
+     *
+     *  \param prefix : Prefix of each line.
+     *
+     *  \return One line per implementation: tag, precisions, capabilities and description.
+     */
+    static std::string getDescription(const std::string &prefix = "");
+};
+
+/*!
+ *  \brief Register the `fp32` and `fp64` factories of an implementation, `create` is a function template
+ *         `SimulationNBodyInterface<T> *create(const implemParams_t &)`.
+ */
+#define REGISTER_IMPLEM(name, tag, caps, create)                                                                       \
+    static const bool name##Float = ImplemRegistry::add(tag, "fp32", caps, create<float>);                           \
+    static const bool name##Double = ImplemRegistry::add(tag, "fp64", caps, create<double>)
+
+#endif /* IMPLEM_REGISTRY_HPP_ */
@@ -0,0 +1,287 @@
+#include <string>
+#include <vector>
+
+#include "KernelsISA.hpp"
+#include "KernelsSIMD.hpp"
+#include "utils/Mipp.hpp"
+
+#ifdef MURB_MULTI_ISA
+#define MURB_DECLARE_ISA(isa)                                                                                          \
+    namespace kernels_##isa                                                                                            \
+    {                                                                                                                  \
+    template <typename T> int getWidth();                                                                              \
+    template <typename T>                                                                                              \
+    void computeAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,                        \
+                              const dataHot_t<T> *hj, const unsigned long nj, const T softSquared, T *aix, T *aiy,     \
+                              T *aiz);                                                                                 \
+    template <typename T>                                                                                              \
+    void computeAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, const T *qjx,          \
+                              const T *qjy, const T *qjz, const T *mj, const unsigned long nj, const T softSquared,    \
+                              T *aix, T *aiy, T *aiz);                                                                 \
+    template <typename T>                                                                                              \
+    void computeCutoffAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, const T *qjx,    \
+                                    const T *qjy, const T *qjz, const T *mj, const unsigned long nj,                   \
+                                    const T softSquared, const T cutoff, T *aix, T *aiy, T *aiz);                      \
+    template <typename T>                                                                                              \
+    void computeShortRangeAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,              \
+                                        const T *qjx, const T *qjy, const T *qjz, const T *mj,                         \
+                                        const unsigned long nj, const T softSquared, const T split, T *aix,            \
+                                        T *aiy, T *aiz);                                                               \
+    template <typename T>                                                                                              \
+    void computeNodeAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,                    \
+                                  const nodeHot_t<T> *nodes, const unsigned long nNodes, const T softSquared,          \
+                                  T *aix, T *aiy, T *aiz);                                                             \
+    }
+
+MURB_DECLARE_ISA(sse2)
+MURB_DECLARE_ISA(avx2)
+MURB_DECLARE_ISA(avx512)
+
+// declared 'extern' in KernelsISA.hxx: the kernels of each instruction set use this definition
+template std::string std::operator+(const std::string &, const char *);
+
+static bool supportsSSE2() { return __builtin_cpu_supports("sse2"); }
+
+static bool supportsAVX2() { return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"); }
+
+static bool supportsAVX512()
+{
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+           __builtin_cpu_supports("avx512dq");
+}
+#else
+/* the instruction set of the compiler flags */
+template <typename T> static int getDefaultWidth() { return mipp::N<T>(); }
+
+template <typename T>
+static void computeDefaultAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                                        const dataHot_t<T> *hj, const unsigned long nj, const T softSquared, T *aix,
+                                        T *aiy, T *aiz)
+{
+    computeAccelerationsSIMD<T>(qix, qiy, qiz, ni, hj, nj, softSquared, aix, aiy, aiz);
+}
+
+template <typename T>
+static void computeDefaultAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                                        const T *qjx, const T *qjy, const T *qjz, const T *mj, const unsigned long nj,
+                                        const T softSquared, T *aix, T *aiy, T *aiz)
+{
+    computeAccelerationsSIMD<T>(qix, qiy, qiz, ni, qjx, qjy, qjz, mj, nj, softSquared, aix, aiy, aiz);
+}
+
+template <typename T>
+static void computeDefaultCutoffAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                                              const T *qjx, const T *qjy, const T *qjz, const T *mj,
+                                              const unsigned long nj, const T softSquared, const T cutoff, T *aix,
+                                              T *aiy, T *aiz)
+{
+    computeCutoffAccelerationsSIMD<T>(qix, qiy, qiz, ni, qjx, qjy, qjz, mj, nj, softSquared, cutoff, aix, aiy, aiz);
+}
+
+template <typename T>
+static void computeDefaultShortRangeAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                                                  const T *qjx, const T *qjy, const T *qjz, const T *mj,
+                                                  const unsigned long nj, const T softSquared, const T split, T *aix,
+                                                  T *aiy, T *aiz)
+{
+    computeShortRangeAccelerationsSIMD<T>(qix, qiy, qiz, ni, qjx, qjy, qjz, mj, nj, softSquared, split, aix, aiy,
+                                          aiz);
+}
+
+template <typename T>
+static void computeDefaultNodeAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                                            const nodeHot_t<T> *nodes, const unsigned long nNodes,
+                                            const T softSquared, T *aix, T *aiy, T *aiz)
+{
+    computeNodeAccelerationsSIMD<T>(qix, qiy, qiz, ni, nodes, nNodes, softSquared, aix, aiy, aiz);
+}
+
+static bool supportsDefault() { return true; }
+#endif
+
+/* kernels of an instruction set */
+template <typename T> struct isaKernels_t {
+    int (*getWidth)();
+    void (*computeAccelerations)(const T *, const T *, const T *, const unsigned long, const dataHot_t<T> *,
+                                 const unsigned long, const T, T *, T *, T *);
+    void (*computeAccelerationsSoA)(const T *, const T *, const T *, const unsigned long, const T *, const T *,
+                                    const T *, const T *, const unsigned long, const T, T *, T *, T *);
+    void (*computeCutoffAccelerations)(const T *, const T *, const T *, const unsigned long, const T *, const T *,
+                                       const T *, const T *, const unsigned long, const T, const T, T *, T *, T *);
+    void (*computeShortRangeAccelerations)(const T *, const T *, const T *, const unsigned long, const T *,
+                                           const T *, const T *, const T *, const unsigned long, const T, const T,
+                                           T *, T *, T *);
+    void (*computeNodeAccelerations)(const T *, const T *, const T *, const unsigned long, const nodeHot_t<T> *,
+                                     const unsigned long, const T, T *, T *, T *);
+};
+
+/* instruction sets compiled in the binary, from the narrowest to the widest */
+static const std::vector<std::string> isaNames = {
+#ifdef MURB_MULTI_ISA
+    "sse2", "avx2", "avx512"
+#else
+    "default"
+#endif
+};
+
+static bool (*const isaSupported[])() = {
+#ifdef MURB_MULTI_ISA
+    supportsSSE2, supportsAVX2, supportsAVX512
+#else
+    supportsDefault
+#endif
+};
+
+template <typename T> static const isaKernels_t<T> &getKernels(const unsigned long iISA)
+{
+    static const isaKernels_t<T> kernels[] = {
+#ifdef MURB_MULTI_ISA
+        {kernels_sse2::getWidth<T>, kernels_sse2::computeAccelerations<T>, kernels_sse2::computeAccelerations<T>,
+         kernels_sse2::computeCutoffAccelerations<T>, kernels_sse2::computeShortRangeAccelerations<T>,
+         kernels_sse2::computeNodeAccelerations<T>},
+        {kernels_avx2::getWidth<T>, kernels_avx2::computeAccelerations<T>, kernels_avx2::computeAccelerations<T>,
+         kernels_avx2::computeCutoffAccelerations<T>, kernels_avx2::computeShortRangeAccelerations<T>,
+         kernels_avx2::computeNodeAccelerations<T>},
+        {kernels_avx512::getWidth<T>, kernels_avx512::computeAccelerations<T>, kernels_avx512::computeAccelerations<T>,
+         kernels_avx512::computeCutoffAccelerations<T>, kernels_avx512::computeShortRangeAccelerations<T>,
+         kernels_avx512::computeNodeAccelerations<T>},
+#else
+        {getDefaultWidth<T>, computeDefaultAccelerations<T>, computeDefaultAccelerations<T>,
+         computeDefaultCutoffAccelerations<T>, computeDefaultShortRangeAccelerations<T>,
+         computeDefaultNodeAccelerations<T>},
+#endif
+    };
+    return kernels[iISA];
+}
+
+/* index of the selected instruction set in `isaNames` (detected on first use) */
+static long iSelectedISA = -1;
+
+static unsigned long findISA(const std::string &isa)
+{
+    for (unsigned long i = 0; i < isaNames.size(); i++)
+        if (isaNames[i] == isa)
+            return i;
+    return isaNames.size();
+}
+
+static unsigned long getSelectedISAIndex()
+{
+    if (iSelectedISA < 0)
+        iSelectedISA = findISA(detectISA());
+    return iSelectedISA;
+}
+
+const std::vector<std::string> &getCompiledISAs() { return isaNames; }
+
+bool isISASupported(const std::string &isa)
+{
+#ifdef MURB_MULTI_ISA
+    __builtin_cpu_init();
+#endif
+    const unsigned long i = findISA(isa);
+    return i < isaNames.size() && isaSupported[i]();
+}
+
+std::string detectISA()
+{
+    for (unsigned long i = isaNames.size(); i-- > 1;)
+        if (isISASupported(isaNames[i]))
+            return isaNames[i];
+    return isaNames[0];
+}
+
+bool selectISA(const std::string &isa)
+{
+    const std::string name = (isa == "auto") ? detectISA() : isa;
+    if (!isISASupported(name))
+        return false;
+    iSelectedISA = findISA(name);
+    return true;
+}
+
+const std::string &getSelectedISA() { return isaNames[getSelectedISAIndex()]; }
+
+template <typename T> int getSelectedISAWidth() { return getKernels<T>(getSelectedISAIndex()).getWidth(); }
+
+template <typename T>
+void computeAccelerationsISA(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, const dataHot_t<T> *hj,
+                             const unsigned long nj, const T softSquared, T *aix, T *aiy, T *aiz)
+{
+    getKernels<T>(getSelectedISAIndex()).computeAccelerations(qix, qiy, qiz, ni, hj, nj, softSquared, aix, aiy, aiz);
+}
+
+template <typename T>
+void computeAccelerationsISA(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, const T *qjx,
+                             const T *qjy, const T *qjz, const T *mj, const unsigned long nj, const T softSquared,
+                             T *aix, T *aiy, T *aiz)
+{
+    getKernels<T>(getSelectedISAIndex())
+        .computeAccelerationsSoA(qix, qiy, qiz, ni, qjx, qjy, qjz, mj, nj, softSquared, aix, aiy, aiz);
+}
+
+template <typename T>
+void computeCutoffAccelerationsISA(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, const T *qjx,
+                                   const T *qjy, const T *qjz, const T *mj, const unsigned long nj,
+                                   const T softSquared, const T cutoff, T *aix, T *aiy, T *aiz)
+{
+    getKernels<T>(getSelectedISAIndex())
+        .computeCutoffAccelerations(qix, qiy, qiz, ni, qjx, qjy, qjz, mj, nj, softSquared, cutoff, aix, aiy, aiz);
+}
+
+template <typename T>
+void computeShortRangeAccelerationsISA(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                                       const T *qjx, const T *qjy, const T *qjz, const T *mj, const unsigned long nj,
+                                       const T softSquared, const T split, T *aix, T *aiy, T *aiz)
+{
+    getKernels<T>(getSelectedISAIndex())
+        .computeShortRangeAccelerations(qix, qiy, qiz, ni, qjx, qjy, qjz, mj, nj, softSquared, split, aix, aiy, aiz);
+}
+
+template <typename T>
+void computeNodeAccelerationsISA(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                                 const nodeHot_t<T> *nodes, const unsigned long nNodes, const T softSquared, T *aix,
+                                 T *aiy, T *aiz)
+{
+    getKernels<T>(getSelectedISAIndex())
+        .computeNodeAccelerations(qix, qiy, qiz, ni, nodes, nNodes, softSquared, aix, aiy, aiz);
+}
+
+// ==================================================================================== explicit template instantiation
+template int getSelectedISAWidth<double>();
+template int getSelectedISAWidth<float>();
+template void computeAccelerationsISA<double>(const double *, const double *, const double *, const unsigned long,
+                                              const dataHot_t<double> *, const unsigned long, const double, double *,
+                                              double *, double *);
+template void computeAccelerationsISA<float>(const float *, const float *, const float *, const unsigned long,
+                                             const dataHot_t<float> *, const unsigned long, const float, float *,
+                                             float *, float *);
+template void computeAccelerationsISA<double>(const double *, const double *, const double *, const unsigned long,
+                                              const double *, const double *, const double *, const double *,
+                                              const unsigned long, const double, double *, double *, double *);
+template void computeAccelerationsISA<float>(const float *, const float *, const float *, const unsigned long,
+                                             const float *, const float *, const float *, const float *,
+                                             const unsigned long, const float, float *, float *, float *);
+template void computeCutoffAccelerationsISA<double>(const double *, const double *, const double *, const unsigned long,
+                                                    const double *, const double *, const double *, const double *,
+                                                    const unsigned long, const double, const double, double *, double *,
+                                                    double *);
+template void computeCutoffAccelerationsISA<float>(const float *, const float *, const float *, const unsigned long,
+                                                   const float *, const float *, const float *, const float *,
+                                                   const unsigned long, const float, const float, float *, float *,
+                                                   float *);
+template void computeShortRangeAccelerationsISA<double>(const double *, const double *, const double *,
+                                                        const unsigned long, const double *, const double *,
+                                                        const double *, const double *, const unsigned long,
+                                                        const double, const double, double *, double *, double *);
+template void computeShortRangeAccelerationsISA<float>(const float *, const float *, const float *, const unsigned long,
+                                                       const float *, const float *, const float *, const float *,
+                                                       const unsigned long, const float, const float, float *, float *,
+                                                       float *);
+template void computeNodeAccelerationsISA<double>(const double *, const double *, const double *, const unsigned long,
+                                                  const nodeHot_t<double> *, const unsigned long, const double,
+                                                  double *, double *, double *);
+template void computeNodeAccelerationsISA<float>(const float *, const float *, const float *, const unsigned long,
+                                                 const nodeHot_t<float> *, const unsigned long, const float, float *,
+                                                 float *, float *);
+// ==================================================================================== explicit template instantiation
@@ -0,0 +1,191 @@
+#ifndef KERNELS_ISA_HPP_
+#define KERNELS_ISA_HPP_
+
+#include <string>
+#include <vector>
+
+#include "core/Bodies.hpp"
+#include "utils/Octree.hpp"
+
+/*
+ * Runtime dispatch of the SIMD kernels.
+ *
+ * The kernels of `KernelsISA.hxx` are compiled once per instruction set (`KernelsISA_sse2.cpp`,
+ * `KernelsISA_avx2.cpp` and `KernelsISA_avx512.cpp`, see the CMake file): MIPP is renamed in each translation unit so
+ * the vector types of the different widths do not collide. The widest instruction set supported by the CPU is
+ * selected on first use, `selectISA` overrides it. Without the multi-ISA build (not x86 or not GCC/Clang) there is
+ * only the `default` instruction set: the one of the compiler flags.
+ *
+ * The `*ISA` functions are the array versions of the kernels of `KernelsSIMD.hpp`, with the same parameters: the
+ * implementations call them instead of the inline kernels to run at the speed of the CPU with portable build flags.
+ */
+
+/*!
+ *  \brief Instruction sets compiled in the binary.
+ *
+ *  \return The names of the instruction sets, from the narrowest to the widest.
+ */
+const std::vector<std::string> &getCompiledISAs();
+
+/*!
+ *  \brief Test if an instruction set is compiled in the binary and supported by the CPU (CPUID).
+ *
+ *  \param isa : Name of the instruction set.
+ *
+ *  \return True if the kernels of `isa` can run.
+ */
+bool isISASupported(const std::string &isa);
+
+/*!
+ *  \brief Widest instruction set compiled in the binary and supported by the CPU.
+ *
+ *  \return The name of the instruction set.
+ */
+std::string detectISA();
+
+/*!
+ *  \brief Select the instruction set of the dispatched kernels.
+ *
+ *  \param isa : Name of the instruction set, or `auto` for the widest supported one.
+ *
+ *  \return False if `isa` is not supported (the selection is unchanged).
+ */
+bool selectISA(const std::string &isa);
+
+/*!
+ *  \brief Selected instruction set getter.
+ *
+ *  \return The name of the instruction set of the dispatched kernels.
+ */
+const std::string &getSelectedISA();
+
+/*!
+ *  \brief Vector width of the selected instruction set.
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  \return The number of elements of type `T` per vector.
+ */
+template <typename T> int getSelectedISAWidth();
+
+/*!
+ *  \brief Accumulate the accelerations of the i-bodies due to a set of packed j-bodies, with the selected instruction
+ *         set (see `computeAccelerationsSIMD`).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  \param qix         : Array of positions x of the i-bodies.
+ *  \param qiy         : Array of positions y of the i-bodies.
+ *  \param qiz         : Array of positions z of the i-bodies.
+ *  \param ni          : Number of i-bodies (any number).
+ *  \param hj          : Array of packed j-bodies.
+ *  \param nj          : Number of j-bodies.
+ *  \param softSquared : Softening factor squared.
+ *  \param aix         : Array of accelerations x of the i-bodies (accumulated).
+ *  \param aiy         : Array of accelerations y of the i-bodies (accumulated).
+ *  \param aiz         : Array of accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+void computeAccelerationsISA(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, const dataHot_t<T> *hj,
+                             const unsigned long nj, const T softSquared, T *aix, T *aiy, T *aiz);
+
+/*!
+ *  \brief Accumulate the accelerations of the i-bodies due to a set of j-bodies, with the selected instruction set
+ *         (see `computeAccelerationsSIMD`).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  \param qix         : Array of positions x of the i-bodies.
+ *  \param qiy         : Array of positions y of the i-bodies.
+ *  \param qiz         : Array of positions z of the i-bodies.
+ *  \param ni          : Number of i-bodies (any number).
+ *  \param qjx         : Array of positions x of the j-bodies.
+ *  \param qjy         : Array of positions y of the j-bodies.
+ *  \param qjz         : Array of positions z of the j-bodies.
+ *  \param mj          : Array of masses of the j-bodies.
+ *  \param nj          : Number of j-bodies.
+ *  \param softSquared : Softening factor squared.
+ *  \param aix         : Array of accelerations x of the i-bodies (accumulated).
+ *  \param aiy         : Array of accelerations y of the i-bodies (accumulated).
+ *  \param aiz         : Array of accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+void computeAccelerationsISA(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, const T *qjx,
+                             const T *qjy, const T *qjz, const T *mj, const unsigned long nj, const T softSquared,
+                             T *aix, T *aiy, T *aiz);
+
+/*!
+ *  \brief Accumulate the truncated accelerations of the i-bodies due to a set of j-bodies, with the selected
+ *         instruction set (see `computeCutoffAccelerationsSIMD`).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  \param qix         : Array of positions x of the i-bodies.
+ *  \param qiy         : Array of positions y of the i-bodies.
+ *  \param qiz         : Array of positions z of the i-bodies.
+ *  \param ni          : Number of i-bodies (any number).
+ *  \param qjx         : Array of positions x of the j-bodies.
+ *  \param qjy         : Array of positions y of the j-bodies.
+ *  \param qjz         : Array of positions z of the j-bodies.
+ *  \param mj          : Array of masses of the j-bodies.
+ *  \param nj          : Number of j-bodies.
+ *  \param softSquared : Softening factor squared.
+ *  \param cutoff      : Cutoff radius.
+ *  \param aix         : Array of accelerations x of the i-bodies (accumulated).
+ *  \param aiy         : Array of accelerations y of the i-bodies (accumulated).
+ *  \param aiz         : Array of accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+void computeCutoffAccelerationsISA(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, const T *qjx,
+                                   const T *qjy, const T *qjz, const T *mj, const unsigned long nj,
+                                   const T softSquared, const T cutoff, T *aix, T *aiy, T *aiz);
+
+/*!
+ *  \brief Accumulate the short-range accelerations of the i-bodies due to a set of j-bodies, with the selected
+ *         instruction set (see `computeShortRangeAccelerationsSIMD`).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  \param qix         : Array of positions x of the i-bodies.
+ *  \param qiy         : Array of positions y of the i-bodies.
+ *  \param qiz         : Array of positions z of the i-bodies.
+ *  \param ni          : Number of i-bodies (any number).
+ *  \param qjx         : Array of positions x of the j-bodies.
+ *  \param qjy         : Array of positions y of the j-bodies.
+ *  \param qjz         : Array of positions z of the j-bodies.
+ *  \param mj          : Array of masses of the j-bodies.
+ *  \param nj          : Number of j-bodies.
+ *  \param softSquared : Softening factor squared.
+ *  \param split       : Split radius rs.
+ *  \param aix         : Array of accelerations x of the i-bodies (accumulated).
+ *  \param aiy         : Array of accelerations y of the i-bodies (accumulated).
+ *  \param aiz         : Array of accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+void computeShortRangeAccelerationsISA(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                                       const T *qjx, const T *qjy, const T *qjz, const T *mj, const unsigned long nj,
+                                       const T softSquared, const T split, T *aix, T *aiy, T *aiz);
+
+/*!
+ *  \brief Accumulate the accelerations of the i-bodies due to a set of nodes (monopole + quadrupole), with the
+ *         selected instruction set (see `computeNodeAccelerationsSIMD`).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  \param qix         : Array of positions x of the i-bodies.
+ *  \param qiy         : Array of positions y of the i-bodies.
+ *  \param qiz         : Array of positions z of the i-bodies.
+ *  \param ni          : Number of i-bodies (any number).
+ *  \param nodes       : Array of packed nodes.
+ *  \param nNodes      : Number of nodes.
+ *  \param softSquared : Softening factor squared.
+ *  \param aix         : Array of accelerations x of the i-bodies (accumulated).
+ *  \param aiy         : Array of accelerations y of the i-bodies (accumulated).
+ *  \param aiz         : Array of accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+void computeNodeAccelerationsISA(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                                 const nodeHot_t<T> *nodes, const unsigned long nNodes, const T softSquared, T *aix,
+                                 T *aiy, T *aiz);
+
+#endif /* KERNELS_ISA_HPP_ */
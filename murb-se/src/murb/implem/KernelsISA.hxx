@@ -0,0 +1,114 @@
+/*
+ * Kernels of the runtime dispatch, included once per instruction set by `KernelsISA_<isa>.cpp` (compiled with the
+ * flags of the instruction set, `MURB_ISA` is its name).
+ *
+ * MIPP is renamed to `mipp_<isa>` and the kernels of `KernelsSIMD.hpp` are put in the `kernels_<isa>` namespace: the
+ * registers have a different width in each translation unit, the inline functions must not be merged by the linker.
+ * For the same reason only raw pointers cross the boundary: an inline function of the standard library instantiated
+ * here could be picked by the linker for the whole binary.
+ */
+
+#ifndef MURB_ISA
+#error "'MURB_ISA' has to be defined."
+#endif
+
+#define MURB_ISA_CAT_(a, b) a##b
+#define MURB_ISA_CAT(a, b) MURB_ISA_CAT_(a, b)
+#define mipp MURB_ISA_CAT(mipp_, MURB_ISA)
+
+#include <string>
+
+// the only inline function of the standard library instantiated by MIPP (for its constant strings): it is not
+// emitted here, it is explicitly instantiated in `KernelsISA.cpp` (compiled with the flags of the build)
+extern template std::string std::operator+(const std::string &, const char *);
+
+#include "utils/Mipp.hpp"
+
+#include "core/Bodies.hpp"
+#include "utils/Octree.hpp"
+
+namespace MURB_ISA_CAT(kernels_, MURB_ISA)
+{
+#include "KernelsSIMD.hpp"
+
+template <typename T> int getWidth() { return mipp::N<T>(); }
+
+template <typename T>
+void computeAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, const dataHot_t<T> *hj,
+                          const unsigned long nj, const T softSquared, T *aix, T *aiy, T *aiz)
+{
+    computeAccelerationsSIMD<T>(qix, qiy, qiz, ni, hj, nj, softSquared, aix, aiy, aiz);
+}
+
+template <typename T>
+void computeAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, const T *qjx,
+                          const T *qjy, const T *qjz, const T *mj, const unsigned long nj, const T softSquared, T *aix,
+                          T *aiy, T *aiz)
+{
+    computeAccelerationsSIMD<T>(qix, qiy, qiz, ni, qjx, qjy, qjz, mj, nj, softSquared, aix, aiy, aiz);
+}
+
+template <typename T>
+void computeCutoffAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, const T *qjx,
+                                const T *qjy, const T *qjz, const T *mj, const unsigned long nj, const T softSquared,
+                                const T cutoff, T *aix, T *aiy, T *aiz)
+{
+    computeCutoffAccelerationsSIMD<T>(qix, qiy, qiz, ni, qjx, qjy, qjz, mj, nj, softSquared, cutoff, aix, aiy, aiz);
+}
+
+template <typename T>
+void computeShortRangeAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, const T *qjx,
+                                    const T *qjy, const T *qjz, const T *mj, const unsigned long nj,
+                                    const T softSquared, const T split, T *aix, T *aiy, T *aiz)
+{
+    computeShortRangeAccelerationsSIMD<T>(qix, qiy, qiz, ni, qjx, qjy, qjz, mj, nj, softSquared, split, aix, aiy,
+                                          aiz);
+}
+
+template <typename T>
+void computeNodeAccelerations(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                              const nodeHot_t<T> *nodes, const unsigned long nNodes, const T softSquared, T *aix,
+                              T *aiy, T *aiz)
+{
+    computeNodeAccelerationsSIMD<T>(qix, qiy, qiz, ni, nodes, nNodes, softSquared, aix, aiy, aiz);
+}
+
+// ==================================================================================== explicit template instantiation
+template int getWidth<double>();
+template int getWidth<float>();
+template void computeAccelerations<double>(const double *, const double *, const double *, const unsigned long,
+                                           const dataHot_t<double> *, const unsigned long, const double, double *,
+                                           double *, double *);
+template void computeAccelerations<float>(const float *, const float *, const float *, const unsigned long,
+                                          const dataHot_t<float> *, const unsigned long, const float, float *,
+                                          float *, float *);
+template void computeAccelerations<double>(const double *, const double *, const double *, const unsigned long,
+                                           const double *, const double *, const double *, const double *,
+                                           const unsigned long, const double, double *, double *, double *);
+template void computeAccelerations<float>(const float *, const float *, const float *, const unsigned long,
+                                          const float *, const float *, const float *, const float *,
+                                          const unsigned long, const float, float *, float *, float *);
+template void computeCutoffAccelerations<double>(const double *, const double *, const double *, const unsigned long,
+                                                 const double *, const double *, const double *, const double *,
+                                                 const unsigned long, const double, const double, double *, double *,
+                                                 double *);
+template void computeCutoffAccelerations<float>(const float *, const float *, const float *, const unsigned long,
+                                                const float *, const float *, const float *, const float *,
+                                                const unsigned long, const float, const float, float *, float *,
+                                                float *);
+template void computeShortRangeAccelerations<double>(const double *, const double *, const double *,
+                                                     const unsigned long, const double *, const double *,
+                                                     const double *, const double *, const unsigned long, const double,
+                                                     const double, double *, double *, double *);
+template void computeShortRangeAccelerations<float>(const float *, const float *, const float *, const unsigned long,
+                                                    const float *, const float *, const float *, const float *,
+                                                    const unsigned long, const float, const float, float *, float *,
+                                                    float *);
+template void computeNodeAccelerations<double>(const double *, const double *, const double *, const unsigned long,
+                                               const nodeHot_t<double> *, const unsigned long, const double, double *,
+                                               double *, double *);
+template void computeNodeAccelerations<float>(const float *, const float *, const float *, const unsigned long,
+                                              const nodeHot_t<float> *, const unsigned long, const float, float *,
+                                              float *, float *);
+// ==================================================================================== explicit template instantiation
+} // namespace MURB_ISA_CAT(kernels_, MURB_ISA)
@@ -0,0 +1,4 @@
+#ifdef MURB_MULTI_ISA
+#define MURB_ISA avx2
+#include "KernelsISA.hxx"
+#endif
@@ -0,0 +1,555 @@
+#ifndef KERNELS_SIMD_HPP_
+#define KERNELS_SIMD_HPP_
+
+#include "core/Bodies.hpp"
+#include "utils/Mipp.hpp"
+#include "utils/Octree.hpp"
+
+/*!
+ *  \brief Apply a kernel to the i-bodies of arrays, by vectors of `mipp::N<T>()` bodies (SIMD).
+ *
+ *  \tparam T : Floating-point type.
+ *  \tparam K : Kernel, called as kernel(rqix, rqiy, rqiz, raix, raiy, raiz) to accumulate the accelerations of a
+ *             vector of i-bodies.
+ *
+ *  `ni` does not have to be a multiple of the vector width: the missing lanes of the last vector are filled with the
+ *  last i-body and only the valid lanes are stored.
+ *
+ *  \param qix    : Array of positions x of the i-bodies.
+ *  \param qiy    : Array of positions y of the i-bodies.
+ *  \param qiz    : Array of positions z of the i-bodies.
+ *  \param ni     : Number of i-bodies.
+ *  \param aix    : Array of accelerations x of the i-bodies (accumulated).
+ *  \param aiy    : Array of accelerations y of the i-bodies (accumulated).
+ *  \param aiz    : Array of accelerations z of the i-bodies (accumulated).
+ *  \param kernel : Kernel of a vector of i-bodies.
+ */
+template <typename T, class K>
+inline void computeByVectorsSIMD(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, T *aix, T *aiy,
+                                 T *aiz, const K &kernel)
+{
+    constexpr int N = mipp::N<T>();
+
+    unsigned long iBody = 0;
+    for (; iBody + N <= ni; iBody += N) {
+        const mipp::Reg<T> rqix = &qix[iBody];
+        const mipp::Reg<T> rqiy = &qiy[iBody];
+        const mipp::Reg<T> rqiz = &qiz[iBody];
+
+        mipp::Reg<T> raix = &aix[iBody];
+        mipp::Reg<T> raiy = &aiy[iBody];
+        mipp::Reg<T> raiz = &aiz[iBody];
+
+        kernel(rqix, rqiy, rqiz, raix, raiy, raiz);
+
+        raix.store(&aix[iBody]);
+        raiy.store(&aiy[iBody]);
+        raiz.store(&aiz[iBody]);
+    }
+
+    // remaining i-bodies: fill the missing lanes with the last body and only store the valid ones
+    if (iBody < ni) {
+        T tqix[N], tqiy[N], tqiz[N], taix[N], taiy[N], taiz[N];
+        for (int l = 0; l < N; l++) {
+            const unsigned long iSrc = (iBody + l < ni) ? iBody + l : ni - 1;
+            tqix[l] = qix[iSrc];
+            tqiy[l] = qiy[iSrc];
+            tqiz[l] = qiz[iSrc];
+            taix[l] = taiy[l] = taiz[l] = (T)0;
+        }
+
+        const mipp::Reg<T> rqix = tqix;
+        const mipp::Reg<T> rqiy = tqiy;
+        const mipp::Reg<T> rqiz = tqiz;
+
+        mipp::Reg<T> raix = taix;
+        mipp::Reg<T> raiy = taiy;
+        mipp::Reg<T> raiz = taiz;
+
+        kernel(rqix, rqiy, rqiz, raix, raiy, raiz);
+
+        raix.store(taix);
+        raiy.store(taiy);
+        raiz.store(taiz);
+
+        for (unsigned long l = 0; iBody + l < ni; l++) {
+            aix[iBody + l] += taix[l];
+            aiy[iBody + l] += taiy[l];
+            aiz[iBody + l] += taiz[l];
+        }
+    }
+}
+
+/*!
+ *  \brief Accumulate the accelerations of a vector of i-bodies due to a set of j-bodies (SIMD).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  The j-bodies are broadcasted one by one, the i-bodies stay in registers. The gravitational constant is not
+ *  applied here: `mj` can either be the masses or the masses already multiplied by G. The self-interaction does not
+ *  contribute since rij is null (requires a non null softening).
+ *
+ *  \param rqix         : Positions x of the i-bodies.
+ *  \param rqiy         : Positions y of the i-bodies.
+ *  \param rqiz         : Positions z of the i-bodies.
+ *  \param qjx          : Array of positions x of the j-bodies.
+ *  \param qjy          : Array of positions y of the j-bodies.
+ *  \param qjz          : Array of positions z of the j-bodies.
+ *  \param mj           : Array of masses of the j-bodies.
+ *  \param nj           : Number of j-bodies.
+ *  \param rSoftSquared : Softening factor squared.
+ *  \param raix         : Accelerations x of the i-bodies (accumulated).
+ *  \param raiy         : Accelerations y of the i-bodies (accumulated).
+ *  \param raiz         : Accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+inline void computeAccelerationsSIMD(const mipp::Reg<T> &rqix, const mipp::Reg<T> &rqiy, const mipp::Reg<T> &rqiz,
+                                     const T *qjx, const T *qjy, const T *qjz, const T *mj, const unsigned long nj,
+                                     const mipp::Reg<T> &rSoftSquared, mipp::Reg<T> &raix, mipp::Reg<T> &raiy,
+                                     mipp::Reg<T> &raiz)
+{
+    const mipp::Reg<T> rOne = (T)1;
+
+    // flops = nj * N * 20
+    for (unsigned long jBody = 0; jBody < nj; jBody++) {
+        const mipp::Reg<T> rijx = mipp::Reg<T>(qjx[jBody]) - rqix; // 1 flop
+        const mipp::Reg<T> rijy = mipp::Reg<T>(qjy[jBody]) - rqiy; // 1 flop
+        const mipp::Reg<T> rijz = mipp::Reg<T>(qjz[jBody]) - rqiz; // 1 flop
+
+        // compute the || rij ||² + e² distance between body i and body j
+        const mipp::Reg<T> rijSquared =
+            mipp::fmadd(rijx, rijx, mipp::fmadd(rijy, rijy, mipp::fmadd(rijz, rijz, rSoftSquared))); // 6 flops
+        // compute the acceleration value between body i and body j: || ai || = mj / (|| rij ||² + e²)^{3/2}
+        const mipp::Reg<T> rInv = rOne / mipp::sqrt(rijSquared);            // 2 flops
+        const mipp::Reg<T> ai = mipp::Reg<T>(mj[jBody]) * (rInv * rInv * rInv); // 3 flops
+
+        // add the acceleration value into the acceleration vector: ai += || ai ||.rij
+        raix = mipp::fmadd(ai, rijx, raix); // 2 flops
+        raiy = mipp::fmadd(ai, rijy, raiy); // 2 flops
+        raiz = mipp::fmadd(ai, rijz, raiz); // 2 flops
+    }
+}
+
+/*!
+ *  \brief Accumulate the accelerations of a vector of i-bodies due to a set of packed j-bodies (SIMD).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  Same as above but the j-bodies are read from the hot array: one stream of (x, y, z, G.m) instead of four. The
+ *  masses are already multiplied by G so the accelerations are final.
+ *
+ *  \param rqix         : Positions x of the i-bodies.
+ *  \param rqiy         : Positions y of the i-bodies.
+ *  \param rqiz         : Positions z of the i-bodies.
+ *  \param hj           : Array of packed j-bodies.
+ *  \param nj           : Number of j-bodies.
+ *  \param rSoftSquared : Softening factor squared.
+ *  \param raix         : Accelerations x of the i-bodies (accumulated).
+ *  \param raiy         : Accelerations y of the i-bodies (accumulated).
+ *  \param raiz         : Accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+inline void computeAccelerationsSIMD(const mipp::Reg<T> &rqix, const mipp::Reg<T> &rqiy, const mipp::Reg<T> &rqiz,
+                                     const dataHot_t<T> *hj, const unsigned long nj, const mipp::Reg<T> &rSoftSquared,
+                                     mipp::Reg<T> &raix, mipp::Reg<T> &raiy, mipp::Reg<T> &raiz)
+{
+    const mipp::Reg<T> rOne = (T)1;
+
+    // flops = nj * N * 20
+    for (unsigned long jBody = 0; jBody < nj; jBody++) {
+        const mipp::Reg<T> rijx = mipp::Reg<T>(hj[jBody].qx) - rqix; // 1 flop
+        const mipp::Reg<T> rijy = mipp::Reg<T>(hj[jBody].qy) - rqiy; // 1 flop
+        const mipp::Reg<T> rijz = mipp::Reg<T>(hj[jBody].qz) - rqiz; // 1 flop
+
+        // compute the || rij ||² + e² distance between body i and body j
+        const mipp::Reg<T> rijSquared =
+            mipp::fmadd(rijx, rijx, mipp::fmadd(rijy, rijy, mipp::fmadd(rijz, rijz, rSoftSquared))); // 6 flops
+        // compute the acceleration value between body i and body j: || ai || = G.mj / (|| rij ||² + e²)^{3/2}
+        const mipp::Reg<T> rInv = rOne / mipp::sqrt(rijSquared);                  // 2 flops
+        const mipp::Reg<T> ai = mipp::Reg<T>(hj[jBody].gm) * (rInv * rInv * rInv); // 3 flops
+
+        // add the acceleration value into the acceleration vector: ai += || ai ||.rij
+        raix = mipp::fmadd(ai, rijx, raix); // 2 flops
+        raiy = mipp::fmadd(ai, rijy, raiy); // 2 flops
+        raiz = mipp::fmadd(ai, rijz, raiz); // 2 flops
+    }
+}
+
+/*!
+ *  \brief Accumulate the accelerations of the i-bodies due to the j-bodies (SIMD).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  `ni` does not have to be a multiple of `mipp::N<T>()`, the remaining i-bodies are computed in a partially filled
+ *  vector. The accelerations are added to `aix`, `aiy` and `aiz` and the gravitational constant is not applied.
+ *
+ *  \param qix         : Array of positions x of the i-bodies.
+ *  \param qiy         : Array of positions y of the i-bodies.
+ *  \param qiz         : Array of positions z of the i-bodies.
+ *  \param ni          : Number of i-bodies.
+ *  \param qjx         : Array of positions x of the j-bodies.
+ *  \param qjy         : Array of positions y of the j-bodies.
+ *  \param qjz         : Array of positions z of the j-bodies.
+ *  \param mj          : Array of masses of the j-bodies.
+ *  \param nj          : Number of j-bodies.
+ *  \param softSquared : Softening factor squared.
+ *  \param aix         : Array of accelerations x of the i-bodies (accumulated).
+ *  \param aiy         : Array of accelerations y of the i-bodies (accumulated).
+ *  \param aiz         : Array of accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+inline void computeAccelerationsSIMD(const T *qix, const T *qiy, const T *qiz, const unsigned long ni, const T *qjx,
+                                     const T *qjy, const T *qjz, const T *mj, const unsigned long nj,
+                                     const T softSquared, T *aix, T *aiy, T *aiz)
+{
+    const mipp::Reg<T> rSoftSquared = softSquared;
+    auto kernel = [&](const mipp::Reg<T> &rqix, const mipp::Reg<T> &rqiy, const mipp::Reg<T> &rqiz,
+                      mipp::Reg<T> &raix, mipp::Reg<T> &raiy, mipp::Reg<T> &raiz) {
+        computeAccelerationsSIMD<T>(rqix, rqiy, rqiz, qjx, qjy, qjz, mj, nj, rSoftSquared, raix, raiy, raiz);
+    };
+    computeByVectorsSIMD<T>(qix, qiy, qiz, ni, aix, aiy, aiz, kernel);
+}
+
+/*!
+ *  \brief Accumulate the accelerations of the i-bodies due to a set of packed j-bodies (SIMD).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  Same as above but the j-bodies are read from the hot array (the masses are already multiplied by G). This is the
+ *  kernel compiled for each instruction set of the runtime dispatch (see `KernelsISA.hpp`): `ni` does not have to be
+ *  a multiple of the vector width.
+ *
+ *  \param qix         : Array of positions x of the i-bodies.
+ *  \param qiy         : Array of positions y of the i-bodies.
+ *  \param qiz         : Array of positions z of the i-bodies.
+ *  \param ni          : Number of i-bodies.
+ *  \param hj          : Array of packed j-bodies.
+ *  \param nj          : Number of j-bodies.
+ *  \param softSquared : Softening factor squared.
+ *  \param aix         : Array of accelerations x of the i-bodies (accumulated).
+ *  \param aiy         : Array of accelerations y of the i-bodies (accumulated).
+ *  \param aiz         : Array of accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+inline void computeAccelerationsSIMD(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                                     const dataHot_t<T> *hj, const unsigned long nj, const T softSquared, T *aix,
+                                     T *aiy, T *aiz)
+{
+    const mipp::Reg<T> rSoftSquared = softSquared;
+    auto kernel = [&](const mipp::Reg<T> &rqix, const mipp::Reg<T> &rqiy, const mipp::Reg<T> &rqiz,
+                      mipp::Reg<T> &raix, mipp::Reg<T> &raiy, mipp::Reg<T> &raiz) {
+        computeAccelerationsSIMD<T>(rqix, rqiy, rqiz, hj, nj, rSoftSquared, raix, raiy, raiz);
+    };
+    computeByVectorsSIMD<T>(qix, qiy, qiz, ni, aix, aiy, aiz, kernel);
+}
+
+/*!
+ *  \brief Accumulate the truncated accelerations of a vector of i-bodies due to a set of j-bodies (SIMD).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  Same as the direct sum but the pairs farther than the cutoff radius are masked out: the comparison is done on
+ *  || rij ||² + e² so the cutoff costs a compare and a blend per pair.
+ *
+ *  \param rqix            : Positions x of the i-bodies.
+ *  \param rqiy            : Positions y of the i-bodies.
+ *  \param rqiz            : Positions z of the i-bodies.
+ *  \param qjx             : Array of positions x of the j-bodies.
+ *  \param qjy             : Array of positions y of the j-bodies.
+ *  \param qjz             : Array of positions z of the j-bodies.
+ *  \param mj              : Array of masses of the j-bodies.
+ *  \param nj              : Number of j-bodies.
+ *  \param rSoftSquared    : Softening factor squared.
+ *  \param rCutSoftSquared : Cutoff radius squared + softening factor squared.
+ *  \param raix            : Accelerations x of the i-bodies (accumulated).
+ *  \param raiy            : Accelerations y of the i-bodies (accumulated).
+ *  \param raiz            : Accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+inline void computeCutoffAccelerationsSIMD(const mipp::Reg<T> &rqix, const mipp::Reg<T> &rqiy,
+                                           const mipp::Reg<T> &rqiz, const T *qjx, const T *qjy, const T *qjz,
+                                           const T *mj, const unsigned long nj, const mipp::Reg<T> &rSoftSquared,
+                                           const mipp::Reg<T> &rCutSoftSquared, mipp::Reg<T> &raix,
+                                           mipp::Reg<T> &raiy, mipp::Reg<T> &raiz)
+{
+    const mipp::Reg<T> rOne = (T)1;
+    const mipp::Reg<T> rZero = (T)0;
+
+    // flops = nj * N * 20
+    for (unsigned long jBody = 0; jBody < nj; jBody++) {
+        const mipp::Reg<T> rijx = mipp::Reg<T>(qjx[jBody]) - rqix; // 1 flop
+        const mipp::Reg<T> rijy = mipp::Reg<T>(qjy[jBody]) - rqiy; // 1 flop
+        const mipp::Reg<T> rijz = mipp::Reg<T>(qjz[jBody]) - rqiz; // 1 flop
+
+        // compute the || rij ||² + e² distance between body i and body j
+        const mipp::Reg<T> rijSquared =
+            mipp::fmadd(rijx, rijx, mipp::fmadd(rijy, rijy, mipp::fmadd(rijz, rijz, rSoftSquared))); // 6 flops
+        // compute the acceleration value between body i and body j, null beyond the cutoff
+        const mipp::Reg<T> rInv = rOne / mipp::sqrt(rijSquared);                                  // 2 flops
+        const mipp::Reg<T> ai = mipp::blend(mipp::Reg<T>(mj[jBody]) * (rInv * rInv * rInv), rZero,
+                                            rijSquared < rCutSoftSquared); // 3 flops
+
+        // add the acceleration value into the acceleration vector: ai += || ai ||.rij
+        raix = mipp::fmadd(ai, rijx, raix); // 2 flops
+        raiy = mipp::fmadd(ai, rijy, raiy); // 2 flops
+        raiz = mipp::fmadd(ai, rijz, raiz); // 2 flops
+    }
+}
+
+/*!
+ *  \brief Accumulate the truncated accelerations of the i-bodies due to the j-bodies (SIMD).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  The i-bodies are computed by `computeByVectorsSIMD`: `ni` does not have to be a multiple of `mipp::N<T>()`.
+ *
+ *  \param qix         : Array of positions x of the i-bodies.
+ *  \param qiy         : Array of positions y of the i-bodies.
+ *  \param qiz         : Array of positions z of the i-bodies.
+ *  \param ni          : Number of i-bodies.
+ *  \param qjx         : Array of positions x of the j-bodies.
+ *  \param qjy         : Array of positions y of the j-bodies.
+ *  \param qjz         : Array of positions z of the j-bodies.
+ *  \param mj          : Array of masses of the j-bodies.
+ *  \param nj          : Number of j-bodies.
+ *  \param softSquared : Softening factor squared.
+ *  \param cutoff      : Cutoff radius.
+ *  \param aix         : Array of accelerations x of the i-bodies (accumulated).
+ *  \param aiy         : Array of accelerations y of the i-bodies (accumulated).
+ *  \param aiz         : Array of accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+inline void computeCutoffAccelerationsSIMD(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                                           const T *qjx, const T *qjy, const T *qjz, const T *mj,
+                                           const unsigned long nj, const T softSquared, const T cutoff, T *aix,
+                                           T *aiy, T *aiz)
+{
+    const mipp::Reg<T> rSoftSquared = softSquared;
+    const mipp::Reg<T> rCutSoftSquared = cutoff * cutoff + softSquared;
+    auto kernel = [&](const mipp::Reg<T> &rqix, const mipp::Reg<T> &rqiy, const mipp::Reg<T> &rqiz,
+                      mipp::Reg<T> &raix, mipp::Reg<T> &raiy, mipp::Reg<T> &raiz) {
+        computeCutoffAccelerationsSIMD<T>(rqix, rqiy, rqiz, qjx, qjy, qjz, mj, nj, rSoftSquared, rCutSoftSquared,
+                                          raix, raiy, raiz);
+    };
+    computeByVectorsSIMD<T>(qix, qiy, qiz, ni, aix, aiy, aiz, kernel);
+}
+
+/*!
+ *  \brief Accumulate the short-range accelerations of a vector of i-bodies due to a set of j-bodies (SIMD).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  Same as the direct sum but the softened kernel 1 / s (s² = || rij ||² + e²) is multiplied by erfc(s / 2rs), the
+ *  remaining erf(s / 2rs) / s part is left to a mesh. The force factor of each pair is
+ *  erfc(u) + 2u / sqrt(pi) . exp(-u²) with u = s / 2rs, erfc is computed with the Abramowitz & Stegun 7.1.26
+ *  approximation (absolute error < 1.5e-7) and exp(-u²) with a Taylor polynomial and 5 squarings, so no libm call is
+ *  needed (u² is clamped to 36, the factor is negligible beyond).
+ *
+ *  \param rqix         : Positions x of the i-bodies.
+ *  \param rqiy         : Positions y of the i-bodies.
+ *  \param rqiz         : Positions z of the i-bodies.
+ *  \param qjx          : Array of positions x of the j-bodies.
+ *  \param qjy          : Array of positions y of the j-bodies.
+ *  \param qjz          : Array of positions z of the j-bodies.
+ *  \param mj           : Array of masses of the j-bodies.
+ *  \param nj           : Number of j-bodies.
+ *  \param rSoftSquared : Softening factor squared.
+ *  \param rInvTwoSplit : 1 / 2rs (rs is the split radius).
+ *  \param raix         : Accelerations x of the i-bodies (accumulated).
+ *  \param raiy         : Accelerations y of the i-bodies (accumulated).
+ *  \param raiz         : Accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+inline void computeShortRangeAccelerationsSIMD(const mipp::Reg<T> &rqix, const mipp::Reg<T> &rqiy,
+                                               const mipp::Reg<T> &rqiz, const T *qjx, const T *qjy, const T *qjz,
+                                               const T *mj, const unsigned long nj, const mipp::Reg<T> &rSoftSquared,
+                                               const mipp::Reg<T> &rInvTwoSplit, mipp::Reg<T> &raix,
+                                               mipp::Reg<T> &raiy, mipp::Reg<T> &raiz)
+{
+    const mipp::Reg<T> rOne = (T)1;
+    const mipp::Reg<T> rMaxU2 = (T)36;
+    const mipp::Reg<T> rTwoOverSqrtPi = (T)1.1283791670955126;
+    // erfc(u) ~= t.(a1 + t.(a2 + t.(a3 + t.(a4 + t.a5)))).exp(-u²), t = 1 / (1 + p.u)
+    const mipp::Reg<T> rP = (T)0.3275911;
+    const mipp::Reg<T> rA1 = (T)0.254829592, rA2 = (T)-0.284496736, rA3 = (T)1.421413741;
+    const mipp::Reg<T> rA4 = (T)-1.453152027, rA5 = (T)1.061405429;
+
+    // flops = nj * N * 74
+    for (unsigned long jBody = 0; jBody < nj; jBody++) {
+        const mipp::Reg<T> rijx = mipp::Reg<T>(qjx[jBody]) - rqix; // 1 flop
+        const mipp::Reg<T> rijy = mipp::Reg<T>(qjy[jBody]) - rqiy; // 1 flop
+        const mipp::Reg<T> rijz = mipp::Reg<T>(qjz[jBody]) - rqiz; // 1 flop
+
+        // compute s² = || rij ||² + e²
+        const mipp::Reg<T> rijSquared =
+            mipp::fmadd(rijx, rijx, mipp::fmadd(rijy, rijy, mipp::fmadd(rijz, rijz, rSoftSquared))); // 6 flops
+        const mipp::Reg<T> rInv = rOne / mipp::sqrt(rijSquared);                                     // 2 flops
+        const mipp::Reg<T> u = rijSquared * rInv * rInvTwoSplit;                                      // 2 flops
+
+        // exp(-u²) = exp(-u² / 32)^32 with a degree 10 Taylor polynomial (u² is clamped, exp(-36) is negligible)
+        const mipp::Reg<T> y = mipp::min(u * u, rMaxU2) * (T)(-1. / 32.); // 3 flops
+        mipp::Reg<T> e = rOne + y * (T)(1. / 10.);                        // 2 flops
+        e = mipp::fmadd(e, y * (T)(1. / 9.), rOne);                       // 3 flops
+        e = mipp::fmadd(e, y * (T)(1. / 8.), rOne);                       // 3 flops
+        e = mipp::fmadd(e, y * (T)(1. / 7.), rOne);                       // 3 flops
+        e = mipp::fmadd(e, y * (T)(1. / 6.), rOne);                       // 3 flops
+        e = mipp::fmadd(e, y * (T)(1. / 5.), rOne);                       // 3 flops
+        e = mipp::fmadd(e, y * (T)(1. / 4.), rOne);                       // 3 flops
+        e = mipp::fmadd(e, y * (T)(1. / 3.), rOne);                       // 3 flops
+        e = mipp::fmadd(e, y * (T)(1. / 2.), rOne);                       // 3 flops
+        e = mipp::fmadd(e, y, rOne);                                      // 2 flops
+        e = e * e;                                                        // 1 flop
+        e = e * e;                                                        // 1 flop
+        e = e * e;                                                        // 1 flop
+        e = e * e;                                                        // 1 flop
+        e = e * e;                                                        // 1 flop
+
+        // force factor: erfc(u) + 2u / sqrt(pi) . exp(-u²)
+        const mipp::Reg<T> t = rOne / mipp::fmadd(rP, u, rOne);                                        // 3 flops
+        const mipp::Reg<T> poly = t * mipp::fmadd(mipp::fmadd(mipp::fmadd(mipp::fmadd(rA5, t, rA4), t, rA3), t, rA2),
+                                                  t, rA1);                                              // 9 flops
+        const mipp::Reg<T> g = mipp::fmadd(rTwoOverSqrtPi, u, poly) * e;                               // 3 flops
+
+        // || ai || = mj . g / s³
+        const mipp::Reg<T> ai = mipp::Reg<T>(mj[jBody]) * g * (rInv * rInv * rInv); // 4 flops
+
+        // add the acceleration value into the acceleration vector: ai += || ai ||.rij
+        raix = mipp::fmadd(ai, rijx, raix); // 2 flops
+        raiy = mipp::fmadd(ai, rijy, raiy); // 2 flops
+        raiz = mipp::fmadd(ai, rijz, raiz); // 2 flops
+    }
+}
+
+/*!
+ *  \brief Accumulate the short-range accelerations of the i-bodies due to the j-bodies (SIMD).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  Array version of the short-range kernel above, `ni` does not have to be a multiple of `mipp::N<T>()`.
+ *
+ *  \param qix         : Array of positions x of the i-bodies.
+ *  \param qiy         : Array of positions y of the i-bodies.
+ *  \param qiz         : Array of positions z of the i-bodies.
+ *  \param ni          : Number of i-bodies.
+ *  \param qjx         : Array of positions x of the j-bodies.
+ *  \param qjy         : Array of positions y of the j-bodies.
+ *  \param qjz         : Array of positions z of the j-bodies.
+ *  \param mj          : Array of masses of the j-bodies.
+ *  \param nj          : Number of j-bodies.
+ *  \param softSquared : Softening factor squared.
+ *  \param split       : Split radius rs.
+ *  \param aix         : Array of accelerations x of the i-bodies (accumulated).
+ *  \param aiy         : Array of accelerations y of the i-bodies (accumulated).
+ *  \param aiz         : Array of accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+inline void computeShortRangeAccelerationsSIMD(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                                               const T *qjx, const T *qjy, const T *qjz, const T *mj,
+                                               const unsigned long nj, const T softSquared, const T split, T *aix,
+                                               T *aiy, T *aiz)
+{
+    const mipp::Reg<T> rSoftSquared = softSquared;
+    const mipp::Reg<T> rInvTwoSplit = (T)1 / (2 * split);
+    auto kernel = [&](const mipp::Reg<T> &rqix, const mipp::Reg<T> &rqiy, const mipp::Reg<T> &rqiz,
+                      mipp::Reg<T> &raix, mipp::Reg<T> &raiy, mipp::Reg<T> &raiz) {
+        computeShortRangeAccelerationsSIMD<T>(rqix, rqiy, rqiz, qjx, qjy, qjz, mj, nj, rSoftSquared, rInvTwoSplit,
+                                              raix, raiy, raiz);
+    };
+    computeByVectorsSIMD<T>(qix, qiy, qiz, ni, aix, aiy, aiz, kernel);
+}
+
+/*!
+ *  \brief Accumulate the accelerations of a vector of i-bodies due to a set of nodes (monopole + quadrupole, SIMD).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  The nodes are broadcasted one by one like the j-bodies of the direct sum. With d the vector from the body to the
+ *  center of mass of a node, s² = || d ||² + e², e = d / s and Q its quadrupole, the acceleration is the gradient of
+ *  the expansion of the softened potential up to the second order:
+ *  a = M / s³ . ((1 + (15/2 e.Q.e - 3/2 tr(Q)) / (M s²)) d - 3 Q.e / (M s)).
+ *  Every intermediate value stays in the range of fp32.
+ *
+ *  \param rqix         : Positions x of the i-bodies.
+ *  \param rqiy         : Positions y of the i-bodies.
+ *  \param rqiz         : Positions z of the i-bodies.
+ *  \param nodes        : Array of packed nodes.
+ *  \param nNodes       : Number of nodes.
+ *  \param rSoftSquared : Softening factor squared.
+ *  \param raix         : Accelerations x of the i-bodies (accumulated).
+ *  \param raiy         : Accelerations y of the i-bodies (accumulated).
+ *  \param raiz         : Accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+inline void computeNodeAccelerationsSIMD(const mipp::Reg<T> &rqix, const mipp::Reg<T> &rqiy, const mipp::Reg<T> &rqiz,
+                                         const nodeHot_t<T> *nodes, const unsigned long nNodes,
+                                         const mipp::Reg<T> &rSoftSquared, mipp::Reg<T> &raix, mipp::Reg<T> &raiy,
+                                         mipp::Reg<T> &raiz)
+{
+    const mipp::Reg<T> rOne = (T)1;
+    const mipp::Reg<T> rFiveHalf = (T)2.5;
+
+    // flops = nNodes * N * 56
+    for (unsigned long j = 0; j < nNodes; j++) {
+        const nodeHot_t<T> &node = nodes[j];
+        const mipp::Reg<T> dx = mipp::Reg<T>(node.cx) - rqix; // 1 flop
+        const mipp::Reg<T> dy = mipp::Reg<T>(node.cy) - rqiy; // 1 flop
+        const mipp::Reg<T> dz = mipp::Reg<T>(node.cz) - rqiz; // 1 flop
+
+        const mipp::Reg<T> s2 = mipp::fmadd(dx, dx, mipp::fmadd(dy, dy, mipp::fmadd(dz, dz, rSoftSquared))); // 6 flops
+        const mipp::Reg<T> rInv = rOne / mipp::sqrt(s2); // 2 flops
+        const mipp::Reg<T> rInv2 = rInv * rInv;          // 1 flop
+        const mipp::Reg<T> ex = dx * rInv;               // 1 flop
+        const mipp::Reg<T> ey = dy * rInv;               // 1 flop
+        const mipp::Reg<T> ez = dz * rInv;               // 1 flop
+
+        // 3 Q.e / M and e.(3 Q / M).e
+        const mipp::Reg<T> qex = mipp::fmadd(mipp::Reg<T>(node.q[0]), ex,
+                                             mipp::fmadd(mipp::Reg<T>(node.q[1]), ey, mipp::Reg<T>(node.q[2]) * ez));
+        const mipp::Reg<T> qey = mipp::fmadd(mipp::Reg<T>(node.q[1]), ex,
+                                             mipp::fmadd(mipp::Reg<T>(node.q[3]), ey, mipp::Reg<T>(node.q[4]) * ez));
+        const mipp::Reg<T> qez = mipp::fmadd(mipp::Reg<T>(node.q[2]), ex,
+                                             mipp::fmadd(mipp::Reg<T>(node.q[4]), ey, mipp::Reg<T>(node.q[5]) * ez));
+        const mipp::Reg<T> eqe = mipp::fmadd(ex, qex, mipp::fmadd(ey, qey, ez * qez)); // 20 flops (with above)
+
+        // 1 + (5/2 e.(3 Q / M).e - tr(3 Q / M) / 2) / s² and M / s³
+        const mipp::Reg<T> f = mipp::fmadd(mipp::fmsub(rFiveHalf, eqe, mipp::Reg<T>(node.tq)), rInv2, rOne); // 4 flops
+        const mipp::Reg<T> ai = mipp::Reg<T>(node.gm) * (rInv2 * rInv);                                     // 2 flops
+
+        raix = mipp::fmadd(ai, mipp::fmsub(f, dx, rInv * qex), raix); // 5 flops
+        raiy = mipp::fmadd(ai, mipp::fmsub(f, dy, rInv * qey), raiy); // 5 flops
+        raiz = mipp::fmadd(ai, mipp::fmsub(f, dz, rInv * qez), raiz); // 5 flops
+    }
+}
+
+/*!
+ *  \brief Accumulate the accelerations of the i-bodies due to a set of nodes (monopole + quadrupole, SIMD).
+ *
+ *  \tparam T : Floating-point type.
+ *
+ *  The i-bodies are computed by `computeByVectorsSIMD`: `ni` does not have to be a multiple of `mipp::N<T>()`.
+ *
+ *  \param qix         : Array of positions x of the i-bodies.
+ *  \param qiy         : Array of positions y of the i-bodies.
+ *  \param qiz         : Array of positions z of the i-bodies.
+ *  \param ni          : Number of i-bodies.
+ *  \param nodes       : Array of packed nodes.
+ *  \param nNodes      : Number of nodes.
+ *  \param softSquared : Softening factor squared.
+ *  \param aix         : Array of accelerations x of the i-bodies (accumulated).
+ *  \param aiy         : Array of accelerations y of the i-bodies (accumulated).
+ *  \param aiz         : Array of accelerations z of the i-bodies (accumulated).
+ */
+template <typename T>
+inline void computeNodeAccelerationsSIMD(const T *qix, const T *qiy, const T *qiz, const unsigned long ni,
+                                         const nodeHot_t<T> *nodes, const unsigned long nNodes, const T softSquared,
+                                         T *aix, T *aiy, T *aiz)
+{
+    const mipp::Reg<T> rSoftSquared = softSquared;
+    auto kernel = [&](const mipp::Reg<T> &rqix, const mipp::Reg<T> &rqiy, const mipp::Reg<T> &rqiz,
+                      mipp::Reg<T> &raix, mipp::Reg<T> &raiy, mipp::Reg<T> &raiz) {
+        computeNodeAccelerationsSIMD<T>(rqix, rqiy, rqiz, nodes, nNodes, rSoftSquared, raix, raiy, raiz);
+    };
+    computeByVectorsSIMD<T>(qix, qiy, qiz, ni, aix, aiy, aiz, kernel);
+}
+
+#endif /* KERNELS_SIMD_HPP_ */
@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "ParticleMesh.hpp"
+#include "utils/TaskScheduler.hpp"
+
+/* bodies per task of the loops submitted to the task scheduler */
+static constexpr unsigned long grainBodies = 4096;
+
+template <typename T>
+ParticleMesh<T>::ParticleMesh(const unsigned long gridSize, const std::string &assignment, const kernel_t &kernel)
+    : gridSize(gridSize), support(assignment == "cic" ? 2 : 3), kernel(kernel), fft(2 * gridSize), h(0), ox(0), oy(0),
+      oz(0)
+{
+    assert(gridSize >= 16 && (gridSize & (gridSize - 1)) == 0);
+    assert(assignment == "cic" || assignment == "tsc");
+
+    const unsigned long N = this->gridSize;
+    const unsigned long M = 2 * N;
+    this->green.resize(M * M * M);
+    this->potential.resize(M * M * M);
+    this->gax.resize(N * N * N);
+    this->gay.resize(N * N * N);
+    this->gaz.resize(N * N * N);
+    this->slabStart.resize(N + 1);
+}
+
+template <typename T> double ParticleMesh<T>::getSpacing() const { return this->h; }
+
+template <typename T> float ParticleMesh<T>::getAllocatedBytes() const
+{
+    const float N = this->gridSize;
+    return (8 * N * N * N) * (sizeof(std::complex<double>) + sizeof(double)) + 3 * (N * N * N) * sizeof(double);
+}
+
+template <typename T> inline int ParticleMesh<T>::weights(const double s, double w[3]) const
+{
+    if (this->support == 2) { // CIC
+        const double i = std::floor(s);
+        const double f = s - i;
+        w[0] = 1. - f;
+        w[1] = f;
+        w[2] = 0.;
+        return (int)i;
+    }
+    else { // TSC
+        const double i = std::floor(s + 0.5);
+        const double d = s - i;
+        w[0] = 0.5 * (0.5 - d) * (0.5 - d);
+        w[1] = 0.75 - d * d;
+        w[2] = 0.5 * (0.5 + d) * (0.5 + d);
+        return (int)i - 1;
+    }
+}
+
+template <typename T> void ParticleMesh<T>::updateBox(const T *qx, const T *qy, const T *qz, const unsigned long n)
+{
+    // one bounding box per task: {minX, minY, minZ, maxX, maxY, maxZ}
+    std::vector<std::array<T, 6>> boxes((n + grainBodies - 1) / grainBodies);
+    TaskScheduler::get().parallelFor(0, n, grainBodies, [&](unsigned long begin, unsigned long end) {
+        std::array<T, 6> box = {qx[begin], qy[begin], qz[begin], qx[begin], qy[begin], qz[begin]};
+        for (unsigned long i = begin + 1; i < end; i++) {
+            box[0] = std::min(box[0], qx[i]);
+            box[1] = std::min(box[1], qy[i]);
+            box[2] = std::min(box[2], qz[i]);
+            box[3] = std::max(box[3], qx[i]);
+            box[4] = std::max(box[4], qy[i]);
+            box[5] = std::max(box[5], qz[i]);
+        }
+        boxes[begin / grainBodies] = box;
+    });
+    T minX = std::numeric_limits<T>::max(), minY = minX, minZ = minX;
+    T maxX = std::numeric_limits<T>::lowest(), maxY = maxX, maxZ = maxX;
+    for (const std::array<T, 6> &box : boxes) {
+        minX = std::min(minX, box[0]);
+        minY = std::min(minY, box[1]);
+        minZ = std::min(minZ, box[2]);
+        maxX = std::max(maxX, box[3]);
+        maxY = std::max(maxY, box[4]);
+        maxZ = std::max(maxZ, box[5]);
+    }
+    double extent = std::max((double)maxX - minX, std::max((double)maxY - minY, (double)maxZ - minZ));
+    if (extent <= 0)
+        extent = 1.;
+
+    // the bodies have to stay in [2.5, N - 4] (in nodes) so the stencils of the assignment and of the differences
+    // stay in the grid
+    const double N = this->gridSize;
+    const double lo = 2.5, hi = N - 4;
+    if (this->h > 0 && (minX - this->ox) / this->h >= lo && (maxX - this->ox) / this->h <= hi &&
+        (minY - this->oy) / this->h >= lo && (maxY - this->oy) / this->h <= hi && (minZ - this->oz) / this->h >= lo &&
+        (maxZ - this->oz) / this->h <= hi && extent >= 0.5 * (N - 8) * this->h)
+        return;
+
+    // new box with a 10% margin
+    this->h = 1.1 * extent / (N - 8);
+    this->ox = 0.5 * ((double)minX + maxX) - 0.5 * (N - 1) * this->h;
+    this->oy = 0.5 * ((double)minY + maxY) - 0.5 * (N - 1) * this->h;
+    this->oz = 0.5 * ((double)minZ + maxZ) - 0.5 * (N - 1) * this->h;
+
+    // sample the kernel on the zero-padded grid: offsets in ]-N, N[, the negative ones are wrapped (the potential
+    // grid is used as a buffer). The kernel is real and even so its transform is real.
+    const long Ni = this->gridSize;
+    const long M = 2 * Ni;
+    TaskScheduler::get().parallelFor(0, M, 1, [&](unsigned long iBegin, unsigned long iEnd) {
+        for (long i = iBegin; i < (long)iEnd; i++) {
+            const long di = i < Ni ? i : i - M;
+            for (long j = 0; j < M; j++) {
+                const long dj = j < Ni ? j : j - M;
+                for (long k = 0; k < M; k++) {
+                    const long dk = k < Ni ? k : k - M;
+                    const bool valid = i != Ni && j != Ni && k != Ni;
+                    const double r = this->h * std::sqrt((double)(di * di + dj * dj + dk * dk));
+                    this->potential[(i * M + j) * M + k] = valid ? this->kernel(r, this->h) : 0.;
+                }
+            }
+        }
+    });
+    this->fft.forward(this->potential.data());
+
+    // deconvolution of the assignment and of the interpolation: divide by W(k)^2, W(k) = prod sinc(k.h / 2)^support
+    std::vector<double> window(M);
+    const double pi = std::acos(-1.);
+    for (long i = 0; i < M; i++) {
+        const double x = pi * (double)(i < Ni ? i : i - M) / M; // k.h / 2
+        window[i] = i ? std::pow(std::sin(x) / x, this->support) : 1.;
+    }
+    TaskScheduler::get().parallelFor(0, M, 1, [&](unsigned long iBegin, unsigned long iEnd) {
+        for (long i = iBegin; i < (long)iEnd; i++)
+            for (long j = 0; j < M; j++)
+                for (long k = 0; k < M; k++) {
+                    const double w = window[i] * window[j] * window[k];
+                    this->green[(i * M + j) * M + k] = this->potential[(i * M + j) * M + k].real() / (w * w);
+                }
+    });
+}
+
+template <typename T>
+void ParticleMesh<T>::assign(const T *qx, const T *qy, const T *qz, const T *gm, const unsigned long n)
+{
+    const unsigned long N = this->gridSize;
+    const unsigned long M = 2 * N;
+    std::fill(this->potential.begin(), this->potential.end(), std::complex<double>(0.));
+
+    // counting sort of the bodies by x-slab (first node touched along x)
+    this->bodySlab.resize(n);
+    this->slabBodies.resize(n);
+    std::fill(this->slabStart.begin(), this->slabStart.end(), 0);
+    for (unsigned long i = 0; i < n; i++) {
+        double w[3];
+        this->bodySlab[i] = this->weights((qx[i] - this->ox) / this->h, w);
+        this->slabStart[this->bodySlab[i] + 1]++;
+    }
+    for (unsigned long s = 0; s < N; s++)
+        this->slabStart[s + 1] += this->slabStart[s];
+    {
+        std::vector<unsigned long> pos(this->slabStart.begin(), this->slabStart.end() - 1);
+        for (unsigned long i = 0; i < n; i++)
+            this->slabBodies[pos[this->bodySlab[i]]++] = i;
+    }
+
+    // the slabs of the same color do not share any node: one task per slab, the idle threads steal the slabs of the
+    // late ones
+    const unsigned long support = this->support;
+    for (unsigned long color = 0; color < support; color++) {
+        const unsigned long nSlabs = (N - color + support - 1) / support;
+        TaskScheduler::get().parallelFor(0, nSlabs, 1, [&](unsigned long tBegin, unsigned long tEnd) {
+            for (unsigned long t = tBegin; t < tEnd; t++) {
+                const unsigned long s = color + t * support;
+                for (unsigned long b = this->slabStart[s]; b < this->slabStart[s + 1]; b++) {
+                    const unsigned long i = this->slabBodies[b];
+                    double wx[3], wy[3], wz[3];
+                    const int bx = this->weights((qx[i] - this->ox) / this->h, wx);
+                    const int by = this->weights((qy[i] - this->oy) / this->h, wy);
+                    const int bz = this->weights((qz[i] - this->oz) / this->h, wz);
+                    for (int x = 0; x < this->support; x++)
+                        for (int y = 0; y < this->support; y++)
+                            for (int z = 0; z < this->support; z++)
+                                this->potential[((bx + x) * M + by + y) * M + bz + z] +=
+                                    gm[i] * wx[x] * wy[y] * wz[z];
+                }
+            }
+        });
+    }
+}
+
+template <typename T> void ParticleMesh<T>::computeGridAccelerations()
+{
+    const long N = this->gridSize;
+    const long M = 2 * N;
+    const double norm = 1. / ((double)M * M * M); // the backward FFT is not normalized
+    const double c = norm / (12. * this->h);
+    const std::complex<double> *phi = this->potential.data();
+
+    // 4th-order centered differences: (8.(phi[i+1] - phi[i-1]) - (phi[i+2] - phi[i-2])) / 12h
+    TaskScheduler::get().parallelFor(2, N - 2, 1, [&](unsigned long xBegin, unsigned long xEnd) {
+        for (long x = xBegin; x < (long)xEnd; x++)
+            for (long y = 2; y < N - 2; y++)
+                for (long z = 2; z < N - 2; z++) {
+                    const long i = (x * M + y) * M + z;
+                    const long g = (x * N + y) * N + z;
+                    this->gax[g] = c * (8. * (phi[i + M * M].real() - phi[i - M * M].real()) -
+                                        (phi[i + 2 * M * M].real() - phi[i - 2 * M * M].real()));
+                    this->gay[g] = c * (8. * (phi[i + M].real() - phi[i - M].real()) -
+                                        (phi[i + 2 * M].real() - phi[i - 2 * M].real()));
+                    this->gaz[g] = c * (8. * (phi[i + 1].real() - phi[i - 1].real()) -
+                                        (phi[i + 2].real() - phi[i - 2].real()));
+                }
+    });
+}
+
+template <typename T>
+void ParticleMesh<T>::interpolate(const T *qx, const T *qy, const T *qz, const unsigned long n, T *ax, T *ay,
+                                  T *az) const
+{
+    const unsigned long N = this->gridSize;
+    TaskScheduler::get().parallelFor(0, n, grainBodies, [&](unsigned long begin, unsigned long end) {
+        for (unsigned long i = begin; i < end; i++) {
+            double wx[3], wy[3], wz[3];
+            const int bx = this->weights((qx[i] - this->ox) / this->h, wx);
+            const int by = this->weights((qy[i] - this->oy) / this->h, wy);
+            const int bz = this->weights((qz[i] - this->oz) / this->h, wz);
+            double aix = 0, aiy = 0, aiz = 0;
+            for (int x = 0; x < this->support; x++)
+                for (int y = 0; y < this->support; y++)
+                    for (int z = 0; z < this->support; z++) {
+                        const unsigned long g = ((bx + x) * N + by + y) * N + bz + z;
+                        const double w = wx[x] * wy[y] * wz[z];
+                        aix += w * this->gax[g];
+                        aiy += w * this->gay[g];
+                        aiz += w * this->gaz[g];
+                    }
+            ax[i] += aix;
+            ay[i] += aiy;
+            az[i] += aiz;
+        }
+    });
+}
+
+template <typename T>
+void ParticleMesh<T>::computeAccelerations(const T *qx, const T *qy, const T *qz, const T *gm, const unsigned long n,
+                                           T *ax, T *ay, T *az)
+{
+    const unsigned long N = this->gridSize;
+    const unsigned long M = 2 * N;
+
+    this->updateBox(qx, qy, qz, n);
+    this->assign(qx, qy, qz, gm, n);
+
+    // convolution: only the first N^3 points are non zero, and only the first N^3 points are needed
+    this->fft.forward(this->potential.data(), N);
+    TaskScheduler::get().parallelFor(0, M * M * M, M * M, [&](unsigned long begin, unsigned long end) {
+        for (unsigned long i = begin; i < end; i++)
+            this->potential[i] *= this->green[i];
+    });
+    this->fft.backward(this->potential.data(), N);
+
+    this->computeGridAccelerations();
+    this->interpolate(qx, qy, qz, n, ax, ay, az);
+}
+
+// ==================================================================================== explicit template instantiation
+template class ParticleMesh<double>;
+template class ParticleMesh<float>;
+// ==================================================================================== explicit template instantiation
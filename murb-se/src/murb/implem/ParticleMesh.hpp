@@ -0,0 +1,103 @@
+#ifndef PARTICLE_MESH_HPP_
+#define PARTICLE_MESH_HPP_
+
+#include <complex>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "utils/FFT.hpp"
+
+/*!
+ * \class  ParticleMesh
+ * \brief  Mesh part of the particle-mesh solvers: mass assignment, FFT convolution and force interpolation.
+ *
+ * \tparam T : Floating-point type of the bodies (the mesh is always in `double`).
+ *
+ * The bodies are assigned to a cubic grid of `gridSize`^3 nodes with the cloud-in-cell (CIC) or the triangular
+ * shaped cloud (TSC) scheme. The potential is the convolution of the mass grid with the sampled potential kernel,
+ * computed with FFTs on a zero-padded grid of (2.gridSize)^3 points: the boundary conditions are isolated (open
+ * space) and not periodic. The accelerations are computed on the grid with 4th-order centered differences and
+ * interpolated back with the same assignment scheme (no self-force).
+ *
+ * The grid follows the bodies: the box is only updated (and the kernel transformed again) when a body leaves it or
+ * when the bodies occupy less than half of it.
+ *
+ * The mass assignment is parallel without atomics: the bodies are sorted by x-slab and the slabs that are at least
+ * 2 (CIC) or 3 (TSC) nodes apart are processed concurrently.
+ */
+template <typename T> class ParticleMesh {
+  public:
+    /*!
+     *  \brief Potential created by a unit mass.
+     *
+     *  \param r : Distance to the mass.
+     *  \param h : Grid spacing.
+     *
+     *  \return The potential (positive, the accelerations are its gradient).
+     */
+    using kernel_t = std::function<double(const double r, const double h)>;
+
+  protected:
+    const unsigned long gridSize;                /*!< Number of nodes per dimension. */
+    const int support;                           /*!< Number of nodes per dimension touched by a body (2 or 3). */
+    const kernel_t kernel;                       /*!< Potential of a unit mass. */
+    const FFT3D fft;                             /*!< FFT on the zero-padded grid. */
+    double h;                                    /*!< Grid spacing. */
+    double ox, oy, oz;                           /*!< Position of the node (0, 0, 0). */
+    std::vector<double> green;                   /*!< Transformed kernel, real (zero-padded grid). */
+    std::vector<std::complex<double>> potential; /*!< Masses, then potential (zero-padded grid). */
+    std::vector<double> gax, gay, gaz;           /*!< Accelerations on the grid. */
+    std::vector<unsigned long> slabStart;        /*!< First body of each x-slab in `slabBodies`. */
+    std::vector<unsigned long> slabBodies;       /*!< Bodies sorted by x-slab. */
+    std::vector<unsigned long> bodySlab;         /*!< X-slab of each body. */
+
+  public:
+    /*!
+     *  \brief Constructor.
+     *
+     *  \param gridSize   : Number of nodes per dimension (power of 2, at least 16).
+     *  \param assignment : "cic" or "tsc".
+     *  \param kernel     : Potential of a unit mass.
+     */
+    ParticleMesh(const unsigned long gridSize, const std::string &assignment, const kernel_t &kernel);
+    virtual ~ParticleMesh() = default;
+
+    /*!
+     *  \brief Add the mesh accelerations of the bodies.
+     *
+     *  \param qx : Array of positions x.
+     *  \param qy : Array of positions y.
+     *  \param qz : Array of positions z.
+     *  \param gm : Array of masses multiplied by G.
+     *  \param n  : Number of bodies.
+     *  \param ax : Array of accelerations x (accumulated).
+     *  \param ay : Array of accelerations y (accumulated).
+     *  \param az : Array of accelerations z (accumulated).
+     */
+    void computeAccelerations(const T *qx, const T *qy, const T *qz, const T *gm, const unsigned long n, T *ax, T *ay,
+                              T *az);
+
+    /*!
+     *  \brief Grid spacing getter.
+     *
+     *  \return The current grid spacing.
+     */
+    double getSpacing() const;
+
+    /*!
+     *  \brief Allocated bytes getter.
+     *
+     *  \return The number of bytes allocated by the grids.
+     */
+    float getAllocatedBytes() const;
+
+  protected:
+    inline int weights(const double s, double w[3]) const;
+    void updateBox(const T *qx, const T *qy, const T *qz, const unsigned long n);
+    void assign(const T *qx, const T *qy, const T *qz, const T *gm, const unsigned long n);
+    void computeGridAccelerations();
+    void interpolate(const T *qx, const T *qy, const T *qz, const unsigned long n, T *ax, T *ay, T *az) const;
+};
+
+#endif /* PARTICLE_MESH_HPP_ */
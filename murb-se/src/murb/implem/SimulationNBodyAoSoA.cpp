@@ -0,0 +1,79 @@
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "ImplemRegistry.hpp"
+#include "KernelsSIMD.hpp"
+#include "SimulationNBodyAoSoA.hpp"
+
+template <typename T>
+SimulationNBodyAoSoA<T>::SimulationNBodyAoSoA(const unsigned long nBodies, const std::string &scheme, const T soft,
+                                              const unsigned long randInit)
+    : SimulationNBodyInterface<T>(nBodies, scheme, soft, randInit)
+{
+    this->resizeBuffers();
+}
+
+template <typename T> void SimulationNBodyAoSoA<T>::resizeBuffers()
+{
+    this->flopsPerIte = 20.f * (float)this->getBodies().getN() * (float)this->getBodies().getN();
+    this->accelerations.a.resize((this->getBodies().getN() + this->getBodies().getPadding()) * 3);
+}
+
+template <typename T> void SimulationNBodyAoSoA<T>::computeBodiesAcceleration()
+{
+    constexpr int N = mipp::N<T>();
+    const dataAoSoA_t<T> &d = this->getBodies().getDataAoSoA();
+    assert(d.blockSize == N);
+
+    const unsigned long nBlocks = (this->getBodies().getN() + this->getBodies().getPadding()) / N;
+    const mipp::Reg<T> rSoftSquared = this->soft * this->soft;
+    const mipp::Reg<T> rG = this->G;
+
+    // flops = n² * 20
+    for (unsigned long iBlock = 0; iBlock < nBlocks; iBlock++) {
+        const T *hi = &d.hot[iBlock * 4 * N];
+        const mipp::Reg<T> rqix = &hi[0 * N];
+        const mipp::Reg<T> rqiy = &hi[1 * N];
+        const mipp::Reg<T> rqiz = &hi[2 * N];
+
+        mipp::Reg<T> raix = (T)0, raiy = (T)0, raiz = (T)0;
+
+        // a single stream: the j-blocks (the padding bodies have a null mass)
+        for (unsigned long jBlock = 0; jBlock < nBlocks; jBlock++) {
+            const T *hj = &d.hot[jBlock * 4 * N];
+            computeAccelerationsSIMD<T>(rqix, rqiy, rqiz, &hj[0 * N], &hj[1 * N], &hj[2 * N], &hj[3 * N], N,
+                                        rSoftSquared, raix, raiy, raiz);
+        }
+
+        T *ai = &this->accelerations.a[iBlock * 3 * N];
+        (raix * rG).store(&ai[0 * N]);
+        (raiy * rG).store(&ai[1 * N]);
+        (raiz * rG).store(&ai[2 * N]);
+    }
+}
+
+template <typename T> void SimulationNBodyAoSoA<T>::computeOneIteration()
+{
+    this->resizeBuffers();
+    this->computeBodiesAcceleration();
+    // time integration (SIMD, on the blocks)
+    this->bodies.updatePositionsAndVelocities(this->accelerations, this->dt);
+}
+
+// ==================================================================================== explicit template instantiation
+template class SimulationNBodyAoSoA<double>;
+template class SimulationNBodyAoSoA<float>;
+// ==================================================================================== explicit template instantiation
+
+// ======================================================================================================== registration
+template <typename T> static SimulationNBodyInterface<T> *createAoSoA(const implemParams_t &p)
+{
+    return new SimulationNBodyAoSoA<T>(p.nBodies, p.scheme, p.soft);
+}
+
+static const implemCaps_t capsAoSoA = {"direct sum vectorized with MIPP on tiles", "AoSoA", false, true, {}, false};
+REGISTER_IMPLEM(aosoa, "cpu+simd+aosoa", capsAoSoA, createAoSoA);
@@ -0,0 +1,32 @@
+#ifndef SIMULATION_N_BODY_AOSOA_HPP_
+#define SIMULATION_N_BODY_AOSOA_HPP_
+
+#include <string>
+
+#include "core/SimulationNBodyInterface.hpp"
+
+/*!
+ * \class  SimulationNBodyAoSoA
+ * \brief  Direct sum vectorized with MIPP on the AoSoA (tiled) data layout.
+ *
+ * \tparam T : Floating-point type (`float` or `double`).
+ *
+ * The hot loop streams only the `hot` blocks of the bodies (positions and masses contiguous per block) and the time
+ * integration is vectorized on the blocks.
+ */
+template <typename T> class SimulationNBodyAoSoA : public SimulationNBodyInterface<T> {
+  protected:
+    accAoSoA_t<T> accelerations; /*!< Array of blocks of body accelerations. */
+
+  public:
+    SimulationNBodyAoSoA(const unsigned long nBodies, const std::string &scheme = "galaxy", const T soft = 0.035,
+                         const unsigned long randInit = 0);
+    virtual ~SimulationNBodyAoSoA() = default;
+    virtual void computeOneIteration();
+
+  protected:
+    void resizeBuffers();
+    void computeBodiesAcceleration();
+};
+
+#endif /* SIMULATION_N_BODY_AOSOA_HPP_ */
@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <string>
+
+#include "ImplemRegistry.hpp"
+#include "KernelsISA.hpp"
+#include "SimulationNBodyBarnesHut.hpp"
+
+template <typename T>
+SimulationNBodyBarnesHut<T>::SimulationNBodyBarnesHut(const unsigned long nBodies, const std::string &scheme,
+                                                      const T soft, const unsigned long randInit, const T theta,
+                                                      const unsigned long groupSize, const unsigned long rebuildPeriod)
+    : SimulationNBodyInterface<T>(nBodies, scheme, soft, randInit), theta(theta), rebuildPeriod(rebuildPeriod),
+      nItesSinceRebuild(0), treeLayoutVersion(0), tree(groupSize)
+{
+    assert(theta > 0 && theta < 1);
+    assert(rebuildPeriod > 0);
+
+    const unsigned long n = this->getBodies().getN();
+    this->flopsPerIte = 0.f;
+    this->resizeBuffers();
+
+    // sorted bodies and keys, the size of the tree depends on the distribution (about 2 n / groupSize nodes)
+    this->allocatedBytes += n * (sizeof(T) * 8 + sizeof(uint64_t) + sizeof(unsigned long));
+    this->allocatedBytes += (2.f * n / groupSize) * (sizeof(octreeNode_t) + sizeof(nodeHot_t<T>));
+}
+
+template <typename T> void SimulationNBodyBarnesHut<T>::resizeBuffers()
+{
+    const unsigned long n = this->getBodies().getN();
+    this->gm.resize(n);
+    this->sax.resize(n);
+    this->say.resize(n);
+    this->saz.resize(n);
+    this->accelerations.ax.resize(n + this->getBodies().getPadding());
+    this->accelerations.ay.resize(n + this->getBodies().getPadding());
+    this->accelerations.az.resize(n + this->getBodies().getPadding());
+}
+
+template <typename T> void SimulationNBodyBarnesHut<T>::updateTree()
+{
+    const dataSoA_t<T> &d = this->getBodies().getDataSoA();
+    const std::vector<dataHot_t<T>> &h = this->getBodies().getDataHot();
+    const unsigned long n = this->getBodies().getN();
+
+    for (unsigned long i = 0; i < n; i++)
+        this->gm[i] = h[i].gm;
+
+    // the tree is refitted between two rebuilds, unless the bodies have been moved in memory
+    const unsigned long layoutVersion = this->getBodies().getLayoutVersion();
+    if (this->nItesSinceRebuild == 0 || this->nItesSinceRebuild >= this->rebuildPeriod ||
+        layoutVersion != this->treeLayoutVersion) {
+        this->tree.build(d.qx.data(), d.qy.data(), d.qz.data(), this->gm.data(), n);
+        this->nItesSinceRebuild = 0;
+        this->treeLayoutVersion = layoutVersion;
+    }
+    else
+        this->tree.refit(d.qx.data(), d.qy.data(), d.qz.data(), this->gm.data());
+    this->nItesSinceRebuild++;
+
+    // packed moments in the floating-point type of the kernels
+    const std::vector<octreeNode_t> &nodes = this->tree.getNodes();
+    this->nodesHot.resize(nodes.size());
+#pragma omp parallel for schedule(static)
+    for (unsigned long i = 0; i < nodes.size(); i++) {
+        const octreeNode_t &node = nodes[i];
+        nodeHot_t<T> &hot = this->nodesHot[i];
+        hot.cx = node.cx;
+        hot.cy = node.cy;
+        hot.cz = node.cz;
+        hot.gm = node.gm;
+        const double scale = node.gm > 0 ? 3. / node.gm : 0.;
+        for (int k = 0; k < 6; k++)
+            hot.q[k] = scale * node.q[k];
+        hot.tq = 0.5 * scale * (node.q[0] + node.q[3] + node.q[5]);
+    }
+}
+
+template <typename T>
+void SimulationNBodyBarnesHut<T>::buildInteractionLists(const unsigned long group, std::vector<unsigned long> &stack,
+                                                        std::vector<nodeHot_t<T>> &nodeList, std::vector<T> &jqx,
+                                                        std::vector<T> &jqy, std::vector<T> &jqz,
+                                                        std::vector<T> &jgm) const
+{
+    const std::vector<octreeNode_t> &nodes = this->tree.getNodes();
+    const T *sqx = this->tree.getSortedQx().data();
+    const T *sqy = this->tree.getSortedQy().data();
+    const T *sqz = this->tree.getSortedQz().data();
+    const T *sgm = this->tree.getSortedGm().data();
+    const octreeNode_t &g = nodes[group];
+
+    nodeList.clear();
+    jqx.clear();
+    jqy.clear();
+    jqz.clear();
+    jgm.clear();
+    stack.assign(1, 0);
+    while (!stack.empty()) {
+        const unsigned long b = stack.back();
+        stack.pop_back();
+        const octreeNode_t &nb = nodes[b];
+
+        const double dx = nb.cx - g.cx, dy = nb.cy - g.cy, dz = nb.cz - g.cz;
+        const double dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+        if (nb.radius < this->theta * (dist - g.radius))
+            nodeList.push_back(this->nodesHot[b]);
+        else if (nb.nChildren == 0) {
+            jqx.insert(jqx.end(), sqx + nb.begin, sqx + nb.end);
+            jqy.insert(jqy.end(), sqy + nb.begin, sqy + nb.end);
+            jqz.insert(jqz.end(), sqz + nb.begin, sqz + nb.end);
+            jgm.insert(jgm.end(), sgm + nb.begin, sgm + nb.end);
+        }
+        else
+            for (unsigned char c = 0; c < nb.nChildren; c++)
+                stack.push_back(nb.firstChild + c);
+    }
+}
+
+template <typename T> void SimulationNBodyBarnesHut<T>::computeBodiesAcceleration()
+{
+    const unsigned long n = this->getBodies().getN();
+
+    this->updateTree();
+    const std::vector<octreeNode_t> &nodes = this->tree.getNodes();
+    const std::vector<unsigned long> &leaves = this->tree.getLeaves();
+    const std::vector<unsigned long> &perm = this->tree.getPermutation();
+    const T *sqx = this->tree.getSortedQx().data();
+    const T *sqy = this->tree.getSortedQy().data();
+    const T *sqz = this->tree.getSortedQz().data();
+    const T softSquared = this->soft * this->soft;
+
+    double nBodyInteractions = 0, nNodeInteractions = 0;
+#pragma omp parallel reduction(+ : nBodyInteractions, nNodeInteractions)
+    {
+        // the interaction lists of a group are reused by the next group of the thread
+        std::vector<unsigned long> stack;
+        std::vector<nodeHot_t<T>> nodeList;
+        std::vector<T> jqx, jqy, jqz, jgm;
+#pragma omp for schedule(dynamic)
+        for (unsigned long l = 0; l < leaves.size(); l++) {
+            const octreeNode_t &g = nodes[leaves[l]];
+            const unsigned long ni = g.end - g.begin;
+            this->buildInteractionLists(leaves[l], stack, nodeList, jqx, jqy, jqz, jgm);
+
+            std::fill(&this->sax[g.begin], &this->sax[g.begin] + ni, (T)0);
+            std::fill(&this->say[g.begin], &this->say[g.begin] + ni, (T)0);
+            std::fill(&this->saz[g.begin], &this->saz[g.begin] + ni, (T)0);
+            computeAccelerationsISA<T>(&sqx[g.begin], &sqy[g.begin], &sqz[g.begin], ni, jqx.data(), jqy.data(),
+                                       jqz.data(), jgm.data(), jqx.size(), softSquared, &this->sax[g.begin],
+                                       &this->say[g.begin], &this->saz[g.begin]);
+            computeNodeAccelerationsISA<T>(&sqx[g.begin], &sqy[g.begin], &sqz[g.begin], ni, nodeList.data(),
+                                           nodeList.size(), softSquared, &this->sax[g.begin], &this->say[g.begin],
+                                           &this->saz[g.begin]);
+            nBodyInteractions += (double)ni * jqx.size();
+            nNodeInteractions += (double)ni * nodeList.size();
+        }
+    }
+    this->flopsPerIte = 20.f * nBodyInteractions + 56.f * nNodeInteractions;
+
+    // back to the order of the bodies
+#pragma omp parallel for schedule(static)
+    for (unsigned long i = 0; i < n; i++) {
+        this->accelerations.ax[perm[i]] = this->sax[i];
+        this->accelerations.ay[perm[i]] = this->say[i];
+        this->accelerations.az[perm[i]] = this->saz[i];
+    }
+}
+
+template <typename T> void SimulationNBodyBarnesHut<T>::computeOneIteration()
+{
+    this->resizeBuffers();
+    this->computeBodiesAcceleration();
+    // time integration
+    this->bodies.updatePositionsAndVelocities(this->accelerations, this->dt);
+}
+
+// ==================================================================================== explicit template instantiation
+template class SimulationNBodyBarnesHut<double>;
+template class SimulationNBodyBarnesHut<float>;
+// ==================================================================================== explicit template instantiation
+
+// ======================================================================================================== registration
+template <typename T> static SimulationNBodyInterface<T> *createBarnesHut(const implemParams_t &p)
+{
+    return new SimulationNBodyBarnesHut<T>(p.nBodies, p.scheme, p.soft, 0, p.theta, p.leafSize ? p.leafSize : 32,
+                                           p.rebuildPeriod);
+}
+
+static const implemCaps_t capsBarnesHut = {"Barnes-Hut group walk, see --theta and --rebuild", "hot", true, false,
+                                           {"threads", "leaf"}, true};
+REGISTER_IMPLEM(barnesHut, "cpu+bh", capsBarnesHut, createBarnesHut);
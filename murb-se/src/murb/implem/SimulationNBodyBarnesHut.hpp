@@ -0,0 +1,53 @@
+#ifndef SIMULATION_N_BODY_BARNES_HUT_HPP_
+#define SIMULATION_N_BODY_BARNES_HUT_HPP_
+
+#include <string>
+#include <vector>
+
+#include "core/SimulationNBodyInterface.hpp"
+#include "utils/Octree.hpp"
+
+/*!
+ * \class  SimulationNBodyBarnesHut
+ * \brief  Barnes-Hut tree code with a group walk: one interaction list per leaf, evaluated with SIMD kernels.
+ *
+ * \tparam T : Floating-point type.
+ *
+ * Instead of walking the tree once per body, the bodies of a leaf (a group) walk it together: a node is accepted if
+ * r_node < theta . (d - r_group), d being the distance between the centers of mass, which is the usual opening
+ * criterion for every body of the group. The accepted nodes are appended to the node list of the group (monopole +
+ * quadrupole), the bodies of the opened leaves to its body list. Both lists are contiguous and shared by the bodies
+ * of the group, they are evaluated with the SIMD direct-sum kernel and the SIMD node kernel, so the time is spent in
+ * the kernels and not in the walk.
+ *
+ * The tree is rebuilt every `rebuildPeriod` iterations and only refitted in between.
+ */
+template <typename T> class SimulationNBodyBarnesHut : public SimulationNBodyInterface<T> {
+  protected:
+    const T theta;                       /*!< Opening angle. */
+    const unsigned long rebuildPeriod;   /*!< Number of iterations between two rebuilds of the tree. */
+    unsigned long nItesSinceRebuild;     /*!< Number of iterations since the last rebuild. */
+    unsigned long treeLayoutVersion;     /*!< Layout version of the bodies at the last rebuild. */
+    Octree<T> tree;                      /*!< Octree of the bodies, a leaf is a group. */
+    std::vector<nodeHot_t<T>> nodesHot;  /*!< Packed moments of the nodes. */
+    std::vector<T> gm;                   /*!< Array of masses multiplied by G. */
+    std::vector<T> sax, say, saz;        /*!< Sorted accelerations. */
+    accSoA_t<T> accelerations;           /*!< Structure of arrays of body accelerations. */
+
+  public:
+    SimulationNBodyBarnesHut(const unsigned long nBodies, const std::string &scheme = "galaxy", const T soft = 0.035,
+                             const unsigned long randInit = 0, const T theta = 0.5, const unsigned long groupSize = 32,
+                             const unsigned long rebuildPeriod = 1);
+    virtual ~SimulationNBodyBarnesHut() = default;
+    virtual void computeOneIteration();
+
+  protected:
+    void resizeBuffers();
+    void computeBodiesAcceleration();
+    void updateTree();
+    void buildInteractionLists(const unsigned long group, std::vector<unsigned long> &stack,
+                               std::vector<nodeHot_t<T>> &nodeList, std::vector<T> &jqx, std::vector<T> &jqy,
+                               std::vector<T> &jqz, std::vector<T> &jgm) const;
+};
+
+#endif /* SIMULATION_N_BODY_BARNES_HUT_HPP_ */
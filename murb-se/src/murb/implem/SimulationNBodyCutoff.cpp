@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <string>
+
+#include "ImplemRegistry.hpp"
+#include "KernelsISA.hpp"
+#include "SimulationNBodyCutoff.hpp"
+#include "utils/Morton.hpp"
+#include "utils/TaskScheduler.hpp"
+
+/* bodies and cells per task of the loops submitted to the task scheduler */
+static constexpr unsigned long grainBodies = 4096;
+static constexpr unsigned long grainCells = 16;
+
+template <typename T>
+SimulationNBodyCutoff<T>::SimulationNBodyCutoff(const unsigned long nBodies, const std::string &scheme, const T soft,
+                                                const unsigned long randInit, const T cutoff, const T skin)
+    : SimulationNBodyInterface<T>(nBodies, scheme, soft, randInit), cutoff(cutoff), skin(skin), nItesSinceRebuild(0),
+      gridLayoutVersion(0), nCells{1, 1, 1}
+{
+    assert(cutoff > 0);
+    assert(skin >= 0);
+
+    const unsigned long n = this->getBodies().getN();
+    this->flopsPerIte = 0.f;
+    this->resizeBuffers();
+    this->allocatedBytes += n * (11 * sizeof(T) + sizeof(uint64_t) + sizeof(unsigned long));
+}
+
+template <typename T> void SimulationNBodyCutoff<T>::resizeBuffers()
+{
+    const unsigned long n = this->getBodies().getN();
+    this->accelerations.ax.resize(n + this->getBodies().getPadding());
+    this->accelerations.ay.resize(n + this->getBodies().getPadding());
+    this->accelerations.az.resize(n + this->getBodies().getPadding());
+    this->gm.resize(n);
+    this->qx0.resize(n);
+    this->qy0.resize(n);
+    this->qz0.resize(n);
+    this->perm.resize(n);
+    this->sqx.resize(n);
+    this->sqy.resize(n);
+    this->sqz.resize(n);
+    this->sgm.resize(n);
+    this->sax.resize(n);
+    this->say.resize(n);
+    this->saz.resize(n);
+}
+
+template <typename T> bool SimulationNBodyCutoff<T>::needRebuild() const
+{
+    if (this->nItesSinceRebuild == 0 || this->getBodies().getLayoutVersion() != this->gridLayoutVersion)
+        return true;
+
+    // largest displacement since the last build
+    const dataSoA_t<T> &d = this->getBodies().getDataSoA();
+    const unsigned long n = this->getBodies().getN();
+    std::vector<T> maxDispsSquared((n + grainBodies - 1) / grainBodies, 0);
+    TaskScheduler::get().parallelFor(0, n, grainBodies, [&](unsigned long begin, unsigned long end) {
+        T maxDispSquared = 0;
+        for (unsigned long i = begin; i < end; i++) {
+            const T dx = d.qx[i] - this->qx0[i], dy = d.qy[i] - this->qy0[i], dz = d.qz[i] - this->qz0[i];
+            maxDispSquared = std::max(maxDispSquared, dx * dx + dy * dy + dz * dz);
+        }
+        maxDispsSquared[begin / grainBodies] = maxDispSquared;
+    });
+    const T maxDispSquared = *std::max_element(maxDispsSquared.begin(), maxDispsSquared.end());
+    return 4 * maxDispSquared > this->skin * this->skin;
+}
+
+template <typename T> void SimulationNBodyCutoff<T>::buildCells()
+{
+    const dataSoA_t<T> &d = this->getBodies().getDataSoA();
+    const unsigned long n = this->getBodies().getN();
+    const T *q[3] = {d.qx.data(), d.qy.data(), d.qz.data()};
+
+    // the cells are at least `cutoff` + `skin` wide so the interactions within the cutoff are between neighbor cells
+    const unsigned long maxCells = 128;
+    const T cellSize = this->cutoff + this->skin;
+    T qMin[3], invWidth[3];
+    std::vector<T> mis((n + grainBodies - 1) / grainBodies), mas(mis.size());
+    for (int a = 0; a < 3; a++) {
+        TaskScheduler::get().parallelFor(0, n, grainBodies, [&](unsigned long begin, unsigned long end) {
+            T mi = std::numeric_limits<T>::max(), ma = std::numeric_limits<T>::lowest();
+            for (unsigned long i = begin; i < end; i++) {
+                mi = std::min(mi, q[a][i]);
+                ma = std::max(ma, q[a][i]);
+            }
+            mis[begin / grainBodies] = mi;
+            mas[begin / grainBodies] = ma;
+        });
+        const T mi = *std::min_element(mis.begin(), mis.end());
+        const T ma = *std::max_element(mas.begin(), mas.end());
+        const T extent = ma - mi;
+        const T nc = std::floor(extent / cellSize);
+        this->nCells[a] = nc < 1 ? 1 : (nc > maxCells ? maxCells : (unsigned long)nc);
+        qMin[a] = mi;
+        invWidth[a] = extent > 0 ? this->nCells[a] / extent : 0;
+    }
+
+    // parallel sort of the bodies by cell (the keys have at most 21 bits: 3 passes of the radix sort)
+    this->cellKeys.resize(n);
+    TaskScheduler::get().parallelFor(0, n, grainBodies, [&](unsigned long begin, unsigned long end) {
+        for (unsigned long i = begin; i < end; i++) {
+            unsigned long c[3];
+            for (int a = 0; a < 3; a++)
+                c[a] = std::min((unsigned long)((q[a][i] - qMin[a]) * invWidth[a]), this->nCells[a] - 1);
+            this->cellKeys[i] = (c[0] * this->nCells[1] + c[1]) * this->nCells[2] + c[2];
+            this->qx0[i] = d.qx[i];
+            this->qy0[i] = d.qy[i];
+            this->qz0[i] = d.qz[i];
+        }
+    });
+    std::iota(this->perm.begin(), this->perm.end(), 0);
+    radixSortPairs(this->cellKeys, this->perm);
+
+    // first body of each cell: the cells between two consecutive keys start at the second one
+    const unsigned long nc = this->nCells[0] * this->nCells[1] * this->nCells[2];
+    const uint64_t *keys = this->cellKeys.data();
+    this->cellStart.resize(nc + 1);
+    TaskScheduler::get().parallelFor(0, n + 1, grainBodies, [&](unsigned long begin, unsigned long end) {
+        for (unsigned long i = begin; i < end; i++) {
+            const uint64_t first = (i == 0) ? 0 : keys[i - 1] + 1;
+            const uint64_t last = (i == n) ? nc : keys[i];
+            for (uint64_t c = first; c <= last; c++)
+                this->cellStart[c] = i;
+        }
+    });
+
+    this->nItesSinceRebuild = 0;
+    this->gridLayoutVersion = this->getBodies().getLayoutVersion();
+}
+
+template <typename T> void SimulationNBodyCutoff<T>::computeBodiesAcceleration()
+{
+    const dataSoA_t<T> &d = this->getBodies().getDataSoA();
+    const std::vector<dataHot_t<T>> &h = this->getBodies().getDataHot();
+    const unsigned long n = this->getBodies().getN();
+
+    if (this->needRebuild())
+        this->buildCells();
+    this->nItesSinceRebuild++;
+
+    // the bodies keep their cell between two builds, only their positions are updated
+    TaskScheduler::get().parallelFor(0, n, grainBodies, [&](unsigned long begin, unsigned long end) {
+        for (unsigned long i = begin; i < end; i++) {
+            this->sqx[i] = d.qx[this->perm[i]];
+            this->sqy[i] = d.qy[this->perm[i]];
+            this->sqz[i] = d.qz[this->perm[i]];
+            this->sgm[i] = h[this->perm[i]].gm;
+        }
+    });
+
+    const long ncx = this->nCells[0], ncy = this->nCells[1], ncz = this->nCells[2];
+    const T softSquared = this->soft * this->soft;
+    // one count of interactions per task: the cells have very different costs, the idle threads steal the tasks
+    const long nc = ncx * ncy * ncz;
+    std::vector<double> nInteractionsTasks((nc + grainCells - 1) / grainCells, 0);
+    TaskScheduler::get().parallelFor(0, nc, grainCells, [&](unsigned long cBegin, unsigned long cEnd) {
+        double nInteractionsTask = 0;
+        for (long c = cBegin; c < (long)cEnd; c++) {
+            const unsigned long begin = this->cellStart[c];
+            const unsigned long ni = this->cellStart[c + 1] - begin;
+            if (ni == 0)
+                continue;
+            std::fill(&this->sax[begin], &this->sax[begin] + ni, (T)0);
+            std::fill(&this->say[begin], &this->say[begin] + ni, (T)0);
+            std::fill(&this->saz[begin], &this->saz[begin] + ni, (T)0);
+
+            const long cx = c / (ncy * ncz), cy = (c / ncz) % ncy, cz = c % ncz;
+            for (long x = std::max(cx - 1, 0l); x <= std::min(cx + 1, ncx - 1); x++)
+                for (long y = std::max(cy - 1, 0l); y <= std::min(cy + 1, ncy - 1); y++) {
+                    // the cells (x, y, cz - 1) to (x, y, cz + 1) are contiguous
+                    const long column = (x * ncy + y) * ncz;
+                    const unsigned long jBegin = this->cellStart[column + std::max(cz - 1, 0l)];
+                    const unsigned long jEnd = this->cellStart[column + std::min(cz + 1, ncz - 1) + 1];
+                    if (jEnd == jBegin)
+                        continue;
+                    computeCutoffAccelerationsISA<T>(&this->sqx[begin], &this->sqy[begin], &this->sqz[begin], ni,
+                                                     &this->sqx[jBegin], &this->sqy[jBegin], &this->sqz[jBegin],
+                                                     &this->sgm[jBegin], jEnd - jBegin, softSquared, this->cutoff,
+                                                     &this->sax[begin], &this->say[begin], &this->saz[begin]);
+                    nInteractionsTask += (double)ni * (jEnd - jBegin);
+                }
+        }
+        nInteractionsTasks[cBegin / grainCells] = nInteractionsTask;
+    });
+    const double nInteractions = std::accumulate(nInteractionsTasks.begin(), nInteractionsTasks.end(), 0.);
+    this->flopsPerIte = 20.f * nInteractions;
+
+    // back to the order of the bodies
+    TaskScheduler::get().parallelFor(0, n, grainBodies, [&](unsigned long begin, unsigned long end) {
+        for (unsigned long i = begin; i < end; i++) {
+            this->accelerations.ax[this->perm[i]] = this->sax[i];
+            this->accelerations.ay[this->perm[i]] = this->say[i];
+            this->accelerations.az[this->perm[i]] = this->saz[i];
+        }
+    });
+}
+
+template <typename T> void SimulationNBodyCutoff<T>::computeOneIteration()
+{
+    this->resizeBuffers();
+    this->computeBodiesAcceleration();
+    // time integration
+    this->bodies.updatePositionsAndVelocities(this->accelerations, this->dt);
+}
+
+// ==================================================================================== explicit template instantiation
+template class SimulationNBodyCutoff<double>;
+template class SimulationNBodyCutoff<float>;
+// ==================================================================================== explicit template instantiation
+
+// ======================================================================================================== registration
+template <typename T> static SimulationNBodyInterface<T> *createCutoff(const implemParams_t &p)
+{
+    // Verlet skin of 10% of the cutoff radius
+    return new SimulationNBodyCutoff<T>(p.nBodies, p.scheme, p.soft, 0, p.cutoff, p.cutoff / 10);
+}
+
+static const implemCaps_t capsCutoff = {"truncated gravity with a cell list, see --cutoff", "hot", true, false,
+                                        {"threads"}, true};
+REGISTER_IMPLEM(cutoff, "cpu+cutoff", capsCutoff, createCutoff);
@@ -0,0 +1,54 @@
+#ifndef SIMULATION_N_BODY_CUTOFF_HPP_
+#define SIMULATION_N_BODY_CUTOFF_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/SimulationNBodyInterface.hpp"
+
+/*!
+ * \class  SimulationNBodyCutoff
+ * \brief  Truncated gravity: only the pairs closer than a cutoff radius interact, found with a uniform cell list.
+ *
+ * \tparam T : Floating-point type.
+ *
+ * The bodies are binned into a uniform grid of cells at least `cutoff` + `skin` wide (parallel radix sort of the cell
+ * indices, the cells along z of a column are contiguous) and each cell only interacts with the 27 cells around it:
+ * 9 ranges of bodies evaluated with the SIMD direct-sum kernel, the pairs beyond the cutoff are masked out. The cost
+ * is O(n) at a fixed density.
+ *
+ * The grid is a Verlet list of cells: it is only rebuilt when a body has moved more than `skin` / 2 since the last
+ * build (or when the bodies have been moved in memory), the cells of the bodies are kept in between. Every pair
+ * closer than the cutoff was then closer than `cutoff` + `skin` at the last build, so it is still found.
+ */
+template <typename T> class SimulationNBodyCutoff : public SimulationNBodyInterface<T> {
+  protected:
+    const T cutoff;                       /*!< Cutoff radius. */
+    const T skin;                         /*!< Verlet skin: extra width of the cells. */
+    unsigned long nItesSinceRebuild;      /*!< Number of iterations since the last build of the grid. */
+    unsigned long gridLayoutVersion;      /*!< Layout version of the bodies at the last build. */
+    accSoA_t<T> accelerations;            /*!< Structure of arrays of body accelerations. */
+    std::vector<T> gm;                    /*!< Array of masses multiplied by G. */
+    std::vector<T> qx0, qy0, qz0;         /*!< Positions of the bodies at the last build. */
+    unsigned long nCells[3];              /*!< Number of cells in each dimension. */
+    std::vector<unsigned long> cellStart; /*!< First (sorted) body of each cell, the z dimension is contiguous. */
+    std::vector<uint64_t> cellKeys;       /*!< Sorted cell indices of the bodies. */
+    std::vector<unsigned long> perm;      /*!< Original index of each sorted body. */
+    std::vector<T> sqx, sqy, sqz, sgm;    /*!< Positions and G.masses sorted by cell. */
+    std::vector<T> sax, say, saz;         /*!< Accelerations sorted by cell. */
+
+  public:
+    SimulationNBodyCutoff(const unsigned long nBodies, const std::string &scheme = "galaxy", const T soft = 0.035,
+                          const unsigned long randInit = 0, const T cutoff = 5e7, const T skin = 5e6);
+    virtual ~SimulationNBodyCutoff() = default;
+    virtual void computeOneIteration();
+
+  protected:
+    void resizeBuffers();
+    void computeBodiesAcceleration();
+    bool needRebuild() const;
+    void buildCells();
+};
+
+#endif /* SIMULATION_N_BODY_CUTOFF_HPP_ */
@@ -0,0 +1,458 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <string>
+
+#include "ImplemRegistry.hpp"
+#include "KernelsISA.hpp"
+#include "SimulationNBodyFMM.hpp"
+
+template <typename T>
+SimulationNBodyFMM<T>::SimulationNBodyFMM(const unsigned long nBodies, const std::string &scheme, const T soft,
+                                          const unsigned long randInit, const int order, const T theta,
+                                          const unsigned long leafSize, const unsigned long rebuildPeriod)
+    : SimulationNBodyInterface<T>(nBodies, scheme, soft, randInit), order(order), theta(theta), leafSize(leafSize),
+      rebuildPeriod(rebuildPeriod), nItesSinceRebuild(0), treeLayoutVersion(0), tree(leafSize)
+{
+    assert(order >= 1);
+    assert(theta > 0 && theta < 1);
+    assert(rebuildPeriod > 0);
+    assert(leafSize > 0);
+
+    // multi-indices sorted by total degree: the coefficients of degree <= L are the first ones
+    const int p1 = this->order + 1;
+    this->mIdx.resize(p1 * p1 * p1, -1);
+    for (int L = 0; L <= this->order; L++)
+        for (int t = L; t >= 0; t--)
+            for (int u = L - t; u >= 0; u--) {
+                const int v = L - t - u;
+                this->mIdx[(t * p1 + u) * p1 + v] = this->mt.size();
+                this->mt.push_back(t);
+                this->mu.push_back(u);
+                this->mv.push_back(v);
+            }
+    this->nCoefs = this->mt.size();
+    this->p2pMax = this->nCoefs * this->nCoefs;
+
+    // M2L: pairs (n, n + k) of each k with |n| + |k| <= order
+    this->mSign.resize(this->nCoefs);
+    this->m2lBegin.push_back(0);
+    for (int k = 0; k < this->nCoefs; k++) {
+        const int Lk = this->mt[k] + this->mu[k] + this->mv[k];
+        this->mSign[k] = (Lk & 1) ? -1. : 1.;
+        for (int n = 0; n < this->nCoefs && this->mt[n] + this->mu[n] + this->mv[n] + Lk <= this->order; n++) {
+            this->m2lN.push_back(n);
+            this->m2lNK.push_back(this->mIdx[((this->mt[k] + this->mt[n]) * p1 + this->mu[k] + this->mu[n]) * p1 +
+                                             this->mv[k] + this->mv[n]]);
+        }
+        this->m2lBegin.push_back(this->m2lN.size());
+    }
+
+    std::vector<double> fact(p1, 1.);
+    for (int i = 1; i < p1; i++)
+        fact[i] = fact[i - 1] * i;
+    this->invFact.resize(this->nCoefs);
+    for (int k = 0; k < this->nCoefs; k++)
+        this->invFact[k] = 1. / (fact[this->mt[k]] * fact[this->mu[k]] * fact[this->mv[k]]);
+
+    const unsigned long n = this->getBodies().getN();
+    this->resizeBuffers();
+
+    // sorted bodies and keys, the size of the tree depends on the distribution (about 2 n / leafSize nodes)
+    this->allocatedBytes += n * (sizeof(T) * 8 + sizeof(uint64_t) + sizeof(unsigned long));
+    this->allocatedBytes += (2.f * n / leafSize) * (sizeof(octreeNode_t) + 2 * this->nCoefs * sizeof(double));
+}
+
+template <typename T> void SimulationNBodyFMM<T>::resizeBuffers()
+{
+    const unsigned long n = this->getBodies().getN();
+    this->gm.resize(n);
+    this->sax.resize(n);
+    this->say.resize(n);
+    this->saz.resize(n);
+    this->accelerations.ax.resize(n + this->getBodies().getPadding());
+    this->accelerations.ay.resize(n + this->getBodies().getPadding());
+    this->accelerations.az.resize(n + this->getBodies().getPadding());
+}
+
+template <typename T> void SimulationNBodyFMM<T>::updateTree()
+{
+    const dataSoA_t<T> &d = this->getBodies().getDataSoA();
+    const std::vector<dataHot_t<T>> &h = this->getBodies().getDataHot();
+    const unsigned long n = this->getBodies().getN();
+
+    for (unsigned long i = 0; i < n; i++)
+        this->gm[i] = h[i].gm;
+
+    // the tree is refitted between two rebuilds, unless the bodies have been moved in memory
+    const unsigned long layoutVersion = this->getBodies().getLayoutVersion();
+    if (this->nItesSinceRebuild == 0 || this->nItesSinceRebuild >= this->rebuildPeriod ||
+        layoutVersion != this->treeLayoutVersion) {
+        this->tree.build(d.qx.data(), d.qy.data(), d.qz.data(), this->gm.data(), n);
+        this->nItesSinceRebuild = 0;
+        this->treeLayoutVersion = layoutVersion;
+    }
+    else
+        this->tree.refit(d.qx.data(), d.qy.data(), d.qz.data(), this->gm.data());
+    this->nItesSinceRebuild++;
+}
+
+template <typename T> void SimulationNBodyFMM<T>::traverse(const unsigned long a, const unsigned long b)
+{
+    const std::vector<octreeNode_t> &nodes = this->tree.getNodes();
+    const octreeNode_t &na = nodes[a];
+    const octreeNode_t &nb = nodes[b];
+
+    const double dx = na.cx - nb.cx, dy = na.cy - nb.cy, dz = na.cz - nb.cz;
+    const double dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+    if (a != b && na.radius + nb.radius < this->theta * dist) {
+        // the direct sum is cheaper than a M2L (about nCoefs² operations) for the small pairs
+        if (na.nChildren == 0 && (na.end - na.begin) * (nb.end - nb.begin) <= this->p2pMax)
+            this->listP2P[a].push_back(b);
+        else
+            this->listM2L[a].push_back(b);
+        return;
+    }
+
+    if (na.nChildren == 0 && nb.nChildren == 0) {
+        this->listP2P[a].push_back(b);
+        return;
+    }
+
+    if (a == b) {
+        for (unsigned char ca = 0; ca < na.nChildren; ca++)
+            for (unsigned char cb = 0; cb < na.nChildren; cb++)
+                this->traverse(na.firstChild + ca, na.firstChild + cb);
+    }
+    // split the biggest node
+    else if (nb.nChildren == 0 || (na.nChildren != 0 && na.radius >= nb.radius)) {
+        for (unsigned char ca = 0; ca < na.nChildren; ca++)
+            this->traverse(na.firstChild + ca, b);
+    }
+    else {
+        for (unsigned char cb = 0; cb < nb.nChildren; cb++)
+            this->traverse(a, nb.firstChild + cb);
+    }
+}
+
+template <typename T>
+void SimulationNBodyFMM<T>::computeKernelDerivatives(const double rx, const double ry, const double rz,
+                                                     const double softSquared, std::vector<double> &R) const
+{
+    // McMurchie-Davidson: R^n_{t+1,u,v} = t.R^{n+1}_{t-1,u,v} + x.R^{n+1}_{t,u,v} with
+    // R^n_{000} = 2^n.f^(n)(s) = (-1)^n.(2n-1)!!.(s + e²)^{-(2n+1)/2} and f(s) = (s + e²)^{-1/2}, s = r²
+    // R[n * nCoefs + k] is R^n of the multi-index k, the derivatives of the kernel are R^0
+    const int p = this->order;
+    const int p1 = p + 1;
+    const double invQ2 = 1. / (rx * rx + ry * ry + rz * rz + softSquared);
+    double r0 = std::sqrt(invQ2);
+    for (int n = 0; n <= p; n++) {
+        R[n * this->nCoefs] = r0;
+        r0 *= -(2 * n + 1) * invQ2;
+    }
+
+    for (int k = 1; k < this->nCoefs; k++) {
+        const int t = this->mt[k], u = this->mu[k], v = this->mv[k];
+        const int L = t + u + v;
+        // lower the first non null index
+        int k1, k2 = -1;
+        double x, c;
+        if (t > 0) {
+            k1 = this->mIdx[((t - 1) * p1 + u) * p1 + v];
+            if (t > 1)
+                k2 = this->mIdx[((t - 2) * p1 + u) * p1 + v];
+            x = rx;
+            c = t - 1;
+        }
+        else if (u > 0) {
+            k1 = this->mIdx[(t * p1 + u - 1) * p1 + v];
+            if (u > 1)
+                k2 = this->mIdx[(t * p1 + u - 2) * p1 + v];
+            x = ry;
+            c = u - 1;
+        }
+        else {
+            k1 = this->mIdx[(t * p1 + u) * p1 + v - 1];
+            if (v > 1)
+                k2 = this->mIdx[(t * p1 + u) * p1 + v - 2];
+            x = rz;
+            c = v - 1;
+        }
+        for (int n = 0; n <= p - L; n++) {
+            double val = x * R[(n + 1) * this->nCoefs + k1];
+            if (k2 >= 0)
+                val += c * R[(n + 1) * this->nCoefs + k2];
+            R[n * this->nCoefs + k] = val;
+        }
+    }
+}
+
+template <typename T> void SimulationNBodyFMM<T>::P2M(const unsigned long iNode)
+{
+    const std::vector<octreeNode_t> &nodes = this->tree.getNodes();
+    const T *sqx = this->tree.getSortedQx().data();
+    const T *sqy = this->tree.getSortedQy().data();
+    const T *sqz = this->tree.getSortedQz().data();
+    const T *sgm = this->tree.getSortedGm().data();
+    const octreeNode_t &node = nodes[iNode];
+    double *M = &this->multipoles[iNode * this->nCoefs];
+    const int p = this->order;
+
+    // M_k = sum_i G.m_i.(q_i - c)^k / k!
+    std::vector<double> px(p + 1), py(p + 1), pz(p + 1);
+    for (unsigned long i = node.begin; i < node.end; i++) {
+        const double dx = sqx[i] - node.cx, dy = sqy[i] - node.cy, dz = sqz[i] - node.cz;
+        px[0] = py[0] = pz[0] = 1.;
+        for (int l = 1; l <= p; l++) {
+            px[l] = px[l - 1] * dx;
+            py[l] = py[l - 1] * dy;
+            pz[l] = pz[l - 1] * dz;
+        }
+        for (int k = 0; k < this->nCoefs; k++)
+            M[k] += sgm[i] * this->invFact[k] * px[this->mt[k]] * py[this->mu[k]] * pz[this->mv[k]];
+    }
+}
+
+template <typename T> void SimulationNBodyFMM<T>::M2M(const unsigned long iNode)
+{
+    const std::vector<octreeNode_t> &nodes = this->tree.getNodes();
+    const octreeNode_t &node = nodes[iNode];
+    double *M = &this->multipoles[iNode * this->nCoefs];
+    const int p = this->order;
+    const int p1 = p + 1;
+
+    // M_k = sum_{j <= k} Mc_j.s^{k-j} / (k-j)!, s = c_child - c_parent
+    std::vector<double> ps(this->nCoefs), px(p1), py(p1), pz(p1);
+    for (unsigned char c = 0; c < node.nChildren; c++) {
+        const unsigned long iChild = node.firstChild + c;
+        const octreeNode_t &child = nodes[iChild];
+        const double *Mc = &this->multipoles[iChild * this->nCoefs];
+        px[0] = py[0] = pz[0] = 1.;
+        for (int l = 1; l <= p; l++) {
+            px[l] = px[l - 1] * (child.cx - node.cx);
+            py[l] = py[l - 1] * (child.cy - node.cy);
+            pz[l] = pz[l - 1] * (child.cz - node.cz);
+        }
+        for (int k = 0; k < this->nCoefs; k++)
+            ps[k] = this->invFact[k] * px[this->mt[k]] * py[this->mu[k]] * pz[this->mv[k]];
+
+        for (int k = 0; k < this->nCoefs; k++) {
+            const int t = this->mt[k], u = this->mu[k], v = this->mv[k];
+            double sum = 0;
+            for (int jt = 0; jt <= t; jt++)
+                for (int ju = 0; ju <= u; ju++)
+                    for (int jv = 0; jv <= v; jv++)
+                        sum += Mc[this->mIdx[(jt * p1 + ju) * p1 + jv]] *
+                               ps[this->mIdx[((t - jt) * p1 + u - ju) * p1 + v - jv]];
+            M[k] += sum;
+        }
+    }
+}
+
+template <typename T>
+void SimulationNBodyFMM<T>::M2L(const unsigned long a, const unsigned long b, std::vector<double> &R)
+{
+    const std::vector<octreeNode_t> &nodes = this->tree.getNodes();
+    const octreeNode_t &na = nodes[a];
+    const octreeNode_t &nb = nodes[b];
+    const double *M = &this->multipoles[b * this->nCoefs];
+    double *L = &this->locals[a * this->nCoefs];
+
+    // L_k = 1/k! sum_{|n| <= p - |k|} (-1)^|n|.M_n.D^{n+k}(c_a - c_b)
+    this->computeKernelDerivatives(na.cx - nb.cx, na.cy - nb.cy, na.cz - nb.cz, (double)this->soft * this->soft, R);
+    double *sM = &R[(this->order + 1) * this->nCoefs];
+    for (int n = 0; n < this->nCoefs; n++)
+        sM[n] = this->mSign[n] * M[n];
+    for (int k = 0; k < this->nCoefs; k++) {
+        double sum = 0;
+        for (int i = this->m2lBegin[k]; i < this->m2lBegin[k + 1]; i++)
+            sum += sM[this->m2lN[i]] * R[this->m2lNK[i]];
+        L[k] += this->invFact[k] * sum;
+    }
+}
+
+template <typename T> void SimulationNBodyFMM<T>::L2L(const unsigned long iNode)
+{
+    const std::vector<octreeNode_t> &nodes = this->tree.getNodes();
+    const octreeNode_t &node = nodes[iNode];
+    const double *L = &this->locals[iNode * this->nCoefs];
+    const int p = this->order;
+    const int p1 = p + 1;
+
+    // Lc_j = sum_{k >= j} L_k.k!/j!.s^{k-j}/(k-j)!, s = c_child - c_parent
+    std::vector<double> ps(this->nCoefs), px(p1), py(p1), pz(p1);
+    for (unsigned char c = 0; c < node.nChildren; c++) {
+        const unsigned long iChild = node.firstChild + c;
+        const octreeNode_t &child = nodes[iChild];
+        double *Lc = &this->locals[iChild * this->nCoefs];
+        px[0] = py[0] = pz[0] = 1.;
+        for (int l = 1; l <= p; l++) {
+            px[l] = px[l - 1] * (child.cx - node.cx);
+            py[l] = py[l - 1] * (child.cy - node.cy);
+            pz[l] = pz[l - 1] * (child.cz - node.cz);
+        }
+        for (int k = 0; k < this->nCoefs; k++)
+            ps[k] = this->invFact[k] * px[this->mt[k]] * py[this->mu[k]] * pz[this->mv[k]];
+
+        for (int j = 0; j < this->nCoefs; j++) {
+            const int jt = this->mt[j], ju = this->mu[j], jv = this->mv[j];
+            double sum = 0;
+            for (int t = jt; t <= p; t++)
+                for (int u = ju; t + u <= p; u++)
+                    for (int v = jv; t + u + v <= p; v++) {
+                        const int k = this->mIdx[(t * p1 + u) * p1 + v];
+                        sum += L[k] / this->invFact[k] * ps[this->mIdx[((t - jt) * p1 + u - ju) * p1 + v - jv]];
+                    }
+            Lc[j] += this->invFact[j] * sum;
+        }
+    }
+}
+
+template <typename T> void SimulationNBodyFMM<T>::L2P(const unsigned long iNode)
+{
+    const std::vector<octreeNode_t> &nodes = this->tree.getNodes();
+    const T *sqx = this->tree.getSortedQx().data();
+    const T *sqy = this->tree.getSortedQy().data();
+    const T *sqz = this->tree.getSortedQz().data();
+    const octreeNode_t &node = nodes[iNode];
+    const double *L = &this->locals[iNode * this->nCoefs];
+    const int p = this->order;
+
+    // a = grad(sum_k L_k.z^k), z = q - c
+    std::vector<double> px(p + 1), py(p + 1), pz(p + 1);
+    for (unsigned long i = node.begin; i < node.end; i++) {
+        const double dx = sqx[i] - node.cx, dy = sqy[i] - node.cy, dz = sqz[i] - node.cz;
+        px[0] = py[0] = pz[0] = 1.;
+        for (int l = 1; l <= p; l++) {
+            px[l] = px[l - 1] * dx;
+            py[l] = py[l - 1] * dy;
+            pz[l] = pz[l - 1] * dz;
+        }
+        double ax = 0, ay = 0, az = 0;
+        for (int k = 1; k < this->nCoefs; k++) {
+            const int t = this->mt[k], u = this->mu[k], v = this->mv[k];
+            if (t > 0)
+                ax += L[k] * t * px[t - 1] * py[u] * pz[v];
+            if (u > 0)
+                ay += L[k] * u * px[t] * py[u - 1] * pz[v];
+            if (v > 0)
+                az += L[k] * v * px[t] * py[u] * pz[v - 1];
+        }
+        this->sax[i] += ax;
+        this->say[i] += ay;
+        this->saz[i] += az;
+    }
+}
+
+template <typename T> void SimulationNBodyFMM<T>::computeBodiesAcceleration()
+{
+    const unsigned long n = this->getBodies().getN();
+
+    this->updateTree();
+    const std::vector<octreeNode_t> &nodes = this->tree.getNodes();
+    const std::vector<unsigned long> &levelStart = this->tree.getLevelStart();
+    const std::vector<unsigned long> &leaves = this->tree.getLeaves();
+    const std::vector<unsigned long> &perm = this->tree.getPermutation();
+    const unsigned long nNodes = nodes.size();
+    const unsigned long nLevels = levelStart.size() - 1;
+
+    // dual tree traversal
+    this->listM2L.assign(nNodes, std::vector<unsigned long>());
+    this->listP2P.assign(nNodes, std::vector<unsigned long>());
+    this->traverse(0, 0);
+
+    this->multipoles.assign(nNodes * this->nCoefs, 0.);
+    this->locals.assign(nNodes * this->nCoefs, 0.);
+
+    // upward pass, one level at a time (the children of a node are on the next level)
+#pragma omp parallel for schedule(dynamic)
+    for (unsigned long l = 0; l < leaves.size(); l++)
+        this->P2M(leaves[l]);
+    for (unsigned long level = nLevels; level-- > 0;) {
+#pragma omp parallel for schedule(dynamic)
+        for (unsigned long iNode = levelStart[level]; iNode < levelStart[level + 1]; iNode++)
+            if (nodes[iNode].nChildren)
+                this->M2M(iNode);
+    }
+
+    // far field
+#pragma omp parallel
+    {
+        // the order + 1 levels of the recurrence of the derivatives and the signed multipole
+        std::vector<double> R((this->order + 2) * this->nCoefs);
+#pragma omp for schedule(dynamic)
+        for (unsigned long a = 0; a < nNodes; a++)
+            for (unsigned long b : this->listM2L[a])
+                this->M2L(a, b, R);
+    }
+
+    // downward pass, one level at a time
+    for (unsigned long level = 0; level < nLevels; level++) {
+#pragma omp parallel for schedule(dynamic)
+        for (unsigned long iNode = levelStart[level]; iNode < levelStart[level + 1]; iNode++)
+            if (nodes[iNode].nChildren)
+                this->L2L(iNode);
+    }
+
+    // near field and evaluation of the local expansions
+    const T *sqx = this->tree.getSortedQx().data();
+    const T *sqy = this->tree.getSortedQy().data();
+    const T *sqz = this->tree.getSortedQz().data();
+    const T *sgm = this->tree.getSortedGm().data();
+    const T softSquared = this->soft * this->soft;
+    double nInteractions = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+ : nInteractions)
+    for (unsigned long l = 0; l < leaves.size(); l++) {
+        const octreeNode_t &na = nodes[leaves[l]];
+        const unsigned long ni = na.end - na.begin;
+        std::fill(&this->sax[na.begin], &this->sax[na.begin] + ni, (T)0);
+        std::fill(&this->say[na.begin], &this->say[na.begin] + ni, (T)0);
+        std::fill(&this->saz[na.begin], &this->saz[na.begin] + ni, (T)0);
+        for (unsigned long b : this->listP2P[leaves[l]]) {
+            const octreeNode_t &nb = nodes[b];
+            const unsigned long nj = nb.end - nb.begin;
+            computeAccelerationsISA<T>(&sqx[na.begin], &sqy[na.begin], &sqz[na.begin], ni, &sqx[nb.begin],
+                                       &sqy[nb.begin], &sqz[nb.begin], &sgm[nb.begin], nj, softSquared,
+                                       &this->sax[na.begin], &this->say[na.begin], &this->saz[na.begin]);
+            nInteractions += (double)ni * nj;
+        }
+        this->L2P(leaves[l]);
+    }
+    this->flopsPerIte = 20.f * nInteractions;
+
+    // back to the order of the bodies
+#pragma omp parallel for schedule(static)
+    for (unsigned long i = 0; i < n; i++) {
+        this->accelerations.ax[perm[i]] = this->sax[i];
+        this->accelerations.ay[perm[i]] = this->say[i];
+        this->accelerations.az[perm[i]] = this->saz[i];
+    }
+}
+
+template <typename T> void SimulationNBodyFMM<T>::computeOneIteration()
+{
+    this->resizeBuffers();
+    this->computeBodiesAcceleration();
+    // time integration
+    this->bodies.updatePositionsAndVelocities(this->accelerations, this->dt);
+}
+
+// ==================================================================================== explicit template instantiation
+template class SimulationNBodyFMM<double>;
+template class SimulationNBodyFMM<float>;
+// ==================================================================================== explicit template instantiation
+
+// ======================================================================================================== registration
+template <typename T> static SimulationNBodyInterface<T> *createFMM(const implemParams_t &p)
+{
+    return new SimulationNBodyFMM<T>(p.nBodies, p.scheme, p.soft, 0, p.order, p.theta, p.leafSize ? p.leafSize : 64,
+                                     p.rebuildPeriod);
+}
+
+static const implemCaps_t capsFMM = {"fast multipole method, see --order, --theta and --rebuild", "hot", true, false,
+                                     {"threads", "leaf"}, true};
+REGISTER_IMPLEM(fmm, "cpu+fmm", capsFMM, createFMM);
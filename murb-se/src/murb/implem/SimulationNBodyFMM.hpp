@@ -0,0 +1,73 @@
+#ifndef SIMULATION_N_BODY_FMM_HPP_
+#define SIMULATION_N_BODY_FMM_HPP_
+
+#include <string>
+#include <vector>
+
+#include "core/SimulationNBodyInterface.hpp"
+#include "utils/Octree.hpp"
+
+/*!
+ * \class  SimulationNBodyFMM
+ * \brief  Fast Multipole Method with Cartesian Taylor expansions and a dual tree traversal.
+ *
+ * \tparam T : Floating-point type of the bodies (the expansions are always computed in `double`).
+ *
+ * The bodies are sorted along a Morton curve and an octree is built with at most `leafSize` bodies per leaf, the
+ * tree is rebuilt every `rebuildPeriod` iterations and only refitted (same topology, new moments) in between. The
+ * potential of the softened kernel 1 / (r² + e²)^{1/2} is expanded up to the total degree `order` (the forces up to
+ * `order` - 1): multipoles around the centers of mass (P2M, M2M), conversion into local expansions
+ * (M2L) for the pairs of nodes that satisfy (r_a + r_b) < theta . d_ab, then L2L and L2P. The derivatives of the
+ * softened kernel are computed with the McMurchie-Davidson recurrence. The near field (pairs of leaves that are not
+ * well separated, and the well separated pairs that are cheaper to compute directly than with a M2L) is computed with
+ * the SIMD direct-sum kernel.
+ *
+ * Only the near-field interactions are counted in the flops.
+ */
+template <typename T> class SimulationNBodyFMM : public SimulationNBodyInterface<T> {
+  protected:
+    const int order;                                  /*!< Expansion order (total degree of the potential). */
+    const T theta;                                    /*!< Multipole acceptance criterion (opening angle). */
+    const unsigned long leafSize;                     /*!< Maximum number of bodies per leaf. */
+    int nCoefs;                                       /*!< Number of coefficients per expansion. */
+    unsigned long p2pMax;                             /*!< Max. number of interactions of a P2P instead of a M2L. */
+    std::vector<int> mt, mu, mv;                      /*!< Multi-index (t, u, v) of each coefficient. */
+    std::vector<int> mIdx;                            /*!< Coefficient index of (t, u, v), -1 if t + u + v > order. */
+    std::vector<double> invFact;                      /*!< 1 / t!.u!.v! of each coefficient. */
+    std::vector<double> mSign;                        /*!< (-1)^(t + u + v) of each coefficient. */
+    std::vector<int> m2lBegin;                        /*!< First M2L pair of each local coefficient k. */
+    std::vector<int> m2lN, m2lNK;                     /*!< M2L pairs: multipole coefficient n and derivative n + k. */
+    const unsigned long rebuildPeriod;                /*!< Number of iterations between two rebuilds of the tree. */
+    unsigned long nItesSinceRebuild;                  /*!< Number of iterations since the last rebuild. */
+    unsigned long treeLayoutVersion;                  /*!< Layout version of the bodies at the last rebuild. */
+    Octree<T> tree;                                   /*!< Octree of the bodies. */
+    std::vector<T> gm;                                /*!< Array of masses multiplied by G. */
+    std::vector<T> sax, say, saz;                     /*!< Sorted accelerations. */
+    std::vector<double> multipoles;                   /*!< Multipole expansions (`nCoefs` per node). */
+    std::vector<double> locals;                       /*!< Local expansions (`nCoefs` per node). */
+    std::vector<std::vector<unsigned long>> listM2L;  /*!< Source nodes of the M2L of each node. */
+    std::vector<std::vector<unsigned long>> listP2P;  /*!< Source leaves of the P2P of each node. */
+    accSoA_t<T> accelerations;                        /*!< Structure of arrays of body accelerations. */
+
+  public:
+    SimulationNBodyFMM(const unsigned long nBodies, const std::string &scheme = "galaxy", const T soft = 0.035,
+                       const unsigned long randInit = 0, const int order = 4, const T theta = 0.5,
+                       const unsigned long leafSize = 64, const unsigned long rebuildPeriod = 1);
+    virtual ~SimulationNBodyFMM() = default;
+    virtual void computeOneIteration();
+
+  protected:
+    void resizeBuffers();
+    void computeBodiesAcceleration();
+    void updateTree();
+    void traverse(const unsigned long a, const unsigned long b);
+    void computeKernelDerivatives(const double rx, const double ry, const double rz, const double softSquared,
+                                  std::vector<double> &R) const;
+    void P2M(const unsigned long iNode);
+    void M2M(const unsigned long iNode);
+    void M2L(const unsigned long a, const unsigned long b, std::vector<double> &R);
+    void L2L(const unsigned long iNode);
+    void L2P(const unsigned long iNode);
+};
+
+#endif /* SIMULATION_N_BODY_FMM_HPP_ */
@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "utils/Mipp.hpp"
+#if defined(__SSE2__) || defined(__AVX__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "ImplemRegistry.hpp"
+#include "SimulationNBodyHalf.hpp"
+
+/* fp16 (IEEE 754 binary16) and bf16 conversions */
+
+static inline float halfToFloat(const uint16_t h)
+{
+#if defined(__F16C__)
+    return _cvtsh_ss(h);
+#else
+    const uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    const uint32_t exp = (h >> 10) & 0x1f;
+    const uint32_t mant = h & 0x3ff;
+    uint32_t bits;
+    if (exp == 0) { // zero and subnormals
+        const float f = (float)mant * 5.9604644775390625e-8f; // mant.2^-24
+        return sign ? -f : f;
+    }
+    else if (exp == 31) // infinities and NaNs
+        bits = sign | 0x7f800000 | (mant << 13);
+    else
+        bits = sign | ((exp + 112) << 23) | (mant << 13);
+    float f;
+    std::memcpy(&f, &bits, sizeof(float));
+    return f;
+#endif
+}
+
+static inline uint16_t floatToHalf(const float f)
+{
+#if defined(__F16C__)
+    return _cvtss_sh(f, 0); // round to nearest even
+#else
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(float));
+    const uint32_t sign = (x >> 16) & 0x8000;
+    const int32_t exp = (int32_t)((x >> 23) & 0xff) - 127 + 15;
+    uint32_t mant = x & 0x7fffff;
+    if (((x >> 23) & 0xff) == 0xff) // infinities and NaNs
+        return sign | 0x7c00 | (mant ? 0x200 : 0);
+    if (exp >= 31) // overflow
+        return sign | 0x7c00;
+    if (exp <= 0) { // subnormals (round to nearest even)
+        if (exp < -10)
+            return sign;
+        mant |= 0x800000;
+        const uint32_t shift = 14 - exp;
+        uint32_t h = mant >> shift;
+        const uint32_t rem = mant & ((1u << shift) - 1);
+        const uint32_t half = 1u << (shift - 1);
+        if (rem > half || (rem == half && (h & 1)))
+            h++;
+        return sign | h;
+    }
+    uint32_t h = ((uint32_t)exp << 10) | (mant >> 13);
+    const uint32_t rem = mant & 0x1fff;
+    if (rem > 0x1000 || (rem == 0x1000 && (h & 1))) // can carry into the exponent, this is the expected behavior
+        h++;
+    return sign | h;
+#endif
+}
+
+static inline float bf16ToFloat(const uint16_t b)
+{
+    const uint32_t bits = (uint32_t)b << 16;
+    float f;
+    std::memcpy(&f, &bits, sizeof(float));
+    return f;
+}
+
+static inline uint16_t floatToBf16(const float f)
+{
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(float));
+    x += 0x7fff + ((x >> 16) & 1); // round to nearest even
+    return (uint16_t)(x >> 16);
+}
+
+/*!
+ *  \brief Load `mipp::N<float>()` 16-bit values and expand them to fp32 in a register.
+ *
+ *  \tparam BF16 : `true` for bf16 values, `false` for fp16 values.
+ */
+template <bool BF16> inline mipp::Reg<float> loadHalf(const uint16_t *p);
+
+template <> inline mipp::Reg<float> loadHalf<false>(const uint16_t *p)
+{
+#if defined(__AVX512F__) && MIPP_REGISTER_SIZE == 512
+    return mipp::Reg<float>(_mm512_cvtph_ps(_mm256_loadu_si256((const __m256i *)p)));
+#elif defined(__F16C__) && MIPP_REGISTER_SIZE == 256
+    return mipp::Reg<float>(_mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)p)));
+#elif defined(__F16C__) && MIPP_REGISTER_SIZE == 128 && defined(__SSE2__)
+    return mipp::Reg<float>(_mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)p)));
+#else
+    float tmp[mipp::N<float>()];
+    for (int l = 0; l < mipp::N<float>(); l++)
+        tmp[l] = halfToFloat(p[l]);
+    return mipp::Reg<float>(tmp);
+#endif
+}
+
+template <> inline mipp::Reg<float> loadHalf<true>(const uint16_t *p)
+{
+#if defined(__AVX512F__) && MIPP_REGISTER_SIZE == 512
+    const __m512i v = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *)p));
+    return mipp::Reg<float>(_mm512_castsi512_ps(_mm512_slli_epi32(v, 16)));
+#elif defined(__AVX2__) && MIPP_REGISTER_SIZE == 256
+    const __m256i v = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)p));
+    return mipp::Reg<float>(_mm256_castsi256_ps(_mm256_slli_epi32(v, 16)));
+#elif defined(__SSE2__) && MIPP_REGISTER_SIZE == 128
+    // interleave with zeros: each 32-bit lane becomes (b << 16)
+    const __m128i v = _mm_unpacklo_epi16(_mm_setzero_si128(), _mm_loadl_epi64((const __m128i *)p));
+    return mipp::Reg<float>(_mm_castsi128_ps(v));
+#else
+    float tmp[mipp::N<float>()];
+    for (int l = 0; l < mipp::N<float>(); l++)
+        tmp[l] = bf16ToFloat(p[l]);
+    return mipp::Reg<float>(tmp);
+#endif
+}
+
+/*!
+ *  \brief Compute the accelerations of the bodies from the compressed j-bodies.
+ *
+ *  \tparam BF16 : `true` for bf16 values, `false` for fp16 values.
+ */
+template <bool BF16>
+static void computeAccelerationsHalf(const float *qx, const float *qy, const float *qz, const unsigned long n,
+                                     const std::vector<tileHalf_t> &tiles, const unsigned long tileSize,
+                                     const uint16_t *dqx, const uint16_t *dqy, const uint16_t *dqz,
+                                     const uint16_t *dm, float *ax, float *ay, float *az)
+{
+    constexpr int N = mipp::N<float>();
+    const mipp::Reg<float> rOne = 1.f;
+
+    // flops = n² * 20 (+ the tiles overhead)
+    for (unsigned long iBody = 0; iBody < n; iBody++) {
+        mipp::Reg<float> raix = 0.f, raiy = 0.f, raiz = 0.f;
+
+        for (unsigned long iTile = 0; iTile < tiles.size(); iTile++) {
+            const tileHalf_t &tile = tiles[iTile];
+            // body i in the normalized units of the tile
+            const mipp::Reg<float> rqix = (qx[iBody] - tile.ox) * tile.invScale;
+            const mipp::Reg<float> rqiy = (qy[iBody] - tile.oy) * tile.invScale;
+            const mipp::Reg<float> rqiz = (qz[iBody] - tile.oz) * tile.invScale;
+            const mipp::Reg<float> rSoftSquared = tile.softSquared;
+
+            mipp::Reg<float> rtx = 0.f, rty = 0.f, rtz = 0.f;
+            const unsigned long jOff = iTile * tileSize;
+            for (unsigned long jBody = jOff; jBody < jOff + tileSize; jBody += N) {
+                const mipp::Reg<float> rijx = loadHalf<BF16>(&dqx[jBody]) - rqix;
+                const mipp::Reg<float> rijy = loadHalf<BF16>(&dqy[jBody]) - rqiy;
+                const mipp::Reg<float> rijz = loadHalf<BF16>(&dqz[jBody]) - rqiz;
+                const mipp::Reg<float> rmj = loadHalf<BF16>(&dm[jBody]);
+
+                const mipp::Reg<float> rijSquared =
+                    mipp::fmadd(rijx, rijx, mipp::fmadd(rijy, rijy, mipp::fmadd(rijz, rijz, rSoftSquared)));
+                const mipp::Reg<float> rInv = rOne / mipp::sqrt(rijSquared);
+                const mipp::Reg<float> ai = rmj * (rInv * rInv * rInv);
+
+                rtx = mipp::fmadd(ai, rijx, rtx);
+                rty = mipp::fmadd(ai, rijy, rty);
+                rtz = mipp::fmadd(ai, rijz, rtz);
+            }
+
+            // back from the normalized units of the tile (G is included in the factor)
+            const mipp::Reg<float> rFactor = tile.factor;
+            raix = mipp::fmadd(rtx, rFactor, raix);
+            raiy = mipp::fmadd(rty, rFactor, raiy);
+            raiz = mipp::fmadd(rtz, rFactor, raiz);
+        }
+
+        ax[iBody] = mipp::hadd(raix);
+        ay[iBody] = mipp::hadd(raiy);
+        az[iBody] = mipp::hadd(raiz);
+    }
+}
+
+SimulationNBodyHalf::SimulationNBodyHalf(const unsigned long nBodies, const std::string &scheme, const float soft,
+                                         const unsigned long randInit, const bool bf16, const unsigned long tileSize)
+    : SimulationNBodyInterface<float>(nBodies, scheme, soft, randInit), bf16(bf16), tileSize(tileSize)
+{
+    assert(tileSize > 0 && tileSize % mipp::N<float>() == 0);
+
+    this->resizeBuffers();
+    this->allocatedBytes += this->tiles.size() * (sizeof(tileHalf_t) + this->tileSize * sizeof(uint16_t) * 4);
+}
+
+void SimulationNBodyHalf::resizeBuffers()
+{
+    const unsigned long n = this->getBodies().getN();
+    const unsigned long nTiles = (n + this->tileSize - 1) / this->tileSize;
+    this->flopsPerIte = 20.f * (float)n * (float)n;
+    this->tiles.resize(nTiles);
+    this->dqx.resize(nTiles * this->tileSize);
+    this->dqy.resize(nTiles * this->tileSize);
+    this->dqz.resize(nTiles * this->tileSize);
+    this->dm.resize(nTiles * this->tileSize);
+    this->accelerations.ax.resize(n);
+    this->accelerations.ay.resize(n);
+    this->accelerations.az.resize(n);
+}
+
+void SimulationNBodyHalf::initIteration()
+{
+    const dataSoA_t<float> &d = this->getBodies().getDataSoA();
+    const unsigned long n = this->getBodies().getN();
+    uint16_t (*toHalf)(const float) = this->bf16 ? floatToBf16 : floatToHalf;
+
+    // compress the j-bodies tile by tile
+    for (unsigned long iTile = 0; iTile < this->tiles.size(); iTile++) {
+        const unsigned long jBeg = iTile * this->tileSize;
+        const unsigned long jEnd = std::min(jBeg + this->tileSize, n);
+
+        float minX = d.qx[jBeg], maxX = d.qx[jBeg];
+        float minY = d.qy[jBeg], maxY = d.qy[jBeg];
+        float minZ = d.qz[jBeg], maxZ = d.qz[jBeg];
+        float minM = std::numeric_limits<float>::max(), maxM = 0.f;
+        for (unsigned long jBody = jBeg; jBody < jEnd; jBody++) {
+            minX = std::min(minX, d.qx[jBody]);
+            maxX = std::max(maxX, d.qx[jBody]);
+            minY = std::min(minY, d.qy[jBody]);
+            maxY = std::max(maxY, d.qy[jBody]);
+            minZ = std::min(minZ, d.qz[jBody]);
+            maxZ = std::max(maxZ, d.qz[jBody]);
+            if (d.m[jBody] > 0.f) {
+                minM = std::min(minM, d.m[jBody]);
+                maxM = std::max(maxM, d.m[jBody]);
+            }
+        }
+
+        tileHalf_t &tile = this->tiles[iTile];
+        tile.ox = 0.5f * (minX + maxX);
+        tile.oy = 0.5f * (minY + maxY);
+        tile.oz = 0.5f * (minZ + maxZ);
+        float scale = 0.5f * std::max(maxX - minX, std::max(maxY - minY, maxZ - minZ));
+        if (scale == 0.f)
+            scale = 1.f;
+        // center the normalized masses on 2 (geometric center of the fp16 normal range), ratios up to 1e9 fit
+        const float mScale = (maxM > 0.f) ? 0.5f * std::sqrt(minM) * std::sqrt(maxM) : 1.f;
+        tile.invScale = 1.f / scale;
+        tile.softSquared = (this->soft * tile.invScale) * (this->soft * tile.invScale);
+        tile.factor = this->G * mScale * tile.invScale * tile.invScale;
+
+        for (unsigned long jBody = jBeg; jBody < jEnd; jBody++) {
+            this->dqx[jBody] = toHalf((d.qx[jBody] - tile.ox) * tile.invScale);
+            this->dqy[jBody] = toHalf((d.qy[jBody] - tile.oy) * tile.invScale);
+            this->dqz[jBody] = toHalf((d.qz[jBody] - tile.oz) * tile.invScale);
+            this->dm[jBody] = toHalf(d.m[jBody] / mScale);
+        }
+        // the last tile is completed with massless bodies at the origin of the tile
+        for (unsigned long jBody = jEnd; jBody < jBeg + this->tileSize; jBody++)
+            this->dqx[jBody] = this->dqy[jBody] = this->dqz[jBody] = this->dm[jBody] = toHalf(0.f);
+    }
+}
+
+void SimulationNBodyHalf::computeBodiesAcceleration()
+{
+    const dataSoA_t<float> &d = this->getBodies().getDataSoA();
+
+    if (this->bf16)
+        computeAccelerationsHalf<true>(d.qx.data(), d.qy.data(), d.qz.data(), this->getBodies().getN(), this->tiles,
+                                       this->tileSize, this->dqx.data(), this->dqy.data(), this->dqz.data(),
+                                       this->dm.data(), this->accelerations.ax.data(), this->accelerations.ay.data(),
+                                       this->accelerations.az.data());
+    else
+        computeAccelerationsHalf<false>(d.qx.data(), d.qy.data(), d.qz.data(), this->getBodies().getN(), this->tiles,
+                                        this->tileSize, this->dqx.data(), this->dqy.data(), this->dqz.data(),
+                                        this->dm.data(), this->accelerations.ax.data(), this->accelerations.ay.data(),
+                                        this->accelerations.az.data());
+}
+
+void SimulationNBodyHalf::computeOneIteration()
+{
+    this->resizeBuffers();
+    this->initIteration();
+    this->computeBodiesAcceleration();
+    // time integration
+    this->bodies.updatePositionsAndVelocities(this->accelerations, this->dt);
+}
+
+// ======================================================================================================== registration
+static SimulationNBodyInterface<float> *createFP16(const implemParams_t &p)
+{
+    return new SimulationNBodyHalf(p.nBodies, p.scheme, p.soft, 0, false, p.tileSize);
+}
+
+static SimulationNBodyInterface<float> *createBF16(const implemParams_t &p)
+{
+    return new SimulationNBodyHalf(p.nBodies, p.scheme, p.soft, 0, true, p.tileSize);
+}
+
+// only fp32 bodies, not exact: the j-bodies are rounded to 16 bits
+static const implemCaps_t capsFP16 = {"direct sum, j-bodies stored in fp16", "fp16", false, false, {"tile"}, false};
+static const implemCaps_t capsBF16 = {"direct sum, j-bodies stored in bf16", "bf16", false, false, {"tile"}, false};
+static const bool registeredFP16 = ImplemRegistry::add("cpu+simd+fp16", "fp32", capsFP16, createFP16);
+static const bool registeredBF16 = ImplemRegistry::add("cpu+simd+bf16", "fp32", capsBF16, createBF16);
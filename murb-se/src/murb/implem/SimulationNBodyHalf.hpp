@@ -0,0 +1,58 @@
+#ifndef SIMULATION_N_BODY_HALF_HPP_
+#define SIMULATION_N_BODY_HALF_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/SimulationNBodyInterface.hpp"
+
+/*!
+ * \struct tileHalf_t
+ * \brief  Parameters to expand a tile of compressed j-bodies.
+ *
+ * Inside a tile, the positions are stored as 16-bit offsets relative to the tile center and normalized by the tile
+ * half extent, the masses are normalized by a per-tile mass scale. The interactions are computed in these normalized
+ * units and the result of the tile is scaled once.
+ */
+struct tileHalf_t {
+    float ox;          /*!< Origin x of the tile (center). */
+    float oy;          /*!< Origin y of the tile (center). */
+    float oz;          /*!< Origin z of the tile (center). */
+    float invScale;    /*!< Inverse of the position scale (half extent of the tile). */
+    float softSquared; /*!< Softening factor squared in normalized units. */
+    float factor;      /*!< G.mScale / scale², converts the normalized acceleration of the tile. */
+};
+
+/*!
+ * \class  SimulationNBodyHalf
+ * \brief  Direct sum with the j-bodies stored in 16-bit floating-point (fp16 or bf16) and expanded in registers.
+ *
+ * The j-bodies are compressed at each iteration into tiles of `tileSize` bodies: an fp32 origin per tile and
+ * fp16/bf16 normalized offsets and masses. The j-stream is then 8 bytes per body instead of 16 and the 16-bit values
+ * are converted to fp32 in registers (F16C/AVX-512 when available). The accumulations are done in fp32.
+ */
+class SimulationNBodyHalf : public SimulationNBodyInterface<float> {
+  protected:
+    const bool bf16;                /*!< Use bf16 instead of fp16 for the j-bodies. */
+    const unsigned long tileSize;   /*!< Number of j-bodies per tile (multiple of `mipp::N<float>()`). */
+    std::vector<tileHalf_t> tiles;  /*!< Tiles parameters. */
+    std::vector<uint16_t> dqx;      /*!< Array of compressed positions x of the j-bodies. */
+    std::vector<uint16_t> dqy;      /*!< Array of compressed positions y of the j-bodies. */
+    std::vector<uint16_t> dqz;      /*!< Array of compressed positions z of the j-bodies. */
+    std::vector<uint16_t> dm;       /*!< Array of compressed masses of the j-bodies. */
+    accSoA_t<float> accelerations; /*!< Structure of arrays of body accelerations. */
+
+  public:
+    SimulationNBodyHalf(const unsigned long nBodies, const std::string &scheme = "galaxy", const float soft = 0.035f,
+                        const unsigned long randInit = 0, const bool bf16 = false, const unsigned long tileSize = 256);
+    virtual ~SimulationNBodyHalf() = default;
+    virtual void computeOneIteration();
+
+  protected:
+    void resizeBuffers();
+    void initIteration();
+    void computeBodiesAcceleration();
+};
+
+#endif /* SIMULATION_N_BODY_HALF_HPP_ */
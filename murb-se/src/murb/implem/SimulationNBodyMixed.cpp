@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "ImplemRegistry.hpp"
+#include "KernelsISA.hpp"
+#include "SimulationNBodyMixed.hpp"
+#include "utils/TaskScheduler.hpp"
+
+constexpr unsigned long SimulationNBodyMixed::tileSize;
+constexpr unsigned long SimulationNBodyMixed::blockSize;
+
+SimulationNBodyMixed::SimulationNBodyMixed(const unsigned long nBodies, const std::string &scheme, const double soft,
+                                           const unsigned long randInit)
+    : SimulationNBodyInterface<double>(nBodies, scheme, soft, randInit)
+{
+    const unsigned long n = this->getBodies().getN();
+    this->resizeBuffers();
+    this->allocatedBytes += n * (sizeof(double) * 3 + sizeof(float) * 4);
+}
+
+void SimulationNBodyMixed::resizeBuffers()
+{
+    const unsigned long n = this->getBodies().getN();
+    this->flopsPerIte = 20.f * (float)n * (float)n;
+    this->accelerations.ax.resize(n);
+    this->accelerations.ay.resize(n);
+    this->accelerations.az.resize(n);
+    this->m.resize(n);
+    this->ax.resize(n);
+    this->ay.resize(n);
+    this->az.resize(n);
+}
+
+void SimulationNBodyMixed::initIteration()
+{
+    const dataSoA_t<double> &d = this->getBodies().getDataSoA();
+    const unsigned long n = this->getBodies().getN();
+
+    TaskScheduler::get().parallelFor(0, n, tileSize, [&](unsigned long begin, unsigned long end) {
+        for (unsigned long iBody = begin; iBody < end; iBody++) {
+            this->m[iBody] = (float)d.m[iBody];
+            this->ax[iBody] = 0.f;
+            this->ay[iBody] = 0.f;
+            this->az[iBody] = 0.f;
+        }
+    });
+}
+
+void SimulationNBodyMixed::computeBodiesAcceleration()
+{
+    const dataSoA_t<double> &d = this->getBodies().getDataSoA();
+    const unsigned long n = this->getBodies().getN();
+    const unsigned long nTiles = (n + tileSize - 1) / tileSize;
+    const float softSquared = (float)(this->soft * this->soft);
+
+    // flops = n² * 20
+    TaskScheduler::get().parallelForAffinity(0, nTiles, 1, [&](unsigned long tileBegin, unsigned long tileEnd) {
+        std::vector<float> qix(tileSize), qiy(tileSize), qiz(tileSize);
+        std::vector<float> qjx(blockSize), qjy(blockSize), qjz(blockSize);
+        for (unsigned long iTile = tileBegin; iTile < tileEnd; iTile++) {
+            const unsigned long iBeg = iTile * tileSize;
+            const unsigned long ni = std::min(tileSize, n - iBeg);
+
+            // the fp32 coordinates are relative to the center of the i-tile: the large offsets stay in fp64 and the
+            // close j-bodies, which dominate the accelerations, keep the full fp32 precision
+            double cx = 0., cy = 0., cz = 0.;
+            for (unsigned long iBody = iBeg; iBody < iBeg + ni; iBody++) {
+                cx += d.qx[iBody];
+                cy += d.qy[iBody];
+                cz += d.qz[iBody];
+            }
+            cx /= (double)ni;
+            cy /= (double)ni;
+            cz /= (double)ni;
+
+            for (unsigned long i = 0; i < ni; i++) {
+                qix[i] = (float)(d.qx[iBeg + i] - cx);
+                qiy[i] = (float)(d.qy[iBeg + i] - cy);
+                qiz[i] = (float)(d.qz[iBeg + i] - cz);
+            }
+            for (unsigned long jBeg = 0; jBeg < n; jBeg += blockSize) {
+                const unsigned long nj = std::min(blockSize, n - jBeg);
+                for (unsigned long j = 0; j < nj; j++) {
+                    qjx[j] = (float)(d.qx[jBeg + j] - cx);
+                    qjy[j] = (float)(d.qy[jBeg + j] - cy);
+                    qjz[j] = (float)(d.qz[jBeg + j] - cz);
+                }
+                computeAccelerationsISA<float>(qix.data(), qiy.data(), qiz.data(), ni, qjx.data(), qjy.data(),
+                                               qjz.data(), &this->m[jBeg], nj, softSquared, &this->ax[iBeg],
+                                               &this->ay[iBeg], &this->az[iBeg]);
+            }
+
+            // back to fp64 and apply the gravitational constant
+            for (unsigned long iBody = iBeg; iBody < iBeg + ni; iBody++) {
+                this->accelerations.ax[iBody] = this->G * (double)this->ax[iBody];
+                this->accelerations.ay[iBody] = this->G * (double)this->ay[iBody];
+                this->accelerations.az[iBody] = this->G * (double)this->az[iBody];
+            }
+        }
+    });
+}
+
+void SimulationNBodyMixed::computeOneIteration()
+{
+    this->resizeBuffers();
+    this->initIteration();
+    this->computeBodiesAcceleration();
+    // time integration (fp64)
+    this->bodies.updatePositionsAndVelocities(this->accelerations, this->dt);
+}
+
+// ======================================================================================================== registration
+static SimulationNBodyInterface<double> *createMixed(const implemParams_t &p)
+{
+    return new SimulationNBodyMixed(p.nBodies, p.scheme, p.soft);
+}
+
+// the mixed precision of `cpu+simd` (same capabilities)
+static const bool registeredMixed = ImplemRegistry::add("cpu+simd", "mixed", implemCaps_t(), createMixed);
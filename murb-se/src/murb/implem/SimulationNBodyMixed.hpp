@@ -0,0 +1,40 @@
+#ifndef SIMULATION_N_BODY_MIXED_HPP_
+#define SIMULATION_N_BODY_MIXED_HPP_
+
+#include <string>
+#include <vector>
+
+#include "core/SimulationNBodyInterface.hpp"
+
+/*!
+ * \class  SimulationNBodyMixed
+ * \brief  Mixed-precision implementation: fp64 positions and velocities, fp32 SIMD interactions.
+ *
+ * The i-bodies are processed by tiles: the positions are converted into fp32 coordinates relative to the center of
+ * the i-tile (the offsets are computed in fp64 then rounded), the pair interactions are computed in fp32 (MIPP) and
+ * the time integration is done in fp64.
+ */
+class SimulationNBodyMixed : public SimulationNBodyInterface<double> {
+  protected:
+    static constexpr unsigned long tileSize = 1024;  /*!< Number of i-bodies sharing the same reference point. */
+    static constexpr unsigned long blockSize = 4096; /*!< Number of j-bodies converted at once. */
+
+    accSoA_t<double> accelerations; /*!< Structure of arrays of body accelerations (fp64). */
+    std::vector<float> m;           /*!< Array of masses (fp32). */
+    std::vector<float> ax;          /*!< Array of accelerations x without G (fp32). */
+    std::vector<float> ay;          /*!< Array of accelerations y without G (fp32). */
+    std::vector<float> az;          /*!< Array of accelerations z without G (fp32). */
+
+  public:
+    SimulationNBodyMixed(const unsigned long nBodies, const std::string &scheme = "galaxy", const double soft = 0.035,
+                         const unsigned long randInit = 0);
+    virtual ~SimulationNBodyMixed() = default;
+    virtual void computeOneIteration();
+
+  protected:
+    void resizeBuffers();
+    void initIteration();
+    void computeBodiesAcceleration();
+};
+
+#endif /* SIMULATION_N_BODY_MIXED_HPP_ */
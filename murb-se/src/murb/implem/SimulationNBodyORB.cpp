@@ -0,0 +1,452 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "ImplemRegistry.hpp"
+#include "KernelsISA.hpp"
+#include "SimulationNBodyORB.hpp"
+#include "utils/TaskScheduler.hpp"
+
+/* a rank receives a message of a rank which has ended: the run can not go on */
+static void recvOrExit(Communicator &comm, const unsigned src, void *buf, const size_t bytes)
+{
+    if (!comm.recv(src, buf, bytes)) {
+        std::cout << "The rank " << src << " has ended before the rank " << comm.getRank() << "... exiting."
+                  << std::endl;
+        exit(-1);
+    }
+}
+
+/* packed moments of the nodes in the floating-point type of the kernels */
+template <typename T>
+static void packNodes(const std::vector<octreeNode_t> &nodes, std::vector<nodeHot_t<T>> &nodesHot)
+{
+    nodesHot.resize(nodes.size());
+    for (unsigned long i = 0; i < nodes.size(); i++) {
+        const octreeNode_t &node = nodes[i];
+        nodeHot_t<T> &hot = nodesHot[i];
+        hot.cx = node.cx;
+        hot.cy = node.cy;
+        hot.cz = node.cz;
+        hot.gm = node.gm;
+        const double scale = node.gm > 0 ? 3. / node.gm : 0.;
+        for (int k = 0; k < 6; k++)
+            hot.q[k] = scale * node.q[k];
+        hot.tq = 0.5 * scale * (node.q[0] + node.q[3] + node.q[5]);
+    }
+}
+
+template <typename T>
+SimulationNBodyORB<T>::SimulationNBodyORB(const unsigned long nBodies, const std::string &scheme, const T soft,
+                                          const unsigned long randInit, const T theta, const unsigned long groupSize,
+                                          const unsigned nRanks, const std::string &transport,
+                                          const bool measuredCosts)
+    : SimulationNBodyInterface<T>(nBodies, scheme, soft, randInit), theta(theta), measuredCosts(measuredCosts),
+      costsLayoutVersion(0), localTree(groupSize), remoteTree(groupSize), imbalance(1.f)
+{
+    assert(theta > 0 && theta < 1);
+    const unsigned long n = this->getBodies().getN();
+    this->flopsPerIte = 0.f;
+
+    this->comm.reset(Communicator::create(transport, nRanks));
+    const unsigned size = this->comm->getSize();
+    this->sendLETs.resize(size);
+    this->recvLETs.resize(size);
+    this->sendCounts.assign(2 * size, 0);
+    this->recvCounts.assign(2 * size, 0);
+
+    // accelerations, costs and domains of all the bodies, then the bodies and the trees of the rank (about
+    // 2 n / groupSize nodes), the locally essential trees depend on the distribution
+    this->allocatedBytes += n * (sizeof(T) * 3 + sizeof(float) + sizeof(unsigned long));
+    this->allocatedBytes += (float)n / size * (sizeof(T) * 15 + sizeof(float) * 2 + sizeof(uint64_t) +
+                                               sizeof(unsigned long));
+    this->allocatedBytes += (2.f * n / size / groupSize) * (sizeof(octreeNode_t) + sizeof(nodeHot_t<T>));
+
+    // the other ranks compute the iterations until the end of the rank 0, they do not return
+    if (this->comm->getRank() != 0)
+        this->runRank();
+}
+
+template <typename T> SimulationNBodyORB<T>::~SimulationNBodyORB()
+{
+    const int32_t stop = 0;
+    for (unsigned r = 1; r < this->comm->getSize(); r++)
+        this->comm->send(r, &stop, sizeof(stop));
+}
+
+template <typename T> const Communicator &SimulationNBodyORB<T>::getCommunicator() const { return *this->comm; }
+
+template <typename T> float SimulationNBodyORB<T>::getImbalance() const { return this->imbalance; }
+
+template <typename T> const std::vector<orbDomain_t> &SimulationNBodyORB<T>::getDomains() const
+{
+    return this->domains;
+}
+
+template <typename T> void SimulationNBodyORB<T>::runRank()
+{
+    int32_t iterate;
+    while (this->comm->recv(0, &iterate, sizeof(iterate)) && iterate)
+        this->computeIteration();
+    this->comm->exitRank();
+}
+
+template <typename T> void SimulationNBodyORB<T>::distributeBodies()
+{
+    const unsigned rank = this->comm->getRank();
+    const unsigned size = this->comm->getSize();
+    std::vector<dataHot_t<T>> bodies;
+    uint64_t count;
+
+    if (rank == 0) {
+        const dataSoA_t<T> &d = this->getBodies().getDataSoA();
+        const std::vector<dataHot_t<T>> &h = this->getBodies().getDataHot();
+        const unsigned long n = this->getBodies().getN();
+        // the costs are the ones of the same bodies (not of the bodies before a reordering or a merging)
+        const bool balanceCosts = this->measuredCosts && this->costs.size() == n &&
+                                  this->costsLayoutVersion == this->getBodies().getLayoutVersion();
+        orbDecompose<T>(d.qx.data(), d.qy.data(), d.qz.data(), balanceCosts ? this->costs.data() : nullptr, n, size,
+                        this->ids, this->offsets, this->domains);
+
+        for (unsigned r = size; r-- > 0;) {
+            count = this->offsets[r + 1] - this->offsets[r];
+            bodies.resize(count);
+            for (unsigned long k = 0; k < count; k++)
+                bodies[k] = h[this->ids[this->offsets[r] + k]];
+            if (r != 0) {
+                this->comm->send(r, &count, sizeof(count));
+                this->comm->send(r, this->domains.data(), size * sizeof(orbDomain_t));
+                this->comm->send(r, bodies.data(), count * sizeof(dataHot_t<T>));
+            }
+        }
+    }
+    else {
+        this->domains.resize(size);
+        recvOrExit(*this->comm, 0, &count, sizeof(count));
+        recvOrExit(*this->comm, 0, this->domains.data(), size * sizeof(orbDomain_t));
+        bodies.resize(count);
+        recvOrExit(*this->comm, 0, bodies.data(), count * sizeof(dataHot_t<T>));
+    }
+
+    this->lqx.resize(count);
+    this->lqy.resize(count);
+    this->lqz.resize(count);
+    this->lgm.resize(count);
+    for (unsigned long k = 0; k < count; k++) {
+        this->lqx[k] = bodies[k].qx;
+        this->lqy[k] = bodies[k].qy;
+        this->lqz[k] = bodies[k].qz;
+        this->lgm[k] = bodies[k].gm;
+    }
+}
+
+template <typename T> void SimulationNBodyORB<T>::buildLETs()
+{
+    const unsigned rank = this->comm->getRank();
+    const std::vector<octreeNode_t> &nodes = this->localTree.getNodes();
+    const T *sqx = this->localTree.getSortedQx().data();
+    const T *sqy = this->localTree.getSortedQy().data();
+    const T *sqz = this->localTree.getSortedQz().data();
+    const T *sgm = this->localTree.getSortedGm().data();
+
+    TaskScheduler::get().parallelFor(0, this->comm->getSize(), 1, [&](unsigned long rBegin, unsigned long rEnd) {
+        std::vector<unsigned long> stack;
+        std::vector<nodeHot_t<T>> letNodes;
+        std::vector<dataHot_t<T>> letBodies;
+        for (unsigned long r = rBegin; r < rEnd; r++) {
+            letNodes.clear();
+            letBodies.clear();
+            // the nodes accepted for every point of the domain of `r`, the bodies of the leaves opened by one
+            const orbDomain_t &domain = this->domains[r];
+            if (r != rank && !this->lqx.empty() && domain.min[0] <= domain.max[0])
+                stack.assign(1, 0);
+            while (!stack.empty()) {
+                const unsigned long b = stack.back();
+                stack.pop_back();
+                const octreeNode_t &nb = nodes[b];
+                if (nb.radius < this->theta * orbDistance(domain, nb.cx, nb.cy, nb.cz))
+                    letNodes.push_back(this->localNodesHot[b]);
+                else if (nb.nChildren == 0)
+                    for (unsigned long i = nb.begin; i < nb.end; i++)
+                        letBodies.push_back({sqx[i], sqy[i], sqz[i], sgm[i]});
+                else
+                    for (unsigned char c = 0; c < nb.nChildren; c++)
+                        stack.push_back(nb.firstChild + c);
+            }
+
+            const size_t nodesBytes = letNodes.size() * sizeof(nodeHot_t<T>);
+            const size_t bodiesBytes = letBodies.size() * sizeof(dataHot_t<T>);
+            this->sendLETs[r].resize(nodesBytes + bodiesBytes);
+            std::memcpy(this->sendLETs[r].data(), letNodes.data(), nodesBytes);
+            std::memcpy(this->sendLETs[r].data() + nodesBytes, letBodies.data(), bodiesBytes);
+            this->sendCounts[2 * r + 0] = letNodes.size();
+            this->sendCounts[2 * r + 1] = letBodies.size();
+        }
+    });
+}
+
+template <typename T> void SimulationNBodyORB<T>::exchangeLETs()
+{
+    const unsigned rank = this->comm->getRank();
+    const unsigned size = this->comm->getSize();
+
+    // the sizes first: the receivers allocate the trees
+    for (unsigned k = 1; k < size; k++) {
+        const unsigned dest = (rank + k) % size, src = (rank + size - k) % size;
+        this->comm->startSendRecv(dest, &this->sendCounts[2 * dest], 2 * sizeof(uint64_t), src,
+                                  &this->recvCounts[2 * src], 2 * sizeof(uint64_t));
+        this->comm->waitSendRecv();
+        this->recvLETs[src].resize(this->recvCounts[2 * src + 0] * sizeof(nodeHot_t<T>) +
+                                   this->recvCounts[2 * src + 1] * sizeof(dataHot_t<T>));
+    }
+
+    // the round `k` exchanges the trees with the ranks at a distance `k + 1` while the part `k` of the groups walks
+    // the local tree
+    const unsigned long nGroups = this->localTree.getLeaves().size();
+    const unsigned nParts = std::max(1u, size - 1);
+    for (unsigned k = 0; k < nParts; k++) {
+        const bool exchange = k + 1 < size;
+        if (exchange) {
+            const unsigned dest = (rank + k + 1) % size, src = (rank + size - k - 1) % size;
+            this->comm->startSendRecv(dest, this->sendLETs[dest].data(), this->sendLETs[dest].size(), src,
+                                      this->recvLETs[src].data(), this->recvLETs[src].size());
+        }
+        this->computeGroups(k * nGroups / nParts, (k + 1) * nGroups / nParts, false);
+        if (exchange)
+            this->comm->waitSendRecv();
+    }
+}
+
+template <typename T> void SimulationNBodyORB<T>::unpackLETs()
+{
+    const unsigned rank = this->comm->getRank();
+    std::vector<dataHot_t<T>> bodies;
+    this->remoteNodes.clear();
+    this->rqx.clear();
+    this->rqy.clear();
+    this->rqz.clear();
+    this->rgm.clear();
+    for (unsigned r = 0; r < this->comm->getSize(); r++) {
+        if (r == rank)
+            continue;
+        const unsigned long nNodes = this->recvCounts[2 * r + 0];
+        const unsigned long nBodies = this->recvCounts[2 * r + 1];
+        const char *let = this->recvLETs[r].data();
+        this->remoteNodes.resize(this->remoteNodes.size() + nNodes);
+        std::memcpy(this->remoteNodes.data() + this->remoteNodes.size() - nNodes, let, nNodes * sizeof(nodeHot_t<T>));
+        bodies.resize(nBodies);
+        std::memcpy(bodies.data(), let + nNodes * sizeof(nodeHot_t<T>), nBodies * sizeof(dataHot_t<T>));
+        for (const dataHot_t<T> &b : bodies) {
+            this->rqx.push_back(b.qx);
+            this->rqy.push_back(b.qy);
+            this->rqz.push_back(b.qz);
+            this->rgm.push_back(b.gm);
+        }
+    }
+
+    // the received bodies are walked like the local ones
+    if (!this->rqx.empty()) {
+        this->remoteTree.build(this->rqx.data(), this->rqy.data(), this->rqz.data(), this->rgm.data(),
+                               this->rqx.size());
+        packNodes<T>(this->remoteTree.getNodes(), this->remoteNodesHot);
+    }
+}
+
+template <typename T>
+void SimulationNBodyORB<T>::walkTree(const Octree<T> &tree, const std::vector<nodeHot_t<T>> &nodesHot,
+                                     const octreeNode_t &group, walkLists_t &l) const
+{
+    const std::vector<octreeNode_t> &nodes = tree.getNodes();
+    const T *sqx = tree.getSortedQx().data();
+    const T *sqy = tree.getSortedQy().data();
+    const T *sqz = tree.getSortedQz().data();
+    const T *sgm = tree.getSortedGm().data();
+
+    l.stack.assign(1, 0);
+    while (!l.stack.empty()) {
+        const unsigned long b = l.stack.back();
+        l.stack.pop_back();
+        const octreeNode_t &nb = nodes[b];
+
+        const double dx = nb.cx - group.cx, dy = nb.cy - group.cy, dz = nb.cz - group.cz;
+        const double dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+        if (nb.radius < this->theta * (dist - group.radius))
+            l.nodeList.push_back(nodesHot[b]);
+        else if (nb.nChildren == 0) {
+            l.jqx.insert(l.jqx.end(), sqx + nb.begin, sqx + nb.end);
+            l.jqy.insert(l.jqy.end(), sqy + nb.begin, sqy + nb.end);
+            l.jqz.insert(l.jqz.end(), sqz + nb.begin, sqz + nb.end);
+            l.jgm.insert(l.jgm.end(), sgm + nb.begin, sgm + nb.end);
+        }
+        else
+            for (unsigned char c = 0; c < nb.nChildren; c++)
+                l.stack.push_back(nb.firstChild + c);
+    }
+}
+
+template <typename T>
+void SimulationNBodyORB<T>::computeGroups(const unsigned long begin, const unsigned long end, const bool remote)
+{
+    const std::vector<octreeNode_t> &nodes = this->localTree.getNodes();
+    const std::vector<unsigned long> &leaves = this->localTree.getLeaves();
+    const T *sqx = this->localTree.getSortedQx().data();
+    const T *sqy = this->localTree.getSortedQy().data();
+    const T *sqz = this->localTree.getSortedQz().data();
+    const T softSquared = this->soft * this->soft;
+
+    TaskScheduler::get().parallelFor(begin, end, 1, [&](unsigned long lBegin, unsigned long lEnd) {
+        walkLists_t &l = this->lists[TaskScheduler::getThreadId()];
+        for (unsigned long iLeaf = lBegin; iLeaf < lEnd; iLeaf++) {
+            const octreeNode_t &g = nodes[leaves[iLeaf]];
+            const unsigned long ni = g.end - g.begin;
+            if (ni == 0)
+                continue;
+            l.nodeList.clear();
+            l.jqx.clear();
+            l.jqy.clear();
+            l.jqz.clear();
+            l.jgm.clear();
+            if (!remote) {
+                this->walkTree(this->localTree, this->localNodesHot, g, l);
+                std::fill(&this->sax[g.begin], &this->sax[g.begin] + ni, (T)0);
+                std::fill(&this->say[g.begin], &this->say[g.begin] + ni, (T)0);
+                std::fill(&this->saz[g.begin], &this->saz[g.begin] + ni, (T)0);
+                std::fill(&this->scosts[g.begin], &this->scosts[g.begin] + ni, 0.f);
+            }
+            else if (!this->rqx.empty())
+                this->walkTree(this->remoteTree, this->remoteNodesHot, g, l);
+
+            computeAccelerationsISA<T>(&sqx[g.begin], &sqy[g.begin], &sqz[g.begin], ni, l.jqx.data(), l.jqy.data(),
+                                       l.jqz.data(), l.jgm.data(), l.jqx.size(), softSquared, &this->sax[g.begin],
+                                       &this->say[g.begin], &this->saz[g.begin]);
+            computeNodeAccelerationsISA<T>(&sqx[g.begin], &sqy[g.begin], &sqz[g.begin], ni, l.nodeList.data(),
+                                           l.nodeList.size(), softSquared, &this->sax[g.begin], &this->say[g.begin],
+                                           &this->saz[g.begin]);
+            unsigned long nNodes = l.nodeList.size();
+            if (remote) {
+                computeNodeAccelerationsISA<T>(&sqx[g.begin], &sqy[g.begin], &sqz[g.begin], ni,
+                                               this->remoteNodes.data(), this->remoteNodes.size(), softSquared,
+                                               &this->sax[g.begin], &this->say[g.begin], &this->saz[g.begin]);
+                nNodes += this->remoteNodes.size();
+            }
+
+            // cost in body interactions (20 flops), a node interaction is 56 flops
+            const float cost = (float)l.jqx.size() + 2.8f * (float)nNodes;
+            for (unsigned long i = g.begin; i < g.end; i++)
+                this->scosts[i] += cost;
+        }
+    });
+}
+
+template <typename T> void SimulationNBodyORB<T>::gatherResults()
+{
+    const unsigned rank = this->comm->getRank();
+    const unsigned size = this->comm->getSize();
+
+    // back to the order of the received bodies
+    const unsigned long count = this->lqx.size();
+    const std::vector<unsigned long> &perm = this->localTree.getPermutation();
+    this->lax.resize(count);
+    this->lay.resize(count);
+    this->laz.resize(count);
+    this->lcosts.resize(count);
+    for (unsigned long i = 0; i < count; i++) {
+        this->lax[perm[i]] = this->sax[i];
+        this->lay[perm[i]] = this->say[i];
+        this->laz[perm[i]] = this->saz[i];
+        this->lcosts[perm[i]] = this->scosts[i];
+    }
+
+    if (rank != 0) {
+        this->comm->send(0, this->lax.data(), count * sizeof(T));
+        this->comm->send(0, this->lay.data(), count * sizeof(T));
+        this->comm->send(0, this->laz.data(), count * sizeof(T));
+        this->comm->send(0, this->lcosts.data(), count * sizeof(float));
+        return;
+    }
+
+    const unsigned long n = this->getBodies().getN();
+    this->accelerations.ax.resize(n);
+    this->accelerations.ay.resize(n);
+    this->accelerations.az.resize(n);
+    this->costs.resize(n);
+    double totalCost = 0., maxCost = 0.;
+    for (unsigned r = 0; r < size; r++) {
+        const unsigned long rCount = this->offsets[r + 1] - this->offsets[r];
+        if (r != 0) {
+            this->lax.resize(rCount);
+            this->lay.resize(rCount);
+            this->laz.resize(rCount);
+            this->lcosts.resize(rCount);
+            recvOrExit(*this->comm, r, this->lax.data(), rCount * sizeof(T));
+            recvOrExit(*this->comm, r, this->lay.data(), rCount * sizeof(T));
+            recvOrExit(*this->comm, r, this->laz.data(), rCount * sizeof(T));
+            recvOrExit(*this->comm, r, this->lcosts.data(), rCount * sizeof(float));
+        }
+        double rankCost = 0.;
+        for (unsigned long k = 0; k < rCount; k++) {
+            const unsigned long b = this->ids[this->offsets[r] + k];
+            this->accelerations.ax[b] = this->lax[k];
+            this->accelerations.ay[b] = this->lay[k];
+            this->accelerations.az[b] = this->laz[k];
+            this->costs[b] = this->lcosts[k];
+            rankCost += this->lcosts[k];
+        }
+        totalCost += rankCost;
+        maxCost = std::max(maxCost, rankCost);
+    }
+    this->costsLayoutVersion = this->getBodies().getLayoutVersion();
+    this->flopsPerIte = 20.f * totalCost;
+    this->imbalance = totalCost > 0 ? maxCost * size / totalCost : 1.f;
+}
+
+template <typename T> void SimulationNBodyORB<T>::computeIteration()
+{
+    this->distributeBodies();
+
+    const unsigned long count = this->lqx.size();
+    this->localTree.build(this->lqx.data(), this->lqy.data(), this->lqz.data(), this->lgm.data(), count);
+    packNodes<T>(this->localTree.getNodes(), this->localNodesHot);
+    this->sax.resize(count);
+    this->say.resize(count);
+    this->saz.resize(count);
+    this->scosts.resize(count);
+    this->lists.resize(TaskScheduler::get().getNumThreads());
+
+    this->buildLETs();
+    this->exchangeLETs();
+    this->unpackLETs();
+    this->computeGroups(0, this->localTree.getLeaves().size(), true);
+    this->gatherResults();
+}
+
+template <typename T> void SimulationNBodyORB<T>::computeOneIteration()
+{
+    const int32_t iterate = 1;
+    for (unsigned r = 1; r < this->comm->getSize(); r++)
+        this->comm->send(r, &iterate, sizeof(iterate));
+    this->computeIteration();
+    // time integration
+    this->bodies.updatePositionsAndVelocities(this->accelerations, this->dt);
+}
+
+// ==================================================================================== explicit template instantiation
+template class SimulationNBodyORB<double>;
+template class SimulationNBodyORB<float>;
+// ==================================================================================== explicit template instantiation
+
+// ======================================================================================================== registration
+template <typename T> static SimulationNBodyInterface<T> *createORB(const implemParams_t &p)
+{
+    return new SimulationNBodyORB<T>(p.nBodies, p.scheme, p.soft, 0, p.theta, p.leafSize ? p.leafSize : 32, p.ranks,
+                                     p.transport);
+}
+
+// not a candidate of `--im auto`: the calibration would start the ranks
+static const implemCaps_t capsORB = {"Barnes-Hut distributed over processes, recursive bisection balanced with the "
+                                     "measured costs and locally essential trees (--ranks, --transport)",
+                                     "hot", true, false, {"leaf"}, true};
+REGISTER_IMPLEM(orb, "cpu+bh+orb", capsORB, createORB);
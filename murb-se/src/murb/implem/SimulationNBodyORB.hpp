@@ -0,0 +1,112 @@
+#ifndef SIMULATION_N_BODY_ORB_HPP_
+#define SIMULATION_N_BODY_ORB_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/SimulationNBodyInterface.hpp"
+#include "utils/Communicator.hpp"
+#include "utils/Octree.hpp"
+#include "utils/Orb.hpp"
+
+/*!
+ * \class  SimulationNBodyORB
+ * \brief  Barnes-Hut tree code distributed over processes (ranks): orthogonal recursive bisection of the bodies and
+ *         exchange of the locally essential trees.
+ *
+ * \tparam T : Floating-point type.
+ *
+ * At each iteration, the rank 0 cuts the bodies in one domain per rank with an orthogonal recursive bisection
+ * weighted by the cost of each body at the previous iteration (number of body and node interactions of its group),
+ * and sends its bodies and the bounding boxes of all the domains to each rank. A rank builds the octree of its
+ * bodies and, for each other rank, the part of its tree that the other rank needs (locally essential tree): the nodes
+ * accepted by the opening criterion for every point of the box of the other domain, r_node < theta . d(node, box),
+ * and the bodies of the opened leaves. The locally essential trees are exchanged in `nRanks - 1` rounds while the
+ * groups of the rank walk their own tree (the communications overlap the computations), then the groups walk the
+ * octree of the received bodies and evaluate the received nodes. The SIMD kernels and the group walk are the ones of
+ * `SimulationNBodyBarnesHut`.
+ *
+ * The ranks send the accelerations and the costs of their bodies to the rank 0, which integrates all the bodies (the
+ * bodies of the rank 0 are the ones of the output and of the visualization).
+ */
+template <typename T> class SimulationNBodyORB : public SimulationNBodyInterface<T> {
+  protected:
+    /* interaction lists of a thread */
+    struct walkLists_t {
+        std::vector<unsigned long> stack;
+        std::vector<nodeHot_t<T>> nodeList;
+        std::vector<T> jqx, jqy, jqz, jgm;
+    };
+
+    const T theta;                            /*!< Opening angle. */
+    const bool measuredCosts;                 /*!< Balance the measured costs (or the number of bodies). */
+    std::unique_ptr<Communicator> comm;       /*!< Transport between the ranks. */
+    std::vector<orbDomain_t> domains;         /*!< Bounding box of the bodies of each rank. */
+    std::vector<unsigned long> ids;           /*!< Bodies of each rank (rank 0). */
+    std::vector<unsigned long> offsets;       /*!< First body of each rank in `ids` (rank 0). */
+    std::vector<float> costs;                 /*!< Cost of each body at the last iteration (rank 0). */
+    unsigned long costsLayoutVersion;         /*!< Layout version of the bodies of `costs`. */
+    accSoA_t<T> accelerations;                /*!< Accelerations of all the bodies (rank 0). */
+    std::vector<T> lqx, lqy, lqz, lgm;        /*!< Positions and G.masses of the bodies of the rank. */
+    std::vector<T> lax, lay, laz;             /*!< Accelerations of the bodies of the rank. */
+    std::vector<float> lcosts;                /*!< Costs of the bodies of the rank. */
+    Octree<T> localTree;                      /*!< Octree of the bodies of the rank, a leaf is a group. */
+    std::vector<nodeHot_t<T>> localNodesHot;  /*!< Packed moments of the local tree. */
+    std::vector<std::vector<char>> sendLETs;  /*!< Locally essential tree of each other rank (nodes, bodies). */
+    std::vector<std::vector<char>> recvLETs;  /*!< Locally essential tree from each other rank. */
+    std::vector<uint64_t> sendCounts;         /*!< Number of nodes and bodies of the sent trees. */
+    std::vector<uint64_t> recvCounts;         /*!< Number of nodes and bodies of the received trees. */
+    std::vector<nodeHot_t<T>> remoteNodes;    /*!< Received nodes (accepted for all the groups). */
+    std::vector<T> rqx, rqy, rqz, rgm;        /*!< Received bodies. */
+    Octree<T> remoteTree;                     /*!< Octree of the received bodies. */
+    std::vector<nodeHot_t<T>> remoteNodesHot; /*!< Packed moments of the remote tree. */
+    std::vector<T> sax, say, saz;             /*!< Accelerations of the bodies of the rank (order of the tree). */
+    std::vector<float> scosts;                /*!< Costs of the bodies of the rank (order of the tree). */
+    std::vector<walkLists_t> lists;           /*!< Interaction lists of each thread. */
+    float imbalance;                          /*!< Max. cost of a rank / mean cost at the last iteration. */
+
+  public:
+    SimulationNBodyORB(const unsigned long nBodies, const std::string &scheme = "galaxy", const T soft = 0.035,
+                       const unsigned long randInit = 0, const T theta = 0.5, const unsigned long groupSize = 32,
+                       const unsigned nRanks = 2, const std::string &transport = "auto",
+                       const bool measuredCosts = true);
+    virtual ~SimulationNBodyORB();
+    virtual void computeOneIteration();
+
+    /*!
+     *  \brief Communicator getter.
+     *
+     *  \return The communicator of the rank 0.
+     */
+    const Communicator &getCommunicator() const;
+
+    /*!
+     *  \brief Load imbalance getter.
+     *
+     *  \return The cost of the most loaded rank divided by the mean cost of the ranks, at the last iteration.
+     */
+    float getImbalance() const;
+
+    /*!
+     *  \brief Domains getter.
+     *
+     *  \return The bounding box of the bodies of each rank at the last iteration.
+     */
+    const std::vector<orbDomain_t> &getDomains() const;
+
+  protected:
+    void computeIteration();
+    void distributeBodies();
+    void buildLETs();
+    void exchangeLETs();
+    void unpackLETs();
+    void walkTree(const Octree<T> &tree, const std::vector<nodeHot_t<T>> &nodesHot, const octreeNode_t &group,
+                  walkLists_t &l) const;
+    void computeGroups(const unsigned long begin, const unsigned long end, const bool remote);
+    void gatherResults();
+    void runRank();
+};
+
+#endif /* SIMULATION_N_BODY_ORB_HPP_ */
@@ -0,0 +1,82 @@
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "ImplemRegistry.hpp"
+#include "SimulationNBodyOptim.hpp"
+
+template <typename T>
+SimulationNBodyOptim<T>::SimulationNBodyOptim(const unsigned long nBodies, const std::string &scheme, const T soft,
+                                              const unsigned long randInit)
+    : SimulationNBodyInterface<T>(nBodies, scheme, soft, randInit)
+{
+    this->resizeBuffers();
+}
+
+template <typename T> void SimulationNBodyOptim<T>::resizeBuffers()
+{
+    this->flopsPerIte = 20.f * (float)this->getBodies().getN() * (float)this->getBodies().getN();
+    this->accelerations.resize(this->getBodies().getN());
+}
+
+template <typename T> void SimulationNBodyOptim<T>::computeBodiesAcceleration()
+{
+    const std::vector<dataHot_t<T>> &h = this->getBodies().getDataHot();
+    const unsigned long n = this->getBodies().getN();
+    const T softSquared = this->soft * this->soft;
+
+    // flops = n² * 20
+    for (unsigned long iBody = 0; iBody < n; iBody++) {
+        const T qix = h[iBody].qx;
+        const T qiy = h[iBody].qy;
+        const T qiz = h[iBody].qz;
+        T aix = 0, aiy = 0, aiz = 0;
+
+        // flops = n * 20
+        for (unsigned long jBody = 0; jBody < n; jBody++) {
+            const T rijx = h[jBody].qx - qix; // 1 flop
+            const T rijy = h[jBody].qy - qiy; // 1 flop
+            const T rijz = h[jBody].qz - qiz; // 1 flop
+
+            // compute the || rij ||² + e² distance between body i and body j
+            const T rijSquared = rijx * rijx + rijy * rijy + rijz * rijz + softSquared; // 6 flops
+            // compute the acceleration value between body i and body j: || ai || = G.mj / (|| rij ||² + e²)^{3/2}
+            const T rInv = (T)1 / std::sqrt(rijSquared);  // 2 flops
+            const T ai = h[jBody].gm * (rInv * rInv * rInv); // 3 flops
+
+            // add the acceleration value into the acceleration vector: ai += || ai ||.rij
+            aix += ai * rijx; // 2 flops
+            aiy += ai * rijy; // 2 flops
+            aiz += ai * rijz; // 2 flops
+        }
+
+        this->accelerations[iBody].ax = aix;
+        this->accelerations[iBody].ay = aiy;
+        this->accelerations[iBody].az = aiz;
+    }
+}
+
+template <typename T> void SimulationNBodyOptim<T>::computeOneIteration()
+{
+    this->resizeBuffers();
+    this->computeBodiesAcceleration();
+    // time integration
+    this->bodies.updatePositionsAndVelocities(this->accelerations, this->dt);
+}
+
+// ==================================================================================== explicit template instantiation
+template class SimulationNBodyOptim<double>;
+template class SimulationNBodyOptim<float>;
+// ==================================================================================== explicit template instantiation
+
+// ======================================================================================================== registration
+template <typename T> static SimulationNBodyInterface<T> *createOptim(const implemParams_t &p)
+{
+    return new SimulationNBodyOptim<T>(p.nBodies, p.scheme, p.soft);
+}
+
+static const implemCaps_t capsOptim = {"sequential direct sum on the packed hot array", "hot", false, true, {}, false};
+REGISTER_IMPLEM(optim, "cpu+optim", capsOptim, createOptim);
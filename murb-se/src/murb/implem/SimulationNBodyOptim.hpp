@@ -0,0 +1,33 @@
+#ifndef SIMULATION_N_BODY_OPTIM_HPP_
+#define SIMULATION_N_BODY_OPTIM_HPP_
+
+#include <string>
+
+#include "core/SimulationNBodyInterface.hpp"
+
+/*!
+ * \class  SimulationNBodyOptim
+ * \brief  Sequential direct sum on the packed hot array (x, y, z, G.m).
+ *
+ * \tparam T : Floating-point type (`float` or `double`).
+ *
+ * Compared to the naive version, only the positions and the masses are streamed by the inner loop (16 bytes per
+ * j-body in single precision instead of 32), G is premultiplied in the masses and `std::pow` is replaced by a square
+ * root.
+ */
+template <typename T> class SimulationNBodyOptim : public SimulationNBodyInterface<T> {
+  protected:
+    std::vector<accAoS_t<T>> accelerations; /*!< Array of body acceleration structures. */
+
+  public:
+    SimulationNBodyOptim(const unsigned long nBodies, const std::string &scheme = "galaxy", const T soft = 0.035,
+                         const unsigned long randInit = 0);
+    virtual ~SimulationNBodyOptim() = default;
+    virtual void computeOneIteration();
+
+  protected:
+    void resizeBuffers();
+    void computeBodiesAcceleration();
+};
+
+#endif /* SIMULATION_N_BODY_OPTIM_HPP_ */
@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "ImplemRegistry.hpp"
+#include "KernelsISA.hpp"
+#include "SimulationNBodyP3M.hpp"
+
+template <typename T>
+SimulationNBodyP3M<T>::SimulationNBodyP3M(const unsigned long nBodies, const std::string &scheme, const T soft,
+                                          const unsigned long randInit, const unsigned long gridSize,
+                                          const std::string &assignment, const T split, const T cutoff)
+    : SimulationNBodyInterface<T>(nBodies, scheme, soft, randInit),
+      mesh(gridSize, assignment,
+           [soft, split](const double r, const double h) {
+               // long-range part of the softened kernel: erf(s / 2rs) / s
+               const double s = std::sqrt(r * r + (double)soft * soft);
+               const double rs = split * h;
+               return s > 0 ? std::erf(s / (2. * rs)) / s : 1. / (rs * std::sqrt(std::acos(-1.)));
+           }),
+      split(split), cutoff(cutoff), nCells{1, 1, 1}
+{
+    assert(split > 0);
+    assert(cutoff > 0);
+
+    const unsigned long n = this->getBodies().getN();
+    this->flopsPerIte = 0.f;
+    this->resizeBuffers();
+    this->allocatedBytes += this->mesh.getAllocatedBytes() + n * (8 * sizeof(T) + 2 * sizeof(unsigned long));
+}
+
+template <typename T> void SimulationNBodyP3M<T>::resizeBuffers()
+{
+    const unsigned long n = this->getBodies().getN();
+    this->accelerations.ax.resize(n + this->getBodies().getPadding());
+    this->accelerations.ay.resize(n + this->getBodies().getPadding());
+    this->accelerations.az.resize(n + this->getBodies().getPadding());
+    this->gm.resize(n);
+    this->bodyCell.resize(n);
+    this->perm.resize(n);
+    this->sqx.resize(n);
+    this->sqy.resize(n);
+    this->sqz.resize(n);
+    this->sgm.resize(n);
+    this->sax.resize(n);
+    this->say.resize(n);
+    this->saz.resize(n);
+}
+
+template <typename T> void SimulationNBodyP3M<T>::buildCells(const T cellSize)
+{
+    const dataSoA_t<T> &d = this->getBodies().getDataSoA();
+    const unsigned long n = this->getBodies().getN();
+    const T *q[3] = {d.qx.data(), d.qy.data(), d.qz.data()};
+
+    // the cells are at least `cellSize` wide so the interactions within the cutoff are between neighbor cells
+    const unsigned long maxCells = 128;
+    T qMin[3], invWidth[3];
+    for (int a = 0; a < 3; a++) {
+        T mi = std::numeric_limits<T>::max(), ma = std::numeric_limits<T>::lowest();
+#pragma omp parallel for schedule(static) reduction(min : mi) reduction(max : ma)
+        for (unsigned long i = 0; i < n; i++) {
+            mi = std::min(mi, q[a][i]);
+            ma = std::max(ma, q[a][i]);
+        }
+        const T extent = ma - mi;
+        const T nc = std::floor(extent / cellSize);
+        this->nCells[a] = nc < 1 ? 1 : (nc > maxCells ? maxCells : (unsigned long)nc);
+        qMin[a] = mi;
+        invWidth[a] = extent > 0 ? this->nCells[a] / extent : 0;
+    }
+
+    // counting sort of the bodies by cell
+    const unsigned long nc = this->nCells[0] * this->nCells[1] * this->nCells[2];
+    this->cellStart.assign(nc + 1, 0);
+    for (unsigned long i = 0; i < n; i++) {
+        unsigned long c[3];
+        for (int a = 0; a < 3; a++)
+            c[a] = std::min((unsigned long)((q[a][i] - qMin[a]) * invWidth[a]), this->nCells[a] - 1);
+        this->bodyCell[i] = (c[0] * this->nCells[1] + c[1]) * this->nCells[2] + c[2];
+        this->cellStart[this->bodyCell[i] + 1]++;
+    }
+    for (unsigned long c = 0; c < nc; c++)
+        this->cellStart[c + 1] += this->cellStart[c];
+    {
+        std::vector<unsigned long> pos(this->cellStart.begin(), this->cellStart.end() - 1);
+        for (unsigned long i = 0; i < n; i++)
+            this->perm[pos[this->bodyCell[i]]++] = i;
+    }
+
+#pragma omp parallel for schedule(static)
+    for (unsigned long i = 0; i < n; i++) {
+        this->sqx[i] = d.qx[this->perm[i]];
+        this->sqy[i] = d.qy[this->perm[i]];
+        this->sqz[i] = d.qz[this->perm[i]];
+        this->sgm[i] = this->gm[this->perm[i]];
+    }
+}
+
+template <typename T> void SimulationNBodyP3M<T>::computeShortRange()
+{
+    const unsigned long n = this->getBodies().getN();
+    const T rs = this->split * this->mesh.getSpacing();
+    // the cells are half the cutoff wide: the neighborhood of a cell is 5^3 cells (15.6 rc^3 instead of 27 rc^3)
+    const long k = 2;
+    this->buildCells(this->cutoff * rs / k);
+
+    const long ncx = this->nCells[0], ncy = this->nCells[1], ncz = this->nCells[2];
+    const T softSquared = this->soft * this->soft;
+    double nInteractions = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+ : nInteractions)
+    for (long c = 0; c < ncx * ncy * ncz; c++) {
+        const unsigned long begin = this->cellStart[c];
+        const unsigned long ni = this->cellStart[c + 1] - begin;
+        if (ni == 0)
+            continue;
+        std::fill(&this->sax[begin], &this->sax[begin] + ni, (T)0);
+        std::fill(&this->say[begin], &this->say[begin] + ni, (T)0);
+        std::fill(&this->saz[begin], &this->saz[begin] + ni, (T)0);
+
+        const long cx = c / (ncy * ncz), cy = (c / ncz) % ncy, cz = c % ncz;
+        for (long x = std::max(cx - k, 0l); x <= std::min(cx + k, ncx - 1); x++)
+            for (long y = std::max(cy - k, 0l); y <= std::min(cy + k, ncy - 1); y++) {
+                // the cells (x, y, cz - k) to (x, y, cz + k) are contiguous
+                const long column = (x * ncy + y) * ncz;
+                const unsigned long jBegin = this->cellStart[column + std::max(cz - k, 0l)];
+                const unsigned long jEnd = this->cellStart[column + std::min(cz + k, ncz - 1) + 1];
+                if (jEnd == jBegin)
+                    continue;
+                computeShortRangeAccelerationsISA<T>(&this->sqx[begin], &this->sqy[begin], &this->sqz[begin], ni,
+                                                     &this->sqx[jBegin], &this->sqy[jBegin], &this->sqz[jBegin],
+                                                     &this->sgm[jBegin], jEnd - jBegin, softSquared, rs,
+                                                     &this->sax[begin], &this->say[begin], &this->saz[begin]);
+                nInteractions += (double)ni * (jEnd - jBegin);
+            }
+    }
+    this->flopsPerIte = 74.f * nInteractions;
+
+    // back to the order of the bodies
+#pragma omp parallel for schedule(static)
+    for (unsigned long i = 0; i < n; i++) {
+        this->accelerations.ax[this->perm[i]] += this->sax[i];
+        this->accelerations.ay[this->perm[i]] += this->say[i];
+        this->accelerations.az[this->perm[i]] += this->saz[i];
+    }
+}
+
+template <typename T> void SimulationNBodyP3M<T>::computeBodiesAcceleration()
+{
+    const dataSoA_t<T> &d = this->getBodies().getDataSoA();
+    const std::vector<dataHot_t<T>> &h = this->getBodies().getDataHot();
+    const unsigned long n = this->getBodies().getN();
+
+    for (unsigned long i = 0; i < n; i++)
+        this->gm[i] = h[i].gm;
+
+    std::fill(this->accelerations.ax.begin(), this->accelerations.ax.end(), (T)0);
+    std::fill(this->accelerations.ay.begin(), this->accelerations.ay.end(), (T)0);
+    std::fill(this->accelerations.az.begin(), this->accelerations.az.end(), (T)0);
+
+    // long range (also updates the grid spacing, and then the split radius)
+    this->mesh.computeAccelerations(d.qx.data(), d.qy.data(), d.qz.data(), this->gm.data(), n,
+                                    this->accelerations.ax.data(), this->accelerations.ay.data(),
+                                    this->accelerations.az.data());
+    this->computeShortRange();
+}
+
+template <typename T> void SimulationNBodyP3M<T>::computeOneIteration()
+{
+    this->resizeBuffers();
+    this->computeBodiesAcceleration();
+    // time integration
+    this->bodies.updatePositionsAndVelocities(this->accelerations, this->dt);
+}
+
+// ==================================================================================== explicit template instantiation
+template class SimulationNBodyP3M<double>;
+template class SimulationNBodyP3M<float>;
+// ==================================================================================== explicit template instantiation
+
+// ======================================================================================================== registration
+template <typename T> static SimulationNBodyInterface<T> *createP3M(const implemParams_t &p)
+{
+    return new SimulationNBodyP3M<T>(p.nBodies, p.scheme, p.soft, 0, p.gridSize, p.assignment, p.split);
+}
+
+static const implemCaps_t capsP3M = {"particle-mesh + short-range direct sums, see --split", "hot", true, false,
+                                     {"threads"}, true};
+REGISTER_IMPLEM(p3m, "cpu+p3m", capsP3M, createP3M);
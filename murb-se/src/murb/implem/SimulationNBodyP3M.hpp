@@ -0,0 +1,52 @@
+#ifndef SIMULATION_N_BODY_P3M_HPP_
+#define SIMULATION_N_BODY_P3M_HPP_
+
+#include <string>
+#include <vector>
+
+#include "ParticleMesh.hpp"
+#include "core/SimulationNBodyInterface.hpp"
+
+/*!
+ * \class  SimulationNBodyP3M
+ * \brief  Particle-particle/particle-mesh (P3M) solver: mesh for the long range, direct sums for the short range.
+ *
+ * \tparam T : Floating-point type.
+ *
+ * The softened kernel 1 / s (s² = r² + e²) is split with the split radius rs (`split` grid spacings):
+ * erf(s / 2rs) / s is smooth and computed by the particle-mesh, erfc(s / 2rs) / s decays quickly and is computed with
+ * the SIMD direct-sum kernel between the bodies of neighboring cells. The cells are at least `cutoff`.rs / 2 wide and
+ * the short-range interactions are truncated beyond 2 cells.
+ *
+ * The bodies are sorted by cell (counting sort) at each iteration: the 5 cells along z of a column are contiguous so
+ * the neighborhood of a cell is only 25 ranges of bodies. Only the short-range interactions are counted in the flops.
+ */
+template <typename T> class SimulationNBodyP3M : public SimulationNBodyInterface<T> {
+  protected:
+    ParticleMesh<T> mesh;                 /*!< The mesh solver (long range). */
+    const T split;                        /*!< Split radius, in grid spacings. */
+    const T cutoff;                       /*!< Short-range cutoff radius, in split radii. */
+    accSoA_t<T> accelerations;            /*!< Structure of arrays of body accelerations. */
+    std::vector<T> gm;                    /*!< Array of masses multiplied by G. */
+    unsigned long nCells[3];              /*!< Number of cells in each dimension. */
+    std::vector<unsigned long> cellStart; /*!< First (sorted) body of each cell, the z dimension is contiguous. */
+    std::vector<unsigned long> bodyCell;  /*!< Cell of each body. */
+    std::vector<unsigned long> perm;      /*!< Original index of each sorted body. */
+    std::vector<T> sqx, sqy, sqz, sgm;    /*!< Positions and G.masses sorted by cell. */
+    std::vector<T> sax, say, saz;         /*!< Short-range accelerations sorted by cell. */
+
+  public:
+    SimulationNBodyP3M(const unsigned long nBodies, const std::string &scheme = "galaxy", const T soft = 0.035,
+                       const unsigned long randInit = 0, const unsigned long gridSize = 64,
+                       const std::string &assignment = "tsc", const T split = 1.25, const T cutoff = 4.5);
+    virtual ~SimulationNBodyP3M() = default;
+    virtual void computeOneIteration();
+
+  protected:
+    void resizeBuffers();
+    void computeBodiesAcceleration();
+    void buildCells(const T cellSize);
+    void computeShortRange();
+};
+
+#endif /* SIMULATION_N_BODY_P3M_HPP_ */
@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "ImplemRegistry.hpp"
+#include "SimulationNBodyPM.hpp"
+
+template <typename T>
+SimulationNBodyPM<T>::SimulationNBodyPM(const unsigned long nBodies, const std::string &scheme, const T soft,
+                                        const unsigned long randInit, const unsigned long gridSize,
+                                        const std::string &assignment)
+    : SimulationNBodyInterface<T>(nBodies, scheme, soft, randInit),
+      mesh(gridSize, assignment,
+           [soft](const double r, const double h) { return 1. / std::sqrt(r * r + (double)soft * soft + h * h); })
+{
+    const unsigned long n = this->getBodies().getN();
+    this->flopsPerIte = 0.f;
+    this->resizeBuffers();
+    this->allocatedBytes += this->mesh.getAllocatedBytes() + n * sizeof(T);
+}
+
+template <typename T> void SimulationNBodyPM<T>::resizeBuffers()
+{
+    const unsigned long n = this->getBodies().getN();
+    this->accelerations.ax.resize(n + this->getBodies().getPadding());
+    this->accelerations.ay.resize(n + this->getBodies().getPadding());
+    this->accelerations.az.resize(n + this->getBodies().getPadding());
+    this->gm.resize(n);
+}
+
+template <typename T> void SimulationNBodyPM<T>::computeBodiesAcceleration()
+{
+    const dataSoA_t<T> &d = this->getBodies().getDataSoA();
+    const std::vector<dataHot_t<T>> &h = this->getBodies().getDataHot();
+    const unsigned long n = this->getBodies().getN();
+
+    for (unsigned long i = 0; i < n; i++)
+        this->gm[i] = h[i].gm;
+
+    std::fill(this->accelerations.ax.begin(), this->accelerations.ax.end(), (T)0);
+    std::fill(this->accelerations.ay.begin(), this->accelerations.ay.end(), (T)0);
+    std::fill(this->accelerations.az.begin(), this->accelerations.az.end(), (T)0);
+    this->mesh.computeAccelerations(d.qx.data(), d.qy.data(), d.qz.data(), this->gm.data(), n,
+                                    this->accelerations.ax.data(), this->accelerations.ay.data(),
+                                    this->accelerations.az.data());
+}
+
+template <typename T> void SimulationNBodyPM<T>::computeOneIteration()
+{
+    this->resizeBuffers();
+    this->computeBodiesAcceleration();
+    // time integration
+    this->bodies.updatePositionsAndVelocities(this->accelerations, this->dt);
+}
+
+// ==================================================================================== explicit template instantiation
+template class SimulationNBodyPM<double>;
+template class SimulationNBodyPM<float>;
+// ==================================================================================== explicit template instantiation
+
+// ======================================================================================================== registration
+template <typename T> static SimulationNBodyInterface<T> *createPM(const implemParams_t &p)
+{
+    return new SimulationNBodyPM<T>(p.nBodies, p.scheme, p.soft, 0, p.gridSize, p.assignment);
+}
+
+static const implemCaps_t capsPM = {"particle-mesh, see --grid and --assign", "hot", true, false, {"threads"}, false};
+REGISTER_IMPLEM(pm, "cpu+pm", capsPM, createPM);
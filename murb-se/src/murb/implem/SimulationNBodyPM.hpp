@@ -0,0 +1,36 @@
+#ifndef SIMULATION_N_BODY_PM_HPP_
+#define SIMULATION_N_BODY_PM_HPP_
+
+#include <string>
+
+#include "ParticleMesh.hpp"
+#include "core/SimulationNBodyInterface.hpp"
+
+/*!
+ * \class  SimulationNBodyPM
+ * \brief  Particle-mesh solver: the forces are computed on a grid with FFTs (isolated boundary conditions).
+ *
+ * \tparam T : Floating-point type.
+ *
+ * The kernel is the softened potential 1 / (r² + e² + h²)^{1/2}: the grid spacing h limits the resolution, the forces
+ * between bodies closer than a few cells are underestimated. The cost is O(n + gridSize^3.log(gridSize)).
+ */
+template <typename T> class SimulationNBodyPM : public SimulationNBodyInterface<T> {
+  protected:
+    ParticleMesh<T> mesh;      /*!< The mesh solver. */
+    accSoA_t<T> accelerations; /*!< Structure of arrays of body accelerations. */
+    std::vector<T> gm;         /*!< Array of masses multiplied by G. */
+
+  public:
+    SimulationNBodyPM(const unsigned long nBodies, const std::string &scheme = "galaxy", const T soft = 0.035,
+                      const unsigned long randInit = 0, const unsigned long gridSize = 64,
+                      const std::string &assignment = "tsc");
+    virtual ~SimulationNBodyPM() = default;
+    virtual void computeOneIteration();
+
+  protected:
+    void resizeBuffers();
+    void computeBodiesAcceleration();
+};
+
+#endif /* SIMULATION_N_BODY_PM_HPP_ */
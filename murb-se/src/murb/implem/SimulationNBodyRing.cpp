@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "ImplemRegistry.hpp"
+#include "KernelsISA.hpp"
+#include "SimulationNBodyRing.hpp"
+#include "utils/TaskScheduler.hpp"
+
+/* message of the rank 0 to the other ranks before each iteration */
+struct ringCommand_t {
+    int32_t iterate; /*!< 1 to compute an iteration, 0 to end the rank. */
+    double dt;       /*!< Time step of the iteration. */
+};
+
+template <typename T>
+SimulationNBodyRing<T>::SimulationNBodyRing(const unsigned long nBodies, const std::string &scheme, const T soft,
+                                            const unsigned long randInit, const unsigned nRanks,
+                                            const std::string &transport, const unsigned long tileSize)
+    : SimulationNBodyInterface<T>(nBodies, scheme, soft, randInit), tileSize(tileSize)
+{
+    assert(tileSize > 0);
+    // the instruction set is detected once, before the parallel regions and the fork of the ranks
+    getSelectedISA();
+    const unsigned long n = this->getBodies().getN();
+    this->flopsPerIte = 20.f * (float)n * (float)n;
+    this->accelerations.ax.resize(n);
+    this->accelerations.ay.resize(n);
+    this->accelerations.az.resize(n);
+
+    this->comm.reset(Communicator::create(transport, nRanks));
+    unsigned long maxBlock = 0;
+    for (unsigned r = 0; r < this->comm->getSize(); r++)
+        maxBlock = std::max(maxBlock, this->getRangeBegin(r + 1) - this->getRangeBegin(r));
+    this->blocks[0].resize(maxBlock);
+    this->blocks[1].resize(maxBlock);
+    this->allocatedBytes += 2 * maxBlock * sizeof(dataHot_t<T>);
+
+    // the other ranks compute the iterations until the end of the rank 0, they do not return
+    if (this->comm->getRank() != 0)
+        this->runRank();
+}
+
+template <typename T> SimulationNBodyRing<T>::~SimulationNBodyRing()
+{
+    const ringCommand_t stop = {0, 0.};
+    for (unsigned r = 1; r < this->comm->getSize(); r++)
+        this->comm->send(r, &stop, sizeof(stop));
+}
+
+template <typename T> const Communicator &SimulationNBodyRing<T>::getCommunicator() const { return *this->comm; }
+
+template <typename T> unsigned long SimulationNBodyRing<T>::getRangeBegin(const unsigned rank) const
+{
+    return (unsigned long)rank * this->getBodies().getN() / this->comm->getSize();
+}
+
+template <typename T> void SimulationNBodyRing<T>::runRank()
+{
+    ringCommand_t command;
+    while (this->comm->recv(0, &command, sizeof(command)) && command.iterate)
+        this->computeIteration((T)command.dt);
+    this->comm->exitRank();
+}
+
+template <typename T> void SimulationNBodyRing<T>::computeBlock(const dataHot_t<T> *hj, const unsigned long nj)
+{
+    const dataSoA_t<T> &d = this->getBodies().getDataSoA();
+    const unsigned long iBegin = this->getRangeBegin(this->comm->getRank());
+    const unsigned long iEnd = this->getRangeBegin(this->comm->getRank() + 1);
+    const unsigned long nTiles = (iEnd - iBegin + this->tileSize - 1) / this->tileSize;
+    const T softSquared = this->soft * this->soft;
+    accSoA_t<T> &a = this->accelerations;
+
+    // flops = (iEnd - iBegin) * nj * 20
+    TaskScheduler::get().parallelForAffinity(0, nTiles, 1, [&](unsigned long tileBegin, unsigned long tileEnd) {
+        for (unsigned long iTile = tileBegin; iTile < tileEnd; iTile++) {
+            const unsigned long iBeg = iBegin + iTile * this->tileSize;
+            const unsigned long ni = std::min(this->tileSize, iEnd - iBeg);
+            computeAccelerationsISA<T>(&d.qx[iBeg], &d.qy[iBeg], &d.qz[iBeg], ni, hj, nj, softSquared, &a.ax[iBeg],
+                                       &a.ay[iBeg], &a.az[iBeg]);
+        }
+    });
+}
+
+template <typename T> void SimulationNBodyRing<T>::computeIteration(const T dt)
+{
+    const unsigned rank = this->comm->getRank();
+    const unsigned size = this->comm->getSize();
+    const unsigned long iBegin = this->getRangeBegin(rank);
+    const unsigned long iEnd = this->getRangeBegin(rank + 1);
+    accSoA_t<T> &a = this->accelerations;
+    std::fill(a.ax.begin() + iBegin, a.ax.begin() + iEnd, (T)0);
+    std::fill(a.ay.begin() + iBegin, a.ay.begin() + iEnd, (T)0);
+    std::fill(a.az.begin() + iBegin, a.az.begin() + iEnd, (T)0);
+
+    // the step `s` computes the block of the rank `rank - s`, the block of the next step is exchanged meanwhile
+    const std::vector<dataHot_t<T>> &h = this->getBodies().getDataHot();
+    std::copy(h.begin() + iBegin, h.begin() + iEnd, this->blocks[0].begin());
+    int cur = 0;
+    for (unsigned s = 0; s < size; s++) {
+        const unsigned origin = (rank + size - s) % size;
+        const unsigned long nj = this->getRangeBegin(origin + 1) - this->getRangeBegin(origin);
+        if (s + 1 < size) {
+            const unsigned nextOrigin = (origin + size - 1) % size;
+            const unsigned long njNext = this->getRangeBegin(nextOrigin + 1) - this->getRangeBegin(nextOrigin);
+            this->comm->startSendRecv((rank + 1) % size, this->blocks[cur].data(), nj * sizeof(dataHot_t<T>),
+                                      (rank + size - 1) % size, this->blocks[1 - cur].data(),
+                                      njNext * sizeof(dataHot_t<T>));
+        }
+        this->computeBlock(this->blocks[cur].data(), nj);
+        if (s + 1 < size) {
+            this->comm->waitSendRecv();
+            cur = 1 - cur;
+        }
+    }
+
+    // the rank 0 integrates all the bodies with the accelerations of the other ranks: same results as their owners
+    T dtIte = dt;
+    if (rank != 0) {
+        const size_t bytes = (iEnd - iBegin) * sizeof(T);
+        this->comm->send(0, &a.ax[iBegin], bytes);
+        this->comm->send(0, &a.ay[iBegin], bytes);
+        this->comm->send(0, &a.az[iBegin], bytes);
+        this->bodies.updatePositionsAndVelocities(a, dtIte, iBegin, iEnd);
+    }
+    else {
+        for (unsigned r = 1; r < size; r++) {
+            const unsigned long b = this->getRangeBegin(r);
+            const size_t bytes = (this->getRangeBegin(r + 1) - b) * sizeof(T);
+            if (!this->comm->recv(r, &a.ax[b], bytes) || !this->comm->recv(r, &a.ay[b], bytes) ||
+                !this->comm->recv(r, &a.az[b], bytes)) {
+                std::cout << "The rank " << r << " has ended before the rank 0... exiting." << std::endl;
+                exit(-1);
+            }
+        }
+        this->bodies.updatePositionsAndVelocities(a, dtIte);
+    }
+}
+
+template <typename T> void SimulationNBodyRing<T>::computeOneIteration()
+{
+    const ringCommand_t command = {1, (double)this->dt};
+    for (unsigned r = 1; r < this->comm->getSize(); r++)
+        this->comm->send(r, &command, sizeof(command));
+    this->computeIteration(this->dt);
+}
+
+template <typename T> bool SimulationNBodyRing<T>::updateBodiesLayout()
+{
+    // the ranks own fixed ranges of bodies: they do not move in memory
+    return false;
+}
+
+template <typename T>
+unsigned long SimulationNBodyRing<T>::addBody(const T mi, const T ri, const T qix, const T qiy, const T qiz,
+                                              const T vix, const T viy, const T viz)
+{
+    // the other ranks would keep the ranges of the previous number of bodies
+    std::cout << "(EE) `cpu+ring` can not add a body, the ranks own fixed ranges of bodies." << std::endl;
+    std::exit(-1);
+}
+
+template <typename T> void SimulationNBodyRing<T>::removeBody(const unsigned long iBody)
+{
+    std::cout << "(EE) `cpu+ring` can not remove a body, the ranks own fixed ranges of bodies." << std::endl;
+    std::exit(-1);
+}
+
+// ==================================================================================== explicit template instantiation
+template class SimulationNBodyRing<double>;
+template class SimulationNBodyRing<float>;
+// ==================================================================================== explicit template instantiation
+
+// ======================================================================================================== registration
+template <typename T> static SimulationNBodyInterface<T> *createRing(const implemParams_t &p)
+{
+    return new SimulationNBodyRing<T>(p.nBodies, p.scheme, p.soft, 0, p.ranks, p.transport, p.tileSize);
+}
+
+// not a candidate of `--im auto`: the calibration would start the ranks
+static const implemCaps_t capsRing = {"direct sum distributed over processes, j-blocks exchanged in a ring (--ranks, "
+                                      "--transport)",
+                                      "hot", true, false, {"tile"}, true};
+REGISTER_IMPLEM(ring, "cpu+ring", capsRing, createRing);
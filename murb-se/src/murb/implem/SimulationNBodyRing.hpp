@@ -0,0 +1,60 @@
+#ifndef SIMULATION_N_BODY_RING_HPP_
+#define SIMULATION_N_BODY_RING_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/SimulationNBodyInterface.hpp"
+#include "utils/Communicator.hpp"
+
+/*!
+ * \class  SimulationNBodyRing
+ * \brief  Direct sum distributed over processes (ranks): each rank owns a contiguous range of i-bodies and the blocks
+ *         of j-bodies circulate in a ring.
+ *
+ * \tparam T : Floating-point type (`float` or `double`).
+ *
+ * At each iteration, the rank 0 sends the time step to the other ranks and each rank starts with the j-block of its
+ * own bodies. In `nRanks` steps, the block received from the left neighbour at the previous step is sent to the
+ * right neighbour while the accelerations of the own bodies are computed with the current block (SIMD kernel of
+ * `KernelsISA.hpp`, tiles on the threads of the task scheduler): the communications overlap the computations. Each
+ * rank integrates its bodies and sends their accelerations to the rank 0, which integrates all the bodies with the
+ * same accelerations (the bodies of the rank 0 are the ones of the output and of the visualization).
+ *
+ * The bodies do not move in memory (the ranks own fixed ranges): the collisions and the reorderings are disabled, and
+ * adding or removing a body, which would change the ranges of the rank 0 only, exits with an error.
+ */
+template <typename T> class SimulationNBodyRing : public SimulationNBodyInterface<T> {
+  protected:
+    const unsigned long tileSize;        /*!< Number of i-bodies per task of the task scheduler. */
+    std::unique_ptr<Communicator> comm;  /*!< Transport between the ranks. */
+    accSoA_t<T> accelerations;           /*!< Accelerations of the own bodies (of all the bodies on the rank 0). */
+    std::vector<dataHot_t<T>> blocks[2]; /*!< Current and next j-blocks of the ring. */
+
+  public:
+    SimulationNBodyRing(const unsigned long nBodies, const std::string &scheme = "galaxy", const T soft = 0.035,
+                        const unsigned long randInit = 0, const unsigned nRanks = 2,
+                        const std::string &transport = "auto", const unsigned long tileSize = 256);
+    virtual ~SimulationNBodyRing();
+    virtual void computeOneIteration();
+    virtual bool updateBodiesLayout();
+    virtual unsigned long addBody(const T mi, const T ri, const T qix, const T qiy, const T qiz, const T vix,
+                                  const T viy, const T viz);
+    virtual void removeBody(const unsigned long iBody);
+
+    /*!
+     *  \brief Communicator getter.
+     *
+     *  \return The communicator of the rank 0.
+     */
+    const Communicator &getCommunicator() const;
+
+  protected:
+    unsigned long getRangeBegin(const unsigned rank) const;
+    void computeIteration(const T dt);
+    void computeBlock(const dataHot_t<T> *hj, const unsigned long nj);
+    void runRank();
+};
+
+#endif /* SIMULATION_N_BODY_RING_HPP_ */
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "ImplemRegistry.hpp"
+#include "KernelsISA.hpp"
+#include "SimulationNBodySIMD.hpp"
+#include "utils/Numa.hpp"
+#include "utils/TaskScheduler.hpp"
+
+template <typename T>
+SimulationNBodySIMD<T>::SimulationNBodySIMD(const unsigned long nBodies, const std::string &scheme, const T soft,
+                                            const unsigned long randInit, const unsigned long tileSize,
+                                            const bool dynamicSchedule, const bool replicate)
+    : SimulationNBodyInterface<T>(nBodies, scheme, soft, randInit), tileSize(tileSize),
+      dynamicSchedule(dynamicSchedule), replicate(replicate)
+{
+    assert(tileSize > 0);
+    // the instruction set is detected once, before the parallel regions
+    getSelectedISA();
+    this->resizeBuffers();
+}
+
+template <typename T> void SimulationNBodySIMD<T>::resizeBuffers()
+{
+    const unsigned long n = this->getBodies().getN();
+    this->flopsPerIte = 20.f * (float)n * (float)n;
+    const bool firstAllocation = this->accelerations.ax.empty();
+    this->accelerations.ax.resize(n + this->getBodies().getPadding());
+    this->accelerations.ay.resize(n + this->getBodies().getPadding());
+    this->accelerations.az.resize(n + this->getBodies().getPadding());
+    // the accelerations are zeroed (first touched) by the thread of their tile
+    if (firstAllocation)
+        for (std::vector<T> *a : {&this->accelerations.ax, &this->accelerations.ay, &this->accelerations.az})
+            Numa::releasePages(a->data(), a->size() * sizeof(T));
+}
+
+template <typename T> void SimulationNBodySIMD<T>::replicateBodies()
+{
+    TaskScheduler &scheduler = TaskScheduler::get();
+    const std::vector<dataHot_t<T>> &h = this->getBodies().getDataHot();
+    const unsigned long n = this->getBodies().getN();
+    const unsigned nThreads = scheduler.getNumThreads();
+
+    // rank of each thread among the threads of its node
+    std::vector<unsigned> node(nThreads), rank(nThreads), nThreadsNode(Numa::getNodes().size(), 0);
+    for (unsigned t = 0; t < nThreads; t++) {
+        node[t] = scheduler.getThreadNode(t);
+        rank[t] = nThreadsNode[node[t]]++;
+    }
+    this->replicas.resize(nThreadsNode.size());
+    for (std::vector<dataHot_t<T>> &replica : this->replicas)
+        if (replica.size() < n) {
+            std::vector<dataHot_t<T>>(this->getBodies().getCapacity()).swap(replica);
+            Numa::releasePages(replica.data(), replica.size() * sizeof(dataHot_t<T>));
+        }
+
+    // each thread copies its part of the replica of its node
+    scheduler.parallelForAffinity(0, nThreads, 1, [&](unsigned long tBegin, unsigned long tEnd) {
+        for (unsigned long t = tBegin; t < tEnd; t++) {
+            const unsigned long jBeg = rank[t] * n / nThreadsNode[node[t]];
+            const unsigned long jEnd = (rank[t] + 1) * n / nThreadsNode[node[t]];
+            std::copy(h.begin() + jBeg, h.begin() + jEnd, this->replicas[node[t]].begin() + jBeg);
+        }
+    });
+}
+
+template <typename T> void SimulationNBodySIMD<T>::computeBodiesAcceleration()
+{
+    // the i-bodies are loaded from the SoA arrays, the j-bodies are streamed from the packed hot array (or its replica
+    // on the node of the thread), the kernel is the one of the instruction set selected at runtime
+    const dataSoA_t<T> &d = this->getBodies().getDataSoA();
+    const std::vector<dataHot_t<T>> &h = this->getBodies().getDataHot();
+    const unsigned long n = this->getBodies().getN();
+    const unsigned long nTiles = (n + this->tileSize - 1) / this->tileSize;
+    const T softSquared = this->soft * this->soft;
+    accSoA_t<T> &a = this->accelerations;
+    if (this->replicate)
+        this->replicateBodies();
+
+    // flops = n² * 20
+    TaskScheduler &scheduler = TaskScheduler::get();
+    auto computeTiles = [&](unsigned long tileBegin, unsigned long tileEnd) {
+        const dataHot_t<T> *hj =
+            this->replicate ? this->replicas[scheduler.getThreadNode(TaskScheduler::getThreadId())].data() : h.data();
+        for (unsigned long iTile = tileBegin; iTile < tileEnd; iTile++) {
+            const unsigned long iBeg = iTile * this->tileSize;
+            const unsigned long ni = std::min(this->tileSize, n - iBeg);
+            std::fill(&a.ax[iBeg], &a.ax[iBeg] + ni, (T)0);
+            std::fill(&a.ay[iBeg], &a.ay[iBeg] + ni, (T)0);
+            std::fill(&a.az[iBeg], &a.az[iBeg] + ni, (T)0);
+            computeAccelerationsISA<T>(&d.qx[iBeg], &d.qy[iBeg], &d.qz[iBeg], ni, hj, n, softSquared, &a.ax[iBeg],
+                                       &a.ay[iBeg], &a.az[iBeg]);
+        }
+    };
+    // static: the same part of the tiles on the same thread at each iteration (stolen only if a thread is late),
+    // dynamic: the tiles one by one
+    if (this->dynamicSchedule)
+        scheduler.parallelFor(0, nTiles, 1, computeTiles);
+    else
+        scheduler.parallelForAffinity(0, nTiles, 1, computeTiles);
+}
+
+template <typename T> void SimulationNBodySIMD<T>::computeOneIteration()
+{
+    this->resizeBuffers();
+    this->computeBodiesAcceleration();
+    // time integration
+    this->bodies.updatePositionsAndVelocities(this->accelerations, this->dt);
+}
+
+// ==================================================================================== explicit template instantiation
+template class SimulationNBodySIMD<double>;
+template class SimulationNBodySIMD<float>;
+// ==================================================================================== explicit template instantiation
+
+// ======================================================================================================== registration
+template <typename T> static SimulationNBodyInterface<T> *createSIMD(const implemParams_t &p)
+{
+    return new SimulationNBodySIMD<T>(p.nBodies, p.scheme, p.soft, 0, p.tileSize, p.schedule == "dynamic",
+                                      p.replicate);
+}
+
+static const implemCaps_t capsSIMD = {"direct sum vectorized with MIPP, instruction set dispatched at runtime (--isa)",
+                                      "hot", true, true, {"threads", "tile", "schedule"}, true};
+REGISTER_IMPLEM(simd, "cpu+simd", capsSIMD, createSIMD);
@@ -0,0 +1,40 @@
+#ifndef SIMULATION_N_BODY_SIMD_HPP_
+#define SIMULATION_N_BODY_SIMD_HPP_
+
+#include <string>
+#include <vector>
+
+#include "core/SimulationNBodyInterface.hpp"
+
+/*!
+ * \class  SimulationNBodySIMD
+ * \brief  Direct sum vectorized with MIPP on the SoA data layout, the instruction set is selected at runtime (see
+ *         `KernelsISA.hpp`) and the tiles of i-bodies are distributed over the threads of the task scheduler.
+ *
+ * The static schedule keeps the same tiles on the same threads from one iteration to the next (the accelerations are
+ * first touched by their thread) and, on the NUMA hosts, the j-bodies can be replicated on each node.
+ *
+ * \tparam T : Floating-point type (`float` or `double`).
+ */
+template <typename T> class SimulationNBodySIMD : public SimulationNBodyInterface<T> {
+  protected:
+    const unsigned long tileSize;                    /*!< Number of i-bodies per task of the task scheduler. */
+    const bool dynamicSchedule;                      /*!< Dynamic scheduling of the tiles (static otherwise). */
+    const bool replicate;                            /*!< Copy of the j-bodies on each NUMA node. */
+    accSoA_t<T> accelerations;                       /*!< Structure of arrays of body accelerations. */
+    std::vector<std::vector<dataHot_t<T>>> replicas; /*!< Copies of the j-bodies, one per NUMA node. */
+
+  public:
+    SimulationNBodySIMD(const unsigned long nBodies, const std::string &scheme = "galaxy", const T soft = 0.035,
+                        const unsigned long randInit = 0, const unsigned long tileSize = 256,
+                        const bool dynamicSchedule = false, const bool replicate = false);
+    virtual ~SimulationNBodySIMD() = default;
+    virtual void computeOneIteration();
+
+  protected:
+    void resizeBuffers();
+    void replicateBodies();
+    void computeBodiesAcceleration();
+};
+
+#endif /* SIMULATION_N_BODY_SIMD_HPP_ */
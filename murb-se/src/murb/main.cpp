@@ -8,26 +8,39 @@
 #include <vector>
 
 #include "ogl/SpheresVisu.hpp"
+#include "ogl/SpheresVisuFrames.hpp"
 #include "ogl/SpheresVisuNo.hpp"
 #ifdef VISU
 #include "ogl/OGLSpheresVisuGS.hpp"
 #include "ogl/OGLSpheresVisuInst.hpp"
+#include "ogl/OGLSpheresVisuThread.hpp"
 #endif
 
 #include "core/Bodies.hpp"
 #include "utils/ArgumentsReader.hpp"
+#include "utils/Communicator.hpp"
+#include "utils/Numa.hpp"
 #include "utils/Perf.hpp"
+#include "utils/TaskScheduler.hpp"
 
-#include "implem/SimulationNBodyNaive.hpp"
+#include "implem/Autotuner.hpp"
+#include "implem/ImplemRegistry.hpp"
+#include "implem/KernelsISA.hpp"
 
 /* global variables */
 unsigned long NBodies;               /*!< Number of bodies. */
 unsigned long NIterations;           /*!< Number of iterations. */
 std::string ImplTag = "cpu+naive";   /*!< Implementation id. */
+bool AutoImplem = false;             /*!< The implementation has been selected by a calibration (`--im auto`). */
+bool Autotune = false;               /*!< Search the knobs of the implementation (`--autotune`). */
+std::string Tuning;                  /*!< Knobs of the implementation and their origin (for the banner). */
 bool Verbose = false;                /*!< Mode verbose. */
 bool GSEnable = true;                /*!< Enable geometry shader. */
 bool VisuEnable = true;              /*!< Enable visualization. */
 bool VisuColor = true;               /*!< Enable visualization with colors. */
+bool VisuThread = false;             /*!< Render the visualization on its own thread (`--vthread`). */
+std::string FramesDir;               /*!< Directory of the headless images (`--frames`, empty = no image). */
+unsigned long FramesPeriod = 10;     /*!< Number of iterations between two headless images. */
 float Dt = 3600;                     /*!< Time step in seconds. */
 float MinDt = 200;                   /*!< Minimum time step. */
 float Softening = 2e+08;             /*!< Softening factor value. */
@@ -36,6 +49,20 @@ unsigned int WinHeight = 768;        /*!< Window height for visualization. */
 unsigned int LocalWGSize = 32;       /*!< OpenCL local workgroup size. */
 std::string BodiesScheme = "galaxy"; /*!< Initial condition of the bodies. */
 bool ShowGFlops = false;             /*!< Display the GFlop/s. */
+std::string Precision = "fp32";      /*!< Floating-point precision (`fp32`, `fp64` or `mixed`). */
+unsigned long ReorderPeriod = 0;     /*!< Period of the Morton reordering of the bodies (0 = disabled). */
+int Order = 4;                       /*!< Expansion order of the fast multipole method. */
+float Theta = 0.5f;                  /*!< Opening angle of the tree methods. */
+unsigned long GridSize = 64;         /*!< Number of nodes per dimension of the particle-mesh grid. */
+std::string Assignment = "tsc";      /*!< Mass assignment scheme of the particle-mesh (`cic` or `tsc`). */
+float Split = 1.25f;                 /*!< Split radius of the P3M solver, in grid spacings. */
+unsigned long RebuildPeriod = 1;     /*!< Period of the rebuilds of the octree (refitted in between). */
+float Cutoff = 5e7;                  /*!< Cutoff radius of the truncated gravity (`cpu+cutoff`). */
+bool Collisions = false;             /*!< Merge the colliding bodies after each iteration. */
+std::string ISA = "auto";            /*!< Instruction set of the dispatched SIMD kernels (`auto` = widest supported). */
+std::string NumaPolicy = "auto";     /*!< Placement on the NUMA nodes (`auto`, `off`, `pin` or `replicate`). */
+unsigned Ranks = 2;                  /*!< Number of ranks of the distributed implementations (`sockets`). */
+std::string Transport = "auto";      /*!< Transport between the ranks (`auto`, `sockets` or `mpi`). */
 
 /*!
  * \fn     void argsReader(int argc, char** argv)
@@ -72,10 +99,24 @@ void argsReader(int argc, char **argv)
     docArgs["-nv"] = "no visualization (disable visu).";
     faculArgs["-nvc"] = "";
     docArgs["-nvc"] = "visualization without colors.";
+    faculArgs["-vthread"] = "";
+    docArgs["-vthread"] = "render the visualization on its own thread from snapshots of the bodies, the simulation "
+                          "does not wait for the display (Linux/X11).";
+    faculArgs["-frames"] = "directory";
+    docArgs["-frames"] = "headless visualization: draw the bodies without display nor GPU in PPM images written in "
+                         "'directory' by a separate thread (size of --ww and --wh), replaces the window.";
+    faculArgs["-fperiod"] = "period";
+    docArgs["-fperiod"] = "number of iterations between two images of --frames (default is " +
+                          std::to_string(FramesPeriod) + ").";
     faculArgs["-im"] = "ImplTag";
-    docArgs["-im"] = "code implementation tag:\n"
-                     "\t\t\t - \"cpu+naive\"\n"
-                     "\t\t\t ----";
+    docArgs["-im"] = "code implementation tag, \"list\" to print them or \"auto\" to select the fastest direct sum "
+                     "with a short calibration:\n" +
+                     ImplemRegistry::getDescription("\t\t\t - ") + "\t\t\t ----";
+    faculArgs["-precision"] = "precision";
+    docArgs["-precision"] = "floating-point precision, can be \"fp32\" (default), \"fp64\" or \"mixed\" (fp64 "
+                            "positions and velocities, fp32 interactions).";
+    faculArgs["-fp64"] = "";
+    docArgs["-fp64"] = "double precision (same as \"--precision fp64\").";
     faculArgs["-soft"] = "softeningFactor";
     docArgs["-soft"] = "softening factor.";
 #ifdef USE_OCL
@@ -86,8 +127,59 @@ void argsReader(int argc, char **argv)
     docArgs["s"] = "bodies scheme (initial conditions can be \"galaxy\" or \"random\").";
     faculArgs["-gf"] = "";
     docArgs["-gf"] = "display the number of GFlop/s.";
-
-    if (argsReader.parse_arguments(reqArgs, faculArgs)) {
+    faculArgs["-order"] = "order";
+    docArgs["-order"] = "expansion order of the fast multipole method (default is " + std::to_string(Order) + ").";
+    faculArgs["-theta"] = "theta";
+    docArgs["-theta"] = "opening angle of the tree methods, in ]0, 1[ (default is " + std::to_string(Theta) + ").";
+    faculArgs["-grid"] = "gridSize";
+    docArgs["-grid"] = "number of nodes per dimension of the particle-mesh grid, power of 2 (default is " +
+                       std::to_string(GridSize) + ").";
+    faculArgs["-assign"] = "scheme";
+    docArgs["-assign"] =
+        "mass assignment of the particle-mesh, \"cic\" or \"tsc\" (default is \"" + Assignment + "\").";
+    faculArgs["-split"] = "split";
+    docArgs["-split"] = "split radius between the mesh and the direct sums of the P3M solver, in grid spacings "
+                        "(default is " + std::to_string(Split) + ").";
+    faculArgs["-reorder"] = "period";
+    docArgs["-reorder"] = "reorder the bodies in memory along a Morton curve every 'period' iterations, or sooner if "
+                          "the locality degrades (default is 0 = disabled).";
+    faculArgs["-cutoff"] = "radius";
+    docArgs["-cutoff"] = "cutoff radius of the truncated gravity, the farther pairs do not interact (default is " +
+                         std::to_string(Cutoff) + " m).";
+    faculArgs["-collisions"] = "";
+    docArgs["-collisions"] = "merge the overlapping bodies (radius) after each iteration, the number of bodies "
+                             "decreases.";
+    faculArgs["-rebuild"] = "period";
+    docArgs["-rebuild"] = "rebuild the octree of the tree methods every 'period' iterations and only refit it in "
+                          "between (default is " + std::to_string(RebuildPeriod) + ").";
+    faculArgs["-autotune"] = "";
+    docArgs["-autotune"] = "search the tile size, the number of threads, the schedule and the leaf size of the "
+                           "implementation with short timed runs and save them in the cache of the host (loaded "
+                           "automatically by the next runs).";
+    faculArgs["-isa"] = "isa";
+    docArgs["-isa"] = "instruction set of the SIMD kernels dispatched at runtime (the implementations marked \"--isa\" "
+                      "in the list), can be \"auto\" (default, the widest supported by the CPU), \"sse2\", \"avx2\" "
+                      "or \"avx512\".";
+    faculArgs["-ranks"] = "nRanks";
+    docArgs["-ranks"] = "number of processes of \"cpu+ring\" and \"cpu+bh+orb\" with the \"sockets\" transport "
+                        "(default is " + std::to_string(Ranks) + ", the one of mpirun with MPI).";
+    faculArgs["-transport"] = "transport";
+    docArgs["-transport"] = "transport between the processes of \"cpu+ring\" and \"cpu+bh+orb\", can be \"auto\" "
+                            "(default, \"mpi\" if compiled with MPI), \"sockets\" (built-in, the processes are forked "
+                            "and connected by Unix sockets) or \"mpi\" (run with mpirun).";
+    faculArgs["-numa"] = "policy";
+    docArgs["-numa"] = "placement of the threads of the task scheduler, can be \"auto\" (default, \"pin\" on the hosts "
+                       "with several NUMA nodes, \"off\" otherwise), \"off\", \"pin\" (threads pinned on the CPUs of "
+                       "the nodes one after the other) or \"replicate\" (\"pin\" and a copy of the j-bodies of "
+                       "\"cpu+simd\" on each node).";
+
+    const bool parsed = argsReader.parse_arguments(reqArgs, faculArgs);
+    // the list of the implementations does not need the other arguments
+    if (argsReader.exist_argument("-im") && argsReader.get_argument("-im") == "list") {
+        std::cout << ImplemRegistry::getDescription();
+        exit(0);
+    }
+    if (parsed) {
         NBodies = stoi(argsReader.get_argument("n"));
         NIterations = stoi(argsReader.get_argument("i"));
     }
@@ -121,6 +213,35 @@ void argsReader(int argc, char **argv)
         VisuEnable = false;
     if (argsReader.exist_argument("-nvc"))
         VisuColor = false;
+    if (argsReader.exist_argument("-vthread"))
+        VisuThread = true;
+    if (argsReader.exist_argument("-frames"))
+        FramesDir = argsReader.get_argument("-frames");
+    if (argsReader.exist_argument("-fperiod")) {
+        FramesPeriod = stoul(argsReader.get_argument("-fperiod"));
+        if (FramesPeriod == 0) {
+            std::cout << "The period of the images has to be positive... exiting." << std::endl;
+            exit(-1);
+        }
+    }
+    if (argsReader.exist_argument("-precision")) {
+        Precision = argsReader.get_argument("-precision");
+        if (Precision != "fp32" && Precision != "fp64" && Precision != "mixed") {
+            std::cout << "Precision '" << Precision << "' does not exist... exiting." << std::endl;
+            exit(-1);
+        }
+        // the mixed-precision code is only available in SIMD
+        if (Precision == "mixed")
+            ImplTag = "cpu+simd";
+    }
+    if (argsReader.exist_argument("-fp64")) {
+        // "--fp64" is "--precision fp64": another precision is a contradiction, whatever the order of the arguments
+        if (argsReader.exist_argument("-precision") && Precision != "fp64") {
+            std::cout << "The precision '" << Precision << "' can not be combined with --fp64... exiting." << std::endl;
+            exit(-1);
+        }
+        Precision = "fp64";
+    }
     if (argsReader.exist_argument("-im"))
         ImplTag = argsReader.get_argument("-im");
     if (argsReader.exist_argument("-soft")) {
@@ -138,6 +259,95 @@ void argsReader(int argc, char **argv)
         BodiesScheme = argsReader.get_argument("s");
     if (argsReader.exist_argument("-gf"))
         ShowGFlops = true;
+    if (argsReader.exist_argument("-order")) {
+        Order = stoi(argsReader.get_argument("-order"));
+        if (Order < 1) {
+            std::cout << "The expansion order has to be at least 1... exiting." << std::endl;
+            exit(-1);
+        }
+    }
+    if (argsReader.exist_argument("-theta")) {
+        Theta = stof(argsReader.get_argument("-theta"));
+        if (Theta <= 0.f || Theta >= 1.f) {
+            std::cout << "The opening angle has to be in ]0, 1[... exiting." << std::endl;
+            exit(-1);
+        }
+    }
+    if (argsReader.exist_argument("-grid")) {
+        GridSize = stoul(argsReader.get_argument("-grid"));
+        if (GridSize < 16 || (GridSize & (GridSize - 1)) != 0) {
+            std::cout << "The grid size has to be a power of 2 greater or equal to 16... exiting." << std::endl;
+            exit(-1);
+        }
+    }
+    if (argsReader.exist_argument("-assign")) {
+        Assignment = argsReader.get_argument("-assign");
+        if (Assignment != "cic" && Assignment != "tsc") {
+            std::cout << "Mass assignment '" << Assignment << "' does not exist... exiting." << std::endl;
+            exit(-1);
+        }
+    }
+    if (argsReader.exist_argument("-split")) {
+        Split = stof(argsReader.get_argument("-split"));
+        if (Split <= 0.f) {
+            std::cout << "The split radius has to be positive... exiting." << std::endl;
+            exit(-1);
+        }
+    }
+    if (argsReader.exist_argument("-collisions"))
+        Collisions = true;
+    if (argsReader.exist_argument("-reorder"))
+        ReorderPeriod = stoul(argsReader.get_argument("-reorder"));
+    // the bodies of the distributed implementations do not move in memory (ranges or domains of the ranks)
+    if ((ImplTag == "cpu+ring" || ImplTag == "cpu+bh+orb") && (Collisions || ReorderPeriod)) {
+        std::cout << "The collisions and the reordering are not available with '" << ImplTag << "'... exiting."
+                  << std::endl;
+        exit(-1);
+    }
+    if (argsReader.exist_argument("-cutoff")) {
+        Cutoff = stof(argsReader.get_argument("-cutoff"));
+        if (Cutoff <= 0.f) {
+            std::cout << "The cutoff radius has to be positive... exiting." << std::endl;
+            exit(-1);
+        }
+    }
+    if (argsReader.exist_argument("-rebuild")) {
+        RebuildPeriod = stoul(argsReader.get_argument("-rebuild"));
+        if (RebuildPeriod == 0) {
+            std::cout << "The rebuild period has to be at least 1... exiting." << std::endl;
+            exit(-1);
+        }
+    }
+    if (argsReader.exist_argument("-autotune"))
+        Autotune = true;
+    if (argsReader.exist_argument("-isa"))
+        ISA = argsReader.get_argument("-isa");
+    if (!selectISA(ISA)) {
+        std::cout << "Instruction set '" << ISA << "' is not supported by this binary or this CPU... exiting."
+                  << std::endl;
+        exit(-1);
+    }
+    if (argsReader.exist_argument("-ranks")) {
+        Ranks = stoul(argsReader.get_argument("-ranks"));
+        if (Ranks == 0) {
+            std::cout << "The number of ranks has to be at least 1... exiting." << std::endl;
+            exit(-1);
+        }
+    }
+    if (argsReader.exist_argument("-transport"))
+        Transport = argsReader.get_argument("-transport");
+    if (Transport == "auto")
+        Transport = Communicator::getDefaultTransport();
+    if (argsReader.exist_argument("-numa"))
+        NumaPolicy = argsReader.get_argument("-numa");
+    if (NumaPolicy == "auto")
+        NumaPolicy = (Numa::getNodes().size() > 1) ? "pin" : "off";
+    if (NumaPolicy != "off" && NumaPolicy != "pin" && NumaPolicy != "replicate") {
+        std::cout << "NUMA policy '" << NumaPolicy << "' does not exist... exiting." << std::endl;
+        exit(-1);
+    }
+    // before the allocation of the bodies: they are first touched by the pinned threads
+    TaskScheduler::get().setPinning(NumaPolicy != "off");
 }
 
 /*!
@@ -173,68 +383,119 @@ std::string strDate(float timestamp)
 }
 
 /*!
- * \fn     SimulationNBodyInterface *createImplem()
- * \brief  Select and allocate an n-body simulation object.
+ * \fn     implemParams_t getImplemParams()
+ * \brief  Parameters of the implementations, from the command line.
+ *
+ * \return The parameters.
+ */
+implemParams_t getImplemParams()
+{
+    implemParams_t params;
+    params.nBodies = NBodies;
+    params.scheme = BodiesScheme;
+    params.soft = Softening;
+    params.order = Order;
+    params.theta = Theta;
+    params.rebuildPeriod = RebuildPeriod;
+    params.gridSize = GridSize;
+    params.assignment = Assignment;
+    params.split = Split;
+    params.cutoff = Cutoff;
+    params.replicate = NumaPolicy == "replicate";
+    params.ranks = Ranks;
+    params.transport = Transport;
+    return params;
+}
+
+/*!
+ * \fn     SimulationNBodyInterface<T> *createImplem()
+ * \brief  Select and allocate an n-body simulation object in the registry (see `ImplemRegistry`).
+ *
+ * \tparam T : Floating-point type of the bodies (`float` for fp32, `double` for fp64 and mixed precision).
  *
  * \return A fresh allocated simulation.
  */
-SimulationNBodyInterface *createImplem()
+template <typename T> SimulationNBodyInterface<T> *createImplem()
 {
-    SimulationNBodyInterface *simu = nullptr;
-    if (ImplTag == "cpu+naive") {
-        simu = new SimulationNBodyNaive(NBodies, BodiesScheme, Softening);
+    if (ImplTag == "auto") {
+        ImplTag = ImplemRegistry::selectFastest(Precision, getImplemParams(), Verbose);
+        AutoImplem = true;
     }
-    else {
-        std::cout << "Implementation '" << ImplTag << "' does not exist... Exiting." << std::endl;
+    implemParams_t params = getImplemParams();
+    if (ImplemRegistry::find(ImplTag) != nullptr) {
+        if (Autotune && ImplemRegistry::find(ImplTag)->caps.knobs.size()) {
+            Autotuner::tune(ImplTag, Precision, params, Verbose);
+            Tuning = Autotuner::toString(ImplTag, params) + " (autotuned)";
+        }
+        else if (Autotuner::load(ImplTag, Precision, params))
+            Tuning = Autotuner::toString(ImplTag, params) + " (cache)";
+    }
+    SimulationNBodyInterface<T> *simu = ImplemRegistry::create<T>(ImplTag, Precision, params);
+    if (simu == nullptr) {
+        std::cout << "Implementation '" << ImplTag << "' does not exist in " << Precision << "... Exiting."
+                  << std::endl;
         exit(-1);
     }
     return simu;
 }
 
-SpheresVisu *createVisu(SimulationNBodyInterface *simu)
+template <typename T> SpheresVisu *createVisu(SimulationNBodyInterface<T> *simu)
 {
     SpheresVisu *visu;
 
+    // the headless images do not need a display: they replace the window
+    if (!FramesDir.empty())
+        return new SpheresVisuFrames<T>(simu->getBodies(), FramesDir, FramesPeriod, WinWidth, WinHeight, VisuColor);
+
 #ifdef VISU
     if (VisuEnable) {
-        const float *positionsX = simu->getBodies().getDataSoA().qx.data();
-        const float *positionsY = simu->getBodies().getDataSoA().qy.data();
-        const float *positionsZ = simu->getBodies().getDataSoA().qz.data();
-
-        const float *velocitiesX = simu->getBodies().getDataSoA().vx.data();
-        const float *velocitiesY = simu->getBodies().getDataSoA().vy.data();
-        const float *velocitiesZ = simu->getBodies().getDataSoA().vz.data();
-
-        const float *radiuses = simu->getBodies().getDataSoA().r.data();
-
-        if (GSEnable) // geometry shader = better performances on dedicated GPUs
-            visu = new OGLSpheresVisuGS<float>("MUrB n-body (geometry shader)", WinWidth, WinHeight, positionsX,
-                                               positionsY, positionsZ, velocitiesX, velocitiesY, velocitiesZ, radiuses,
-                                               NBodies, VisuColor);
-        else
-            visu = new OGLSpheresVisuInst<float>("MUrB n-body (instancing)", WinWidth, WinHeight, positionsX,
+        // the visualization is created from the arrays of the bodies (or of a snapshot with the render thread), it
+        // reads them again at each frame: they move and grow with the insertions and the compactions
+        auto create = [](const T *positionsX, const T *positionsY, const T *positionsZ, const T *velocitiesX,
+                         const T *velocitiesY, const T *velocitiesZ, const T *radiuses,
+                         const unsigned long nBodies) -> OGLSpheresVisu<T> * {
+            if (GSEnable) // geometry shader = better performances on dedicated GPUs
+                return new OGLSpheresVisuGS<T>("MUrB n-body (geometry shader)", WinWidth, WinHeight, positionsX,
+                                               positionsY, positionsZ, velocitiesX, velocitiesY, velocitiesZ,
+                                               radiuses, nBodies, VisuColor);
+            else
+                return new OGLSpheresVisuInst<T>("MUrB n-body (instancing)", WinWidth, WinHeight, positionsX,
                                                  positionsY, positionsZ, velocitiesX, velocitiesY, velocitiesZ,
-                                                 radiuses, NBodies, VisuColor);
+                                                 radiuses, nBodies, VisuColor);
+        };
+        if (VisuThread)
+            visu = new OGLSpheresVisuThread<T>(simu->getBodies(), create);
+        else {
+            const dataSoA_t<T> &d = simu->getBodies().getDataSoA();
+            OGLSpheresVisu<T> *oglVisu = create(d.qx.data(), d.qy.data(), d.qz.data(), d.vx.data(), d.vy.data(),
+                                                d.vz.data(), d.r.data(), simu->getBodies().getN());
+            oglVisu->followBodies(simu->getBodies());
+            visu = oglVisu;
+        }
         std::cout << std::endl;
     }
     else
-        visu = new SpheresVisuNo<float>();
+        visu = new SpheresVisuNo<T>();
 #else
     VisuEnable = false;
-    visu = new SpheresVisuNo<float>();
+    visu = new SpheresVisuNo<T>();
 #endif
 
     return visu;
 }
 
-int main(int argc, char **argv)
+/*!
+ * \fn     int simulate(SimulationNBodyInterface<T> *simu)
+ * \brief  Create the visualization and run the iterations of the simulation.
+ *
+ * \tparam T : Floating-point type of the bodies (`float` for fp32, `double` for fp64 and mixed precision).
+ *
+ * \param  simu : The n-body simulation (freed at the end).
+ *
+ * \return The exit status of the program.
+ */
+template <typename T> int simulate(SimulationNBodyInterface<T> *simu)
 {
-    // read arguments from the command line
-    // usage: ./nbody -n nBodies  -i nIterations [-v] [-w] ...
-    argsReader(argc, argv);
-
-    // create the n-body simulation
-    SimulationNBodyInterface *simu = createImplem();
     NBodies = simu->getBodies().getN();
 
     // get MB used for this simulation
@@ -244,27 +505,49 @@ int main(int argc, char **argv)
     std::cout << "n-body simulation configuration:" << std::endl;
     std::cout << "--------------------------------" << std::endl;
     std::cout << "  -> bodies scheme     (-s    ): " << BodiesScheme << std::endl;
-    std::cout << "  -> implementation    (--im  ): " << ImplTag << std::endl;
+    std::cout << "  -> implementation    (--im  ): " << ImplTag << ((AutoImplem) ? " (auto)" : "") << std::endl;
     std::cout << "  -> nb. of bodies     (-n    ): " << NBodies << std::endl;
     std::cout << "  -> nb. of iterations (-i    ): " << NIterations << std::endl;
     std::cout << "  -> verbose mode      (-v    ): " << ((Verbose) ? "enable" : "disable") << std::endl;
-    std::cout << "  -> precision                 : " << "fp32" << std::endl;
+    std::cout << "  -> precision                 : " << Precision << std::endl;
     std::cout << "  -> mem. allocated            : " << Mbytes << " MB" << std::endl;
     std::cout << "  -> geometry shader   (--ngs ): " << ((GSEnable) ? "enable" : "disable") << std::endl;
+    if (VisuThread)
+        std::cout << "  -> render thread  (--vthread): enable" << std::endl;
+    if (!FramesDir.empty())
+        std::cout << "  -> images          (--frames): " << FramesDir << "/frame_*.ppm every " << FramesPeriod
+                  << " ite." << std::endl;
     std::cout << "  -> time step         (--dt  ): " << std::to_string(Dt) + " sec" << std::endl;
     std::cout << "  -> softening factor  (--soft): " << Softening << std::endl;
+    std::cout << "  -> Morton reordering         : "
+              << ((ReorderPeriod) ? "every " + std::to_string(ReorderPeriod) + " ite." : "disable") << std::endl;
+    std::cout << "  -> collisions                : " << ((Collisions) ? "enable" : "disable") << std::endl;
+    if (!Tuning.empty())
+        std::cout << "  -> tuning                    : " << Tuning << std::endl;
+    if (ImplemRegistry::find(ImplTag)->caps.isa)
+        std::cout << "  -> instruction set   (--isa ): " << getSelectedISA() << ((ISA == "auto") ? " (detected)" : "")
+                  << std::endl;
+    if (ImplTag == "cpu+ring" || ImplTag == "cpu+bh+orb")
+        std::cout << "  -> ranks            (--ranks): " << ((Transport == "mpi") ? "mpirun" : std::to_string(Ranks))
+                  << " (" << Transport << ")" << std::endl;
+    std::cout << "  -> NUMA topology     (--numa): " << Numa::toString() << ", "
+              << ((NumaPolicy == "off") ? "threads not pinned" : "pinned threads")
+              << ((NumaPolicy == "replicate") ? ", j-bodies replicated per node" : "") << std::endl;
 
     // initialize visualization of bodies (with spheres in space)
     SpheresVisu *visu = createVisu(simu);
 
     // time step selection
     simu->setDt(Dt);
+    simu->setReorderingPolicy(ReorderPeriod);
+    simu->setCollisionPolicy(Collisions);
 
     std::cout << "Simulation started..." << std::endl;
 
     // loop over the iterations
     Perf perfIte, perfTotal;
     float physicTime = 0.f;
+    unsigned long nAlive = simu->getBodies().getNAlive();
     unsigned long iIte;
     for (iIte = 1; iIte <= NIterations && !visu->windowShouldClose(); iIte++) {
         // refresh the display in OpenGL window
@@ -273,6 +556,12 @@ int main(int argc, char **argv)
         // simulation computations
         perfIte.start();
         simu->computeOneIteration();
+        // the merging and the reordering are checked at each iteration when their policy is enabled, else the layout
+        // only has to be updated when the number of bodies changes (compaction of the removed bodies)
+        if (Collisions || ReorderPeriod || simu->getBodies().getNAlive() != nAlive) {
+            simu->updateBodiesLayout();
+            nAlive = simu->getBodies().getNAlive();
+        }
         perfIte.stop();
         perfTotal += perfIte;
 
@@ -310,3 +599,16 @@ int main(int argc, char **argv)
 
     return EXIT_SUCCESS;
 }
+
+int main(int argc, char **argv)
+{
+    // read arguments from the command line
+    // usage: ./nbody -n nBodies  -i nIterations [-v] [-w] ...
+    argsReader(argc, argv);
+
+    // create the n-body simulation and run it
+    if (Precision == "fp64" || Precision == "mixed")
+        return simulate(createImplem<double>());
+    else
+        return simulate(createImplem<float>());
+}
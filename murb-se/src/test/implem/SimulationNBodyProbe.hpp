@@ -0,0 +1,17 @@
+#ifndef SIMULATION_N_BODY_PROBE_HPP_
+#define SIMULATION_N_BODY_PROBE_HPP_
+
+#include "SimulationNBodyNaive.hpp"
+
+/* gives the tests an access to the accelerations of the last iteration of the `S` implementation (AoS or SoA
+ * depending on `S`) */
+template <class S> class SimulationNBodyProbe : public S {
+  public:
+    using S::S;
+    auto getAccelerations() const -> decltype((this->accelerations)) { return this->accelerations; }
+};
+
+/* `cpu+naive`, the reference of the accuracy tests */
+template <typename T> using SimulationNBodyNaiveProbe = SimulationNBodyProbe<SimulationNBodyNaive<T>>;
+
+#endif /* SIMULATION_N_BODY_PROBE_HPP_ */
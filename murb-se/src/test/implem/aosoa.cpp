@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <exception>
+#include <numeric>
+#include <random>
+#include <string>
+
+#include "SimulationNBodyAoSoA.hpp"
+#include "SimulationNBodyNaive.hpp"
+
+template <typename T>
+void test_nbody_aosoa(const size_t n, const T soft, const T dt, const size_t nIte, const std::string &scheme,
+                     const T eps, const std::string &layout = "AoSoA")
+{
+    SimulationNBodyNaive<T> simuRef(n, scheme, soft);
+    simuRef.setDt(dt);
+
+    SimulationNBodyAoSoA<T> simuTest(n, scheme, soft);
+    simuTest.setDt(dt);
+    simuTest.setActiveLayout(layout);
+
+    const T *xRef = simuRef.getBodies().getDataSoA().qx.data();
+    const T *yRef = simuRef.getBodies().getDataSoA().qy.data();
+    const T *zRef = simuRef.getBodies().getDataSoA().qz.data();
+
+    const T *xTest = simuTest.getBodies().getDataSoA().qx.data();
+    const T *yTest = simuTest.getBodies().getDataSoA().qy.data();
+    const T *zTest = simuTest.getBodies().getDataSoA().qz.data();
+
+    T e = 0; // espilon
+    for (size_t i = 0; i < nIte + 1; i++) {
+        if (i > 0) {
+            simuRef.computeOneIteration();
+            simuTest.computeOneIteration();
+            e = eps;
+        }
+
+        for (size_t b = 0; b < simuRef.getBodies().getN(); b++) {
+            REQUIRE_THAT(xRef[b], Catch::Matchers::WithinRel(xTest[b], e));
+            REQUIRE_THAT(yRef[b], Catch::Matchers::WithinRel(yTest[b], e));
+            REQUIRE_THAT(zRef[b], Catch::Matchers::WithinRel(zTest[b], e));
+        }
+    }
+
+    // the layouts that are not active are rebuilt from the SoA when they are read
+    const Bodies<T> &bodies = simuTest.getBodies();
+    const dataSoA_t<T> &d = bodies.getDataSoA();
+    const dataAoSoA_t<T> &t = bodies.getDataAoSoA();
+    const unsigned long bs = t.blockSize;
+    for (size_t b = 0; b < bodies.getN() + bodies.getPadding(); b++) {
+        const unsigned long iHot = (b / bs) * 4 * bs + (b % bs);
+        REQUIRE(t.hot[iHot] == d.qx[b]);
+        REQUIRE(t.cold[iHot + 2 * bs] == d.vz[b]);
+        REQUIRE(bodies.getDataAoS()[b].qy == d.qy[b]);
+        REQUIRE(bodies.getDataAoS()[b].vx == d.vx[b]);
+        REQUIRE(bodies.getDataHot()[b].qz == d.qz[b]);
+        REQUIRE(bodies.getDataHot()[b].gm == Bodies<T>::G * d.m[b]);
+    }
+}
+
+TEST_CASE("n-body - AoSoA", "[aosoa]")
+{
+    SECTION("fp32 - n=13 - i=1 - random") { test_nbody_aosoa<float>(13, 2e+08, 3600, 1, "random", 1e-3); }
+    SECTION("fp32 - n=13 - i=100 - random") { test_nbody_aosoa<float>(13, 2e+08, 3600, 100, "random", 5e-3); }
+    SECTION("fp32 - n=2049 - i=3 - random") { test_nbody_aosoa<float>(2049, 2e+08, 3600, 3, "random", 1e-3); }
+    SECTION("fp32 - n=13 - i=30 - galaxy") { test_nbody_aosoa<float>(13, 2e+08, 3600, 30, "galaxy", 1e-1); }
+    SECTION("fp32 - n=2049 - i=3 - galaxy") { test_nbody_aosoa<float>(2049, 2e+08, 3600, 3, "galaxy", 1e-1); }
+
+    SECTION("fp64 - n=13 - i=100 - random") { test_nbody_aosoa<double>(13, 2e+08, 3600, 100, "random", 1e-9); }
+    SECTION("fp64 - n=2049 - i=3 - random") { test_nbody_aosoa<double>(2049, 2e+08, 3600, 3, "random", 1e-9); }
+    SECTION("fp64 - n=13 - i=30 - galaxy") { test_nbody_aosoa<double>(13, 2e+08, 3600, 30, "galaxy", 1e-9); }
+    SECTION("fp64 - n=2049 - i=3 - galaxy") { test_nbody_aosoa<double>(2049, 2e+08, 3600, 3, "galaxy", 1e-9); }
+
+    SECTION("fp32 - n=2049 - i=3 - random - AoSoA built on demand")
+    {
+        test_nbody_aosoa<float>(2049, 2e+08, 3600, 3, "random", 1e-3, "SoA");
+    }
+    SECTION("fp64 - n=13 - i=30 - galaxy - AoSoA built on demand")
+    {
+        test_nbody_aosoa<double>(13, 2e+08, 3600, 30, "galaxy", 1e-9, "hot");
+    }
+}
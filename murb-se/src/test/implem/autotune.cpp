@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Autotuner.hpp"
+#include "ImplemRegistry.hpp"
+#include "SimulationNBodySIMD.hpp"
+#include "utils/Numa.hpp"
+
+/* the tiles and the schedule of the OpenMP loop do not change the results (one i-body is computed by one thread) */
+template <typename T> void test_simd_tiles(const size_t n, const unsigned long tileSize, const bool dynamicSchedule)
+{
+    SimulationNBodySIMD<T> simuRef(n, "galaxy", 2e+08);
+    SimulationNBodySIMD<T> simuTest(n, "galaxy", 2e+08, 0, tileSize, dynamicSchedule);
+    simuRef.setDt(3600);
+    simuTest.setDt(3600);
+    for (int i = 0; i < 3; i++) {
+        simuRef.computeOneIteration();
+        simuTest.computeOneIteration();
+    }
+    for (size_t b = 0; b < n; b++) {
+        REQUIRE(simuRef.getBodies().getDataSoA().qx[b] == simuTest.getBodies().getDataSoA().qx[b]);
+        REQUIRE(simuRef.getBodies().getDataSoA().vz[b] == simuTest.getBodies().getDataSoA().vz[b]);
+    }
+}
+
+static std::vector<std::string> read_lines(const std::string &path)
+{
+    std::vector<std::string> lines;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+        lines.push_back(line);
+    return lines;
+}
+
+TEST_CASE("n-body - Autotuner", "[autotune]")
+{
+    SECTION("fp32 - n=1000 - tiles of 64, dynamic") { test_simd_tiles<float>(1000, 64, true); }
+    SECTION("fp32 - n=1000 - tiles of 100, static") { test_simd_tiles<float>(1000, 100, false); }
+    SECTION("fp64 - n=333 - tiles of 4096, static") { test_simd_tiles<double>(333, 4096, false); }
+
+    SECTION("cache")
+    {
+        const std::string path = "murb-test-autotune.txt";
+        setenv("MURB_AUTOTUNE_CACHE", path.c_str(), 1);
+        REQUIRE(Autotuner::getCachePath() == path);
+        const std::string nCPUs = std::to_string(Numa::getNumCPUs());
+        {
+            // the entries of the other hosts are kept, as the ones of the same CPU model with another number of CPUs
+            std::ofstream cache(path);
+            cache << "cpu+simd fp32 1024 " << nCPUs << " threads=3;tile=64;schedule=dynamic Other CPU" << std::endl;
+            cache << "cpu+simd fp32 1024 " << Numa::getNumCPUs() + 1 << " threads=3;tile=64;schedule=dynamic "
+                  << Autotuner::getCPUModel() << std::endl;
+        }
+
+        implemParams_t params;
+        params.nBodies = 1000;
+        REQUIRE(!Autotuner::load("cpu+simd", "fp32", params));
+        REQUIRE(Autotuner::tune("cpu+simd", "fp32", params, false, 256) > 0.f);
+        const std::vector<std::string> tiles = Autotuner::getCandidates("tile");
+        REQUIRE(std::find(tiles.begin(), tiles.end(), std::to_string(params.tileSize)) != tiles.end());
+        REQUIRE((params.schedule == "static" || params.schedule == "dynamic"));
+        REQUIRE(params.threads > 0);
+        const std::vector<std::string> threads = Autotuner::getCandidates("threads");
+        REQUIRE(threads.back() == nCPUs);
+        REQUIRE(std::find(threads.begin(), threads.end(), std::to_string(params.threads)) != threads.end());
+
+        const std::vector<std::string> lines = read_lines(path);
+        REQUIRE(lines.size() == 3);
+        REQUIRE(lines[0].find("Other CPU") != std::string::npos);
+        REQUIRE(lines[1].find("cpu+simd fp32 1024 " + std::to_string(Numa::getNumCPUs() + 1) + " ") == 0);
+        REQUIRE(lines[2].find("cpu+simd fp32 1024 " + nCPUs + " ") == 0);
+        REQUIRE(lines[2].find(Autotuner::getCPUModel()) != std::string::npos);
+
+        // the same power of 2 of bodies
+        implemParams_t loaded;
+        loaded.nBodies = 900;
+        REQUIRE(Autotuner::load("cpu+simd", "fp32", loaded));
+        REQUIRE(Autotuner::toString("cpu+simd", loaded) == Autotuner::toString("cpu+simd", params));
+        loaded.nBodies = 5000;
+        REQUIRE(!Autotuner::load("cpu+simd", "fp32", loaded));
+        REQUIRE(!Autotuner::load("cpu+simd", "fp64", loaded));
+
+        // a new search replaces the entry
+        REQUIRE(Autotuner::tune("cpu+simd", "fp32", params, false, 256) > 0.f);
+        REQUIRE(read_lines(path).size() == 3);
+
+        // no knob: nothing to save
+        REQUIRE(Autotuner::tune("cpu+naive", "fp32", params, false, 256) > 0.f);
+        REQUIRE(read_lines(path).size() == 3);
+        REQUIRE(Autotuner::tune("cpu+simd+fp16", "fp64", params, false, 256) < 0.f);
+
+        std::remove(path.c_str());
+        unsetenv("MURB_AUTOTUNE_CACHE");
+    }
+}
+
+/* search of the knobs of the tree codes, run it with: ./bin/murb-test "[autotune-report]" */
+TEST_CASE("n-body - Autotuner - report", "[.][autotune-report]")
+{
+    const std::string path = "murb-test-autotune.txt";
+    setenv("MURB_AUTOTUNE_CACHE", path.c_str(), 1);
+    implemParams_t params;
+    params.nBodies = 100000;
+    for (const std::string tag : {"cpu+simd", "cpu+bh", "cpu+fmm"}) {
+        Autotuner::tune(tag, "fp32", params, true);
+        std::cout << "  => " << Autotuner::toString(tag, params) << std::endl;
+    }
+    std::remove(path.c_str());
+    unsetenv("MURB_AUTOTUNE_CACHE");
+}
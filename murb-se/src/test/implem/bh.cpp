@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "SimulationNBodyBarnesHut.hpp"
+#include "SimulationNBodyProbe.hpp"
+#include "utils/Perf.hpp"
+
+/* rms error of the Barnes-Hut accelerations compared to `cpu+naive` (fp64), relative to the rms norm of the
+ * reference accelerations */
+double accuracy_nbody_bh(const SimulationNBodyNaiveProbe<double> &simuRef, const size_t n, const double soft,
+                         const std::string &scheme, const double theta, const unsigned long groupSize, float &ms)
+{
+    SimulationNBodyProbe<SimulationNBodyBarnesHut<double>> simuTest(n, scheme, soft, 0, theta, groupSize);
+    simuTest.setDt(3600);
+
+    Perf perf;
+    perf.start();
+    simuTest.computeOneIteration();
+    perf.stop();
+    ms = perf.getElapsedTime();
+
+    const std::vector<accAoS_t<double>> &aRef = simuRef.getAccelerations();
+    const accSoA_t<double> &aTest = simuTest.getAccelerations();
+
+    double sumRef = 0., sumErr = 0.;
+    for (size_t b = 0; b < n; b++) {
+        sumRef += aRef[b].ax * aRef[b].ax + aRef[b].ay * aRef[b].ay + aRef[b].az * aRef[b].az;
+        const double dx = aTest.ax[b] - aRef[b].ax;
+        const double dy = aTest.ay[b] - aRef[b].ay;
+        const double dz = aTest.az[b] - aRef[b].az;
+        sumErr += dx * dx + dy * dy + dz * dz;
+    }
+    return std::sqrt(sumErr / sumRef);
+}
+
+void test_nbody_bh(const size_t n, const double soft, const std::string &scheme)
+{
+    SimulationNBodyNaiveProbe<double> simuRef(n, scheme, soft);
+    simuRef.setDt(3600);
+    simuRef.computeOneIteration();
+
+    // the error decreases with the opening angle (quadrupole: about theta^3)
+    float ms;
+    double prevErr = 1.;
+    for (double theta : {0.8, 0.5, 0.3}) {
+        const double err = accuracy_nbody_bh(simuRef, n, soft, scheme, theta, 16, ms);
+        REQUIRE(err <= prevErr);
+        prevErr = err;
+    }
+    REQUIRE(prevErr < 1e-3);
+}
+
+TEST_CASE("n-body - Barnes-Hut", "[bh]")
+{
+    SECTION("fp64 - n=13 - random") { test_nbody_bh(13, 2e+08, "random"); }
+    SECTION("fp64 - n=3000 - random") { test_nbody_bh(3000, 2e+08, "random"); }
+    SECTION("fp64 - n=3000 - galaxy") { test_nbody_bh(3000, 2e+08, "galaxy"); }
+    SECTION("fp64 - n=3000 - galaxy - small softening") { test_nbody_bh(3000, 1e+06, "galaxy"); }
+
+    SECTION("fp32 - n=2049 - i=3 - galaxy - refit")
+    {
+        SimulationNBodyNaive<float> simuRef(2049, "galaxy", 2e+08);
+        simuRef.setDt(3600);
+        SimulationNBodyBarnesHut<float> simuTest(2049, "galaxy", 2e+08, 0, 0.5, 32, 2);
+        simuTest.setDt(3600);
+        for (size_t i = 0; i < 3; i++) {
+            simuRef.computeOneIteration();
+            simuTest.computeOneIteration();
+        }
+        const float *xRef = simuRef.getBodies().getDataSoA().qx.data();
+        const float *xTest = simuTest.getBodies().getDataSoA().qx.data();
+        for (size_t b = 0; b < 2049; b++)
+            REQUIRE_THAT(xRef[b], Catch::Matchers::WithinRel(xTest[b], 1e-2f));
+    }
+}
+
+/* accuracy and time vs opening angle and group size report, run it with: ./bin/murb-test "[bh-report]" */
+TEST_CASE("n-body - Barnes-Hut - accuracy report", "[.][bh-report]")
+{
+    std::cout << "rms error of the Barnes-Hut accelerations vs cpu+naive (relative to the rms acceleration):"
+              << std::endl;
+    std::cout << "  scheme |      n | theta | group |   rms err | time (ms)" << std::endl;
+    for (auto scheme : {"galaxy", "random"})
+        for (auto n : {30000ul}) {
+            SimulationNBodyNaiveProbe<double> simuRef(n, scheme, 2e+08);
+            simuRef.setDt(3600);
+            simuRef.computeOneIteration();
+            for (auto theta : {0.3, 0.5, 0.7})
+                for (auto groupSize : {8ul, 16ul, 32ul, 64ul}) {
+                    float ms;
+                    const double err = accuracy_nbody_bh(simuRef, n, 2e+08, scheme, theta, groupSize, ms);
+                    std::cout << "  " << std::setw(6) << scheme << " | " << std::setw(6) << n << " | "
+                              << std::setw(5) << theta << " | " << std::setw(5) << groupSize << " | "
+                              << std::scientific << std::setprecision(2) << std::setw(9) << err << " | "
+                              << std::fixed << std::setprecision(1) << std::setw(9) << ms << std::defaultfloat
+                              << std::endl;
+                }
+        }
+
+    std::cout << std::endl << "time per step vs n (theta 0.5, group 32, galaxy, fp32):" << std::endl;
+    for (auto n : {10000ul, 40000ul, 160000ul, 640000ul}) {
+        SimulationNBodyBarnesHut<float> simu(n, "galaxy", 2e+08);
+        simu.setDt(3600);
+        Perf perf;
+        perf.start();
+        simu.computeOneIteration();
+        perf.stop();
+        std::cout << "  n = " << std::setw(7) << n << ": " << std::fixed << std::setprecision(1) << std::setw(9)
+                  << perf.getElapsedTime() << " ms (" << perf.getElapsedTime() * 1e3f / n << " us/body, "
+                  << simu.getFlopsPerIte() / perf.getElapsedTime() * 1e-6f << " Gflop/s)" << std::defaultfloat
+                  << std::endl;
+    }
+}
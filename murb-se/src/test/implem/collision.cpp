@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "SimulationNBodyBarnesHut.hpp"
+#include "SimulationNBodyCutoff.hpp"
+#include "SimulationNBodyHalf.hpp"
+#include "SimulationNBodyNaive.hpp"
+#include "SimulationNBodySIMD.hpp"
+#include "utils/Mipp.hpp"
+#include "utils/Perf.hpp"
+
+/* number of groups of overlapping bodies, computed with all the pairs */
+template <typename T> unsigned long count_groups_reference(const Bodies<T> &bodies)
+{
+    const unsigned long n = bodies.getN();
+    const dataSoA_t<T> &d = bodies.getDataSoA();
+    std::vector<unsigned long> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](unsigned long i) {
+        while (parent[i] != i)
+            i = parent[i];
+        return i;
+    };
+    for (unsigned long i = 0; i < n; i++)
+        for (unsigned long j = i + 1; j < n; j++) {
+            // same arithmetic as the spatial hash
+            const T rx = d.qx[j] - d.qx[i], ry = d.qy[j] - d.qy[i], rz = d.qz[j] - d.qz[i];
+            const T rij = d.r[i] + d.r[j];
+            if (rx * rx + ry * ry + rz * rz < rij * rij)
+                parent[std::max(find(i), find(j))] = std::min(find(i), find(j));
+        }
+    unsigned long nGroups = 0;
+    for (unsigned long i = 0; i < n; i++)
+        nGroups += parent[i] == i;
+    return nGroups;
+}
+
+/* mass and momentum of the bodies (fp64) */
+template <typename T> void compute_invariants(const Bodies<T> &bodies, double &m, double p[3], double &pNorm)
+{
+    const dataSoA_t<T> &d = bodies.getDataSoA();
+    m = pNorm = 0.;
+    p[0] = p[1] = p[2] = 0.;
+    for (unsigned long i = 0; i < bodies.getN(); i++) {
+        m += d.m[i];
+        p[0] += (double)d.m[i] * d.vx[i];
+        p[1] += (double)d.m[i] * d.vy[i];
+        p[2] += (double)d.m[i] * d.vz[i];
+        pNorm += d.m[i] * std::sqrt((double)d.vx[i] * d.vx[i] + (double)d.vy[i] * d.vy[i] + (double)d.vz[i] * d.vz[i]);
+    }
+}
+
+/* the padding bodies are massless, the arrays are a multiple of the SIMD width and the layouts are consistent */
+template <typename T> void check_layouts(const Bodies<T> &bodies, const unsigned long capacity)
+{
+    const unsigned long n = bodies.getN();
+    const unsigned long nTotal = n + bodies.getPadding();
+    const dataSoA_t<T> &d = bodies.getDataSoA();
+    REQUIRE(nTotal % mipp::N<T>() == 0);
+    REQUIRE(bodies.getPadding() < mipp::N<T>());
+    REQUIRE(bodies.getIds().size() == n);
+    REQUIRE(d.qx.size() == capacity);
+    for (unsigned long i = n; i < capacity; i++) {
+        REQUIRE(d.m[i] == 0);
+        REQUIRE(bodies.getDataHot()[i].gm == 0);
+    }
+    const dataAoSoA_t<T> &a = bodies.getDataAoSoA();
+    const unsigned long bs = a.blockSize;
+    for (unsigned long i = 0; i < nTotal; i++) {
+        REQUIRE(bodies.getDataAoS()[i].qx == d.qx[i]);
+        REQUIRE(bodies.getDataHot()[i].qy == d.qy[i]);
+        REQUIRE(a.hot[(i / bs) * 4 * bs + (i % bs) + 3 * bs] == d.m[i]);
+        REQUIRE(a.cold[(i / bs) * 4 * bs + (i % bs) + 3 * bs] == d.r[i]);
+    }
+}
+
+template <typename T> void test_collisions(const size_t n, const std::string &scheme, const double eps)
+{
+    Bodies<T> bodies(n, scheme);
+    const unsigned long capacity = bodies.getDataSoA().qx.size();
+    const unsigned long nGroups = count_groups_reference(bodies);
+
+    double m0, p0[3], pNorm;
+    compute_invariants(bodies, m0, p0, pNorm);
+    const unsigned long version = bodies.getLayoutVersion();
+
+    const unsigned long nMerged = bodies.mergeCollisions();
+    REQUIRE(nMerged == n - nGroups);
+    REQUIRE(bodies.getN() == nGroups);
+    // the bodies only move in memory if some of them have been merged
+    REQUIRE(bodies.getLayoutVersion() == version + (nMerged > 0));
+
+    // mass and momentum are conserved
+    double m1, p1[3];
+    compute_invariants(bodies, m1, p1, pNorm);
+    REQUIRE_THAT(m1, Catch::Matchers::WithinRel(m0, eps));
+    for (int a = 0; a < 3; a++)
+        REQUIRE_THAT(p1[a], Catch::Matchers::WithinAbs(p0[a], eps * pNorm));
+
+    check_layouts(bodies, capacity);
+
+    // the survivors keep their ids, in the same order
+    const std::vector<unsigned long> &ids = bodies.getIds();
+    for (size_t b = 1; b < ids.size(); b++)
+        REQUIRE(ids[b - 1] < ids[b]);
+    REQUIRE(ids.back() < n);
+}
+
+template <typename T, class S> void test_simulation_collisions(const size_t n, const size_t nIte)
+{
+    S simu(n, "random", 2e+08);
+    simu.setDt(3600);
+    simu.setCollisionPolicy(true);
+    const unsigned long capacity = simu.getBodies().getDataSoA().qx.size();
+    double m0, p[3], pNorm;
+    compute_invariants(simu.getBodies(), m0, p, pNorm);
+
+    unsigned long nPrev = n;
+    for (size_t i = 0; i < nIte; i++) {
+        simu.computeOneIteration();
+        const bool merged = simu.updateBodiesLayout();
+        REQUIRE(simu.getBodies().getN() <= nPrev);
+        REQUIRE(merged == (simu.getBodies().getN() < nPrev));
+        nPrev = simu.getBodies().getN();
+        for (unsigned long b = 0; b < nPrev; b++)
+            REQUIRE(std::isfinite(simu.getBodies().getDataSoA().qx[b]));
+    }
+    REQUIRE(nPrev < n);
+    double m1;
+    compute_invariants(simu.getBodies(), m1, p, pNorm);
+    REQUIRE_THAT(m1, Catch::Matchers::WithinRel(m0, 1e-5));
+    check_layouts(simu.getBodies(), capacity);
+}
+
+TEST_CASE("n-body - Collisions", "[collision]")
+{
+    SECTION("fp64 - n=13 - random") { test_collisions<double>(13, "random", 1e-12); }
+    SECTION("fp64 - n=3000 - random") { test_collisions<double>(3000, "random", 1e-12); }
+    SECTION("fp64 - n=3000 - galaxy") { test_collisions<double>(3000, "galaxy", 1e-12); }
+    SECTION("fp32 - n=3001 - random") { test_collisions<float>(3001, "random", 1e-5); }
+    SECTION("fp32 - n=30000 - random") { test_collisions<float>(30000, "random", 1e-5); }
+
+    // the solvers follow the decreasing number of bodies
+    SECTION("fp32 - n=2049 - naive") { test_simulation_collisions<float, SimulationNBodyNaive<float>>(2049, 4); }
+    SECTION("fp32 - n=2049 - simd") { test_simulation_collisions<float, SimulationNBodySIMD<float>>(2049, 4); }
+    SECTION("fp32 - n=2049 - fp16") { test_simulation_collisions<float, SimulationNBodyHalf>(2049, 4); }
+    SECTION("fp64 - n=2049 - bh") { test_simulation_collisions<double, SimulationNBodyBarnesHut<double>>(2049, 4); }
+    SECTION("fp64 - n=2049 - cutoff") { test_simulation_collisions<double, SimulationNBodyCutoff<double>>(2049, 4); }
+}
+
+/* cost of the collision stage vs n, run it with: ./bin/murb-test "[collision-report]" */
+TEST_CASE("n-body - Collisions - scaling report", "[.][collision-report]")
+{
+    std::cout << "time of the collision stage vs n (galaxy, fp32):" << std::endl;
+    for (auto n : {10000ul, 100000ul, 1000000ul}) {
+        Bodies<float> bodies(n, "galaxy");
+        Perf perf;
+        perf.start();
+        const unsigned long nMerged = bodies.mergeCollisions();
+        perf.stop();
+        std::cout << "  n = " << std::setw(7) << n << ": " << std::fixed << std::setprecision(1) << std::setw(9)
+                  << perf.getElapsedTime() << " ms (" << perf.getElapsedTime() * 1e3f / n << " us/body, "
+                  << nMerged << " bodies merged)" << std::defaultfloat << std::endl;
+    }
+}
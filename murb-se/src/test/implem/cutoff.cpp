@@ -0,0 +1,104 @@
+#include <catch.hpp>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "SimulationNBodyCutoff.hpp"
+#include "SimulationNBodyProbe.hpp"
+#include "utils/Perf.hpp"
+
+template <typename T> class SimulationNBodyCutoffProbe : public SimulationNBodyProbe<SimulationNBodyCutoff<T>> {
+  public:
+    using SimulationNBodyProbe<SimulationNBodyCutoff<T>>::SimulationNBodyProbe;
+    unsigned long getNItesSinceRebuild() const { return this->nItesSinceRebuild; }
+};
+
+/* truncated accelerations computed with all the pairs (fp64) */
+template <typename T>
+void compute_cutoff_reference(const Bodies<T> &bodies, const double soft, const double cutoff,
+                              std::vector<double> &ax, std::vector<double> &ay, std::vector<double> &az)
+{
+    const unsigned long n = bodies.getN();
+    const dataSoA_t<T> &d = bodies.getDataSoA();
+    const std::vector<dataHot_t<T>> &h = bodies.getDataHot();
+    ax.assign(n, 0.);
+    ay.assign(n, 0.);
+    az.assign(n, 0.);
+    for (unsigned long i = 0; i < n; i++)
+        for (unsigned long j = 0; j < n; j++) {
+            const double rx = (double)d.qx[j] - d.qx[i], ry = (double)d.qy[j] - d.qy[i];
+            const double rz = (double)d.qz[j] - d.qz[i];
+            const double r2 = rx * rx + ry * ry + rz * rz;
+            if (r2 >= cutoff * cutoff)
+                continue;
+            const double s = std::sqrt(r2 + soft * soft);
+            const double a = h[j].gm / (s * s * s);
+            ax[i] += a * rx;
+            ay[i] += a * ry;
+            az[i] += a * rz;
+        }
+}
+
+template <typename T>
+void test_nbody_cutoff(const size_t n, const T soft, const T cutoff, const T skin, const std::string &scheme,
+                       const size_t nIte, const double eps)
+{
+    SimulationNBodyCutoffProbe<T> simuTest(n, scheme, soft, 0, cutoff, skin);
+    simuTest.setDt(3600);
+
+    // the accelerations are computed from the positions before the update of the iteration
+    std::vector<double> ax, ay, az;
+    unsigned long maxItesSinceRebuild = 0;
+    for (size_t i = 0; i < nIte; i++) {
+        compute_cutoff_reference<T>(simuTest.getBodies(), soft, cutoff, ax, ay, az);
+        simuTest.computeOneIteration();
+        maxItesSinceRebuild = std::max(maxItesSinceRebuild, simuTest.getNItesSinceRebuild());
+
+        const accSoA_t<T> &a = simuTest.getAccelerations();
+        double sumRef = 0., sumErr = 0.;
+        for (size_t b = 0; b < n; b++) {
+            sumRef += ax[b] * ax[b] + ay[b] * ay[b] + az[b] * az[b];
+            sumErr += (a.ax[b] - ax[b]) * (a.ax[b] - ax[b]) + (a.ay[b] - ay[b]) * (a.ay[b] - ay[b]) +
+                      (a.az[b] - az[b]) * (a.az[b] - az[b]);
+        }
+        REQUIRE(sumRef > 0.);
+        REQUIRE(std::sqrt(sumErr / sumRef) < eps);
+    }
+    // the skin avoids a rebuild at each iteration (the bodies of the galaxy move faster than skin / 2 per iteration)
+    if (skin > 0 && scheme == "random")
+        REQUIRE(maxItesSinceRebuild > 1);
+}
+
+TEST_CASE("n-body - Cutoff", "[cutoff]")
+{
+    SECTION("fp64 - n=13 - random") { test_nbody_cutoff<double>(13, 2e+08, 1e9, 1e8, "random", 3, 1e-12); }
+    SECTION("fp64 - n=2000 - galaxy") { test_nbody_cutoff<double>(2000, 2e+08, 5e7, 5e6, "galaxy", 8, 1e-12); }
+    SECTION("fp64 - n=2000 - random") { test_nbody_cutoff<double>(2000, 2e+08, 2e8, 2e7, "random", 8, 1e-12); }
+    SECTION("fp64 - n=2000 - galaxy - no skin") { test_nbody_cutoff<double>(2000, 2e+08, 5e7, 0, "galaxy", 3, 1e-12); }
+    // in fp32 a few pairs at the cutoff distance fall on the other side than in the fp64 reference
+    SECTION("fp32 - n=2049 - galaxy") { test_nbody_cutoff<float>(2049, 2e+08, 5e7, 5e6, "galaxy", 8, 2e-2); }
+    SECTION("fp32 - n=2049 - random") { test_nbody_cutoff<float>(2049, 2e+08, 2e8, 2e7, "random", 8, 2e-2); }
+}
+
+/* cost vs n at a fixed density, run it with: ./bin/murb-test "[cutoff-report]" */
+TEST_CASE("n-body - Cutoff - scaling report", "[.][cutoff-report]")
+{
+    std::cout << "time per step vs n (random, fixed number of neighbors per body, fp32):" << std::endl;
+    for (auto n : {10000ul, 80000ul, 640000ul}) {
+        // the random scheme has a fixed box: shrink the cutoff instead, n.rc^3 is constant
+        const float cutoff = 2e8f * std::cbrt(10000.f / n);
+        SimulationNBodyCutoff<float> simu(n, "random", 2e+07, 0, cutoff, cutoff / 10);
+        simu.setDt(3600);
+        simu.computeOneIteration();
+        Perf perf;
+        perf.start();
+        for (int i = 0; i < 3; i++)
+            simu.computeOneIteration();
+        perf.stop();
+        std::cout << "  n = " << std::setw(7) << n << ": " << std::fixed << std::setprecision(1) << std::setw(9)
+                  << perf.getElapsedTime() / 3 << " ms (" << perf.getElapsedTime() / 3 * 1e3f / n << " us/body)"
+                  << std::defaultfloat << std::endl;
+    }
+}
@@ -0,0 +1,235 @@
+#include <catch.hpp>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "SimulationNBodyBarnesHut.hpp"
+#include "SimulationNBodyCutoff.hpp"
+#include "SimulationNBodyHalf.hpp"
+#include "SimulationNBodyNaive.hpp"
+#include "SimulationNBodySIMD.hpp"
+#include "utils/Mipp.hpp"
+#include "utils/Perf.hpp"
+
+/* the padding and the tombstones are massless and the layouts are consistent */
+template <typename T> void check_dynamic_layouts(const Bodies<T> &bodies)
+{
+    const unsigned long n = bodies.getN();
+    const dataSoA_t<T> &d = bodies.getDataSoA();
+    REQUIRE((n + bodies.getPadding()) % mipp::N<T>() == 0);
+    REQUIRE(bodies.getPadding() < mipp::N<T>());
+    REQUIRE(n + bodies.getPadding() <= bodies.getCapacity());
+    REQUIRE(d.qx.size() == bodies.getCapacity());
+    REQUIRE(bodies.getIds().size() == n);
+    unsigned long nAlive = 0;
+    for (unsigned long i = 0; i < bodies.getCapacity(); i++) {
+        const bool alive = i < n && bodies.isAlive(i);
+        nAlive += alive;
+        if (!alive)
+            REQUIRE(d.m[i] == 0);
+        REQUIRE(bodies.getDataHot()[i].gm == Bodies<T>::G * d.m[i]);
+        REQUIRE(bodies.getDataAoS()[i].qz == d.qz[i]);
+    }
+    REQUIRE(nAlive == bodies.getNAlive());
+}
+
+template <typename T> void test_bodies_dynamic(const size_t n, const size_t nAdd)
+{
+    Bodies<T> bodies(n, "random");
+    check_dynamic_layouts(bodies);
+
+    // amortized growth: the capacity doubles
+    const T *qx = bodies.getDataSoA().qx.data();
+    unsigned long nReallocs = 0;
+    for (size_t i = 0; i < nAdd; i++) {
+        const unsigned long capacity = bodies.getCapacity();
+        const unsigned long version = bodies.getLayoutVersion();
+        const unsigned long id = bodies.addBody(1e21, 1e6, i * 1e6, 0, 0, 0, 0, 0);
+        REQUIRE(id == n + i);
+        REQUIRE(bodies.getN() == n + i + 1);
+        REQUIRE(bodies.getLayoutVersion() == version + 1);
+        REQUIRE(bodies.getDataSoA().qx[n + i] == (T)(i * 1e6));
+        if (bodies.getCapacity() != capacity) {
+            REQUIRE(bodies.getCapacity() >= 2 * capacity);
+            nReallocs++;
+        }
+    }
+    REQUIRE(nReallocs <= std::ceil(std::log2((double)(n + nAdd) / n)) + 1);
+    check_dynamic_layouts(bodies);
+    if (nReallocs == 0)
+        REQUIRE(bodies.getDataSoA().qx.data() == qx);
+
+    // tombstones: the other bodies do not move
+    const unsigned long nTotal = bodies.getN();
+    const unsigned long version = bodies.getLayoutVersion();
+    for (unsigned long i = 0; i < nTotal; i += 3)
+        bodies.removeBody(i);
+    bodies.removeBody(0); // already removed
+    const unsigned long nRemoved = (nTotal + 2) / 3;
+    REQUIRE(bodies.getN() == nTotal);
+    REQUIRE(bodies.getNAlive() == nTotal - nRemoved);
+    REQUIRE(bodies.getLayoutVersion() == version);
+    check_dynamic_layouts(bodies);
+
+    // the time integration moves the live bodies only (SoA, AoS and AoSoA accelerations)
+    {
+        const dataSoA_t<T> &d = bodies.getDataSoA();
+        const std::vector<T> qx(d.qx.begin(), d.qx.begin() + nTotal);
+        accSoA_t<T> accSoA;
+        accSoA.ax.assign(nTotal, 1);
+        accSoA.ay.assign(nTotal, 1);
+        accSoA.az.assign(nTotal, 1);
+        const std::vector<accAoS_t<T>> accAoS(nTotal, accAoS_t<T>{1, 1, 1});
+        accAoSoA_t<T> accAoSoA;
+        accAoSoA.a.assign(3 * (nTotal + bodies.getPadding()), 1);
+        T dt = 100;
+        bodies.updatePositionsAndVelocities(accSoA, dt);
+        bodies.updatePositionsAndVelocities(accAoS, dt);
+        bodies.setActiveLayout("AoSoA");
+        bodies.updatePositionsAndVelocities(accAoSoA, dt);
+        for (unsigned long i = 0; i < nTotal; i++) {
+            REQUIRE((d.qx[i] == qx[i]) == !bodies.isAlive(i));
+            REQUIRE((d.vy[i] == 0) == !bodies.isAlive(i));
+        }
+        check_dynamic_layouts(bodies);
+    }
+
+    // compaction below the threshold: nothing to do, then above
+    bodies.setCompactionPolicy(0.5);
+    REQUIRE(!bodies.updateLayout());
+    REQUIRE(bodies.getN() == nTotal);
+    bodies.setCompactionPolicy(0.25);
+    REQUIRE(bodies.updateLayout());
+    REQUIRE(bodies.getN() == nTotal - nRemoved);
+    REQUIRE(bodies.getNAlive() == bodies.getN());
+    REQUIRE(bodies.getLayoutVersion() > version);
+    check_dynamic_layouts(bodies);
+    for (unsigned long i = 0; i < bodies.getN(); i++)
+        REQUIRE(bodies.getIds()[i] % 3 != 0);
+
+    // the slots are reused after the compaction: the bodies fill the capacity (a multiple of the SIMD width)
+    const unsigned long capacity = bodies.getCapacity();
+    const unsigned long nFree = capacity - bodies.getN();
+    REQUIRE(nFree >= nRemoved);
+    for (unsigned long i = 0; i < nFree; i++)
+        bodies.addBody(1e21, 1e6, 0, i * 1e6, 0, 0, 0, 0);
+    REQUIRE(bodies.getN() == capacity);
+    REQUIRE(bodies.getCapacity() == capacity);
+    check_dynamic_layouts(bodies);
+
+    // all the bodies removed: the compaction gives an empty set
+    for (unsigned long i = 0; i < bodies.getN(); i++)
+        bodies.removeBody(i);
+    REQUIRE(bodies.updateLayout());
+    REQUIRE(bodies.getN() == 0);
+    REQUIRE(bodies.getNAlive() == 0);
+    check_dynamic_layouts(bodies);
+}
+
+/* bodies added and removed between the iterations: the solver (tombstones kept) gives the same trajectories as
+ * `cpu+naive` (tombstones compacted at each iteration) */
+template <class S>
+void test_simulation_dynamic(const size_t n, const float soft, const size_t nIte, const float eps, S &simuTest)
+{
+    SimulationNBodyNaive<float> simuRef(n, "galaxy", soft);
+    simuRef.setDt(3600);
+    simuRef.setCompactionPolicy(0);
+    simuTest.setDt(3600);
+    simuTest.setCompactionPolicy(1);
+
+    for (size_t i = 0; i < nIte; i++) {
+        // a stream of bodies injected around the galaxy and the removal of a live body
+        for (int k = 0; k < 5; k++) {
+            const float q = 1.5e8f + 1e7f * k, v = 2e3f * (i + 1);
+            simuRef.addBody(1e21f, 1e6f, q, -q, 1e7f * i, -v, v, 0);
+            simuTest.addBody(1e21f, 1e6f, q, -q, 1e7f * i, -v, v, 0);
+        }
+        const unsigned long idToRemove = 7 * i + 1;
+        for (unsigned long b = 0; b < simuRef.getBodies().getN(); b++)
+            if (simuRef.getBodies().getIds()[b] == idToRemove)
+                simuRef.removeBody(b);
+        for (unsigned long b = 0; b < simuTest.getBodies().getN(); b++)
+            if (simuTest.getBodies().getIds()[b] == idToRemove)
+                simuTest.removeBody(b);
+        simuRef.updateBodiesLayout();
+
+        simuRef.computeOneIteration();
+        simuTest.computeOneIteration();
+        simuTest.updateBodiesLayout();
+        REQUIRE(simuTest.getFlopsPerIte() > 0.f);
+    }
+    REQUIRE(simuTest.getBodies().getNAlive() == n + nIte * 4);
+    REQUIRE(simuTest.getBodies().getN() == n + nIte * 5);
+    REQUIRE(simuRef.getBodies().getN() == n + nIte * 4);
+
+    const Bodies<float> &ref = simuRef.getBodies();
+    const Bodies<float> &test = simuTest.getBodies();
+    for (unsigned long b = 0, r = 0; b < test.getN(); b++) {
+        if (!test.isAlive(b))
+            continue;
+        // the live bodies are in the same order
+        REQUIRE(test.getIds()[b] == ref.getIds()[r]);
+        REQUIRE_THAT(ref.getDataSoA().qx[r], Catch::Matchers::WithinRel(test.getDataSoA().qx[b], eps));
+        REQUIRE_THAT(ref.getDataSoA().qy[r], Catch::Matchers::WithinRel(test.getDataSoA().qy[b], eps));
+        REQUIRE_THAT(ref.getDataSoA().vz[r] + 1e3f, Catch::Matchers::WithinRel(test.getDataSoA().vz[b] + 1e3f, eps));
+        r++;
+    }
+}
+
+TEST_CASE("n-body - Dynamic number of bodies", "[dynamic]")
+{
+    SECTION("fp64 - n=13 - add 100") { test_bodies_dynamic<double>(13, 100); }
+    SECTION("fp32 - n=13 - add 3") { test_bodies_dynamic<float>(13, 3); }
+    SECTION("fp32 - n=1000 - add 5000") { test_bodies_dynamic<float>(1000, 5000); }
+
+    SECTION("fp32 - n=509 - simd")
+    {
+        SimulationNBodySIMD<float> simu(509, "galaxy", 2e+08);
+        test_simulation_dynamic(509, 2e+08, 6, 1e-3, simu);
+    }
+    SECTION("fp32 - n=509 - fp16")
+    {
+        SimulationNBodyHalf simu(509, "galaxy", 2e+08);
+        test_simulation_dynamic(509, 2e+08, 6, 2e-2, simu);
+    }
+    SECTION("fp32 - n=509 - bh")
+    {
+        SimulationNBodyBarnesHut<float> simu(509, "galaxy", 2e+08, 0, 0.3, 16, 2);
+        test_simulation_dynamic(509, 2e+08, 6, 1e-2, simu);
+    }
+    SECTION("fp32 - n=509 - cutoff")
+    {
+        // the cutoff is larger than the galaxy: all the pairs interact
+        SimulationNBodyCutoff<float> simu(509, "galaxy", 2e+08, 0, 1e10, 1e9);
+        test_simulation_dynamic(509, 2e+08, 6, 1e-3, simu);
+    }
+}
+
+/* cost of the insertions and of the compaction, run it with: ./bin/murb-test "[dynamic-report]" */
+TEST_CASE("n-body - Dynamic number of bodies - report", "[.][dynamic-report]")
+{
+    const unsigned long n = 1000000;
+    Bodies<float> bodies(1000, "random");
+    Perf perf;
+    perf.start();
+    for (unsigned long i = 0; i < n; i++)
+        bodies.addBody(1e21f, 1e6f, i, 0, 0, 0, 0, 0);
+    perf.stop();
+    std::cout << "add " << n << " bodies: " << std::fixed << std::setprecision(1) << perf.getElapsedTime() << " ms ("
+              << perf.getElapsedTime() * 1e6f / n << " ns/body, capacity " << bodies.getCapacity() << ")"
+              << std::endl;
+
+    perf.start();
+    for (unsigned long i = 0; i < bodies.getN(); i += 2)
+        bodies.removeBody(i);
+    perf.stop();
+    std::cout << "remove half of them: " << perf.getElapsedTime() << " ms" << std::endl;
+
+    perf.start();
+    bodies.updateLayout();
+    perf.stop();
+    std::cout << "compaction: " << perf.getElapsedTime() << " ms (n = " << bodies.getN() << ")" << std::defaultfloat
+              << std::endl;
+}
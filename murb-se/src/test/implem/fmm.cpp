@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+
+#include "SimulationNBodyFMM.hpp"
+#include "SimulationNBodyProbe.hpp"
+#include "utils/Perf.hpp"
+
+/* errors of the FMM accelerations compared to `cpu+naive` (fp64), relative to the rms norm of the reference
+ * accelerations */
+void accuracy_nbody_fmm(const SimulationNBodyNaiveProbe<double> &simuRef, const size_t n, const double soft,
+                        const std::string &scheme, const int order, const double theta, double &maxErr,
+                        double &rmsErr)
+{
+    SimulationNBodyProbe<SimulationNBodyFMM<double>> simuTest(n, scheme, soft, 0, order, theta);
+    simuTest.setDt(3600);
+
+    simuTest.computeOneIteration();
+
+    const std::vector<accAoS_t<double>> &aRef = simuRef.getAccelerations();
+    const accSoA_t<double> &aTest = simuTest.getAccelerations();
+
+    double sumRef = 0.;
+    for (size_t b = 0; b < n; b++)
+        sumRef += aRef[b].ax * aRef[b].ax + aRef[b].ay * aRef[b].ay + aRef[b].az * aRef[b].az;
+    const double rmsRef = std::sqrt(sumRef / n);
+
+    double sumErr = 0.;
+    maxErr = 0.;
+    for (size_t b = 0; b < n; b++) {
+        const double dx = aTest.ax[b] - aRef[b].ax;
+        const double dy = aTest.ay[b] - aRef[b].ay;
+        const double dz = aTest.az[b] - aRef[b].az;
+        const double err = std::sqrt(dx * dx + dy * dy + dz * dz) / rmsRef;
+        maxErr = std::max(maxErr, err);
+        sumErr += err * err;
+    }
+    rmsErr = std::sqrt(sumErr / n);
+}
+
+void test_nbody_fmm(const size_t n, const double soft, const std::string &scheme, const double theta)
+{
+    SimulationNBodyNaiveProbe<double> simuRef(n, scheme, soft);
+    simuRef.setDt(3600);
+    simuRef.computeOneIteration();
+
+    // the error decreases with the order
+    double maxErr, rmsErr, prevRmsErr = 1.;
+    for (int order : {1, 2, 4, 6, 8}) {
+        accuracy_nbody_fmm(simuRef, n, soft, scheme, order, theta, maxErr, rmsErr);
+        REQUIRE(rmsErr <= prevRmsErr);
+        prevRmsErr = rmsErr;
+    }
+    // the error of the order p is about theta^p
+    REQUIRE(rmsErr < 1e-3);
+    REQUIRE(maxErr < 1e-2);
+}
+
+TEST_CASE("n-body - FMM", "[fmm]")
+{
+    SECTION("fp64 - n=13 - random") { test_nbody_fmm(13, 2e+08, "random", 0.5); }
+    SECTION("fp64 - n=3000 - random") { test_nbody_fmm(3000, 2e+08, "random", 0.5); }
+    SECTION("fp64 - n=3000 - galaxy") { test_nbody_fmm(3000, 2e+08, "galaxy", 0.5); }
+    SECTION("fp64 - n=3000 - random - small softening") { test_nbody_fmm(3000, 1e+06, "random", 0.5); }
+    SECTION("fp64 - n=3000 - galaxy - small softening") { test_nbody_fmm(3000, 1e+06, "galaxy", 0.5); }
+
+    SECTION("fp32 - n=2049 - i=3 - galaxy")
+    {
+        SimulationNBodyNaive<float> simuRef(2049, "galaxy", 2e+08);
+        simuRef.setDt(3600);
+        SimulationNBodyFMM<float> simuTest(2049, "galaxy", 2e+08, 0, 6);
+        simuTest.setDt(3600);
+        for (size_t i = 0; i < 3; i++) {
+            simuRef.computeOneIteration();
+            simuTest.computeOneIteration();
+        }
+        const float *xRef = simuRef.getBodies().getDataSoA().qx.data();
+        const float *xTest = simuTest.getBodies().getDataSoA().qx.data();
+        for (size_t b = 0; b < 2049; b++)
+            REQUIRE_THAT(xRef[b], Catch::Matchers::WithinRel(xTest[b], 1e-1f));
+    }
+
+    SECTION("fp64 - n=3000 - i=4 - galaxy - refit")
+    {
+        // the tree is built once and then refitted
+        SimulationNBodyNaive<double> simuRef(3000, "galaxy", 2e+08);
+        simuRef.setDt(3600);
+        SimulationNBodyFMM<double> simuTest(3000, "galaxy", 2e+08, 0, 6, 0.5, 64, 4);
+        simuTest.setDt(3600);
+        for (size_t i = 0; i < 4; i++) {
+            simuRef.computeOneIteration();
+            simuTest.computeOneIteration();
+        }
+        const double *xRef = simuRef.getBodies().getDataSoA().qx.data();
+        const double *xTest = simuTest.getBodies().getDataSoA().qx.data();
+        for (size_t b = 0; b < 3000; b++)
+            REQUIRE_THAT(xRef[b], Catch::Matchers::WithinRel(xTest[b], 1e-3));
+    }
+}
+
+/* accuracy vs order report, run it with: ./bin/murb-test "[fmm-report]" */
+TEST_CASE("n-body - FMM - accuracy report", "[.][fmm-report]")
+{
+    std::cout << "accuracy of the FMM accelerations vs cpu+naive (errors relative to the rms acceleration):"
+              << std::endl;
+    std::cout << "  scheme |  soft |      n | order |   max err |   rms err" << std::endl;
+    for (auto scheme : {"galaxy", "random"})
+        for (auto soft : {2e+08, 1e+06})
+            for (auto n : {10000ul, 30000ul}) {
+                SimulationNBodyNaiveProbe<double> simuRef(n, scheme, soft);
+                simuRef.setDt(3600);
+                simuRef.computeOneIteration();
+                for (int order = 1; order <= 8; order++) {
+                    double maxErr, rmsErr;
+                    accuracy_nbody_fmm(simuRef, n, soft, scheme, order, 0.5, maxErr, rmsErr);
+                    std::cout << "  " << std::setw(6) << scheme << " | " << std::scientific << std::setprecision(0)
+                              << soft << " | " << std::defaultfloat << std::setw(6) << n << " | " << std::setw(5)
+                              << order << " | " << std::scientific << std::setprecision(2) << std::setw(9) << maxErr
+                              << " | " << std::setw(9) << rmsErr << std::defaultfloat << std::endl;
+                }
+            }
+
+    std::cout << std::endl << "time per step vs n (order 4, theta 0.5, galaxy):" << std::endl;
+    for (auto n : {10000ul, 40000ul, 160000ul, 640000ul}) {
+        SimulationNBodyFMM<float> simu(n, "galaxy", 2e+08);
+        simu.setDt(3600);
+        Perf perf;
+        perf.start();
+        simu.computeOneIteration();
+        perf.stop();
+        std::cout << "  n = " << std::setw(7) << n << ": " << std::fixed << std::setprecision(1) << std::setw(9)
+                  << perf.getElapsedTime() << " ms (" << perf.getElapsedTime() * 1e3f / n << " us/body)"
+                  << std::defaultfloat << std::endl;
+    }
+}
@@ -0,0 +1,127 @@
+#include <catch.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "SimulationNBodySIMD.hpp"
+#include "ogl/SpheresVisuFrames.hpp"
+#include "utils/Perf.hpp"
+
+/* names of the files of a directory (removed if `clean`) */
+static std::vector<std::string> list_frames(const std::string &directory, const bool clean)
+{
+    std::vector<std::string> names;
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr)
+        return names;
+    for (struct dirent *e = readdir(dir); e != nullptr; e = readdir(dir)) {
+        const std::string name = e->d_name;
+        if (name == "." || name == "..")
+            continue;
+        names.push_back(name);
+        if (clean)
+            std::remove((directory + "/" + name).c_str());
+    }
+    closedir(dir);
+    if (clean)
+        rmdir(directory.c_str());
+    return names;
+}
+
+/* the images are the snapshots of the iterations multiple of the period, the last one is always written */
+template <typename T> void test_frames(const unsigned long n, const unsigned long period, const bool color)
+{
+    char tmpl[] = "/tmp/murb-frames-XXXXXX";
+    REQUIRE(mkdtemp(tmpl) != nullptr);
+    const std::string directory = tmpl;
+
+    const int width = 64, height = 48;
+    SimulationNBodySIMD<T> simu(n, "galaxy", 2e+08);
+    simu.setDt(3600);
+    {
+        SpheresVisuFrames<T> visu(simu.getBodies(), directory, period, width, height, color);
+        for (unsigned long i = 0; i < 10; i++) {
+            visu.refreshDisplay();
+            simu.computeOneIteration();
+        }
+    }
+
+    std::ifstream last(directory + "/frame_000009.ppm", std::ios::binary);
+    REQUIRE(last.good());
+    std::string magic;
+    int w = 0, h = 0, maxValue = 0;
+    last >> magic >> w >> h >> maxValue;
+    last.get();
+    const std::vector<char> pixels((std::istreambuf_iterator<char>(last)), std::istreambuf_iterator<char>());
+    last.close();
+
+    const std::vector<std::string> names = list_frames(directory, true);
+    REQUIRE(names.size() >= 1);
+    REQUIRE(names.size() <= (10 + period - 1) / period);
+    for (const std::string &name : names) {
+        REQUIRE(name.size() == std::string("frame_000000.ppm").size());
+        REQUIRE(std::stoul(name.substr(6, 6)) % period == 0);
+    }
+
+    REQUIRE(magic == "P6");
+    REQUIRE(w == width);
+    REQUIRE(h == height);
+    REQUIRE(maxValue == 255);
+    REQUIRE(pixels.size() == (size_t)(3 * width * height));
+    unsigned long nLit = 0;
+    for (size_t i = 0; i < pixels.size(); i += 3)
+        nLit += (pixels[i] != 0 || pixels[i + 1] != 0 || pixels[i + 2] != 0) ? 1 : 0;
+    // the galaxy is framed: a fraction of the pixels is lit, not all of them
+    REQUIRE(nLit > 10);
+    REQUIRE(nLit < (unsigned long)(width * height));
+}
+
+TEST_CASE("Headless images (PPM)", "[frames]")
+{
+    SECTION("fp32 - n=2000 - period 3 - color") { test_frames<float>(2000, 3, true); }
+    SECTION("fp64 - n=1000 - period 1 - white") { test_frames<double>(1000, 1, false); }
+}
+
+/* time of `refreshDisplay` (snapshot) vs time of an iteration, run it with: ./bin/murb-test "[frames-report]" */
+TEST_CASE("Headless images (PPM) - report", "[.][frames-report]")
+{
+    std::cout << "headless images 1024x768 every iteration, cpu+simd, galaxy, fp32:" << std::endl;
+    std::cout << "        n | snapshot (ms) | iteration (ms) | images written" << std::endl;
+    for (unsigned long n : {10000ul, 30000ul, 100000ul}) {
+        char tmpl[] = "/tmp/murb-frames-XXXXXX";
+        REQUIRE(mkdtemp(tmpl) != nullptr);
+        const std::string directory = tmpl;
+
+        SimulationNBodySIMD<float> simu(n, "galaxy", 2e+08);
+        simu.setDt(3600);
+        Perf perfSnapshot, perfIte;
+        const int nIte = 5;
+        {
+            SpheresVisuFrames<float> visu(simu.getBodies(), directory, 1, 1024, 768, true);
+            for (int i = 0; i < nIte; i++) {
+                Perf perf;
+                perf.start();
+                visu.refreshDisplay();
+                perf.stop();
+                perfSnapshot += perf;
+
+                perf.start();
+                simu.computeOneIteration();
+                perf.stop();
+                perfIte += perf;
+            }
+        }
+        const unsigned long nImages = list_frames(directory, true).size();
+
+        std::cout << "  " << std::setw(7) << n << " | " << std::fixed << std::setprecision(3) << std::setw(13)
+                  << perfSnapshot.getElapsedTime() / nIte << " | " << std::setw(14) << perfIte.getElapsedTime() / nIte
+                  << " | " << std::setw(8) << nImages << " / " << nIte << std::defaultfloat << std::endl;
+    }
+}
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+
+#include "SimulationNBodyHalf.hpp"
+#include "SimulationNBodyProbe.hpp"
+
+/* errors of the accelerations computed from the fp16/bf16 j-bodies compared to `cpu+naive`, the errors are relative to
+ * the rms norm of the reference accelerations (the galaxy center has an almost null acceleration) */
+void accuracy_nbody_half(const size_t n, const float soft, const std::string &scheme, const bool bf16, float &maxErr,
+                         float &rmsErr)
+{
+    SimulationNBodyNaiveProbe<float> simuRef(n, scheme, soft);
+    simuRef.setDt(3600);
+    SimulationNBodyProbe<SimulationNBodyHalf> simuTest(n, scheme, soft, 0, bf16);
+    simuTest.setDt(3600);
+
+    simuRef.computeOneIteration();
+    simuTest.computeOneIteration();
+
+    const std::vector<accAoS_t<float>> &aRef = simuRef.getAccelerations();
+    const accSoA_t<float> &aTest = simuTest.getAccelerations();
+
+    double sumRef = 0.;
+    for (size_t b = 0; b < n; b++)
+        sumRef += (double)aRef[b].ax * aRef[b].ax + (double)aRef[b].ay * aRef[b].ay + (double)aRef[b].az * aRef[b].az;
+    const double rmsRef = std::sqrt(sumRef / n);
+
+    double sumErr = 0.;
+    maxErr = 0.f;
+    for (size_t b = 0; b < n; b++) {
+        const double dx = (double)aTest.ax[b] - aRef[b].ax;
+        const double dy = (double)aTest.ay[b] - aRef[b].ay;
+        const double dz = (double)aTest.az[b] - aRef[b].az;
+        const double err = std::sqrt(dx * dx + dy * dy + dz * dz) / rmsRef;
+        maxErr = std::max(maxErr, (float)err);
+        sumErr += err * err;
+    }
+    rmsErr = (float)std::sqrt(sumErr / n);
+}
+
+void test_nbody_half(const size_t n, const std::string &scheme, const bool bf16, const float eps)
+{
+    float maxErr, rmsErr;
+    accuracy_nbody_half(n, 2e+08, scheme, bf16, maxErr, rmsErr);
+    REQUIRE(maxErr < eps);
+    REQUIRE(rmsErr < eps);
+}
+
+TEST_CASE("n-body - Half precision j-bodies", "[half]")
+{
+    SECTION("fp16 - n=13 - random") { test_nbody_half(13, "random", false, 5e-3); }
+    SECTION("fp16 - n=2049 - random") { test_nbody_half(2049, "random", false, 5e-3); }
+    SECTION("fp16 - n=13 - galaxy") { test_nbody_half(13, "galaxy", false, 5e-3); }
+    SECTION("fp16 - n=2049 - galaxy") { test_nbody_half(2049, "galaxy", false, 5e-3); }
+
+    SECTION("bf16 - n=13 - random") { test_nbody_half(13, "random", true, 5e-2); }
+    SECTION("bf16 - n=2049 - random") { test_nbody_half(2049, "random", true, 5e-2); }
+    SECTION("bf16 - n=13 - galaxy") { test_nbody_half(13, "galaxy", true, 5e-2); }
+    SECTION("bf16 - n=2049 - galaxy") { test_nbody_half(2049, "galaxy", true, 5e-2); }
+}
+
+/* accuracy report, run it with: ./bin/murb-test "[half-report]" */
+TEST_CASE("n-body - Half precision j-bodies - accuracy report", "[.][half-report]")
+{
+    std::cout << "accuracy of the accelerations vs cpu+naive (errors relative to the rms acceleration):" << std::endl;
+    std::cout << "  scheme |      n | format |   max err |   rms err" << std::endl;
+    for (auto scheme : {"galaxy", "random"})
+        for (auto n : {1000ul, 10000ul, 30000ul})
+            for (auto bf16 : {false, true}) {
+                float maxErr, rmsErr;
+                accuracy_nbody_half(n, 2e+08, scheme, bf16, maxErr, rmsErr);
+                std::cout << "  " << std::setw(6) << scheme << " | " << std::setw(6) << n << " | "
+                          << (bf16 ? "  bf16" : "  fp16") << " | " << std::scientific << std::setprecision(2)
+                          << std::setw(9) << maxErr << " | " << std::setw(9) << rmsErr << std::defaultfloat
+                          << std::endl;
+            }
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "KernelsISA.hpp"
+#include "KernelsSIMD.hpp"
+#include "SimulationNBodyNaive.hpp"
+#include "SimulationNBodySIMD.hpp"
+#include "utils/Mipp.hpp"
+#include "utils/Perf.hpp"
+
+/* size of the registers of an instruction set, in bytes */
+static int get_register_bytes(const std::string &isa)
+{
+    if (isa == "sse2")
+        return 16;
+    if (isa == "avx2")
+        return 32;
+    if (isa == "avx512")
+        return 64;
+    return mipp::RegisterSizeBit / 8; // "default": the instruction set of the compiler flags
+}
+
+/* the dispatched kernel gives the same trajectories as `cpu+naive` */
+template <typename T>
+void test_nbody_isa(const size_t n, const T soft, const size_t nIte, const std::string &scheme, const T eps)
+{
+    SimulationNBodyNaive<T> simuRef(n, scheme, soft);
+    simuRef.setDt(3600);
+    SimulationNBodySIMD<T> simuTest(n, scheme, soft);
+    simuTest.setDt(3600);
+
+    for (size_t i = 0; i < nIte; i++) {
+        simuRef.computeOneIteration();
+        simuTest.computeOneIteration();
+    }
+
+    const dataSoA_t<T> &ref = simuRef.getBodies().getDataSoA();
+    const dataSoA_t<T> &test = simuTest.getBodies().getDataSoA();
+    for (size_t b = 0; b < n; b++) {
+        REQUIRE_THAT(ref.qx[b], Catch::Matchers::WithinRel(test.qx[b], eps));
+        REQUIRE_THAT(ref.qy[b], Catch::Matchers::WithinRel(test.qy[b], eps));
+        REQUIRE_THAT(ref.qz[b], Catch::Matchers::WithinRel(test.qz[b], eps));
+    }
+}
+
+/* the dispatched kernels of the tree, cutoff and P3M implementations give the accelerations of the inline kernels of
+ * `KernelsSIMD.hpp` compiled with the flags of the build */
+template <typename T> void test_kernels_isa(const unsigned long ni, const unsigned long nj, const T eps)
+{
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<T> dist(-1e10, 1e10);
+    std::vector<T> qi(3 * ni), qj(3 * nj), mj(nj);
+    for (T &q : qi)
+        q = dist(gen);
+    for (T &q : qj)
+        q = dist(gen);
+    for (T &m : mj)
+        m = std::abs(dist(gen)) * 1e10;
+    std::vector<nodeHot_t<T>> nodes(nj);
+    for (unsigned long j = 0; j < nj; j++) {
+        nodes[j] = {qj[j], qj[nj + j], qj[2 * nj + j], mj[j], {}, 0};
+        for (int k = 0; k < 6; k++)
+            nodes[j].q[k] = dist(gen) * 1e6;
+        nodes[j].tq = (nodes[j].q[0] + nodes[j].q[3] + nodes[j].q[5]) / 2;
+    }
+    const T *qix = &qi[0], *qiy = &qi[ni], *qiz = &qi[2 * ni];
+    const T *qjx = &qj[0], *qjy = &qj[nj], *qjz = &qj[2 * nj];
+    const T softSquared = (T)4e16, cutoff = (T)1e10, split = (T)3e9;
+
+    for (int kernel = 0; kernel < 4; kernel++) {
+        std::vector<T> aRef(3 * ni, 0), aTest(3 * ni, 0);
+        T *ax[2] = {&aRef[0], &aTest[0]}, *ay[2] = {&aRef[ni], &aTest[ni]}, *az[2] = {&aRef[2 * ni], &aTest[2 * ni]};
+        if (kernel == 0) {
+            computeAccelerationsSIMD<T>(qix, qiy, qiz, ni, qjx, qjy, qjz, mj.data(), nj, softSquared, ax[0], ay[0],
+                                        az[0]);
+            computeAccelerationsISA<T>(qix, qiy, qiz, ni, qjx, qjy, qjz, mj.data(), nj, softSquared, ax[1], ay[1],
+                                       az[1]);
+        }
+        else if (kernel == 1) {
+            computeCutoffAccelerationsSIMD<T>(qix, qiy, qiz, ni, qjx, qjy, qjz, mj.data(), nj, softSquared, cutoff,
+                                              ax[0], ay[0], az[0]);
+            computeCutoffAccelerationsISA<T>(qix, qiy, qiz, ni, qjx, qjy, qjz, mj.data(), nj, softSquared, cutoff,
+                                             ax[1], ay[1], az[1]);
+        }
+        else if (kernel == 2) {
+            computeShortRangeAccelerationsSIMD<T>(qix, qiy, qiz, ni, qjx, qjy, qjz, mj.data(), nj, softSquared, split,
+                                                  ax[0], ay[0], az[0]);
+            computeShortRangeAccelerationsISA<T>(qix, qiy, qiz, ni, qjx, qjy, qjz, mj.data(), nj, softSquared, split,
+                                                 ax[1], ay[1], az[1]);
+        }
+        else {
+            computeNodeAccelerationsSIMD<T>(qix, qiy, qiz, ni, nodes.data(), nj, softSquared, ax[0], ay[0], az[0]);
+            computeNodeAccelerationsISA<T>(qix, qiy, qiz, ni, nodes.data(), nj, softSquared, ax[1], ay[1], az[1]);
+        }
+
+        // errors relative to the largest acceleration (the sums of opposite contributions can cancel)
+        T aMax = 0;
+        for (const T a : aRef)
+            aMax = std::max(aMax, std::abs(a));
+        REQUIRE(aMax > 0);
+        for (unsigned long i = 0; i < 3 * ni; i++)
+            REQUIRE(std::abs(aTest[i] - aRef[i]) <= eps * aMax);
+    }
+}
+
+TEST_CASE("n-body - Runtime dispatch of the instruction set", "[isa]")
+{
+    const std::vector<std::string> &isas = getCompiledISAs();
+    REQUIRE(!isas.empty());
+    REQUIRE(isISASupported(detectISA()));
+    REQUIRE(!isISASupported("mmx"));
+    REQUIRE(!selectISA("mmx"));
+
+    REQUIRE(selectISA("auto"));
+    REQUIRE(getSelectedISA() == detectISA());
+
+    for (const std::string &isa : isas) {
+        if (!isISASupported(isa))
+            continue;
+        SECTION(isa)
+        {
+            REQUIRE(selectISA(isa));
+            REQUIRE(getSelectedISA() == isa);
+            REQUIRE(getSelectedISAWidth<float>() * (int)sizeof(float) == get_register_bytes(isa));
+            REQUIRE(getSelectedISAWidth<double>() * (int)sizeof(double) == get_register_bytes(isa));
+
+            // the numbers of bodies are not multiples of the widths
+            test_nbody_isa<float>(13, 2e+08, 10, "random", 1e-3);
+            test_nbody_isa<float>(2049, 2e+08, 3, "galaxy", 1e-1);
+            test_nbody_isa<double>(37, 2e+08, 10, "random", 1e-9);
+            test_nbody_isa<double>(2049, 2e+08, 3, "galaxy", 1e-9);
+            test_kernels_isa<float>(13, 37, 1e-4);
+            test_kernels_isa<double>(13, 37, 1e-12);
+        }
+    }
+    REQUIRE(selectISA("auto"));
+}
+
+/* time of the `cpu+simd` iterations for each instruction set, run it with: ./bin/murb-test "[isa-report]" */
+TEST_CASE("n-body - Runtime dispatch of the instruction set - report", "[.][isa-report]")
+{
+    const unsigned long n = 30000, nIte = 5;
+    std::cout << "time of an iteration of cpu+simd (n = " << n << ", galaxy, fp32):" << std::endl;
+    for (const std::string &isa : getCompiledISAs()) {
+        if (!selectISA(isa)) {
+            std::cout << "  " << std::setw(7) << isa << ": not supported by the CPU" << std::endl;
+            continue;
+        }
+        SimulationNBodySIMD<float> simu(n, "galaxy", 2e+08);
+        simu.computeOneIteration(); // warm-up
+        Perf perf;
+        perf.start();
+        for (unsigned long i = 0; i < nIte; i++)
+            simu.computeOneIteration();
+        perf.stop();
+        std::cout << "  " << std::setw(7) << isa << ": " << std::fixed << std::setprecision(1) << std::setw(8)
+                  << perf.getElapsedTime() / nIte << " ms (" << getSelectedISAWidth<float>() << " lanes, "
+                  << perf.getGflops(simu.getFlopsPerIte() * nIte) << " Gflop/s)" << std::defaultfloat << std::endl;
+    }
+    selectISA("auto");
+}
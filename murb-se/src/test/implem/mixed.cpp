@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <exception>
+#include <numeric>
+#include <random>
+#include <string>
+
+#include "SimulationNBodyMixed.hpp"
+#include "SimulationNBodyNaive.hpp"
+
+/* replace the bodies of `simu` by the ones of `simuRef` moved by `offset` along the 3 axes (the tombstones of the
+ * removed bodies are compacted, the order of the bodies is kept) */
+template <typename T>
+void set_bodies(SimulationNBodyInterface<T> &simu, const SimulationNBodyInterface<double> &simuRef, const double offset)
+{
+    const dataSoA_t<double> &d = simuRef.getBodies().getDataSoA();
+    const unsigned long n = simu.getBodies().getN();
+    for (unsigned long b = 0; b < n; b++)
+        simu.addBody((T)d.m[b], (T)d.r[b], (T)(d.qx[b] + offset), (T)(d.qy[b] + offset), (T)(d.qz[b] + offset),
+                     (T)d.vx[b], (T)d.vy[b], (T)d.vz[b]);
+    for (unsigned long b = 0; b < n; b++)
+        simu.removeBody(b);
+    simu.updateBodiesLayout();
+    REQUIRE(simu.getBodies().getN() == n);
+}
+
+/* largest distance between the positions of `simu` and the ones of `simuRef`, relative to the largest displacement of
+ * the reference since `q0` */
+template <typename T>
+double get_error(const SimulationNBodyInterface<T> &simu, const SimulationNBodyInterface<double> &simuRef,
+                 const std::vector<double> &q0)
+{
+    const dataSoA_t<T> &d = simu.getBodies().getDataSoA();
+    const dataSoA_t<double> &r = simuRef.getBodies().getDataSoA();
+    const unsigned long n = simuRef.getBodies().getN();
+    double err = 0., disp = 0.;
+    for (unsigned long b = 0; b < n; b++) {
+        err = std::max(err, std::abs((double)d.qx[b] - r.qx[b]));
+        err = std::max(err, std::abs((double)d.qy[b] - r.qy[b]));
+        err = std::max(err, std::abs((double)d.qz[b] - r.qz[b]));
+        disp = std::max(disp, std::abs(r.qx[b] - q0[b]));
+        disp = std::max(disp, std::abs(r.qy[b] - q0[n + b]));
+        disp = std::max(disp, std::abs(r.qz[b] - q0[2 * n + b]));
+    }
+    return err / disp;
+}
+
+/* the fp64 reference, the mixed precision and fp32 everywhere start from the same bodies (moved by `offset`) */
+void test_nbody_mixed(const size_t n, const float soft, const float dt, const size_t nIte, const std::string &scheme,
+                      const double eps, const double offset = 0.)
+{
+    SimulationNBodyNaive<double> simuInit(n, scheme, soft);
+
+    SimulationNBodyNaive<double> simuRef(n, scheme, soft);
+    simuRef.setDt(dt);
+    set_bodies(simuRef, simuInit, offset);
+
+    SimulationNBodyMixed simuTest(n, scheme, soft);
+    simuTest.setDt(dt);
+    set_bodies(simuTest, simuInit, offset);
+
+    SimulationNBodyNaive<float> simuFP32(n, scheme, soft);
+    simuFP32.setDt(dt);
+    set_bodies(simuFP32, simuInit, offset);
+
+    const dataSoA_t<double> &d = simuRef.getBodies().getDataSoA();
+    std::vector<double> q0(d.qx.begin(), d.qx.begin() + n);
+    q0.insert(q0.end(), d.qy.begin(), d.qy.begin() + n);
+    q0.insert(q0.end(), d.qz.begin(), d.qz.begin() + n);
+
+    for (size_t i = 0; i < nIte; i++) {
+        simuRef.computeOneIteration();
+        simuTest.computeOneIteration();
+        simuFP32.computeOneIteration();
+    }
+    // the fp32 interactions only perturb the accelerations, and the offset of the bodies does not change them (the
+    // coordinates are relative to the tiles), whereas fp32 everywhere rounds the positions
+    const double errTest = get_error(simuTest, simuRef, q0);
+    REQUIRE(errTest <= eps);
+    REQUIRE(errTest < get_error(simuFP32, simuRef, q0));
+}
+
+TEST_CASE("n-body - Mixed precision", "[mixed]")
+{
+    SECTION("mixed - n=13 - i=1 - random") { test_nbody_mixed(13, 2e+08, 3600, 1, "random", 1e-9); }
+    SECTION("mixed - n=13 - i=100 - random") { test_nbody_mixed(13, 2e+08, 3600, 100, "random", 1e-9); }
+    SECTION("mixed - n=16 - i=1 - random") { test_nbody_mixed(16, 2e+08, 3600, 1, "random", 1e-9); }
+    SECTION("mixed - n=2049 - i=3 - random") { test_nbody_mixed(2049, 2e+08, 3600, 3, "random", 1e-6); }
+
+    SECTION("mixed - n=13 - i=1 - galaxy") { test_nbody_mixed(13, 2e+08, 3600, 1, "galaxy", 1e-8); }
+    SECTION("mixed - n=16 - i=1 - galaxy") { test_nbody_mixed(16, 2e+08, 3600, 1, "galaxy", 1e-8); }
+    SECTION("mixed - n=2049 - i=3 - galaxy") { test_nbody_mixed(2049, 2e+08, 3600, 3, "galaxy", 1e-6); }
+
+    // far from the origin (1e9 m): the ulp of the fp32 positions is 64 m
+    SECTION("mixed - n=2049 - i=3 - random - offset 1e9 m")
+    {
+        test_nbody_mixed(2049, 2e+08, 3600, 3, "random", 1e-6, 1e9);
+    }
+    SECTION("mixed - n=2049 - i=3 - galaxy - offset 1e9 m")
+    {
+        test_nbody_mixed(2049, 2e+08, 3600, 3, "galaxy", 1e-6, 1e9);
+    }
+}
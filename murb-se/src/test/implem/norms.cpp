@@ -0,0 +1,42 @@
+#include <catch.hpp>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "SimulationNBodyNaive.hpp"
+#include "utils/Norms.hpp"
+
+/* the SIMD pass gives the scalar squared norms of the velocities and their range, whatever the remainder */
+template <typename T> void test_norms(const unsigned long n)
+{
+    SimulationNBodyNaive<T> simu(n, "galaxy", 2e+08);
+    const dataSoA_t<T> &d = simu.getBodies().getDataSoA();
+
+    std::vector<float> norms(n);
+    float min = 0.f, max = 0.f;
+    squaredNorms<T>(d.vx.data(), d.vy.data(), d.vz.data(), n, norms.data(), min, max);
+
+    float minRef = std::numeric_limits<float>::infinity();
+    float maxRef = -std::numeric_limits<float>::infinity();
+    for (unsigned long b = 0; b < n; b++) {
+        const T normRef = d.vx[b] * d.vx[b] + d.vy[b] * d.vy[b] + d.vz[b] * d.vz[b];
+        REQUIRE_THAT(norms[b], Catch::Matchers::WithinRel((float)normRef, 1e-5f));
+        minRef = std::min(minRef, norms[b]);
+        maxRef = std::max(maxRef, norms[b]);
+    }
+    REQUIRE(min == minRef);
+    REQUIRE(max == maxRef);
+}
+
+TEST_CASE("Squared norms (visualization colors)", "[norms]")
+{
+    SECTION("fp32 - n=1000") { test_norms<float>(1000); }
+    SECTION("fp32 - n=13") { test_norms<float>(13); }
+    SECTION("fp64 - n=1001") { test_norms<double>(1001); }
+    SECTION("fp32 - n=0")
+    {
+        float min = 0.f, max = 0.f;
+        squaredNorms<float>(nullptr, nullptr, nullptr, 0, nullptr, min, max);
+        REQUIRE(min > max);
+    }
+}
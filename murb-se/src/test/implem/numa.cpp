@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <atomic>
+#include <catch.hpp>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "SimulationNBodySIMD.hpp"
+#include "utils/Numa.hpp"
+#include "utils/Perf.hpp"
+#include "utils/TaskScheduler.hpp"
+
+/* number of CPUs the calling thread may run on */
+static unsigned count_allowed_cpus()
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    REQUIRE(sched_getaffinity(0, sizeof(set), &set) == 0);
+    return CPU_COUNT(&set);
+#else
+    return 1;
+#endif
+}
+
+/* each iteration is executed once, the part `t` of the range by the thread `t` if nothing is stolen */
+static void test_numa_affinity(TaskScheduler &scheduler, const unsigned long n, const unsigned long grain)
+{
+    std::vector<std::atomic<int>> visits(n);
+    for (auto &v : visits)
+        v = 0;
+    std::atomic<bool> aligned(true);
+    scheduler.parallelForAffinity(0, n, grain, [&](unsigned long b, unsigned long e) {
+        if (b % grain != 0 || e - b > grain)
+            aligned = false;
+        for (unsigned long i = b; i < e; i++)
+            visits[i]++;
+    });
+    REQUIRE(aligned);
+    for (unsigned long i = 0; i < n; i++)
+        REQUIRE(visits[i] == 1);
+}
+
+/* the pinned threads, the first touch and the replicas of the j-bodies do not change the results */
+template <typename T> void test_numa_simd(const size_t n, const unsigned nThreads, const bool dynamicSchedule)
+{
+    SimulationNBodySIMD<T> simuRef(n, "galaxy", 2e+08, 0, 64, dynamicSchedule);
+    simuRef.setDt(3600);
+    for (int i = 0; i < 3; i++)
+        simuRef.computeOneIteration();
+
+    TaskScheduler::get().setNumThreads(nThreads);
+    TaskScheduler::get().setPinning(true);
+    SimulationNBodySIMD<T> simuTest(n, "galaxy", 2e+08, 0, 64, dynamicSchedule, true);
+    simuTest.setDt(3600);
+    for (int i = 0; i < 3; i++)
+        simuTest.computeOneIteration();
+    TaskScheduler::get().setPinning(false);
+    TaskScheduler::get().setNumThreads(TaskScheduler::getDefaultNumThreads());
+
+    for (size_t b = 0; b < n; b++) {
+        REQUIRE(simuRef.getBodies().getDataSoA().qx[b] == simuTest.getBodies().getDataSoA().qx[b]);
+        REQUIRE(simuRef.getBodies().getDataSoA().vz[b] == simuTest.getBodies().getDataSoA().vz[b]);
+        REQUIRE(simuRef.getBodies().getDataAoS()[b].qy == simuTest.getBodies().getDataAoS()[b].qy);
+    }
+}
+
+TEST_CASE("n-body - NUMA placement", "[numa]")
+{
+    SECTION("topology")
+    {
+        REQUIRE(Numa::parseCPUList("0-3,8,10-11\n") == std::vector<unsigned>({0, 1, 2, 3, 8, 10, 11}));
+        REQUIRE(Numa::parseCPUList("5") == std::vector<unsigned>({5}));
+        REQUIRE(Numa::parseCPUList("").empty());
+
+        const std::vector<std::vector<unsigned>> &nodes = Numa::getNodes();
+        REQUIRE(!nodes.empty());
+        for (const std::vector<unsigned> &node : nodes) {
+            REQUIRE(!node.empty());
+            REQUIRE(std::is_sorted(node.begin(), node.end()));
+        }
+        REQUIRE(Numa::toString().find(nodes.size() > 1 ? " nodes (" : "1 node (") == 0);
+
+        // the consecutive threads are on the same node or on the next one
+        for (unsigned nThreads : {1u, 3u, 64u}) {
+            const std::vector<unsigned> placement = Numa::getPlacement(nThreads);
+            REQUIRE(placement.size() == nThreads);
+            for (unsigned t = 1; t < nThreads; t++)
+                REQUIRE(Numa::getNodeOfCPU(placement[t - 1]) <= Numa::getNodeOfCPU(placement[t]));
+        }
+    }
+    SECTION("loops with affinity")
+    {
+        TaskScheduler scheduler(4);
+        const unsigned nProcessCPUs = count_allowed_cpus();
+        test_numa_affinity(scheduler, 100000, 64);
+        test_numa_affinity(scheduler, 3, 1);
+        scheduler.setPinning(true);
+        REQUIRE(scheduler.isPinned());
+        for (unsigned t = 0; t < 4; t++)
+            REQUIRE(scheduler.getThreadNode(t) < Numa::getNodes().size());
+        test_numa_affinity(scheduler, 100000, 1);
+        // the caller is only pinned during the loops: the threads it creates may run on all the CPUs
+        REQUIRE(count_allowed_cpus() == nProcessCPUs);
+        scheduler.setNumThreads(2);
+        test_numa_affinity(scheduler, 4097, 16);
+        scheduler.setPinning(false);
+        REQUIRE(!scheduler.isPinned());
+        REQUIRE(scheduler.getThreadNode(1) == 0);
+    }
+    SECTION("fp32 - n=1000 - 4 threads, static") { test_numa_simd<float>(1000, 4, false); }
+    SECTION("fp32 - n=1000 - 3 threads, dynamic") { test_numa_simd<float>(1000, 3, true); }
+    SECTION("fp64 - n=333 - 2 threads, static") { test_numa_simd<double>(333, 2, false); }
+}
+
+/* time of the direct sum with the NUMA policies, run it with: ./bin/murb-test "[numa-report]" */
+TEST_CASE("n-body - NUMA placement - report", "[.][numa-report]")
+{
+    std::cout << "topology: " << Numa::toString() << std::endl;
+    const unsigned long n = 65536;
+    for (int policy = 0; policy < 3; policy++) {
+        TaskScheduler::get().setPinning(policy > 0);
+        SimulationNBodySIMD<float> simu(n, "galaxy", 2e+08, 0, 256, false, policy == 2);
+        simu.setDt(3600);
+        simu.computeOneIteration();
+        Perf perf;
+        perf.start();
+        for (int i = 0; i < 3; i++)
+            simu.computeOneIteration();
+        perf.stop();
+        std::cout << "  " << std::setw(9) << ((policy == 0) ? "off" : (policy == 1) ? "pin" : "replicate") << ": "
+                  << std::fixed << std::setprecision(1) << std::setw(9) << perf.getElapsedTime() / 3 << " ms/ite. ("
+                  << simu.getFlopsPerIte() / (perf.getElapsedTime() / 3) * 1e-6f << " Gflop/s)" << std::defaultfloat
+                  << std::endl;
+    }
+    TaskScheduler::get().setPinning(false);
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "utils/Octree.hpp"
+#include "utils/Perf.hpp"
+
+/* random bodies: a dense clump inside a uniform cube (an unbalanced tree), and some duplicated positions */
+template <typename T>
+void init_bodies_octree(const size_t n, std::vector<T> &qx, std::vector<T> &qy, std::vector<T> &qz, std::vector<T> &gm)
+{
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<T> uni(-1e9, 1e9), clump(-1e6, 1e6), mass(1, 10);
+    qx.resize(n);
+    qy.resize(n);
+    qz.resize(n);
+    gm.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        std::uniform_real_distribution<T> &d = (i % 4 == 0) ? clump : uni;
+        qx[i] = d(gen);
+        qy[i] = d(gen);
+        qz[i] = d(gen);
+        gm[i] = mass(gen);
+    }
+    for (size_t i = 0; i < std::min(n, (size_t)200); i += 2) {
+        qx[i + 1] = qx[i];
+        qy[i + 1] = qy[i];
+        qz[i + 1] = qz[i];
+    }
+}
+
+/* the moments of a node computed directly from its bodies */
+void check_moments_octree(const Octree<double> &tree, const octreeNode_t &node)
+{
+    const std::vector<double> &qx = tree.getSortedQx(), &qy = tree.getSortedQy(), &qz = tree.getSortedQz();
+    const std::vector<double> &gm = tree.getSortedGm();
+    double m = 0, cx = 0, cy = 0, cz = 0;
+    for (unsigned long i = node.begin; i < node.end; i++) {
+        m += gm[i];
+        cx += gm[i] * qx[i];
+        cy += gm[i] * qy[i];
+        cz += gm[i] * qz[i];
+    }
+    cx /= m;
+    cy /= m;
+    cz /= m;
+    REQUIRE_THAT(node.gm, Catch::Matchers::WithinRel(m, 1e-12));
+    const double scale = node.radius + 1.;
+    REQUIRE_THAT(node.cx, Catch::Matchers::WithinAbs(cx, 1e-9 * scale));
+    REQUIRE_THAT(node.cy, Catch::Matchers::WithinAbs(cy, 1e-9 * scale));
+    REQUIRE_THAT(node.cz, Catch::Matchers::WithinAbs(cz, 1e-9 * scale));
+
+    double q[6] = {0, 0, 0, 0, 0, 0};
+    for (unsigned long i = node.begin; i < node.end; i++) {
+        const double dx = qx[i] - node.cx, dy = qy[i] - node.cy, dz = qz[i] - node.cz;
+        // the radius is an upper bound
+        REQUIRE(std::sqrt(dx * dx + dy * dy + dz * dz) <= node.radius * (1 + 1e-12) + 1e-6);
+        q[0] += gm[i] * dx * dx;
+        q[1] += gm[i] * dx * dy;
+        q[2] += gm[i] * dx * dz;
+        q[3] += gm[i] * dy * dy;
+        q[4] += gm[i] * dy * dz;
+        q[5] += gm[i] * dz * dz;
+    }
+    const double qScale = m * scale * scale;
+    for (int k = 0; k < 6; k++)
+        REQUIRE_THAT(node.q[k], Catch::Matchers::WithinAbs(q[k], 1e-9 * qScale));
+}
+
+TEST_CASE("n-body - Octree", "[octree]")
+{
+    const size_t n = 20000;
+    const unsigned long leafSize = 16;
+    std::vector<double> qx, qy, qz, gm;
+    init_bodies_octree(n, qx, qy, qz, gm);
+
+    Octree<double> tree(leafSize);
+    tree.build(qx.data(), qy.data(), qz.data(), gm.data(), n);
+    const std::vector<octreeNode_t> &nodes = tree.getNodes();
+    const std::vector<unsigned long> &levelStart = tree.getLevelStart();
+
+    SECTION("structure")
+    {
+        REQUIRE(nodes[0].begin == 0);
+        REQUIRE(nodes[0].end == n);
+        REQUIRE(levelStart.front() == 0);
+        REQUIRE(levelStart.back() == nodes.size());
+
+        // the children partition their parent and are on the next level
+        unsigned long nLeaves = 0, nLeafBodies = 0;
+        for (size_t l = 0; l + 1 < levelStart.size(); l++)
+            for (unsigned long i = levelStart[l]; i < levelStart[l + 1]; i++) {
+                const octreeNode_t &node = nodes[i];
+                REQUIRE(node.end > node.begin);
+                if (node.nChildren == 0) {
+                    nLeaves++;
+                    nLeafBodies += node.end - node.begin;
+                    continue;
+                }
+                REQUIRE(node.nChildren <= 8);
+                REQUIRE(node.firstChild >= levelStart[l + 1]);
+                REQUIRE(node.firstChild + node.nChildren <= levelStart[l + 2]);
+                unsigned long b = node.begin;
+                for (unsigned char c = 0; c < node.nChildren; c++) {
+                    REQUIRE(nodes[node.firstChild + c].begin == b);
+                    b = nodes[node.firstChild + c].end;
+                }
+                REQUIRE(b == node.end);
+            }
+        REQUIRE(nLeaves == tree.getLeaves().size());
+        REQUIRE(nLeafBodies == n);
+
+        // only the leaves of the last level (identical keys) can have more than `leafSize` bodies
+        for (unsigned long l : tree.getLeaves())
+            if (nodes[l].end - nodes[l].begin > leafSize)
+                REQUIRE(l >= levelStart[levelStart.size() - 2]);
+
+        // the sorted arrays follow the permutation, which is a permutation
+        const std::vector<unsigned long> &perm = tree.getPermutation();
+        std::vector<bool> seen(n, false);
+        for (size_t i = 0; i < n; i++) {
+            REQUIRE(!seen[perm[i]]);
+            seen[perm[i]] = true;
+            REQUIRE(tree.getSortedQx()[i] == qx[perm[i]]);
+            REQUIRE(tree.getSortedGm()[i] == gm[perm[i]]);
+        }
+    }
+
+    SECTION("moments")
+    {
+        for (const octreeNode_t &node : nodes)
+            check_moments_octree(tree, node);
+    }
+
+    SECTION("refit")
+    {
+        // small displacements: same topology, new moments
+        std::mt19937_64 gen(7);
+        std::uniform_real_distribution<double> dis(-1e5, 1e5);
+        for (size_t i = 0; i < n; i++) {
+            qx[i] += dis(gen);
+            qy[i] += dis(gen);
+            qz[i] += dis(gen);
+        }
+        const size_t nNodes = nodes.size();
+        tree.refit(qx.data(), qy.data(), qz.data(), gm.data());
+        REQUIRE(tree.getNodes().size() == nNodes);
+        for (const octreeNode_t &node : tree.getNodes())
+            check_moments_octree(tree, node);
+    }
+}
+
+/* build time report, run it with: ./bin/murb-test "[octree-report]" */
+TEST_CASE("n-body - Octree - build report", "[.][octree-report]")
+{
+    std::cout << "octree build and refit time (fp32, leaf size 64):" << std::endl;
+    for (auto n : {100000ul, 1000000ul}) {
+        std::vector<float> qx, qy, qz, gm;
+        init_bodies_octree(n, qx, qy, qz, gm);
+        Octree<float> tree(64);
+        tree.build(qx.data(), qy.data(), qz.data(), gm.data(), n); // warm-up (allocations)
+
+        Perf perfBuild, perfRefit;
+        perfBuild.start();
+        tree.build(qx.data(), qy.data(), qz.data(), gm.data(), n);
+        perfBuild.stop();
+        perfRefit.start();
+        tree.refit(qx.data(), qy.data(), qz.data(), gm.data());
+        perfRefit.stop();
+        std::cout << "  n = " << std::setw(7) << n << ": build " << std::fixed << std::setprecision(1) << std::setw(7)
+                  << perfBuild.getElapsedTime() << " ms, refit " << std::setw(7) << perfRefit.getElapsedTime()
+                  << " ms, " << tree.getNodes().size() << " nodes, " << tree.getLevelStart().size() - 1
+                  << " levels" << std::defaultfloat << std::endl;
+    }
+}
@@ -0,0 +1,58 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <exception>
+#include <numeric>
+#include <random>
+#include <string>
+
+#include "SimulationNBodyNaive.hpp"
+#include "SimulationNBodyOptim.hpp"
+
+template <typename T>
+void test_nbody_optim(const size_t n, const T soft, const T dt, const size_t nIte, const std::string &scheme,
+                     const T eps)
+{
+    SimulationNBodyNaive<T> simuRef(n, scheme, soft);
+    simuRef.setDt(dt);
+
+    SimulationNBodyOptim<T> simuTest(n, scheme, soft);
+    simuTest.setDt(dt);
+
+    const T *xRef = simuRef.getBodies().getDataSoA().qx.data();
+    const T *yRef = simuRef.getBodies().getDataSoA().qy.data();
+    const T *zRef = simuRef.getBodies().getDataSoA().qz.data();
+
+    const T *xTest = simuTest.getBodies().getDataSoA().qx.data();
+    const T *yTest = simuTest.getBodies().getDataSoA().qy.data();
+    const T *zTest = simuTest.getBodies().getDataSoA().qz.data();
+
+    T e = 0; // espilon
+    for (size_t i = 0; i < nIte + 1; i++) {
+        if (i > 0) {
+            simuRef.computeOneIteration();
+            simuTest.computeOneIteration();
+            e = eps;
+        }
+
+        for (size_t b = 0; b < simuRef.getBodies().getN(); b++) {
+            REQUIRE_THAT(xRef[b], Catch::Matchers::WithinRel(xTest[b], e));
+            REQUIRE_THAT(yRef[b], Catch::Matchers::WithinRel(yTest[b], e));
+            REQUIRE_THAT(zRef[b], Catch::Matchers::WithinRel(zTest[b], e));
+        }
+    }
+}
+
+TEST_CASE("n-body - Optim", "[optim]")
+{
+    SECTION("fp32 - n=13 - i=1 - random") { test_nbody_optim<float>(13, 2e+08, 3600, 1, "random", 1e-3); }
+    SECTION("fp32 - n=13 - i=100 - random") { test_nbody_optim<float>(13, 2e+08, 3600, 100, "random", 5e-3); }
+    SECTION("fp32 - n=2049 - i=3 - random") { test_nbody_optim<float>(2049, 2e+08, 3600, 3, "random", 1e-3); }
+    SECTION("fp32 - n=13 - i=30 - galaxy") { test_nbody_optim<float>(13, 2e+08, 3600, 30, "galaxy", 1e-1); }
+    SECTION("fp32 - n=2049 - i=3 - galaxy") { test_nbody_optim<float>(2049, 2e+08, 3600, 3, "galaxy", 1e-1); }
+
+    SECTION("fp64 - n=13 - i=100 - random") { test_nbody_optim<double>(13, 2e+08, 3600, 100, "random", 1e-9); }
+    SECTION("fp64 - n=2049 - i=3 - random") { test_nbody_optim<double>(2049, 2e+08, 3600, 3, "random", 1e-9); }
+    SECTION("fp64 - n=13 - i=30 - galaxy") { test_nbody_optim<double>(13, 2e+08, 3600, 30, "galaxy", 1e-9); }
+    SECTION("fp64 - n=2049 - i=3 - galaxy") { test_nbody_optim<double>(2049, 2e+08, 3600, 3, "galaxy", 1e-9); }
+}
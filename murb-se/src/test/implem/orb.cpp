@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "SimulationNBodyBarnesHut.hpp"
+#include "SimulationNBodyORB.hpp"
+#include "SimulationNBodyProbe.hpp"
+#include "utils/Orb.hpp"
+#include "utils/Perf.hpp"
+
+/* the domains are a partition of the bodies, contain their bodies and have the same weight */
+void test_orb_decompose(const size_t n, const unsigned nParts, const bool weighted)
+{
+    SimulationNBodyNaive<float> simu(n, "galaxy", 2e+08);
+    const dataSoA_t<float> &d = simu.getBodies().getDataSoA();
+    std::vector<float> weights(n);
+    for (size_t b = 0; b < n; b++)
+        weights[b] = weighted ? ((d.qx[b] < 0) ? 10.f : 1.f) : 1.f;
+
+    std::vector<unsigned long> ids, offsets;
+    std::vector<orbDomain_t> domains;
+    orbDecompose<float>(d.qx.data(), d.qy.data(), d.qz.data(), weighted ? weights.data() : nullptr, n, nParts, ids,
+                        offsets, domains);
+    REQUIRE(ids.size() == n);
+    REQUIRE(offsets.size() == nParts + 1);
+    REQUIRE(offsets[0] == 0);
+    REQUIRE(offsets[nParts] == n);
+
+    std::vector<unsigned long> sorted(ids);
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t b = 0; b < n; b++)
+        REQUIRE(sorted[b] == b);
+
+    double total = 0.;
+    for (size_t b = 0; b < n; b++)
+        total += weights[b];
+    for (unsigned p = 0; p < nParts; p++) {
+        double w = 0.;
+        for (unsigned long k = offsets[p]; k < offsets[p + 1]; k++) {
+            const unsigned long b = ids[k];
+            REQUIRE(orbDistance(domains[p], d.qx[b], d.qy[b], d.qz[b]) == 0.);
+            w += weights[b];
+        }
+        // a cut is at most half a body away from its target
+        REQUIRE(std::abs(w - total / nParts) <= 10. * std::ceil(std::log2(nParts)));
+    }
+}
+
+/* rms error of the accelerations compared to `cpu+naive` (fp64), relative to the rms norm of the reference */
+double accuracy_nbody_orb(const SimulationNBodyNaiveProbe<double> &simuRef, const size_t n, const std::string &scheme,
+                          const double theta, const unsigned nRanks)
+{
+    SimulationNBodyProbe<SimulationNBodyORB<double>> simuTest(n, scheme, 2e+08, 0, theta, 16, nRanks, "sockets");
+    REQUIRE(simuTest.getCommunicator().getSize() == nRanks);
+    simuTest.setDt(3600);
+    simuTest.computeOneIteration();
+
+    const std::vector<accAoS_t<double>> &aRef = simuRef.getAccelerations();
+    const accSoA_t<double> &aTest = simuTest.getAccelerations();
+    double sumRef = 0., sumErr = 0.;
+    for (size_t b = 0; b < n; b++) {
+        sumRef += aRef[b].ax * aRef[b].ax + aRef[b].ay * aRef[b].ay + aRef[b].az * aRef[b].az;
+        const double dx = aTest.ax[b] - aRef[b].ax;
+        const double dy = aTest.ay[b] - aRef[b].ay;
+        const double dz = aTest.az[b] - aRef[b].az;
+        sumErr += dx * dx + dy * dy + dz * dz;
+    }
+    return std::sqrt(sumErr / sumRef);
+}
+
+void test_nbody_orb(const size_t n, const std::string &scheme)
+{
+    SimulationNBodyNaiveProbe<double> simuRef(n, scheme, 2e+08);
+    simuRef.setDt(3600);
+    simuRef.computeOneIteration();
+
+    // the locally essential trees keep the accuracy of the opening angle whatever the number of ranks
+    for (unsigned nRanks : {1u, 2u, 3u, 4u}) {
+        REQUIRE(accuracy_nbody_orb(simuRef, n, scheme, 0.5, nRanks) < 1e-2);
+        REQUIRE(accuracy_nbody_orb(simuRef, n, scheme, 0.3, nRanks) < 1e-3);
+    }
+}
+
+TEST_CASE("n-body - Domain-decomposed Barnes-Hut (ORB)", "[orb]")
+{
+    SECTION("decompose - n=1000 - 3 parts") { test_orb_decompose(1000, 3, false); }
+    SECTION("decompose - n=10000 - 8 parts - weighted") { test_orb_decompose(10000, 8, true); }
+    SECTION("decompose - n=5 - 7 parts") { test_orb_decompose(5, 7, false); }
+
+    SECTION("fp64 - n=3000 - random") { test_nbody_orb(3000, "random"); }
+    SECTION("fp64 - n=3000 - galaxy") { test_nbody_orb(3000, "galaxy"); }
+    SECTION("fp64 - n=13 - random") { test_nbody_orb(13, "random"); }
+
+    SECTION("fp32 - n=4000 - i=3 - galaxy - measured costs")
+    {
+        SimulationNBodyORB<float> simuCost(4000, "galaxy", 2e+08, 0, 0.5, 32, 4, "sockets", true);
+        simuCost.setDt(3600);
+        for (size_t i = 0; i < 3; i++)
+            simuCost.computeOneIteration();
+        // the costs of an iteration balance the next one
+        REQUIRE(simuCost.getDomains().size() == 4);
+        REQUIRE(simuCost.getImbalance() < 1.1f);
+
+        SimulationNBodyBarnesHut<float> simuRef(4000, "galaxy", 2e+08, 0, 0.5, 32);
+        simuRef.setDt(3600);
+        for (size_t i = 0; i < 3; i++)
+            simuRef.computeOneIteration();
+        const float *xRef = simuRef.getBodies().getDataSoA().qx.data();
+        const float *xTest = simuCost.getBodies().getDataSoA().qx.data();
+        for (size_t b = 0; b < 4000; b++)
+            REQUIRE_THAT(xRef[b], Catch::Matchers::WithinRel(xTest[b], 1e-2f));
+    }
+}
+
+/* load imbalance and time per step vs number of ranks, run it with: ./bin/murb-test "[orb-report]" */
+TEST_CASE("n-body - Domain-decomposed Barnes-Hut (ORB) - report", "[.][orb-report]")
+{
+    const unsigned long n = 100000;
+    std::cout << "cpu+bh+orb, galaxy, n = " << n << ", theta 0.5, group 32, fp32 (imbalance = max / mean cost):"
+              << std::endl;
+    std::cout << "  ranks | imbalance (bodies) | imbalance (costs) | time (ms/ite.)" << std::endl;
+    for (unsigned nRanks : {1u, 2u, 4u, 8u}) {
+        SimulationNBodyORB<float> simuCount(n, "galaxy", 2e+08, 0, 0.5, 32, nRanks, "sockets", false);
+        simuCount.setDt(3600);
+        simuCount.computeOneIteration();
+        simuCount.computeOneIteration();
+        const float imbalanceCount = simuCount.getImbalance();
+
+        SimulationNBodyORB<float> simu(n, "galaxy", 2e+08, 0, 0.5, 32, nRanks, "sockets", true);
+        simu.setDt(3600);
+        simu.computeOneIteration();
+        Perf perf;
+        perf.start();
+        for (int i = 0; i < 3; i++)
+            simu.computeOneIteration();
+        perf.stop();
+        std::cout << "  " << std::setw(5) << nRanks << " | " << std::fixed << std::setprecision(3) << std::setw(18)
+                  << imbalanceCount << " | " << std::setw(17) << simu.getImbalance() << " | " << std::setprecision(1)
+                  << std::setw(14) << perf.getElapsedTime() / 3 << std::defaultfloat << std::endl;
+    }
+}
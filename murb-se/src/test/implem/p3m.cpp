@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "SimulationNBodyP3M.hpp"
+#include "SimulationNBodyPM.hpp"
+#include "SimulationNBodyProbe.hpp"
+#include "utils/Perf.hpp"
+
+/* rms error of the accelerations compared to `cpu+naive` (fp64), relative to the rms norm of the reference
+ * accelerations */
+template <class S>
+double accuracy_nbody_p3m(const SimulationNBodyNaiveProbe<double> &simuRef, S &simuTest, const size_t n)
+{
+    simuTest.setDt(3600);
+    simuTest.computeOneIteration();
+
+    const std::vector<accAoS_t<double>> &aRef = simuRef.getAccelerations();
+    const accSoA_t<double> &aTest = simuTest.getAccelerations();
+
+    double sumRef = 0., sumErr = 0.;
+    for (size_t b = 0; b < n; b++) {
+        sumRef += aRef[b].ax * aRef[b].ax + aRef[b].ay * aRef[b].ay + aRef[b].az * aRef[b].az;
+        const double dx = aTest.ax[b] - aRef[b].ax;
+        const double dy = aTest.ay[b] - aRef[b].ay;
+        const double dz = aTest.az[b] - aRef[b].az;
+        sumErr += dx * dx + dy * dy + dz * dz;
+    }
+    return std::sqrt(sumErr / sumRef);
+}
+
+TEST_CASE("n-body - P3M", "[p3m]")
+{
+    const size_t n = 3000;
+    for (auto scheme : {"random", "galaxy"})
+        for (auto soft : {2e+08, 1e+07}) {
+            SimulationNBodyNaiveProbe<double> simuRef(n, scheme, soft);
+            simuRef.setDt(3600);
+            simuRef.computeOneIteration();
+
+            SimulationNBodyProbe<SimulationNBodyPM<double>> simuPM(n, scheme, soft, 0, 32);
+            SimulationNBodyProbe<SimulationNBodyP3M<double>> simuP3M(n, scheme, soft, 0, 32);
+            const double errPM = accuracy_nbody_p3m(simuRef, simuPM, n);
+            const double errP3M = accuracy_nbody_p3m(simuRef, simuP3M, n);
+            // the short-range direct sums recover the small scales lost by the mesh
+            REQUIRE(errP3M < 1e-2);
+            REQUIRE(errP3M < errPM / 4);
+        }
+
+    SECTION("fp32 - n=2049 - i=3 - galaxy")
+    {
+        SimulationNBodyNaive<float> simuRef(2049, "galaxy", 2e+08);
+        simuRef.setDt(3600);
+        SimulationNBodyP3M<float> simuTest(2049, "galaxy", 2e+08);
+        simuTest.setDt(3600);
+        for (size_t i = 0; i < 3; i++) {
+            simuRef.computeOneIteration();
+            simuTest.computeOneIteration();
+        }
+        const float *xRef = simuRef.getBodies().getDataSoA().qx.data();
+        const float *xTest = simuTest.getBodies().getDataSoA().qx.data();
+        for (size_t b = 0; b < 2049; b++)
+            REQUIRE_THAT(xTest[b], Catch::Matchers::WithinRel(xRef[b], 1e-2f));
+    }
+}
+
+/* accuracy vs split radius report, run it with: ./bin/murb-test "[p3m-report]" */
+TEST_CASE("n-body - P3M - accuracy report", "[.][p3m-report]")
+{
+    std::cout << "rms error of the P3M accelerations vs cpu+naive (relative to the rms acceleration):" << std::endl;
+    std::cout << "  scheme |  soft | grid | split |   rms err | time (ms)" << std::endl;
+    const size_t n = 20000;
+    for (auto scheme : {"galaxy", "random"})
+        for (auto soft : {2e+08, 1e+07}) {
+            SimulationNBodyNaiveProbe<double> simuRef(n, scheme, soft);
+            simuRef.setDt(3600);
+            simuRef.computeOneIteration();
+            for (auto gridSize : {32ul, 64ul})
+                for (auto split : {0.75, 1.25, 2.}) {
+                    SimulationNBodyProbe<SimulationNBodyP3M<double>> simuTest(n, scheme, soft, 0, gridSize,
+                                                                                  "tsc", split);
+                    Perf perf;
+                    perf.start();
+                    const double err = accuracy_nbody_p3m(simuRef, simuTest, n);
+                    perf.stop();
+                    std::cout << "  " << std::setw(6) << scheme << " | " << std::scientific << std::setprecision(0)
+                              << soft << " | " << std::defaultfloat << std::setw(4) << gridSize << " | "
+                              << std::setprecision(3) << std::setw(5) << split << " | " << std::scientific
+                              << std::setprecision(2) << std::setw(9) << err << " | " << std::fixed
+                              << std::setprecision(1) << std::setw(9) << perf.getElapsedTime() << std::defaultfloat
+                              << std::endl;
+                }
+        }
+
+    std::cout << std::endl << "time per step vs n (grid 64, split 1.25, galaxy, fp32):" << std::endl;
+    for (auto n : {10000ul, 40000ul, 160000ul}) {
+        SimulationNBodyP3M<float> simu(n, "galaxy", 2e+08, 0, 64);
+        simu.setDt(3600);
+        Perf perf;
+        perf.start();
+        simu.computeOneIteration();
+        perf.stop();
+        std::cout << "  n = " << std::setw(7) << n << ": " << std::fixed << std::setprecision(1) << std::setw(9)
+                  << perf.getElapsedTime() << " ms (" << perf.getElapsedTime() * 1e3f / n << " us/body)"
+                  << std::defaultfloat << std::endl;
+    }
+}
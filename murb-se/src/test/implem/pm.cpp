@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <complex>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "SimulationNBodyPM.hpp"
+#include "SimulationNBodyProbe.hpp"
+#include "utils/FFT.hpp"
+#include "utils/Perf.hpp"
+
+/* rms error of the PM accelerations compared to `cpu+naive` (fp64), relative to the rms norm of the reference
+ * accelerations */
+double accuracy_nbody_pm(const SimulationNBodyNaiveProbe<double> &simuRef, const size_t n, const double soft,
+                         const std::string &scheme, const unsigned long gridSize, const std::string &assignment)
+{
+    SimulationNBodyProbe<SimulationNBodyPM<double>> simuTest(n, scheme, soft, 0, gridSize, assignment);
+    simuTest.setDt(3600);
+    simuTest.computeOneIteration();
+
+    const std::vector<accAoS_t<double>> &aRef = simuRef.getAccelerations();
+    const accSoA_t<double> &aTest = simuTest.getAccelerations();
+
+    double sumRef = 0., sumErr = 0.;
+    for (size_t b = 0; b < n; b++) {
+        sumRef += aRef[b].ax * aRef[b].ax + aRef[b].ay * aRef[b].ay + aRef[b].az * aRef[b].az;
+        const double dx = aTest.ax[b] - aRef[b].ax;
+        const double dy = aTest.ay[b] - aRef[b].ay;
+        const double dz = aTest.az[b] - aRef[b].az;
+        sumErr += dx * dx + dy * dy + dz * dz;
+    }
+    return std::sqrt(sumErr / sumRef);
+}
+
+TEST_CASE("FFT3D", "[pm]")
+{
+    const unsigned long m = 8;
+    std::vector<std::complex<double>> data(m * m * m), ref(m * m * m);
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> dis(-1., 1.);
+    for (auto &d : data)
+        d = std::complex<double>(dis(gen), dis(gen));
+    const std::vector<std::complex<double>> init = data;
+
+    // naive DFT
+    const double pi = std::acos(-1.);
+    for (unsigned long x = 0; x < m; x++)
+        for (unsigned long y = 0; y < m; y++)
+            for (unsigned long z = 0; z < m; z++) {
+                std::complex<double> sum = 0.;
+                for (unsigned long i = 0; i < m; i++)
+                    for (unsigned long j = 0; j < m; j++)
+                        for (unsigned long k = 0; k < m; k++)
+                            sum += init[(i * m + j) * m + k] *
+                                   std::polar(1., -2. * pi * (double)(x * i + y * j + z * k) / m);
+                ref[(x * m + y) * m + z] = sum;
+            }
+
+    FFT3D fft(m);
+    fft.forward(data.data());
+    for (unsigned long i = 0; i < m * m * m; i++) {
+        REQUIRE(std::abs(data[i] - ref[i]) < 1e-10);
+    }
+
+    fft.backward(data.data());
+    for (unsigned long i = 0; i < m * m * m; i++)
+        REQUIRE(std::abs(data[i] / (double)(m * m * m) - init[i]) < 1e-12);
+
+    // pruned transforms: only the first half of each dimension is non zero / needed
+    std::vector<std::complex<double>> padded(m * m * m, 0.), full;
+    for (unsigned long x = 0; x < m / 2; x++)
+        for (unsigned long y = 0; y < m / 2; y++)
+            for (unsigned long z = 0; z < m / 2; z++)
+                padded[(x * m + y) * m + z] = init[(x * m + y) * m + z];
+    full = padded;
+    fft.forward(full.data());
+    fft.forward(padded.data(), m / 2);
+    for (unsigned long i = 0; i < m * m * m; i++)
+        REQUIRE(std::abs(padded[i] - full[i]) < 1e-12);
+    fft.backward(full.data());
+    fft.backward(padded.data(), m / 2);
+    for (unsigned long x = 0; x < m / 2; x++)
+        for (unsigned long y = 0; y < m / 2; y++)
+            for (unsigned long z = 0; z < m / 2; z++)
+                REQUIRE(std::abs(padded[(x * m + y) * m + z] - full[(x * m + y) * m + z]) < 1e-10);
+}
+
+TEST_CASE("n-body - PM", "[pm]")
+{
+    // the softening is large compared to the grid spacing: the mesh forces are close to the direct ones
+    for (auto scheme : {"random", "galaxy"}) {
+        SimulationNBodyNaiveProbe<double> simuRef(3000, scheme, 2e+08);
+        simuRef.setDt(3600);
+        simuRef.computeOneIteration();
+        const double errCIC = accuracy_nbody_pm(simuRef, 3000, 2e+08, scheme, 64, "cic");
+        const double errTSC = accuracy_nbody_pm(simuRef, 3000, 2e+08, scheme, 64, "tsc");
+        const double errTSC32 = accuracy_nbody_pm(simuRef, 3000, 2e+08, scheme, 32, "tsc");
+        REQUIRE(errCIC < 5e-2);
+        REQUIRE(errTSC < 5e-2);
+        // a finer grid is more accurate
+        REQUIRE(errTSC < errTSC32);
+    }
+
+    SECTION("fp32 - n=2049 - i=3 - galaxy")
+    {
+        SimulationNBodyPM<double> simuRef(2049, "galaxy", 2e+08);
+        simuRef.setDt(3600);
+        SimulationNBodyPM<float> simuTest(2049, "galaxy", 2e+08);
+        simuTest.setDt(3600);
+        for (size_t i = 0; i < 3; i++) {
+            simuRef.computeOneIteration();
+            simuTest.computeOneIteration();
+        }
+        const double *xRef = simuRef.getBodies().getDataSoA().qx.data();
+        const float *xTest = simuTest.getBodies().getDataSoA().qx.data();
+        for (size_t b = 0; b < 2049; b++)
+            REQUIRE_THAT(xTest[b], Catch::Matchers::WithinRel((float)xRef[b], 1e-3f));
+    }
+}
+
+/* accuracy vs grid size report, run it with: ./bin/murb-test "[pm-report]" */
+TEST_CASE("n-body - PM - accuracy report", "[.][pm-report]")
+{
+    std::cout << "rms error of the PM accelerations vs cpu+naive (relative to the rms acceleration):" << std::endl;
+    std::cout << "  scheme |  soft | grid | assign |   rms err | time (ms)" << std::endl;
+    const size_t n = 20000;
+    for (auto scheme : {"galaxy", "random"})
+        for (auto soft : {2e+08, 1e+07}) {
+            SimulationNBodyNaiveProbe<double> simuRef(n, scheme, soft);
+            simuRef.setDt(3600);
+            simuRef.computeOneIteration();
+            for (auto gridSize : {32ul, 64ul, 128ul})
+                for (auto assignment : {"cic", "tsc"}) {
+                    Perf perf;
+                    perf.start();
+                    const double err = accuracy_nbody_pm(simuRef, n, soft, scheme, gridSize, assignment);
+                    perf.stop();
+                    std::cout << "  " << std::setw(6) << scheme << " | " << std::scientific << std::setprecision(0)
+                              << soft << " | " << std::defaultfloat << std::setw(4) << gridSize << " | "
+                              << std::setw(6) << assignment << " | " << std::scientific << std::setprecision(2)
+                              << std::setw(9) << err << " | " << std::fixed << std::setprecision(1) << std::setw(9)
+                              << perf.getElapsedTime() << std::defaultfloat << std::endl;
+                }
+        }
+}
@@ -0,0 +1,76 @@
+#include <catch.hpp>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "ImplemRegistry.hpp"
+
+/* an implementation of the registry can be created and run in one of its precisions */
+template <typename T> void test_registry_create(const implemInfo_t &implem, const std::string &precision)
+{
+    implemParams_t params;
+    params.nBodies = 333;
+    params.gridSize = 16;
+    SimulationNBodyInterface<T> *simu = ImplemRegistry::create<T>(implem.tag, precision, params);
+    REQUIRE(simu != nullptr);
+    REQUIRE(simu->getBodies().getN() == params.nBodies);
+    simu->setDt(3600);
+    simu->computeOneIteration();
+    for (unsigned long b = 0; b < params.nBodies; b++)
+        REQUIRE(std::isfinite(simu->getBodies().getDataSoA().qx[b]));
+    delete simu;
+}
+
+TEST_CASE("n-body - Registry of the implementations", "[registry]")
+{
+    // the implementations register themselves at static initialization
+    const std::vector<std::string> tags = {"cpu+naive", "cpu+optim", "cpu+simd", "cpu+simd+aosoa", "cpu+simd+fp16",
+                                           "cpu+simd+bf16", "cpu+bh",   "cpu+fmm",  "cpu+pm",         "cpu+p3m",
+                                           "cpu+cutoff",    "cpu+ring", "cpu+bh+orb"};
+    for (const std::string &tag : tags) {
+        const implemInfo_t *implem = ImplemRegistry::find(tag);
+        REQUIRE(implem != nullptr);
+        REQUIRE(!implem->caps.description.empty());
+        REQUIRE(!implem->precisions.empty());
+    }
+    REQUIRE(ImplemRegistry::list().size() == tags.size());
+    REQUIRE(ImplemRegistry::find("gpu+naive") == nullptr);
+    REQUIRE(ImplemRegistry::find("cpu+simd")->precisions == std::vector<std::string>({"fp32", "fp64", "mixed"}));
+    REQUIRE(ImplemRegistry::find("cpu+simd+fp16")->precisions == std::vector<std::string>({"fp32"}));
+
+    // the factories match the precisions
+    for (const implemInfo_t *implem : ImplemRegistry::list()) {
+        SECTION(implem->tag)
+        {
+            for (const std::string &precision : implem->precisions) {
+                if (precision == "fp32")
+                    test_registry_create<float>(*implem, precision);
+                else
+                    test_registry_create<double>(*implem, precision);
+            }
+        }
+    }
+    implemParams_t params;
+    REQUIRE(ImplemRegistry::create<float>("cpu+simd+fp16", "fp64", params) == nullptr);
+    REQUIRE(ImplemRegistry::create<double>("cpu+simd+fp16", "fp64", params) == nullptr);
+    REQUIRE(ImplemRegistry::create<double>("gpu+naive", "fp64", params) == nullptr);
+
+    // `--im auto` only selects exact implementations and keeps its choice
+    params.nBodies = 1000;
+    const std::string fastest = ImplemRegistry::selectFastest("fp32", params, false, 512);
+    REQUIRE(ImplemRegistry::find(fastest) != nullptr);
+    REQUIRE(ImplemRegistry::find(fastest)->caps.exact);
+    REQUIRE(ImplemRegistry::selectFastest("fp32", params) == fastest);
+    REQUIRE(ImplemRegistry::selectFastest("mixed", params, false, 512) == "cpu+simd");
+}
+
+/* calibration of `--im auto`, run it with: ./bin/murb-test "[registry-report]" */
+TEST_CASE("n-body - Registry of the implementations - report", "[.][registry-report]")
+{
+    implemParams_t params;
+    for (auto n : {1000ul, 4096ul}) {
+        params.nBodies = n;
+        ImplemRegistry::selectFastest("fp32", params, true);
+        ImplemRegistry::selectFastest("fp64", params, true);
+    }
+}
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <exception>
+#include <numeric>
+#include <random>
+#include <string>
+
+#include "SimulationNBodyNaive.hpp"
+#include "SimulationNBodySIMD.hpp"
+#include "utils/Morton.hpp"
+
+template <typename T>
+void test_nbody_reorder(const size_t n, const T soft, const T dt, const size_t nIte, const std::string &scheme,
+                        const unsigned long period, const T eps)
+{
+    SimulationNBodyNaive<T> simuRef(n, scheme, soft);
+    simuRef.setDt(dt);
+
+    SimulationNBodySIMD<T> simuTest(n, scheme, soft);
+    simuTest.setDt(dt);
+    simuTest.setReorderingPolicy(period);
+
+    const T *xRef = simuRef.getBodies().getDataSoA().qx.data();
+    const T *yRef = simuRef.getBodies().getDataSoA().qy.data();
+    const T *zRef = simuRef.getBodies().getDataSoA().qz.data();
+
+    // the pointers stay valid since the bodies are permuted in place
+    const T *xTest = simuTest.getBodies().getDataSoA().qx.data();
+    const T *yTest = simuTest.getBodies().getDataSoA().qy.data();
+    const T *zTest = simuTest.getBodies().getDataSoA().qz.data();
+    const unsigned long *ids = simuTest.getBodies().getIds().data();
+
+    T e = 0; // espilon
+    for (size_t i = 0; i < nIte + 1; i++) {
+        if (i > 0) {
+            simuRef.computeOneIteration();
+            simuTest.computeOneIteration();
+            simuTest.updateBodiesLayout();
+            e = eps;
+        }
+
+        for (size_t b = 0; b < simuRef.getBodies().getN(); b++) {
+            REQUIRE_THAT(xRef[ids[b]], Catch::Matchers::WithinRel(xTest[b], e));
+            REQUIRE_THAT(yRef[ids[b]], Catch::Matchers::WithinRel(yTest[b], e));
+            REQUIRE_THAT(zRef[ids[b]], Catch::Matchers::WithinRel(zTest[b], e));
+            // the other layouts follow the permutation
+            REQUIRE(simuTest.getBodies().getDataHot()[b].qx == xTest[b]);
+            REQUIRE(simuTest.getBodies().getDataAoS()[b].qy == yTest[b]);
+        }
+    }
+
+    REQUIRE(simuTest.getBodies().getLayoutVersion() >= nIte / period);
+
+    // the ids are a permutation
+    std::vector<unsigned long> sortedIds(ids, ids + n);
+    std::sort(sortedIds.begin(), sortedIds.end());
+    for (size_t b = 0; b < n; b++)
+        REQUIRE(sortedIds[b] == b);
+}
+
+TEST_CASE("n-body - Morton reordering", "[reorder]")
+{
+    SECTION("radix sort")
+    {
+        std::mt19937_64 gen(42);
+        std::vector<uint64_t> keys(10007);
+        for (auto &k : keys)
+            k = gen() >> 1;
+        keys[3] = keys[5]; // duplicated keys
+        std::vector<unsigned long> values(keys.size());
+        std::iota(values.begin(), values.end(), 0);
+        const std::vector<uint64_t> init = keys;
+        std::vector<uint64_t> ref = keys;
+
+        radixSortPairs(keys, values);
+        std::sort(ref.begin(), ref.end());
+        for (size_t i = 0; i < keys.size(); i++) {
+            REQUIRE(keys[i] == ref[i]);
+            REQUIRE(init[values[i]] == keys[i]);
+            if (i > 0 && keys[i] == keys[i - 1])
+                REQUIRE(values[i - 1] < values[i]); // stable
+        }
+    }
+
+    SECTION("fp64 - n=13 - i=30 - random") { test_nbody_reorder<double>(13, 2e+08, 3600, 30, "random", 3, 1e-9); }
+    SECTION("fp64 - n=2049 - i=4 - random") { test_nbody_reorder<double>(2049, 2e+08, 3600, 4, "random", 1, 1e-9); }
+    SECTION("fp64 - n=2049 - i=4 - galaxy") { test_nbody_reorder<double>(2049, 2e+08, 3600, 4, "galaxy", 2, 1e-9); }
+}
@@ -0,0 +1,92 @@
+#include <catch.hpp>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "SimulationNBodyRing.hpp"
+#include "SimulationNBodySIMD.hpp"
+#include "utils/Communicator.hpp"
+#include "utils/Perf.hpp"
+
+/* ring exchange of messages larger than the buffers of the sockets (the other ranks must not use Catch) */
+static void test_ring_transport(const unsigned nRanks, const size_t nInts)
+{
+    std::unique_ptr<Communicator> comm(Communicator::create("sockets", nRanks));
+    const unsigned rank = comm->getRank();
+    const unsigned size = comm->getSize();
+    const unsigned left = (rank + size - 1) % size;
+    std::vector<int> sBuf(nInts, (int)rank), rBuf(nInts, -1);
+    comm->startSendRecv((rank + 1) % size, sBuf.data(), nInts * sizeof(int), left, rBuf.data(), nInts * sizeof(int));
+    comm->waitSendRecv();
+    char ok = 1;
+    for (const int v : rBuf)
+        ok &= (v == (int)left);
+    if (rank != 0) {
+        comm->send(0, &ok, sizeof(ok));
+        comm->exitRank();
+    }
+
+    REQUIRE(size == nRanks);
+    REQUIRE(comm->getTransport() == "sockets");
+    REQUIRE(ok);
+    for (unsigned r = 1; r < size; r++) {
+        char okRank = 0;
+        REQUIRE(comm->recv(r, &okRank, sizeof(okRank)));
+        REQUIRE(okRank);
+    }
+}
+
+/* the ring computes the same interactions as the direct sum, in another order when there are several ranks */
+template <typename T> void test_ring_simd(const size_t n, const unsigned nRanks)
+{
+    SimulationNBodySIMD<T> simuRef(n, "galaxy", 2e+08);
+    SimulationNBodyRing<T> simuTest(n, "galaxy", 2e+08, 0, nRanks, "sockets");
+    REQUIRE(simuTest.getCommunicator().getSize() == nRanks);
+    simuRef.setDt(3600);
+    simuTest.setDt(3600);
+    for (int i = 0; i < 3; i++) {
+        simuRef.computeOneIteration();
+        simuTest.computeOneIteration();
+    }
+
+    const dataSoA_t<T> &ref = simuRef.getBodies().getDataSoA();
+    const dataSoA_t<T> &test = simuTest.getBodies().getDataSoA();
+    const T eps = (nRanks == 1) ? (T)0 : (sizeof(T) == 4 ? (T)1e-5 : (T)1e-12);
+    for (size_t b = 0; b < n; b++) {
+        REQUIRE(std::abs(ref.qx[b] - test.qx[b]) <= eps * std::abs(ref.qx[b]));
+        REQUIRE(std::abs(ref.qz[b] - test.qz[b]) <= eps * std::abs(ref.qz[b]));
+        REQUIRE(std::abs(ref.vy[b] - test.vy[b]) <= 1e3 * eps * std::abs(ref.vy[b]) + eps);
+    }
+}
+
+TEST_CASE("n-body - Distributed direct sum (ring)", "[ring]")
+{
+    SECTION("transport - 2 ranks") { test_ring_transport(2, 1 << 20); }
+    SECTION("transport - 3 ranks") { test_ring_transport(3, 1 << 20); }
+    SECTION("transport - 1 rank") { test_ring_transport(1, 16); }
+    SECTION("fp32 - n=1000 - 1 rank (same order as cpu+simd)") { test_ring_simd<float>(1000, 1); }
+    SECTION("fp32 - n=1000 - 2 ranks") { test_ring_simd<float>(1000, 2); }
+    SECTION("fp32 - n=1001 - 3 ranks") { test_ring_simd<float>(1001, 3); }
+    SECTION("fp64 - n=333 - 4 ranks") { test_ring_simd<double>(333, 4); }
+}
+
+/* time of an iteration with the number of ranks, run it with: ./bin/murb-test "[ring-report]" */
+TEST_CASE("n-body - Distributed direct sum (ring) - report", "[.][ring-report]")
+{
+    const unsigned long n = 16384;
+    for (unsigned nRanks : {1u, 2u, 4u}) {
+        SimulationNBodyRing<float> simu(n, "galaxy", 2e+08, 0, nRanks, "sockets");
+        simu.setDt(3600);
+        simu.computeOneIteration();
+        Perf perf;
+        perf.start();
+        for (int i = 0; i < 5; i++)
+            simu.computeOneIteration();
+        perf.stop();
+        std::cout << "  ranks = " << nRanks << ": " << std::fixed << std::setprecision(2) << std::setw(9)
+                  << perf.getElapsedTime() / 5 << " ms/ite. (" << simu.getFlopsPerIte() / (perf.getElapsedTime() / 5) * 1e-6f
+                  << " Gflop/s)" << std::defaultfloat << std::endl;
+    }
+}
@@ -0,0 +1,140 @@
+#include <atomic>
+#include <catch.hpp>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "SimulationNBodySIMD.hpp"
+#include "utils/Perf.hpp"
+#include "utils/TaskScheduler.hpp"
+
+/* each iteration is executed once, by chunks of at most `grain` iterations aligned on `begin` */
+static void test_scheduler_coverage(TaskScheduler &scheduler, const unsigned long begin, const unsigned long end,
+                                    const unsigned long grain)
+{
+    std::vector<std::atomic<int>> visits(end);
+    for (auto &v : visits)
+        v = 0;
+    std::atomic<bool> aligned(true);
+    scheduler.parallelFor(begin, end, grain, [&](unsigned long b, unsigned long e) {
+        if ((b - begin) % grain != 0 || e - b > grain || (e - b < grain && e != end))
+            aligned = false;
+        for (unsigned long i = b; i < e; i++)
+            visits[i]++;
+    });
+    REQUIRE(aligned);
+    for (unsigned long i = 0; i < end; i++)
+        REQUIRE(visits[i] == (i >= begin ? 1 : 0));
+}
+
+/* the tiles are computed by the threads of the scheduler: the results do not depend on their number */
+template <typename T> void test_scheduler_simd(const size_t n, const unsigned nThreads, const bool dynamicSchedule)
+{
+    TaskScheduler::get().setNumThreads(1);
+    SimulationNBodySIMD<T> simuRef(n, "galaxy", 2e+08, 0, 64);
+    simuRef.setDt(3600);
+    for (int i = 0; i < 3; i++)
+        simuRef.computeOneIteration();
+
+    TaskScheduler::get().setNumThreads(nThreads);
+    SimulationNBodySIMD<T> simuTest(n, "galaxy", 2e+08, 0, 64, dynamicSchedule);
+    simuTest.setDt(3600);
+    for (int i = 0; i < 3; i++)
+        simuTest.computeOneIteration();
+    TaskScheduler::get().setNumThreads(TaskScheduler::getDefaultNumThreads());
+
+    for (size_t b = 0; b < n; b++) {
+        REQUIRE(simuRef.getBodies().getDataSoA().qx[b] == simuTest.getBodies().getDataSoA().qx[b]);
+        REQUIRE(simuRef.getBodies().getDataSoA().vy[b] == simuTest.getBodies().getDataSoA().vy[b]);
+    }
+}
+
+TEST_CASE("n-body - Task scheduler", "[scheduler]")
+{
+    SECTION("coverage - 1 thread")
+    {
+        TaskScheduler scheduler(1);
+        test_scheduler_coverage(scheduler, 0, 10000, 7);
+    }
+    SECTION("coverage - 4 threads")
+    {
+        TaskScheduler scheduler(4);
+        REQUIRE(scheduler.getNumThreads() == 4);
+        test_scheduler_coverage(scheduler, 0, 100000, 1);
+        test_scheduler_coverage(scheduler, 13, 100000, 64);
+        test_scheduler_coverage(scheduler, 5, 6, 64);
+        test_scheduler_coverage(scheduler, 0, 0, 64);
+        scheduler.setNumThreads(3);
+        REQUIRE(scheduler.getNumThreads() == 3);
+        test_scheduler_coverage(scheduler, 0, 4097, 16);
+    }
+    SECTION("nested loops are executed inline")
+    {
+        TaskScheduler scheduler(4);
+        std::atomic<unsigned long> sum(0);
+        scheduler.parallelFor(0, 64, 1, [&](unsigned long b, unsigned long e) {
+            for (unsigned long i = b; i < e; i++)
+                scheduler.parallelFor(0, 100, 10, [&](unsigned long bb, unsigned long ee) {
+                    for (unsigned long j = bb; j < ee; j++)
+                        sum += i * j;
+                });
+        });
+        REQUIRE(sum == (63 * 64 / 2) * (99 * 100 / 2));
+    }
+    SECTION("loops one after another")
+    {
+        TaskScheduler scheduler(4);
+        std::vector<unsigned long> counts(1000, 0);
+        for (int l = 0; l < 1000; l++)
+            scheduler.parallelFor(0, counts.size(), 16, [&](unsigned long b, unsigned long e) {
+                for (unsigned long i = b; i < e; i++)
+                    counts[i]++;
+            });
+        for (unsigned long c : counts)
+            REQUIRE(c == 1000);
+    }
+    SECTION("overhead - 4 threads")
+    {
+        // a loop of n = 1k iterations (16 chunks) costs less than 5 us on a pool of 4 threads
+        TaskScheduler scheduler(4);
+        std::vector<unsigned long> counts(1000, 0);
+        const auto loop = [&]() {
+            scheduler.parallelFor(0, counts.size(), 64, [&](unsigned long b, unsigned long e) { counts[b] += e - b; });
+        };
+        for (int l = 0; l < 1000; l++)
+            loop();
+        const int nLoops = 20000;
+        Perf perf;
+        perf.start();
+        for (int l = 0; l < nLoops; l++)
+            loop();
+        perf.stop();
+        REQUIRE(perf.getElapsedTime() * 1e3f / nLoops < 5.f);
+        REQUIRE(counts[0] == 64ul * (1000 + nLoops));
+    }
+    SECTION("fp32 - n=1000 - 4 threads, static") { test_scheduler_simd<float>(1000, 4, false); }
+    SECTION("fp32 - n=1000 - 3 threads, dynamic") { test_scheduler_simd<float>(1000, 3, true); }
+    SECTION("fp64 - n=333 - 2 threads, dynamic") { test_scheduler_simd<double>(333, 2, true); }
+}
+
+/* overhead of a loop of the scheduler, run it with: ./bin/murb-test "[scheduler-report]" */
+TEST_CASE("n-body - Task scheduler - report", "[.][scheduler-report]")
+{
+    const unsigned long n = 1000;
+    std::vector<float> x(n, 1.f);
+    for (unsigned nThreads : {1u, 2u, 4u, TaskScheduler::getDefaultNumThreads()}) {
+        TaskScheduler scheduler(nThreads);
+        const int nLoops = 20000;
+        Perf perf;
+        perf.start();
+        for (int l = 0; l < nLoops; l++)
+            scheduler.parallelFor(0, n, 64, [&](unsigned long b, unsigned long e) {
+                for (unsigned long i = b; i < e; i++)
+                    x[i] = x[i] * 0.999f + 0.001f;
+            });
+        perf.stop();
+        std::cout << "  threads = " << std::setw(3) << nThreads << ": " << std::fixed << std::setprecision(2)
+                  << std::setw(8) << perf.getElapsedTime() * 1e3f / nLoops << " us per loop of " << n
+                  << " iterations" << std::defaultfloat << std::endl;
+    }
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <atomic>
+#include <catch.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "SimulationNBodySIMD.hpp"
+#include "utils/Perf.hpp"
+#include "utils/TripleBuffer.hpp"
+
+/* the consumer gets the newest published slot once, the slots published in between are skipped */
+static void test_triplebuffer_sequential()
+{
+    TripleBuffer<int> buffer;
+    REQUIRE(!buffer.consume());
+
+    buffer.getBack() = 1;
+    buffer.publish();
+    REQUIRE(buffer.consume());
+    REQUIRE(buffer.getFront() == 1);
+    REQUIRE(!buffer.consume());
+    REQUIRE(buffer.getFront() == 1);
+
+    for (int i = 2; i <= 5; i++) {
+        buffer.getBack() = i;
+        buffer.publish();
+    }
+    REQUIRE(buffer.consume());
+    REQUIRE(buffer.getFront() == 5);
+    REQUIRE(!buffer.consume());
+
+    // the producer never writes the front slot
+    buffer.getBack() = 6;
+    REQUIRE(buffer.getFront() == 5);
+    buffer.publish();
+    REQUIRE(buffer.getFront() == 5);
+    REQUIRE(buffer.consume());
+    REQUIRE(buffer.getFront() == 6);
+}
+
+/* a producer thread publishes slots filled with their sequence number: a consumed slot is never torn and the
+ * sequence numbers increase */
+static void test_triplebuffer_threads(const unsigned long slotSize, const unsigned long nPublish)
+{
+    TripleBuffer<std::vector<unsigned long>> buffer;
+    std::thread producer([&]() {
+        for (unsigned long seq = 1; seq <= nPublish; seq++) {
+            std::vector<unsigned long> &slot = buffer.getBack();
+            slot.assign(slotSize, seq);
+            buffer.publish();
+        }
+    });
+
+    bool torn = false, increasing = true;
+    unsigned long last = 0, nConsumed = 0;
+    while (last < nPublish) {
+        if (!buffer.consume()) {
+            std::this_thread::yield();
+            continue;
+        }
+        const std::vector<unsigned long> &slot = buffer.getFront();
+        for (unsigned long i = 0; i < slotSize; i++)
+            torn = torn || slot[i] != slot[0];
+        increasing = increasing && slot[0] > last;
+        last = slot[0];
+        nConsumed++;
+    }
+    producer.join();
+
+    REQUIRE(!torn);
+    REQUIRE(increasing);
+    REQUIRE(nConsumed >= 1);
+    REQUIRE(nConsumed <= nPublish);
+}
+
+TEST_CASE("Triple buffer", "[triplebuffer]")
+{
+    SECTION("sequential") { test_triplebuffer_sequential(); }
+    SECTION("threads - slots of 1") { test_triplebuffer_threads(1, 100000); }
+    SECTION("threads - slots of 10000") { test_triplebuffer_threads(10000, 2000); }
+}
+
+/* cost of a snapshot of the bodies compared to an iteration, with a consumer drawing at 60 FPS, run it with:
+ * ./bin/murb-test "[triplebuffer-report]" */
+TEST_CASE("Triple buffer - report", "[.][triplebuffer-report]")
+{
+    std::cout << "snapshot of the positions and velocities (fp32) vs one iteration of cpu+simd, render thread at "
+                 "60 FPS:"
+              << std::endl;
+    std::cout << "        n | snapshot (ms) | iteration (ms) | snapshots drawn" << std::endl;
+    for (unsigned long n : {10000ul, 30000ul, 100000ul}) {
+        SimulationNBodySIMD<float> simu(n, "galaxy", 2e+08);
+        simu.setDt(3600);
+        const dataSoA_t<float> &d = simu.getBodies().getDataSoA();
+
+        TripleBuffer<std::vector<float>> buffer;
+        std::atomic<bool> stop(false);
+        unsigned long nDrawn = 0;
+        std::thread consumer([&]() {
+            while (!stop) {
+                if (buffer.consume())
+                    nDrawn++;
+                std::this_thread::sleep_for(std::chrono::microseconds(16667));
+            }
+        });
+
+        Perf perfSnapshot, perfIte;
+        const int nIte = 5;
+        for (int i = 0; i < nIte; i++) {
+            Perf perf;
+            perf.start();
+            std::vector<float> &slot = buffer.getBack();
+            slot.resize(6 * n);
+            std::copy(d.qx.begin(), d.qx.end(), slot.begin() + 0 * n);
+            std::copy(d.qy.begin(), d.qy.end(), slot.begin() + 1 * n);
+            std::copy(d.qz.begin(), d.qz.end(), slot.begin() + 2 * n);
+            std::copy(d.vx.begin(), d.vx.end(), slot.begin() + 3 * n);
+            std::copy(d.vy.begin(), d.vy.end(), slot.begin() + 4 * n);
+            std::copy(d.vz.begin(), d.vz.end(), slot.begin() + 5 * n);
+            buffer.publish();
+            perf.stop();
+            perfSnapshot += perf;
+
+            perf.start();
+            simu.computeOneIteration();
+            perf.stop();
+            perfIte += perf;
+        }
+        stop = true;
+        consumer.join();
+
+        std::cout << "  " << std::setw(7) << n << " | " << std::fixed << std::setprecision(3) << std::setw(13)
+                  << perfSnapshot.getElapsedTime() / nIte << " | " << std::setw(14) << perfIte.getElapsedTime() / nIte
+                  << " | " << std::setw(9) << nDrawn << " / " << nIte << std::defaultfloat << std::endl;
+    }
+}